@@ -72,6 +72,92 @@ rfxcodec_encode_ex(void *handle, char *cdata, int *cdata_bytes,
                    const struct rfx_rect *region, int num_region,
                    const struct rfx_tile *tiles, int num_tiles,
                    const char *quants, int num_quants, int flags);
+/* rfxcodec_encode_ex for a frame time budget
+ * tiles are sent highest priorities[index] first, tiles with the same
+ * priority in tiles order, priorities NULL keeps tiles order
+ * once deadline_us microseconds have passed since the call no more tiles
+ * are started, the first tile is always sent, deadline_us 0 is no deadline
+ * if order is not NULL it gets num_tiles indexes into tiles in the order
+ * they were sent or would have been, the tiles at order[tiles_written]
+ * and on were not sent and can go in the next call
+ * returns tiles_written as rfxcodec_encode_ex does */
+int
+rfxcodec_encode_deadline(void *handle, char *cdata, int *cdata_bytes,
+                         const char *buf, int width, int height,
+                         int stride_bytes,
+                         const struct rfx_rect *region, int num_region,
+                         const struct rfx_tile *tiles, int num_tiles,
+                         const char *quants, int num_quants, int flags,
+                         const int *priorities, int deadline_us,
+                         int *order);
+/* spread the tiles of each rfxcodec_encode_ex call across num_threads
+ * worker threads, the output is the same as when encoding on the calling
+ * thread, num_threads 0 or 1 goes back to that, more than the number of
+ * online cpus gives one thread per online cpu */
+int
+rfxcodec_encode_set_threads(void *handle, int num_threads);
+/* worker threads that can be shared by any number of handles, idle
+ * threads steal tiles queued for the others
+ * num_threads 0 or more than the number of online cpus gives one thread
+ * per online cpu */
+int
+rfxcodec_encode_pool_create(int num_threads, void **pool);
+int
+rfxcodec_encode_pool_destroy(void *pool);
+/* encode the tiles of handle on pool, NULL detaches
+ * handles must be detached or destroyed before the pool is destroyed */
+int
+rfxcodec_encode_set_pool(void *handle, void *pool);
+/* share of the pool's threads handle gets while other handles have
+ * tiles queued on the same pool, a handle with weight 2 gets twice the
+ * tiles of a handle with weight 1, a handle whose oldest queued tile has
+ * waited more than latency_ms goes first, 0 is no target
+ * defaults are weight 1 and no target */
+int
+rfxcodec_encode_set_share(void *handle, int weight, int latency_ms);
+struct rfxcodec_encode_stats
+{
+    int queue_depth; /* tiles waiting in the pool now */
+    int tiles_done; /* tiles the pool has encoded */
+    int wait_us_avg; /* recent average time a tile waited in the pool */
+    int wait_us_max; /* longest wait since the last call, then reset */
+};
+/* pool queue stats of handle, all 0 without a pool */
+int
+rfxcodec_encode_get_stats(void *handle, struct rfxcodec_encode_stats *stats);
+/* tiles_written and cdata_bytes as rfxcodec_encode_ex returns them */
+typedef void (*rfxcodec_encode_done_proc)(void *handle, void *user,
+                                          int tiles_written, int cdata_bytes);
+/* queue an rfxcodec_encode_ex call on handle's own thread and return at
+ * once, calls run one at a time in submit order, cdata, buf, region,
+ * tiles and quants must stay valid until the call is done
+ * when it is done, done is called on that thread, or if done is NULL the
+ * result is kept for rfxcodec_encode_get_result and the fd from
+ * rfxcodec_encode_get_fd becomes readable
+ * do not call rfxcodec_encode_ex on handle while calls are queued */
+int
+rfxcodec_encode_submit(void *handle, char *cdata, int cdata_bytes,
+                       const char *buf, int width, int height,
+                       int stride_bytes,
+                       const struct rfx_rect *region, int num_region,
+                       const struct rfx_tile *tiles, int num_tiles,
+                       const char *quants, int num_quants, int flags,
+                       rfxcodec_encode_done_proc done, void *user);
+/* fd that is readable while results are waiting, for poll or select
+ * returns -1 on error */
+int
+rfxcodec_encode_get_fd(void *handle);
+/* oldest result of a call submitted with done NULL
+ * returns 0 if there was one, 1 if none are waiting */
+int
+rfxcodec_encode_get_result(void *handle, void **user, int *tiles_written,
+                           int *cdata_bytes);
+/* non zero runs colour conversion, DWT/quantisation and entropy coding
+ * of plain RFX tilesets as a pipeline, conversion on the calling thread
+ * and the other two stages on their own threads, used instead of the
+ * pool for those, the output is unchanged, 0 stops the stage threads */
+int
+rfxcodec_encode_set_pipeline(void *handle, int pipeline);
 
 /* use simple types here, no sint16_t, uint8_t, ... */
 typedef int (*rfxencode_rlgr1_proc)(const short *data, unsigned char *buffer, int buffer_size);
@@ -88,6 +174,23 @@ typedef int (*rfxencode_dwt_shift_x86_sse41_proc)(const char *qtable, const unsi
 
 typedef int (*rfxencode_dwt_shift_amd64_sse2_proc)(const char *qtable, const unsigned char *data, short *dwt_buffer1, short *dwt_buffer);
 typedef int (*rfxencode_dwt_shift_amd64_sse41_proc)(const char *qtable, const unsigned char *data, short *dwt_buffer1, short *dwt_buffer);
+typedef int (*rfxencode_dwt_shift_amd64_avx2_proc)(const char *qtable, const unsigned char *data, short *dwt_buffer1, short *dwt_buffer);
+typedef int (*rfxencode_dwt_shift_amd64_avx512_proc)(const char *qtable, const unsigned char *data, short *dwt_buffer1, short *dwt_buffer);
+
+typedef int (*rfxencode_dwt_shift_intrin_sse2_proc)(const char *qtable, const unsigned char *data, short *dwt_buffer1, short *dwt_buffer);
+typedef int (*rfxencode_dwt_shift_intrin_sse41_proc)(const char *qtable, const unsigned char *data, short *dwt_buffer1, short *dwt_buffer);
+typedef int (*rfxencode_dwt_shift_intrin_avx2_proc)(const char *qtable, const unsigned char *data, short *dwt_buffer1, short *dwt_buffer);
+
+typedef int (*rfxencode_rem_dwt_shift_proc)(const unsigned char *in_buffer, short *out_buffer, short *tmp_buffer, const char *quants);
+typedef int (*rfxencode_rem_dwt_shift_amd64_sse41_proc)(const unsigned char *in_buffer, short *out_buffer, short *tmp_buffer, const char *quants);
+typedef int (*rfxencode_rem_dwt_shift_amd64_avx2_proc)(const unsigned char *in_buffer, short *out_buffer, short *tmp_buffer, const char *quants);
+
+typedef int (*rfxencode_differential_pro_proc)(const short *coefs, const short *history, short *diff, short *history_out, int *diff_zeros, int *coef_zeros);
+typedef int (*rfxencode_differential_pro_amd64_sse2_proc)(const short *coefs, const short *history, short *diff, short *history_out, int *diff_zeros, int *coef_zeros);
+typedef int (*rfxencode_differential_pro_amd64_avx2_proc)(const short *coefs, const short *history, short *diff, short *history_out, int *diff_zeros, int *coef_zeros);
+typedef int (*rfxencode_differential_pro_intrin_sse2_proc)(const short *coefs, const short *history, short *diff, short *history_out, int *diff_zeros, int *coef_zeros);
+typedef int (*rfxencode_differential_pro_intrin_sse41_proc)(const short *coefs, const short *history, short *diff, short *history_out, int *diff_zeros, int *coef_zeros);
+typedef int (*rfxencode_differential_pro_intrin_avx2_proc)(const short *coefs, const short *history, short *diff, short *history_out, int *diff_zeros, int *coef_zeros);
 
 struct rfxcodec_encode_internals
 {
@@ -102,6 +205,20 @@ struct rfxcodec_encode_internals
     rfxencode_dwt_shift_x86_sse41_proc rfxencode_dwt_shift_x86_sse41;
     rfxencode_dwt_shift_amd64_sse2_proc rfxencode_dwt_shift_amd64_sse2;
     rfxencode_dwt_shift_amd64_sse41_proc rfxencode_dwt_shift_amd64_sse41;
+    rfxencode_dwt_shift_amd64_avx2_proc rfxencode_dwt_shift_amd64_avx2;
+    rfxencode_dwt_shift_amd64_avx512_proc rfxencode_dwt_shift_amd64_avx512;
+    rfxencode_dwt_shift_intrin_sse2_proc rfxencode_dwt_shift_intrin_sse2;
+    rfxencode_dwt_shift_intrin_sse41_proc rfxencode_dwt_shift_intrin_sse41;
+    rfxencode_dwt_shift_intrin_avx2_proc rfxencode_dwt_shift_intrin_avx2;
+    rfxencode_rem_dwt_shift_proc rfxencode_rem_dwt_shift;
+    rfxencode_rem_dwt_shift_amd64_sse41_proc rfxencode_rem_dwt_shift_amd64_sse41;
+    rfxencode_rem_dwt_shift_amd64_avx2_proc rfxencode_rem_dwt_shift_amd64_avx2;
+    rfxencode_differential_pro_proc rfxencode_differential_pro;
+    rfxencode_differential_pro_amd64_sse2_proc rfxencode_differential_pro_amd64_sse2;
+    rfxencode_differential_pro_amd64_avx2_proc rfxencode_differential_pro_amd64_avx2;
+    rfxencode_differential_pro_intrin_sse2_proc rfxencode_differential_pro_intrin_sse2;
+    rfxencode_differential_pro_intrin_sse41_proc rfxencode_differential_pro_intrin_sse41;
+    rfxencode_differential_pro_intrin_avx2_proc rfxencode_differential_pro_intrin_avx2;
 };
 
 int
@@ -30,4 +30,21 @@ PROC cpuid_amd64
     ; restore registers
     pop rbx
     ret
+
+;int
+;xgetbv_amd64(int ecx_in, int *eax, int *edx)
+
+PROC xgetbv_amd64
+    ; save registers
+    push rdx
+    push rsi
+
+    mov rcx, rdi
+    xgetbv
+    pop rdi
+    mov [rdi], eax
+    pop rdi
+    mov [rdi], edx
+    mov rax, 0
+    ret
 END_OF_FILE
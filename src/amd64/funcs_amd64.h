@@ -30,6 +30,8 @@ extern "C" {
 
 int
 cpuid_amd64(int eax_in, int ecx_in, int *eax, int *ebx, int *ecx, int *edx);
+int
+xgetbv_amd64(int ecx_in, int *eax, int *edx);
 
 int
 rfxcodec_encode_dwt_shift_amd64_sse2(const char *qtable,
@@ -41,6 +43,141 @@ rfxcodec_encode_dwt_shift_amd64_sse41(const char *qtable,
                                       const unsigned char *data,
                                       short *dwt_buffer1,
                                       short *dwt_buffer);
+int
+rfxcodec_encode_dwt_shift_amd64_avx2(const char *qtable,
+                                     const unsigned char *data,
+                                     short *dwt_buffer1,
+                                     short *dwt_buffer);
+int
+rfxcodec_encode_dwt_shift_amd64_avx512(const char *qtable,
+                                       const unsigned char *data,
+                                       short *dwt_buffer1,
+                                       short *dwt_buffer);
+int
+rfxcodec_encode_dwt_h1_shift_amd64_sse2(const char *qtable,
+                                        short *out_buffer,
+                                        short *v1_buffer);
+int
+rfxcodec_encode_dwt_h1_shift_amd64_sse41(const char *qtable,
+                                         short *out_buffer,
+                                         short *v1_buffer);
+int
+rfxcodec_encode_dwt_h1_shift_amd64_avx2(const char *qtable,
+                                        short *out_buffer,
+                                        short *v1_buffer);
+int
+rfxcodec_encode_dwt_h1_shift_amd64_avx512(const char *qtable,
+                                          short *out_buffer,
+                                          short *v1_buffer);
+int
+rfxcodec_encode_dwt_shift_rem_amd64_sse41(const unsigned char *in_buffer,
+                                          short *out_buffer, short *tmp_buffer,
+                                          const char *quants);
+int
+rfxcodec_encode_dwt_shift_rem_amd64_avx2(const unsigned char *in_buffer,
+                                         short *out_buffer, short *tmp_buffer,
+                                         const char *quants);
+int
+rfxcodec_encode_dwt_v1_rows_amd64_sse2(const unsigned char *s0,
+                                       const unsigned char *s1,
+                                       const unsigned char *s2,
+                                       int n,
+                                       short *y_v1,
+                                       short *u_v1,
+                                       short *v_v1);
+int
+rfxcodec_encode_dwt_v1_rows_amd64_avx2(const unsigned char *s0,
+                                       const unsigned char *s1,
+                                       const unsigned char *s2,
+                                       int n,
+                                       short *y_v1,
+                                       short *u_v1,
+                                       short *v_v1);
+
+int
+rfxcodec_encode_diff_count_amd64_sse2(const short *coefs, const short *history,
+                                      short *diff, short *history_out,
+                                      int *diff_zeros, int *coef_zeros);
+int
+rfxcodec_encode_diff_count_amd64_avx2(const short *coefs, const short *history,
+                                      short *diff, short *history_out,
+                                      int *diff_zeros, int *coef_zeros);
+int
+rfxcodec_encode_rgb_to_yuv_tile_amd64_sse2(unsigned char *y_r_buf,
+                                           unsigned char *u_g_buf,
+                                           unsigned char *v_b_buf);
+int
+rfxcodec_encode_deinterleave4_amd64_ssse3(const char *src, int stride_bytes,
+                                          int count, int height,
+                                          unsigned char *c0, unsigned char *c1,
+                                          unsigned char *c2, unsigned char *c3);
+int
+rfxcodec_encode_deinterleave3_amd64_ssse3(const char *src, int stride_bytes,
+                                          int count, int height,
+                                          unsigned char *c0, unsigned char *c1,
+                                          unsigned char *c2);
+int
+rfxcodec_encode_deinterleave4_amd64_avx2(const char *src, int stride_bytes,
+                                         int count, int height,
+                                         unsigned char *c0, unsigned char *c1,
+                                         unsigned char *c2, unsigned char *c3);
+int
+rfxcodec_encode_deinterleave3_amd64_avx2(const char *src, int stride_bytes,
+                                         int count, int height,
+                                         unsigned char *c0, unsigned char *c1,
+                                         unsigned char *c2);
+int
+rfxcodec_encode_bgra_to_yuva_amd64_ssse3(const char *src, int stride_bytes,
+                                         int count, int height,
+                                         unsigned char *y_buf,
+                                         unsigned char *u_buf,
+                                         unsigned char *v_buf,
+                                         unsigned char *a_buf);
+int
+rfxcodec_encode_rgba_to_yuva_amd64_ssse3(const char *src, int stride_bytes,
+                                         int count, int height,
+                                         unsigned char *y_buf,
+                                         unsigned char *u_buf,
+                                         unsigned char *v_buf,
+                                         unsigned char *a_buf);
+int
+rfxcodec_encode_bgr_to_yuv_amd64_ssse3(const char *src, int stride_bytes,
+                                       int count, int height,
+                                       unsigned char *y_buf,
+                                       unsigned char *u_buf,
+                                       unsigned char *v_buf);
+int
+rfxcodec_encode_rgb_to_yuv_amd64_ssse3(const char *src, int stride_bytes,
+                                       int count, int height,
+                                       unsigned char *y_buf,
+                                       unsigned char *u_buf,
+                                       unsigned char *v_buf);
+int
+rfxcodec_encode_bgra_to_yuva_amd64_avx2(const char *src, int stride_bytes,
+                                        int count, int height,
+                                        unsigned char *y_buf,
+                                        unsigned char *u_buf,
+                                        unsigned char *v_buf,
+                                        unsigned char *a_buf);
+int
+rfxcodec_encode_rgba_to_yuva_amd64_avx2(const char *src, int stride_bytes,
+                                        int count, int height,
+                                        unsigned char *y_buf,
+                                        unsigned char *u_buf,
+                                        unsigned char *v_buf,
+                                        unsigned char *a_buf);
+int
+rfxcodec_encode_bgr_to_yuv_amd64_avx2(const char *src, int stride_bytes,
+                                      int count, int height,
+                                      unsigned char *y_buf,
+                                      unsigned char *u_buf,
+                                      unsigned char *v_buf);
+int
+rfxcodec_encode_rgb_to_yuv_amd64_avx2(const char *src, int stride_bytes,
+                                      int count, int height,
+                                      unsigned char *y_buf,
+                                      unsigned char *u_buf,
+                                      unsigned char *v_buf);
 
 #ifdef __cplusplus
 }
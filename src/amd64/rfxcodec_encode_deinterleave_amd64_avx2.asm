@@ -0,0 +1,344 @@
+;
+;Copyright 2026 librfxcodec contributors
+;
+;Permission to use, copy, modify, distribute, and sell this software and its
+;documentation for any purpose is hereby granted without fee, provided that
+;the above copyright notice appear in all copies and that both that
+;copyright notice and this permission notice appear in supporting
+;documentation.
+;
+;The above copyright notice and this permission notice shall be included in
+;all copies or substantial portions of the Software.
+;
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+;IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+;FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+;OPEN GROUP BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+;AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+;CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+;
+;amd64 asm pixel deinterleave, avx2, 32 pixels per loop
+
+%include "common.asm"
+
+PREPARE_RODATA
+    ; 4 bytes per pixel, group each channel of 4 pixels in a dword
+    cb_4     times 2 db 0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15
+    ; 3 bytes per pixel, channel k from the 16 bytes at 16 * j
+    cb_3_00  times 2 db 0, 3, 6, 9, 12, 15, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_01  times 2 db 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 2, 5, 8, 11, 14, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_02  times 2 db 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 1, 4, 7, 10, 13
+    cb_3_10  times 2 db 1, 4, 7, 10, 13, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_11  times 2 db 0x80, 0x80, 0x80, 0x80, 0x80, 0, 3, 6, 9, 12, 15, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_12  times 2 db 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 2, 5, 8, 11, 14
+    cb_3_20  times 2 db 2, 5, 8, 11, 14, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_21  times 2 db 0x80, 0x80, 0x80, 0x80, 0x80, 1, 4, 7, 10, 13, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_22  times 2 db 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0, 3, 6, 9, 12, 15
+
+; Per System V AMD64 ABI, the first six integer or pointer arguments are
+; passed in registers RDI, RSI, RDX, RCX, R8, and R9
+
+;******************************************************************************
+;int
+;rfxcodec_encode_deinterleave4_amd64_avx2(const char *src,
+;                                         int stride_bytes,
+;                                         int count,
+;                                         int height,
+;                                         unsigned char *c0,
+;                                         unsigned char *c1,
+;                                         unsigned char *c2,
+;                                         unsigned char *c3);
+PROC rfxcodec_encode_deinterleave4_amd64_avx2
+    ; stack args first, the prologue moves rsp
+    mov r10, [rsp + 8]                  ; c2
+    mov r11, [rsp + 16]                 ; c3, can be NULL
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    ; save registers
+    push rbx
+    push r12
+    movsxd rsi, esi
+    movsxd rdx, edx
+    xor eax, eax                        ; dst offset
+    test ecx, ecx
+    jz loop4_done
+    test edx, edx
+    jz loop4_done
+    test r11, r11
+    jz loop43_y                         ; no channel 3
+
+loop4_y:
+    mov rbx, rdi
+    mov r12d, edx
+    cmp r12d, 32
+    jb loop4_x16
+loop4_x32:
+    ; 32 pixels, 0 to 15 in the low lane, 16 to 31 in the high
+    vmovdqu xmm0, [rbx]
+    vinserti128 ymm0, ymm0, [rbx + 64], 1
+    vmovdqu xmm1, [rbx + 16]
+    vinserti128 ymm1, ymm1, [rbx + 80], 1
+    vmovdqu xmm2, [rbx + 32]
+    vinserti128 ymm2, ymm2, [rbx + 96], 1
+    vmovdqu xmm3, [rbx + 48]
+    vinserti128 ymm3, ymm3, [rbx + 112], 1
+    vpshufb ymm0, ymm0, [lsym(cb_4)]
+    vpshufb ymm1, ymm1, [lsym(cb_4)]
+    vpshufb ymm2, ymm2, [lsym(cb_4)]
+    vpshufb ymm3, ymm3, [lsym(cb_4)]
+    ; 4 x 4 dword transpose
+    vpunpckhdq ymm4, ymm0, ymm1
+    vpunpckldq ymm0, ymm0, ymm1
+    vpunpckhdq ymm5, ymm2, ymm3
+    vpunpckldq ymm2, ymm2, ymm3
+    vpunpckhqdq ymm1, ymm0, ymm2
+    vpunpcklqdq ymm0, ymm0, ymm2
+    vpunpckhqdq ymm3, ymm4, ymm5
+    vpunpcklqdq ymm4, ymm4, ymm5
+    vmovdqu [r8 + rax], ymm0            ; channel 0
+    vmovdqu [r9 + rax], ymm1            ; channel 1
+    vmovdqu [r10 + rax], ymm4           ; channel 2
+    vmovdqu [r11 + rax], ymm3           ; channel 3
+    lea rbx, [rbx + 32 * 4]
+    lea rax, [rax + 32]
+    sub r12d, 32
+    cmp r12d, 32
+    jae loop4_x32
+loop4_x16:
+    test r12d, r12d
+    jz loop4_next
+    ; 16 pixels
+    vmovdqu xmm0, [rbx]
+    vmovdqu xmm1, [rbx + 16]
+    vmovdqu xmm2, [rbx + 32]
+    vmovdqu xmm3, [rbx + 48]
+    vpshufb xmm0, xmm0, [lsym(cb_4)]
+    vpshufb xmm1, xmm1, [lsym(cb_4)]
+    vpshufb xmm2, xmm2, [lsym(cb_4)]
+    vpshufb xmm3, xmm3, [lsym(cb_4)]
+    ; 4 x 4 dword transpose
+    vpunpckhdq xmm4, xmm0, xmm1
+    vpunpckldq xmm0, xmm0, xmm1
+    vpunpckhdq xmm5, xmm2, xmm3
+    vpunpckldq xmm2, xmm2, xmm3
+    vpunpckhqdq xmm1, xmm0, xmm2
+    vpunpcklqdq xmm0, xmm0, xmm2
+    vpunpckhqdq xmm3, xmm4, xmm5
+    vpunpcklqdq xmm4, xmm4, xmm5
+    vmovdqu [r8 + rax], xmm0            ; channel 0
+    vmovdqu [r9 + rax], xmm1            ; channel 1
+    vmovdqu [r10 + rax], xmm4           ; channel 2
+    vmovdqu [r11 + rax], xmm3           ; channel 3
+    lea rbx, [rbx + 16 * 4]
+    lea rax, [rax + 16]
+loop4_next:
+    ; next row
+    lea rax, [rax + 64]
+    sub rax, rdx
+    add rdi, rsi
+    dec ecx
+    jnz loop4_y
+    jmp loop4_done
+
+    ; channel 3 dropped
+loop43_y:
+    mov rbx, rdi
+    mov r12d, edx
+    cmp r12d, 32
+    jb loop43_x16
+loop43_x32:
+    ; 32 pixels, 0 to 15 in the low lane, 16 to 31 in the high
+    vmovdqu xmm0, [rbx]
+    vinserti128 ymm0, ymm0, [rbx + 64], 1
+    vmovdqu xmm1, [rbx + 16]
+    vinserti128 ymm1, ymm1, [rbx + 80], 1
+    vmovdqu xmm2, [rbx + 32]
+    vinserti128 ymm2, ymm2, [rbx + 96], 1
+    vmovdqu xmm3, [rbx + 48]
+    vinserti128 ymm3, ymm3, [rbx + 112], 1
+    vpshufb ymm0, ymm0, [lsym(cb_4)]
+    vpshufb ymm1, ymm1, [lsym(cb_4)]
+    vpshufb ymm2, ymm2, [lsym(cb_4)]
+    vpshufb ymm3, ymm3, [lsym(cb_4)]
+    ; 4 x 4 dword transpose
+    vpunpckhdq ymm4, ymm0, ymm1
+    vpunpckldq ymm0, ymm0, ymm1
+    vpunpckhdq ymm5, ymm2, ymm3
+    vpunpckldq ymm2, ymm2, ymm3
+    vpunpckhqdq ymm1, ymm0, ymm2
+    vpunpcklqdq ymm0, ymm0, ymm2
+    vpunpcklqdq ymm4, ymm4, ymm5
+    vmovdqu [r8 + rax], ymm0            ; channel 0
+    vmovdqu [r9 + rax], ymm1            ; channel 1
+    vmovdqu [r10 + rax], ymm4           ; channel 2
+    lea rbx, [rbx + 32 * 4]
+    lea rax, [rax + 32]
+    sub r12d, 32
+    cmp r12d, 32
+    jae loop43_x32
+loop43_x16:
+    test r12d, r12d
+    jz loop43_next
+    ; 16 pixels
+    vmovdqu xmm0, [rbx]
+    vmovdqu xmm1, [rbx + 16]
+    vmovdqu xmm2, [rbx + 32]
+    vmovdqu xmm3, [rbx + 48]
+    vpshufb xmm0, xmm0, [lsym(cb_4)]
+    vpshufb xmm1, xmm1, [lsym(cb_4)]
+    vpshufb xmm2, xmm2, [lsym(cb_4)]
+    vpshufb xmm3, xmm3, [lsym(cb_4)]
+    ; 4 x 4 dword transpose
+    vpunpckhdq xmm4, xmm0, xmm1
+    vpunpckldq xmm0, xmm0, xmm1
+    vpunpckhdq xmm5, xmm2, xmm3
+    vpunpckldq xmm2, xmm2, xmm3
+    vpunpckhqdq xmm1, xmm0, xmm2
+    vpunpcklqdq xmm0, xmm0, xmm2
+    vpunpcklqdq xmm4, xmm4, xmm5
+    vmovdqu [r8 + rax], xmm0            ; channel 0
+    vmovdqu [r9 + rax], xmm1            ; channel 1
+    vmovdqu [r10 + rax], xmm4           ; channel 2
+    lea rbx, [rbx + 16 * 4]
+    lea rax, [rax + 16]
+loop43_next:
+    ; next row
+    lea rax, [rax + 64]
+    sub rax, rdx
+    add rdi, rsi
+    dec ecx
+    jnz loop43_y
+
+loop4_done:
+    vzeroupper
+    ; restore registers
+    pop r12
+    pop rbx
+
+    ; epilogue
+%ifdef DEBUG
+    mov rsp, rbp
+    pop rbp
+%endif
+
+    mov eax, 0                          ; return value
+    ret
+
+;******************************************************************************
+;int
+;rfxcodec_encode_deinterleave3_amd64_avx2(const char *src,
+;                                         int stride_bytes,
+;                                         int count,
+;                                         int height,
+;                                         unsigned char *c0,
+;                                         unsigned char *c1,
+;                                         unsigned char *c2);
+PROC rfxcodec_encode_deinterleave3_amd64_avx2
+    ; stack args first, the prologue moves rsp
+    mov r10, [rsp + 8]                  ; c2
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    ; save registers
+    push rbx
+    push r12
+    movsxd rsi, esi
+    movsxd rdx, edx
+    xor eax, eax                        ; dst offset
+    test ecx, ecx
+    jz loop3_done
+    test edx, edx
+    jz loop3_done
+
+loop3_y:
+    mov rbx, rdi
+    mov r12d, edx
+    cmp r12d, 32
+    jb loop3_x16
+loop3_x32:
+    ; 32 pixels, 0 to 15 in the low lane, 16 to 31 in the high
+    vmovdqu xmm0, [rbx]
+    vinserti128 ymm0, ymm0, [rbx + 48], 1
+    vmovdqu xmm1, [rbx + 16]
+    vinserti128 ymm1, ymm1, [rbx + 64], 1
+    vmovdqu xmm2, [rbx + 32]
+    vinserti128 ymm2, ymm2, [rbx + 80], 1
+    vpshufb ymm3, ymm0, [lsym(cb_3_00)]
+    vpshufb ymm4, ymm1, [lsym(cb_3_01)]
+    vpor ymm3, ymm3, ymm4
+    vpshufb ymm4, ymm2, [lsym(cb_3_02)]
+    vpor ymm3, ymm3, ymm4
+    vmovdqu [r8 + rax], ymm3            ; channel 0
+    vpshufb ymm3, ymm0, [lsym(cb_3_10)]
+    vpshufb ymm4, ymm1, [lsym(cb_3_11)]
+    vpor ymm3, ymm3, ymm4
+    vpshufb ymm4, ymm2, [lsym(cb_3_12)]
+    vpor ymm3, ymm3, ymm4
+    vmovdqu [r9 + rax], ymm3            ; channel 1
+    vpshufb ymm3, ymm0, [lsym(cb_3_20)]
+    vpshufb ymm4, ymm1, [lsym(cb_3_21)]
+    vpor ymm3, ymm3, ymm4
+    vpshufb ymm4, ymm2, [lsym(cb_3_22)]
+    vpor ymm3, ymm3, ymm4
+    vmovdqu [r10 + rax], ymm3           ; channel 2
+    lea rbx, [rbx + 32 * 3]
+    lea rax, [rax + 32]
+    sub r12d, 32
+    cmp r12d, 32
+    jae loop3_x32
+loop3_x16:
+    test r12d, r12d
+    jz loop3_next
+    ; 16 pixels
+    vmovdqu xmm0, [rbx]
+    vmovdqu xmm1, [rbx + 16]
+    vmovdqu xmm2, [rbx + 32]
+    vpshufb xmm3, xmm0, [lsym(cb_3_00)]
+    vpshufb xmm4, xmm1, [lsym(cb_3_01)]
+    vpor xmm3, xmm3, xmm4
+    vpshufb xmm4, xmm2, [lsym(cb_3_02)]
+    vpor xmm3, xmm3, xmm4
+    vmovdqu [r8 + rax], xmm3            ; channel 0
+    vpshufb xmm3, xmm0, [lsym(cb_3_10)]
+    vpshufb xmm4, xmm1, [lsym(cb_3_11)]
+    vpor xmm3, xmm3, xmm4
+    vpshufb xmm4, xmm2, [lsym(cb_3_12)]
+    vpor xmm3, xmm3, xmm4
+    vmovdqu [r9 + rax], xmm3            ; channel 1
+    vpshufb xmm3, xmm0, [lsym(cb_3_20)]
+    vpshufb xmm4, xmm1, [lsym(cb_3_21)]
+    vpor xmm3, xmm3, xmm4
+    vpshufb xmm4, xmm2, [lsym(cb_3_22)]
+    vpor xmm3, xmm3, xmm4
+    vmovdqu [r10 + rax], xmm3           ; channel 2
+    lea rbx, [rbx + 16 * 3]
+    lea rax, [rax + 16]
+loop3_next:
+    ; next row
+    lea rax, [rax + 64]
+    sub rax, rdx
+    add rdi, rsi
+    dec ecx
+    jnz loop3_y
+
+loop3_done:
+    vzeroupper
+    ; restore registers
+    pop r12
+    pop rbx
+
+    ; epilogue
+%ifdef DEBUG
+    mov rsp, rbp
+    pop rbp
+%endif
+
+    mov eax, 0                          ; return value
+    ret
+
+END_OF_FILE
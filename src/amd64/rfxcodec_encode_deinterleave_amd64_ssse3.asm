@@ -0,0 +1,259 @@
+;
+;Copyright 2026 librfxcodec contributors
+;
+;Permission to use, copy, modify, distribute, and sell this software and its
+;documentation for any purpose is hereby granted without fee, provided that
+;the above copyright notice appear in all copies and that both that
+;copyright notice and this permission notice appear in supporting
+;documentation.
+;
+;The above copyright notice and this permission notice shall be included in
+;all copies or substantial portions of the Software.
+;
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+;IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+;FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+;OPEN GROUP BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+;AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+;CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+;
+;amd64 asm pixel deinterleave, ssse3, 16 pixels per loop
+
+%include "common.asm"
+
+PREPARE_RODATA
+    ; 4 bytes per pixel, group each channel of 4 pixels in a dword
+    cb_4     times 2 db 0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15
+    ; 3 bytes per pixel, channel k from the 16 bytes at 16 * j
+    cb_3_00  times 2 db 0, 3, 6, 9, 12, 15, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_01  times 2 db 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 2, 5, 8, 11, 14, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_02  times 2 db 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 1, 4, 7, 10, 13
+    cb_3_10  times 2 db 1, 4, 7, 10, 13, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_11  times 2 db 0x80, 0x80, 0x80, 0x80, 0x80, 0, 3, 6, 9, 12, 15, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_12  times 2 db 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 2, 5, 8, 11, 14
+    cb_3_20  times 2 db 2, 5, 8, 11, 14, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_21  times 2 db 0x80, 0x80, 0x80, 0x80, 0x80, 1, 4, 7, 10, 13, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_22  times 2 db 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0, 3, 6, 9, 12, 15
+
+; Per System V AMD64 ABI, the first six integer or pointer arguments are
+; passed in registers RDI, RSI, RDX, RCX, R8, and R9
+
+;******************************************************************************
+;int
+;rfxcodec_encode_deinterleave4_amd64_ssse3(const char *src,
+;                                          int stride_bytes,
+;                                          int count,
+;                                          int height,
+;                                          unsigned char *c0,
+;                                          unsigned char *c1,
+;                                          unsigned char *c2,
+;                                          unsigned char *c3);
+PROC rfxcodec_encode_deinterleave4_amd64_ssse3
+    ; stack args first, the prologue moves rsp
+    mov r10, [rsp + 8]                  ; c2
+    mov r11, [rsp + 16]                 ; c3, can be NULL
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    ; save registers
+    push rbx
+    push r12
+    movsxd rsi, esi
+    movsxd rdx, edx
+    xor eax, eax                        ; dst offset
+    test ecx, ecx
+    jz loop4_done
+    test edx, edx
+    jz loop4_done
+    test r11, r11
+    jz loop43_y                         ; no channel 3
+
+loop4_y:
+    mov rbx, rdi
+    mov r12d, edx
+loop4_x16:
+    ; 16 pixels
+    movdqu xmm0, [rbx]
+    movdqu xmm1, [rbx + 16]
+    movdqu xmm2, [rbx + 32]
+    movdqu xmm3, [rbx + 48]
+    pshufb xmm0, [lsym(cb_4)]
+    pshufb xmm1, [lsym(cb_4)]
+    pshufb xmm2, [lsym(cb_4)]
+    pshufb xmm3, [lsym(cb_4)]
+    ; 4 x 4 dword transpose
+    movdqa xmm4, xmm0
+    punpckhdq xmm4, xmm1
+    punpckldq xmm0, xmm1
+    movdqa xmm5, xmm2
+    punpckhdq xmm5, xmm3
+    punpckldq xmm2, xmm3
+    movdqa xmm1, xmm0
+    punpckhqdq xmm1, xmm2
+    punpcklqdq xmm0, xmm2
+    movdqa xmm3, xmm4
+    punpckhqdq xmm3, xmm5
+    punpcklqdq xmm4, xmm5
+    movdqu [r8 + rax], xmm0             ; channel 0
+    movdqu [r9 + rax], xmm1             ; channel 1
+    movdqu [r10 + rax], xmm4            ; channel 2
+    movdqu [r11 + rax], xmm3            ; channel 3
+    lea rbx, [rbx + 16 * 4]
+    lea rax, [rax + 16]
+    sub r12d, 16
+    jnz loop4_x16
+loop4_next:
+    ; next row
+    lea rax, [rax + 64]
+    sub rax, rdx
+    add rdi, rsi
+    dec ecx
+    jnz loop4_y
+    jmp loop4_done
+
+    ; channel 3 dropped
+loop43_y:
+    mov rbx, rdi
+    mov r12d, edx
+loop43_x16:
+    ; 16 pixels
+    movdqu xmm0, [rbx]
+    movdqu xmm1, [rbx + 16]
+    movdqu xmm2, [rbx + 32]
+    movdqu xmm3, [rbx + 48]
+    pshufb xmm0, [lsym(cb_4)]
+    pshufb xmm1, [lsym(cb_4)]
+    pshufb xmm2, [lsym(cb_4)]
+    pshufb xmm3, [lsym(cb_4)]
+    ; 4 x 4 dword transpose
+    movdqa xmm4, xmm0
+    punpckhdq xmm4, xmm1
+    punpckldq xmm0, xmm1
+    movdqa xmm5, xmm2
+    punpckhdq xmm5, xmm3
+    punpckldq xmm2, xmm3
+    movdqa xmm1, xmm0
+    punpckhqdq xmm1, xmm2
+    punpcklqdq xmm0, xmm2
+    punpcklqdq xmm4, xmm5
+    movdqu [r8 + rax], xmm0             ; channel 0
+    movdqu [r9 + rax], xmm1             ; channel 1
+    movdqu [r10 + rax], xmm4            ; channel 2
+    lea rbx, [rbx + 16 * 4]
+    lea rax, [rax + 16]
+    sub r12d, 16
+    jnz loop43_x16
+loop43_next:
+    ; next row
+    lea rax, [rax + 64]
+    sub rax, rdx
+    add rdi, rsi
+    dec ecx
+    jnz loop43_y
+
+loop4_done:
+    ; restore registers
+    pop r12
+    pop rbx
+
+    ; epilogue
+%ifdef DEBUG
+    mov rsp, rbp
+    pop rbp
+%endif
+
+    mov eax, 0                          ; return value
+    ret
+
+;******************************************************************************
+;int
+;rfxcodec_encode_deinterleave3_amd64_ssse3(const char *src,
+;                                          int stride_bytes,
+;                                          int count,
+;                                          int height,
+;                                          unsigned char *c0,
+;                                          unsigned char *c1,
+;                                          unsigned char *c2);
+PROC rfxcodec_encode_deinterleave3_amd64_ssse3
+    ; stack args first, the prologue moves rsp
+    mov r10, [rsp + 8]                  ; c2
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    ; save registers
+    push rbx
+    push r12
+    movsxd rsi, esi
+    movsxd rdx, edx
+    xor eax, eax                        ; dst offset
+    test ecx, ecx
+    jz loop3_done
+    test edx, edx
+    jz loop3_done
+
+loop3_y:
+    mov rbx, rdi
+    mov r12d, edx
+loop3_x16:
+    ; 16 pixels
+    movdqu xmm0, [rbx]
+    movdqu xmm1, [rbx + 16]
+    movdqu xmm2, [rbx + 32]
+    movdqa xmm3, xmm0
+    pshufb xmm3, [lsym(cb_3_00)]
+    movdqa xmm4, xmm1
+    pshufb xmm4, [lsym(cb_3_01)]
+    por xmm3, xmm4
+    movdqa xmm4, xmm2
+    pshufb xmm4, [lsym(cb_3_02)]
+    por xmm3, xmm4
+    movdqu [r8 + rax], xmm3             ; channel 0
+    movdqa xmm3, xmm0
+    pshufb xmm3, [lsym(cb_3_10)]
+    movdqa xmm4, xmm1
+    pshufb xmm4, [lsym(cb_3_11)]
+    por xmm3, xmm4
+    movdqa xmm4, xmm2
+    pshufb xmm4, [lsym(cb_3_12)]
+    por xmm3, xmm4
+    movdqu [r9 + rax], xmm3             ; channel 1
+    movdqa xmm3, xmm0
+    pshufb xmm3, [lsym(cb_3_20)]
+    movdqa xmm4, xmm1
+    pshufb xmm4, [lsym(cb_3_21)]
+    por xmm3, xmm4
+    movdqa xmm4, xmm2
+    pshufb xmm4, [lsym(cb_3_22)]
+    por xmm3, xmm4
+    movdqu [r10 + rax], xmm3            ; channel 2
+    lea rbx, [rbx + 16 * 3]
+    lea rax, [rax + 16]
+    sub r12d, 16
+    jnz loop3_x16
+loop3_next:
+    ; next row
+    lea rax, [rax + 64]
+    sub rax, rdx
+    add rdi, rsi
+    dec ecx
+    jnz loop3_y
+
+loop3_done:
+    ; restore registers
+    pop r12
+    pop rbx
+
+    ; epilogue
+%ifdef DEBUG
+    mov rsp, rbp
+    pop rbp
+%endif
+
+    mov eax, 0                          ; return value
+    ret
+
+END_OF_FILE
@@ -0,0 +1,142 @@
+;
+;Copyright 2026 librfxcodec contributors
+;
+;Permission to use, copy, modify, distribute, and sell this software and its
+;documentation for any purpose is hereby granted without fee, provided that
+;the above copyright notice appear in all copies and that both that
+;copyright notice and this permission notice appear in supporting
+;documentation.
+;
+;The above copyright notice and this permission notice shall be included in
+;all copies or substantial portions of the Software.
+;
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+;IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+;FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+;OPEN GROUP BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+;AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+;CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+;
+;amd64 asm progressive coefficient diff and zero count, avx2
+
+%include "common.asm"
+
+PREPARE_RODATA
+    cw0      times 16 dw 0
+    cw1      times 16 dw 1
+
+; Per System V AMD64 ABI, the first six integer or pointer arguments are
+; passed in registers RDI, RSI, RDX, RCX, R8, and R9
+
+;******************************************************************************
+;int
+;rfxcodec_encode_diff_count_amd64_avx2(const short *coefs,
+;                                      const short *history,
+;                                      short *diff,
+;                                      short *history_out,
+;                                      int *diff_zeros,
+;                                      int *coef_zeros);
+; see rfx_differential_pro_encode
+PROC rfxcodec_encode_diff_count_amd64_avx2
+    ; prologue. this will make the function appear to the debugger as
+    ; having a stack frame, so that a backtrace can be obtained
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    vpxor ymm6, ymm6, ymm6
+    ; diff zeros in ymm6, coef zeros in ymm7
+    vpxor ymm7, ymm7, ymm7
+    xor eax, eax
+    test rcx, rcx
+    jz diff_count_nocopy
+
+    ; counted, coefs to history_out
+diff_count_copy:
+    vmovdqu ymm0, [rdi + rax]
+    vmovdqu ymm2, [rsi + rax]
+    vmovdqu [rcx + rax], ymm0
+    vpsubw ymm4, ymm0, ymm2
+    vmovdqu [rdx + rax], ymm4
+    vpcmpeqw ymm2, ymm2, ymm0
+    vpsubw ymm6, ymm6, ymm2
+    vpcmpeqw ymm0, ymm0, [lsym(cw0)]
+    vpsubw ymm7, ymm7, ymm0
+    add rax, 32
+    cmp rax, 8032
+    jb diff_count_copy
+diff_copy:
+    vmovdqu ymm0, [rdi + rax]
+    vmovdqu ymm2, [rsi + rax]
+    vmovdqu [rcx + rax], ymm0
+    vpsubw ymm4, ymm0, ymm2
+    vmovdqu [rdx + rax], ymm4
+    add rax, 32
+    cmp rax, 8192
+    jb diff_copy
+    jmp diff_count_done
+
+    ; counted
+diff_count_nocopy:
+    vmovdqu ymm0, [rdi + rax]
+    vmovdqu ymm2, [rsi + rax]
+    vpsubw ymm4, ymm0, ymm2
+    vmovdqu [rdx + rax], ymm4
+    vpcmpeqw ymm2, ymm2, ymm0
+    vpsubw ymm6, ymm6, ymm2
+    vpcmpeqw ymm0, ymm0, [lsym(cw0)]
+    vpsubw ymm7, ymm7, ymm0
+    add rax, 32
+    cmp rax, 8032
+    jb diff_count_nocopy
+diff_nocopy:
+    vmovdqu ymm0, [rdi + rax]
+    vmovdqu ymm2, [rsi + rax]
+    vpsubw ymm4, ymm0, ymm2
+    vmovdqu [rdx + rax], ymm4
+    add rax, 32
+    cmp rax, 8192
+    jb diff_nocopy
+
+diff_count_done:
+    ; coefficient 4015 is in the last counted vector but not counted
+    movzx eax, word [rdi + 8030]
+    movzx ecx, word [rsi + 8030]
+    vpmaddwd ymm6, ymm6, [lsym(cw1)]
+    vextracti128 xmm0, ymm6, 1
+    vpaddd xmm6, xmm6, xmm0
+    vpshufd xmm0, xmm6, 0x4E
+    vpaddd xmm6, xmm6, xmm0
+    vpshufd xmm0, xmm6, 0xB1
+    vpaddd xmm6, xmm6, xmm0
+    vmovd edx, xmm6
+    cmp eax, ecx
+    jne diff_count_d
+    dec edx
+diff_count_d:
+    mov [r8], edx                       ; diff_zeros
+    vpmaddwd ymm7, ymm7, [lsym(cw1)]
+    vextracti128 xmm0, ymm7, 1
+    vpaddd xmm7, xmm7, xmm0
+    vpshufd xmm0, xmm7, 0x4E
+    vpaddd xmm7, xmm7, xmm0
+    vpshufd xmm0, xmm7, 0xB1
+    vpaddd xmm7, xmm7, xmm0
+    vmovd edx, xmm7
+    test eax, eax
+    jnz diff_count_c
+    dec edx
+diff_count_c:
+    mov [r9], edx                       ; coef_zeros
+    vzeroupper
+
+    ; epilogue
+%ifdef DEBUG
+    mov rsp, rbp
+    pop rbp
+%endif
+    mov eax, 0                          ; return value
+    ret
+
+END_OF_FILE
@@ -0,0 +1,171 @@
+;
+;Copyright 2026 librfxcodec contributors
+;
+;Permission to use, copy, modify, distribute, and sell this software and its
+;documentation for any purpose is hereby granted without fee, provided that
+;the above copyright notice appear in all copies and that both that
+;copyright notice and this permission notice appear in supporting
+;documentation.
+;
+;The above copyright notice and this permission notice shall be included in
+;all copies or substantial portions of the Software.
+;
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+;IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+;FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+;OPEN GROUP BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+;AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+;CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+;
+;amd64 asm progressive coefficient diff and zero count, sse2
+
+%include "common.asm"
+
+PREPARE_RODATA
+    cw0      times 8 dw 0
+    cw1      times 8 dw 1
+
+; Per System V AMD64 ABI, the first six integer or pointer arguments are
+; passed in registers RDI, RSI, RDX, RCX, R8, and R9
+
+;******************************************************************************
+;int
+;rfxcodec_encode_diff_count_amd64_sse2(const short *coefs,
+;                                      const short *history,
+;                                      short *diff,
+;                                      short *history_out,
+;                                      int *diff_zeros,
+;                                      int *coef_zeros);
+; see rfx_differential_pro_encode
+PROC rfxcodec_encode_diff_count_amd64_sse2
+    ; prologue. this will make the function appear to the debugger as
+    ; having a stack frame, so that a backtrace can be obtained
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    pxor xmm6, xmm6
+    ; diff zeros in xmm6, coef zeros in xmm7
+    pxor xmm7, xmm7
+    xor eax, eax
+    test rcx, rcx
+    jz diff_count_nocopy
+
+    ; counted, coefs to history_out
+diff_count_copy:
+    movdqu xmm0, [rdi + rax]
+    movdqu xmm2, [rsi + rax]
+    movdqu xmm1, [rdi + rax + 16]
+    movdqu xmm3, [rsi + rax + 16]
+    movdqu [rcx + rax], xmm0
+    movdqu [rcx + rax + 16], xmm1
+    movdqa xmm4, xmm0
+    psubw xmm4, xmm2
+    movdqu [rdx + rax], xmm4
+    movdqa xmm5, xmm1
+    psubw xmm5, xmm3
+    movdqu [rdx + rax + 16], xmm5
+    pcmpeqw xmm2, xmm0
+    psubw xmm6, xmm2
+    pcmpeqw xmm0, [lsym(cw0)]
+    psubw xmm7, xmm0
+    pcmpeqw xmm3, xmm1
+    psubw xmm6, xmm3
+    pcmpeqw xmm1, [lsym(cw0)]
+    psubw xmm7, xmm1
+    add rax, 32
+    cmp rax, 8032
+    jb diff_count_copy
+diff_copy:
+    movdqu xmm0, [rdi + rax]
+    movdqu xmm2, [rsi + rax]
+    movdqu xmm1, [rdi + rax + 16]
+    movdqu xmm3, [rsi + rax + 16]
+    movdqu [rcx + rax], xmm0
+    movdqu [rcx + rax + 16], xmm1
+    movdqa xmm4, xmm0
+    psubw xmm4, xmm2
+    movdqu [rdx + rax], xmm4
+    movdqa xmm5, xmm1
+    psubw xmm5, xmm3
+    movdqu [rdx + rax + 16], xmm5
+    add rax, 32
+    cmp rax, 8192
+    jb diff_copy
+    jmp diff_count_done
+
+    ; counted
+diff_count_nocopy:
+    movdqu xmm0, [rdi + rax]
+    movdqu xmm2, [rsi + rax]
+    movdqu xmm1, [rdi + rax + 16]
+    movdqu xmm3, [rsi + rax + 16]
+    movdqa xmm4, xmm0
+    psubw xmm4, xmm2
+    movdqu [rdx + rax], xmm4
+    movdqa xmm5, xmm1
+    psubw xmm5, xmm3
+    movdqu [rdx + rax + 16], xmm5
+    pcmpeqw xmm2, xmm0
+    psubw xmm6, xmm2
+    pcmpeqw xmm0, [lsym(cw0)]
+    psubw xmm7, xmm0
+    pcmpeqw xmm3, xmm1
+    psubw xmm6, xmm3
+    pcmpeqw xmm1, [lsym(cw0)]
+    psubw xmm7, xmm1
+    add rax, 32
+    cmp rax, 8032
+    jb diff_count_nocopy
+diff_nocopy:
+    movdqu xmm0, [rdi + rax]
+    movdqu xmm2, [rsi + rax]
+    movdqu xmm1, [rdi + rax + 16]
+    movdqu xmm3, [rsi + rax + 16]
+    movdqa xmm4, xmm0
+    psubw xmm4, xmm2
+    movdqu [rdx + rax], xmm4
+    movdqa xmm5, xmm1
+    psubw xmm5, xmm3
+    movdqu [rdx + rax + 16], xmm5
+    add rax, 32
+    cmp rax, 8192
+    jb diff_nocopy
+
+diff_count_done:
+    ; coefficient 4015 is in the last counted vector but not counted
+    movzx eax, word [rdi + 8030]
+    movzx ecx, word [rsi + 8030]
+    pmaddwd xmm6, [lsym(cw1)]
+    pshufd xmm0, xmm6, 0x4E
+    paddd xmm6, xmm0
+    pshufd xmm0, xmm6, 0xB1
+    paddd xmm6, xmm0
+    movd edx, xmm6
+    cmp eax, ecx
+    jne diff_count_d
+    dec edx
+diff_count_d:
+    mov [r8], edx                       ; diff_zeros
+    pmaddwd xmm7, [lsym(cw1)]
+    pshufd xmm0, xmm7, 0x4E
+    paddd xmm7, xmm0
+    pshufd xmm0, xmm7, 0xB1
+    paddd xmm7, xmm0
+    movd edx, xmm7
+    test eax, eax
+    jnz diff_count_c
+    dec edx
+diff_count_c:
+    mov [r9], edx                       ; coef_zeros
+
+    ; epilogue
+%ifdef DEBUG
+    mov rsp, rbp
+    pop rbp
+%endif
+    mov eax, 0                          ; return value
+    ret
+
+END_OF_FILE
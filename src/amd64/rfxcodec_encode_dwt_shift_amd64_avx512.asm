@@ -0,0 +1,782 @@
+;
+;Copyright 2026 librfxcodec contributors
+;
+;Permission to use, copy, modify, distribute, and sell this software and its
+;documentation for any purpose is hereby granted without fee, provided that
+;the above copyright notice appear in all copies and that both that
+;copyright notice and this permission notice appear in supporting
+;documentation.
+;
+;The above copyright notice and this permission notice shall be included in
+;all copies or substantial portions of the Software.
+;
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+;IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+;FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+;OPEN GROUP BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+;AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+;CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+;
+;amd64 asm dwt, avx512bw, 32 coefficients per zmm register
+
+%include "common.asm"
+
+PREPARE_RODATA
+    cw128    times 32 dw 128
+    ; these are 1 << (factor - 1) 0 to 15 is factor
+    cwa0     times 32 dw 0     ; 0
+    cwa1     times 32 dw 1     ; 1
+    cwa2     times 32 dw 2     ; 2
+    cwa4     times 32 dw 4     ; 3
+    cwa8     times 32 dw 8     ; 4
+    cwa16    times 32 dw 16    ; 5
+    cwa32    times 32 dw 32    ; 6
+    cwa64    times 32 dw 64    ; 7
+    cwa128   times 32 dw 128   ; 8
+    cwa256   times 32 dw 256   ; 9
+    cwa512   times 32 dw 512   ; 10
+    cwa1024  times 32 dw 1024  ; 11
+    cwa2048  times 32 dw 2048  ; 12
+    cwa4096  times 32 dw 4096  ; 13
+    cwa8192  times 32 dw 8192  ; 14
+    cwa16384 times 32 dw 16384 ; 15
+
+    ; vpermi2w / vpermw indexes, a zmm pair holds 1, 2 or 4 rows
+    ; src[2n]
+    cwi_even     dw  0,  2,  4,  6,  8, 10, 12, 14
+                 dw 16, 18, 20, 22, 24, 26, 28, 30
+                 dw 32, 34, 36, 38, 40, 42, 44, 46
+                 dw 48, 50, 52, 54, 56, 58, 60, 62
+    ; src[2n + 1]
+    cwi_odd      dw  1,  3,  5,  7,  9, 11, 13, 15
+                 dw 17, 19, 21, 23, 25, 27, 29, 31
+                 dw 33, 35, 37, 39, 41, 43, 45, 47
+                 dw 49, 51, 53, 55, 57, 59, 61, 63
+    ; src[2n + 2], 16 pixel width
+    cwi_next16   dw  2,  4,  6,  8, 10, 12, 14, 14
+                 dw 18, 20, 22, 24, 26, 28, 30, 30
+                 dw 34, 36, 38, 40, 42, 44, 46, 46
+                 dw 50, 52, 54, 56, 58, 60, 62, 62
+    ; h[n - 1], 16 pixel width
+    cwi_prev16   dw  0,  0,  1,  2,  3,  4,  5,  6
+                 dw  8,  8,  9, 10, 11, 12, 13, 14
+                 dw 16, 16, 17, 18, 19, 20, 21, 22
+                 dw 24, 24, 25, 26, 27, 28, 29, 30
+    ; src[2n + 2], 32 pixel width
+    cwi_next32   dw  2,  4,  6,  8, 10, 12, 14, 16
+                 dw 18, 20, 22, 24, 26, 28, 30, 30
+                 dw 34, 36, 38, 40, 42, 44, 46, 48
+                 dw 50, 52, 54, 56, 58, 60, 62, 62
+    ; h[n - 1], 32 pixel width
+    cwi_prev32   dw  0,  0,  1,  2,  3,  4,  5,  6
+                 dw  7,  8,  9, 10, 11, 12, 13, 14
+                 dw 16, 16, 17, 18, 19, 20, 21, 22
+                 dw 23, 24, 25, 26, 27, 28, 29, 30
+    ; src[2n + 2], 64 pixel width
+    cwi_next64   dw  2,  4,  6,  8, 10, 12, 14, 16
+                 dw 18, 20, 22, 24, 26, 28, 30, 32
+                 dw 34, 36, 38, 40, 42, 44, 46, 48
+                 dw 50, 52, 54, 56, 58, 60, 62, 62
+    ; h[n - 1], 64 pixel width
+    cwi_prev64   dw  0,  0,  1,  2,  3,  4,  5,  6
+                 dw  7,  8,  9, 10, 11, 12, 13, 14
+                 dw 15, 16, 17, 18, 19, 20, 21, 22
+                 dw 23, 24, 25, 26, 27, 28, 29, 30
+
+;******************************************************************************
+; source 16 bit signed, 16 pixel width
+rfx_dwt_2d_encode_block_horiz_16_16:
+    mov ecx, 2
+loop1a:
+    ; 4 rows at a time
+    vmovdqu16 zmm1, [rsi]
+    vmovdqu16 zmm2, [rsi + 64]
+    vmovdqu16 zmm3, [lsym(cwi_even)]
+    vpermi2w zmm3, zmm1, zmm2           ; src[2n]
+    vmovdqu16 zmm4, [lsym(cwi_odd)]
+    vpermi2w zmm4, zmm1, zmm2           ; src[2n + 1]
+    vmovdqu16 zmm5, [lsym(cwi_next16)]
+    vpermi2w zmm5, zmm1, zmm2           ; src[2n + 2], mirror at the end
+
+    ; h[n] = (src[2n + 1] - ((src[2n] + src[2n + 2]) >> 1)) >> 1
+    vpaddw zmm5, zmm5, zmm3
+    vpsraw zmm5, zmm5, 1
+    vpsubw zmm4, zmm4, zmm5
+    vpsraw zmm4, zmm4, 1
+
+    vpaddw zmm5, zmm4, zmm8             ; out hi
+    vpsraw zmm5, zmm5, xmm9
+    vmovdqu16 [rdi], zmm5
+
+    ; l[n] = src[2n] + ((h[n - 1] + h[n]) >> 1)
+    vmovdqu16 zmm5, [lsym(cwi_prev16)]
+    vpermw zmm5, zmm5, zmm4             ; h[n - 1], h[-1] = h[0]
+    vpaddw zmm5, zmm5, zmm4
+    vpsraw zmm5, zmm5, 1
+    vpaddw zmm5, zmm5, zmm3
+
+    vpaddw zmm5, zmm5, zmm10            ; out lo
+    vpsraw zmm5, zmm5, xmm11
+    vmovdqu16 [rdx], zmm5
+
+    ; move right / down
+    lea rsi, [rsi + 64 * 2]
+    lea rdi, [rdi + 32 * 2]
+    lea rdx, [rdx + 32 * 2]
+
+    dec ecx
+    jnz loop1a
+
+    ret
+
+;******************************************************************************
+; source 16 bit signed, 16 pixel width
+rfx_dwt_2d_encode_block_verti_16_16:
+    mov ecx, 1
+loop1b:
+    ; pre
+    vmovdqu ymm1, [rsi]                 ; src[2n]
+    vmovdqu ymm2, [rsi + 16 * 2]        ; src[2n + 1]
+    vmovdqu ymm3, [rsi + 16 * 2 * 2]    ; src[2n + 2]
+    ; h[n] = (src[2n + 1] - ((src[2n] + src[2n + 2]) >> 1)) >> 1
+    vpaddw ymm4, ymm1, ymm3
+    vpsraw ymm4, ymm4, 1
+    vpsubw ymm5, ymm2, ymm4
+    vpsraw ymm5, ymm5, 1
+    vmovdqu [rdi], ymm5                 ; out hi
+    ; l[n] = src[2n] + ((h[n - 1] + h[n]) >> 1)
+    vpaddw ymm4, ymm5, ymm1
+    vmovdqu [rdx], ymm4                 ; out lo
+    vmovdqa ymm0, ymm5                  ; save hi
+    ; move down
+    lea rsi, [rsi + 16 * 2 * 2]         ; 2 rows
+    lea rdi, [rdi + 16 * 2]             ; 1 row
+    lea rdx, [rdx + 16 * 2]             ; 1 row
+
+    ; loop
+    shl ecx, 16
+    mov cx, 6
+loop2b:
+    vmovdqa ymm1, ymm3                  ; src[2n]
+    vmovdqu ymm2, [rsi + 16 * 2]        ; src[2n + 1]
+    vmovdqu ymm3, [rsi + 16 * 2 * 2]    ; src[2n + 2]
+    ; h[n] = (src[2n + 1] - ((src[2n] + src[2n + 2]) >> 1)) >> 1
+    vpaddw ymm4, ymm1, ymm3
+    vpsraw ymm4, ymm4, 1
+    vpsubw ymm5, ymm2, ymm4
+    vpsraw ymm5, ymm5, 1
+    vmovdqu [rdi], ymm5                 ; out hi
+    ; l[n] = src[2n] + ((h[n - 1] + h[n]) >> 1)
+    vpaddw ymm4, ymm5, ymm0
+    vpsraw ymm4, ymm4, 1
+    vpaddw ymm4, ymm4, ymm1
+    vmovdqu [rdx], ymm4                 ; out lo
+    vmovdqa ymm0, ymm5                  ; save hi
+    ; move down
+    lea rsi, [rsi + 16 * 2 * 2]         ; 2 rows
+    lea rdi, [rdi + 16 * 2]             ; 1 row
+    lea rdx, [rdx + 16 * 2]             ; 1 row
+
+    dec cx
+    jnz loop2b
+    shr ecx, 16
+
+    ; post
+    vmovdqa ymm1, ymm3                  ; src[2n], src[2n + 2] mirrors it
+    vmovdqu ymm2, [rsi + 16 * 2]        ; src[2n + 1]
+    ; h[n] = (src[2n + 1] - ((src[2n] + src[2n + 2]) >> 1)) >> 1
+    vpaddw ymm4, ymm1, ymm3
+    vpsraw ymm4, ymm4, 1
+    vpsubw ymm5, ymm2, ymm4
+    vpsraw ymm5, ymm5, 1
+    vmovdqu [rdi], ymm5                 ; out hi
+    ; l[n] = src[2n] + ((h[n - 1] + h[n]) >> 1)
+    vpaddw ymm4, ymm5, ymm0
+    vpsraw ymm4, ymm4, 1
+    vpaddw ymm4, ymm4, ymm1
+    vmovdqu [rdx], ymm4                 ; out lo
+    ; move down
+    lea rsi, [rsi + 16 * 2 * 2]         ; 2 rows
+    lea rdi, [rdi + 16 * 2]             ; 1 row
+    lea rdx, [rdx + 16 * 2]             ; 1 row
+
+    dec ecx
+    jnz loop1b
+
+    ret
+
+;******************************************************************************
+; source 16 bit signed, 32 pixel width
+rfx_dwt_2d_encode_block_horiz_16_32:
+    mov ecx, 8
+loop1c:
+    ; 2 rows at a time
+    vmovdqu16 zmm1, [rsi]
+    vmovdqu16 zmm2, [rsi + 64]
+    vmovdqu16 zmm3, [lsym(cwi_even)]
+    vpermi2w zmm3, zmm1, zmm2           ; src[2n]
+    vmovdqu16 zmm4, [lsym(cwi_odd)]
+    vpermi2w zmm4, zmm1, zmm2           ; src[2n + 1]
+    vmovdqu16 zmm5, [lsym(cwi_next32)]
+    vpermi2w zmm5, zmm1, zmm2           ; src[2n + 2], mirror at the end
+
+    ; h[n] = (src[2n + 1] - ((src[2n] + src[2n + 2]) >> 1)) >> 1
+    vpaddw zmm5, zmm5, zmm3
+    vpsraw zmm5, zmm5, 1
+    vpsubw zmm4, zmm4, zmm5
+    vpsraw zmm4, zmm4, 1
+
+    vpaddw zmm5, zmm4, zmm8             ; out hi
+    vpsraw zmm5, zmm5, xmm9
+    vmovdqu16 [rdi], zmm5
+
+    ; l[n] = src[2n] + ((h[n - 1] + h[n]) >> 1)
+    vmovdqu16 zmm5, [lsym(cwi_prev32)]
+    vpermw zmm5, zmm5, zmm4             ; h[n - 1], h[-1] = h[0]
+    vpaddw zmm5, zmm5, zmm4
+    vpsraw zmm5, zmm5, 1
+    vpaddw zmm5, zmm5, zmm3
+
+    vpaddw zmm5, zmm5, zmm10            ; out lo
+    vpsraw zmm5, zmm5, xmm11
+    vmovdqu16 [rdx], zmm5
+
+    ; move right / down
+    lea rsi, [rsi + 64 * 2]
+    lea rdi, [rdi + 32 * 2]
+    lea rdx, [rdx + 32 * 2]
+
+    dec ecx
+    jnz loop1c
+
+    ret
+
+;******************************************************************************
+; source 16 bit signed, 32 pixel width
+rfx_dwt_2d_encode_block_horiz_16_32_no_lo:
+    mov ecx, 8
+loop1c1:
+    ; 2 rows at a time
+    vmovdqu16 zmm1, [rsi]
+    vmovdqu16 zmm2, [rsi + 64]
+    vmovdqu16 zmm3, [lsym(cwi_even)]
+    vpermi2w zmm3, zmm1, zmm2           ; src[2n]
+    vmovdqu16 zmm4, [lsym(cwi_odd)]
+    vpermi2w zmm4, zmm1, zmm2           ; src[2n + 1]
+    vmovdqu16 zmm5, [lsym(cwi_next32)]
+    vpermi2w zmm5, zmm1, zmm2           ; src[2n + 2], mirror at the end
+
+    ; h[n] = (src[2n + 1] - ((src[2n] + src[2n + 2]) >> 1)) >> 1
+    vpaddw zmm5, zmm5, zmm3
+    vpsraw zmm5, zmm5, 1
+    vpsubw zmm4, zmm4, zmm5
+    vpsraw zmm4, zmm4, 1
+
+    vpaddw zmm5, zmm4, zmm8             ; out hi
+    vpsraw zmm5, zmm5, xmm9
+    vmovdqu16 [rdi], zmm5
+
+    ; l[n] = src[2n] + ((h[n - 1] + h[n]) >> 1)
+    vmovdqu16 zmm5, [lsym(cwi_prev32)]
+    vpermw zmm5, zmm5, zmm4             ; h[n - 1], h[-1] = h[0]
+    vpaddw zmm5, zmm5, zmm4
+    vpsraw zmm5, zmm5, 1
+    vpaddw zmm5, zmm5, zmm3
+
+    vmovdqu16 [rdx], zmm5               ; out lo
+
+    ; move right / down
+    lea rsi, [rsi + 64 * 2]
+    lea rdi, [rdi + 32 * 2]
+    lea rdx, [rdx + 32 * 2]
+
+    dec ecx
+    jnz loop1c1
+
+    ret
+
+;******************************************************************************
+; source 16 bit signed, 32 pixel width
+rfx_dwt_2d_encode_block_verti_16_32:
+    mov ecx, 1
+loop1d:
+    ; pre
+    vmovdqu16 zmm1, [rsi]               ; src[2n]
+    vmovdqu16 zmm2, [rsi + 32 * 2]      ; src[2n + 1]
+    vmovdqu16 zmm3, [rsi + 32 * 2 * 2]  ; src[2n + 2]
+    ; h[n] = (src[2n + 1] - ((src[2n] + src[2n + 2]) >> 1)) >> 1
+    vpaddw zmm4, zmm1, zmm3
+    vpsraw zmm4, zmm4, 1
+    vpsubw zmm5, zmm2, zmm4
+    vpsraw zmm5, zmm5, 1
+    vmovdqu16 [rdi], zmm5               ; out hi
+    ; l[n] = src[2n] + ((h[n - 1] + h[n]) >> 1)
+    vpaddw zmm4, zmm5, zmm1
+    vmovdqu16 [rdx], zmm4               ; out lo
+    vmovdqa64 zmm0, zmm5                ; save hi
+    ; move down
+    lea rsi, [rsi + 32 * 2 * 2]         ; 2 rows
+    lea rdi, [rdi + 32 * 2]             ; 1 row
+    lea rdx, [rdx + 32 * 2]             ; 1 row
+
+    ; loop
+    shl ecx, 16
+    mov cx, 14
+loop2d:
+    vmovdqa64 zmm1, zmm3                ; src[2n]
+    vmovdqu16 zmm2, [rsi + 32 * 2]      ; src[2n + 1]
+    vmovdqu16 zmm3, [rsi + 32 * 2 * 2]  ; src[2n + 2]
+    ; h[n] = (src[2n + 1] - ((src[2n] + src[2n + 2]) >> 1)) >> 1
+    vpaddw zmm4, zmm1, zmm3
+    vpsraw zmm4, zmm4, 1
+    vpsubw zmm5, zmm2, zmm4
+    vpsraw zmm5, zmm5, 1
+    vmovdqu16 [rdi], zmm5               ; out hi
+    ; l[n] = src[2n] + ((h[n - 1] + h[n]) >> 1)
+    vpaddw zmm4, zmm5, zmm0
+    vpsraw zmm4, zmm4, 1
+    vpaddw zmm4, zmm4, zmm1
+    vmovdqu16 [rdx], zmm4               ; out lo
+    vmovdqa64 zmm0, zmm5                ; save hi
+    ; move down
+    lea rsi, [rsi + 32 * 2 * 2]         ; 2 rows
+    lea rdi, [rdi + 32 * 2]             ; 1 row
+    lea rdx, [rdx + 32 * 2]             ; 1 row
+
+    dec cx
+    jnz loop2d
+    shr ecx, 16
+
+    ; post
+    vmovdqa64 zmm1, zmm3                ; src[2n], src[2n + 2] mirrors it
+    vmovdqu16 zmm2, [rsi + 32 * 2]      ; src[2n + 1]
+    ; h[n] = (src[2n + 1] - ((src[2n] + src[2n + 2]) >> 1)) >> 1
+    vpaddw zmm4, zmm1, zmm3
+    vpsraw zmm4, zmm4, 1
+    vpsubw zmm5, zmm2, zmm4
+    vpsraw zmm5, zmm5, 1
+    vmovdqu16 [rdi], zmm5               ; out hi
+    ; l[n] = src[2n] + ((h[n - 1] + h[n]) >> 1)
+    vpaddw zmm4, zmm5, zmm0
+    vpsraw zmm4, zmm4, 1
+    vpaddw zmm4, zmm4, zmm1
+    vmovdqu16 [rdx], zmm4               ; out lo
+    ; move down
+    lea rsi, [rsi + 32 * 2 * 2]         ; 2 rows
+    lea rdi, [rdi + 32 * 2]             ; 1 row
+    lea rdx, [rdx + 32 * 2]             ; 1 row
+
+    dec ecx
+    jnz loop1d
+
+    ret
+
+;******************************************************************************
+; source 16 bit signed, 64 pixel width
+rfx_dwt_2d_encode_block_horiz_16_64:
+    mov ecx, 32
+loop1e:
+    vmovdqu16 zmm1, [rsi]
+    vmovdqu16 zmm2, [rsi + 64]
+    vmovdqu16 zmm3, [lsym(cwi_even)]
+    vpermi2w zmm3, zmm1, zmm2           ; src[2n]
+    vmovdqu16 zmm4, [lsym(cwi_odd)]
+    vpermi2w zmm4, zmm1, zmm2           ; src[2n + 1]
+    vmovdqu16 zmm5, [lsym(cwi_next64)]
+    vpermi2w zmm5, zmm1, zmm2           ; src[2n + 2], mirror at the end
+
+    ; h[n] = (src[2n + 1] - ((src[2n] + src[2n + 2]) >> 1)) >> 1
+    vpaddw zmm5, zmm5, zmm3
+    vpsraw zmm5, zmm5, 1
+    vpsubw zmm4, zmm4, zmm5
+    vpsraw zmm4, zmm4, 1
+
+    vpaddw zmm5, zmm4, zmm8             ; out hi
+    vpsraw zmm5, zmm5, xmm9
+    vmovdqu16 [rdi], zmm5
+
+    ; l[n] = src[2n] + ((h[n - 1] + h[n]) >> 1)
+    vmovdqu16 zmm5, [lsym(cwi_prev64)]
+    vpermw zmm5, zmm5, zmm4             ; h[n - 1], h[-1] = h[0]
+    vpaddw zmm5, zmm5, zmm4
+    vpsraw zmm5, zmm5, 1
+    vpaddw zmm5, zmm5, zmm3
+
+    vpaddw zmm5, zmm5, zmm10            ; out lo
+    vpsraw zmm5, zmm5, xmm11
+    vmovdqu16 [rdx], zmm5
+
+    ; move right / down
+    lea rsi, [rsi + 64 * 2]
+    lea rdi, [rdi + 32 * 2]
+    lea rdx, [rdx + 32 * 2]
+
+    dec ecx
+    jnz loop1e
+
+    ret
+
+;******************************************************************************
+; source 16 bit signed, 64 pixel width
+rfx_dwt_2d_encode_block_horiz_16_64_no_lo:
+    mov ecx, 32
+loop1e1:
+    vmovdqu16 zmm1, [rsi]
+    vmovdqu16 zmm2, [rsi + 64]
+    vmovdqu16 zmm3, [lsym(cwi_even)]
+    vpermi2w zmm3, zmm1, zmm2           ; src[2n]
+    vmovdqu16 zmm4, [lsym(cwi_odd)]
+    vpermi2w zmm4, zmm1, zmm2           ; src[2n + 1]
+    vmovdqu16 zmm5, [lsym(cwi_next64)]
+    vpermi2w zmm5, zmm1, zmm2           ; src[2n + 2], mirror at the end
+
+    ; h[n] = (src[2n + 1] - ((src[2n] + src[2n + 2]) >> 1)) >> 1
+    vpaddw zmm5, zmm5, zmm3
+    vpsraw zmm5, zmm5, 1
+    vpsubw zmm4, zmm4, zmm5
+    vpsraw zmm4, zmm4, 1
+
+    vpaddw zmm5, zmm4, zmm8             ; out hi
+    vpsraw zmm5, zmm5, xmm9
+    vmovdqu16 [rdi], zmm5
+
+    ; l[n] = src[2n] + ((h[n - 1] + h[n]) >> 1)
+    vmovdqu16 zmm5, [lsym(cwi_prev64)]
+    vpermw zmm5, zmm5, zmm4             ; h[n - 1], h[-1] = h[0]
+    vpaddw zmm5, zmm5, zmm4
+    vpsraw zmm5, zmm5, 1
+    vpaddw zmm5, zmm5, zmm3
+
+    vmovdqu16 [rdx], zmm5               ; out lo
+
+    ; move right / down
+    lea rsi, [rsi + 64 * 2]
+    lea rdi, [rdi + 32 * 2]
+    lea rdx, [rdx + 32 * 2]
+
+    dec ecx
+    jnz loop1e1
+
+    ret
+
+;******************************************************************************
+; source 8 bit unsigned, 64 pixel width
+rfx_dwt_2d_encode_block_verti_8_64:
+    mov ecx, 2
+loop1f:
+    ; pre
+    vpmovzxbw zmm1, [rsi]               ; src[2n]
+    vpmovzxbw zmm2, [rsi + 64 * 1]      ; src[2n + 1]
+    vpmovzxbw zmm3, [rsi + 64 * 1 * 2]  ; src[2n + 2]
+    vpsubw zmm1, zmm1, [lsym(cw128)]
+    vpsubw zmm2, zmm2, [lsym(cw128)]
+    vpsubw zmm3, zmm3, [lsym(cw128)]
+    vpsllw zmm1, zmm1, 5
+    vpsllw zmm2, zmm2, 5
+    vpsllw zmm3, zmm3, 5
+    ; h[n] = (src[2n + 1] - ((src[2n] + src[2n + 2]) >> 1)) >> 1
+    vpaddw zmm4, zmm1, zmm3
+    vpsraw zmm4, zmm4, 1
+    vpsubw zmm5, zmm2, zmm4
+    vpsraw zmm5, zmm5, 1
+    vmovdqu16 [rdi], zmm5               ; out hi
+    ; l[n] = src[2n] + ((h[n - 1] + h[n]) >> 1)
+    vpaddw zmm4, zmm5, zmm1
+    vmovdqu16 [rdx], zmm4               ; out lo
+    vmovdqa64 zmm0, zmm5                ; save hi
+    ; move down
+    lea rsi, [rsi + 64 * 1 * 2]         ; 2 rows
+    lea rdi, [rdi + 64 * 2]             ; 1 row
+    lea rdx, [rdx + 64 * 2]             ; 1 row
+
+    ; loop
+    shl ecx, 16
+    mov cx, 30
+loop2f:
+    vmovdqa64 zmm1, zmm3                ; src[2n]
+    vpmovzxbw zmm2, [rsi + 64 * 1]      ; src[2n + 1]
+    vpmovzxbw zmm3, [rsi + 64 * 1 * 2]  ; src[2n + 2]
+    vpsubw zmm2, zmm2, [lsym(cw128)]
+    vpsubw zmm3, zmm3, [lsym(cw128)]
+    vpsllw zmm2, zmm2, 5
+    vpsllw zmm3, zmm3, 5
+    ; h[n] = (src[2n + 1] - ((src[2n] + src[2n + 2]) >> 1)) >> 1
+    vpaddw zmm4, zmm1, zmm3
+    vpsraw zmm4, zmm4, 1
+    vpsubw zmm5, zmm2, zmm4
+    vpsraw zmm5, zmm5, 1
+    vmovdqu16 [rdi], zmm5               ; out hi
+    ; l[n] = src[2n] + ((h[n - 1] + h[n]) >> 1)
+    vpaddw zmm4, zmm5, zmm0
+    vpsraw zmm4, zmm4, 1
+    vpaddw zmm4, zmm4, zmm1
+    vmovdqu16 [rdx], zmm4               ; out lo
+    vmovdqa64 zmm0, zmm5                ; save hi
+    ; move down
+    lea rsi, [rsi + 64 * 1 * 2]         ; 2 rows
+    lea rdi, [rdi + 64 * 2]             ; 1 row
+    lea rdx, [rdx + 64 * 2]             ; 1 row
+
+    dec cx
+    jnz loop2f
+    shr ecx, 16
+
+    ; post
+    vmovdqa64 zmm1, zmm3                ; src[2n], src[2n + 2] mirrors it
+    vpmovzxbw zmm2, [rsi + 64 * 1]      ; src[2n + 1]
+    vpsubw zmm2, zmm2, [lsym(cw128)]
+    vpsllw zmm2, zmm2, 5
+    ; h[n] = (src[2n + 1] - ((src[2n] + src[2n + 2]) >> 1)) >> 1
+    vpaddw zmm4, zmm1, zmm3
+    vpsraw zmm4, zmm4, 1
+    vpsubw zmm5, zmm2, zmm4
+    vpsraw zmm5, zmm5, 1
+    vmovdqu16 [rdi], zmm5               ; out hi
+    ; l[n] = src[2n] + ((h[n - 1] + h[n]) >> 1)
+    vpaddw zmm4, zmm5, zmm0
+    vpsraw zmm4, zmm4, 1
+    vpaddw zmm4, zmm4, zmm1
+    vmovdqu16 [rdx], zmm4               ; out lo
+    ; move down
+    lea rsi, [rsi + 64 * 1 * 2]         ; 2 rows
+    lea rdi, [rdi + 64 * 2]             ; 1 row
+    lea rdx, [rdx + 64 * 2]             ; 1 row
+
+    ; move up
+    lea rsi, [rsi - 64 * 1 * 64]
+    lea rdi, [rdi - 32 * 64 * 2]
+    lea rdx, [rdx - 32 * 64 * 2]
+
+    ; move right
+    lea rsi, [rsi + 32]
+    lea rdi, [rdi + 64]
+    lea rdx, [rdx + 64]
+
+    dec ecx
+    jnz loop1f
+
+    ret
+
+set_quants_hi:
+    sub rax, 6 - 5
+    vmovd xmm9, eax
+    imul rax, 64
+    lea rdx, [lsym(cwa0)]
+    add rdx, rax
+    vmovdqu16 zmm8, [rdx]
+    ret
+
+set_quants_lo:
+    sub rax, 6 - 5
+    vmovd xmm11, eax
+    imul rax, 64
+    lea rdx, [lsym(cwa0)]
+    add rdx, rax
+    vmovdqu16 zmm10, [rdx]
+    ret
+
+; Per System V AMD64 ABI, the first six integer or pointer arguments are
+; passed in registers RDI, RSI, RDX, RCX, R8, and R9
+
+;int
+;rfxcodec_encode_dwt_shift_amd64_avx512(const char *qtable,
+;                                      unsigned char *in_buffer,
+;                                      short *out_buffer,
+;                                      short *work_buffer);
+
+;******************************************************************************
+PROC rfxcodec_encode_dwt_shift_amd64_avx512
+    ; prologue. this will make the function appear to the debugger as
+    ; having a stack frame, so that a backtrace can be obtained
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    ; save registers
+    push rbx
+    push rdx  ; rsp+24: out_buffer
+    push rcx  ; rsp+16: work_buffer
+    push rsi  ; rsp+ 8: in_buffer
+    push rdi  ; rsp+ 0: qtable
+
+    ; verical DWT to work buffer, level 1
+    mov rsi, [rsp + 8]                  ; src
+    mov rdi, [rsp + 16]                 ; dst hi
+    lea rdi, [rdi + 64 * 32 * 2]        ; dst hi
+    mov rdx, [rsp + 16]                 ; dst lo
+    call rfx_dwt_2d_encode_block_verti_8_64
+horiz_level1:
+
+    ; horizontal DWT to out buffer, level 1, part 1
+    xor rax, rax
+    mov rdx, [rsp]
+    mov al, [rdx + 4]
+    and al, 0xF
+    call set_quants_hi
+    mov rsi, [rsp + 16]                 ; src
+    mov rdi, [rsp + 24]                 ; dst hi - HL1
+    mov rdx, [rsp + 24]                 ; dst lo - LL1
+    lea rdx, [rdx + 32 * 32 * 6]        ; dst lo - LL1
+    call rfx_dwt_2d_encode_block_horiz_16_64_no_lo
+
+    ; horizontal DWT to out buffer, level 1, part 2
+    xor rax, rax
+    mov rdx, [rsp]
+    mov al, [rdx + 4]
+    shr al, 4
+    call set_quants_hi
+    xor rax, rax
+    mov rdx, [rsp]
+    mov al, [rdx + 3]
+    shr al, 4
+    call set_quants_lo
+    mov rsi, [rsp + 16]                 ; src
+    lea rsi, [rsi + 64 * 32 * 2]        ; src
+    mov rdi, [rsp + 24]                 ; dst hi - HH1
+    lea rdi, [rdi + 32 * 32 * 4]        ; dst hi - HH1
+    mov rdx, [rsp + 24]                 ; dst lo - LH1
+    lea rdx, [rdx + 32 * 32 * 2]        ; dst lo - LH1
+    call rfx_dwt_2d_encode_block_horiz_16_64
+
+    ; verical DWT to work buffer, level 2
+    mov rsi, [rsp + 24]                 ; src
+    lea rsi, [rsi + 32 * 32 * 6]        ; src
+    mov rdi, [rsp + 16]                 ; dst hi
+    lea rdi, [rdi + 32 * 16 * 2]        ; dst hi
+    mov rdx, [rsp + 16]                 ; dst lo
+    call rfx_dwt_2d_encode_block_verti_16_32
+
+    ; horizontal DWT to out buffer, level 2, part 1
+    xor rax, rax
+    mov rdx, [rsp]
+    mov al, [rdx + 2]
+    shr al, 4
+    call set_quants_hi
+    mov rsi, [rsp + 16]                 ; src
+    ; 32 * 32 * 6 + 16 * 16 * 0 = 6144
+    mov rdi, [rsp + 24]                 ; dst hi - HL2
+    lea rdi, [rdi + 6144]               ; dst hi - HL2
+    ; 32 * 32 * 6 + 16 * 16 * 6 = 7680
+    mov rdx, [rsp + 24]                 ; dst lo - LL2
+    lea rdx, [rdx + 7680]               ; dst lo - LL2
+    call rfx_dwt_2d_encode_block_horiz_16_32_no_lo
+
+    ; horizontal DWT to out buffer, level 2, part 2
+    xor rax, rax
+    mov rdx, [rsp]
+    mov al, [rdx + 3]
+    and al, 0xF
+    call set_quants_hi
+    xor rax, rax
+    mov rdx, [rsp]
+    mov al, [rdx + 2]
+    and al, 0xF
+    call set_quants_lo
+    mov rsi, [rsp + 16]                 ; src
+    lea rsi, [rsi + 32 * 16 * 2]        ; src
+    ; 32 * 32 * 6 + 16 * 16 * 4 = 7168
+    mov rdi, [rsp + 24]                 ; dst hi - HH2
+    lea rdi, [rdi + 7168]               ; dst hi - HH2
+    ; 32 * 32 * 6 + 16 * 16 * 2 = 6656
+    mov rdx, [rsp + 24]                 ; dst lo - LH2
+    lea rdx, [rdx + 6656]               ; dst lo - LH2
+    call rfx_dwt_2d_encode_block_horiz_16_32
+
+    ; verical DWT to work buffer, level 3
+    ; 32 * 32 * 6 + 16 * 16 * 6 = 7680
+    mov rsi, [rsp + 24]                 ; src
+    lea rsi, [rsi + 7680]               ; src
+    mov rdi, [rsp + 16]                 ; dst hi
+    lea rdi, [rdi + 16 * 8 * 2]         ; dst hi
+    mov rdx, [rsp + 16]                 ; dst lo
+    call rfx_dwt_2d_encode_block_verti_16_16
+
+    ; horizontal DWT to out buffer, level 3, part 1
+    xor rax, rax
+    mov rdx, [rsp]
+    mov al, [rdx + 1]
+    and al, 0xF
+    call set_quants_hi
+    xor rax, rax
+    mov rdx, [rsp]
+    mov al, [rdx + 0]
+    and al, 0xF
+    call set_quants_lo
+    mov rsi, [rsp + 16]                 ; src
+    ; 32 * 32 * 6 + 16 * 16 * 6 + 8 * 8 * 0 = 7680
+    mov rdi, [rsp + 24]                 ; dst hi - HL3
+    lea rdi, [rdi + 7680]               ; dst hi - HL3
+    ; 32 * 32 * 6 + 16 * 16 * 6 + 8 * 8 * 6 = 8064
+    mov rdx, [rsp + 24]                 ; dst lo - LL3
+    lea rdx, [rdx + 8064]               ; dst lo - LL3
+    call rfx_dwt_2d_encode_block_horiz_16_16
+
+    ; horizontal DWT to out buffer, level 3, part 2
+    xor rax, rax
+    mov rdx, [rsp]
+    mov al, [rdx + 1]
+    shr al, 4
+    call set_quants_hi
+    xor rax, rax
+    mov rdx, [rsp]
+    mov al, [rdx + 0]
+    shr al, 4
+    call set_quants_lo
+    mov rsi, [rsp + 16]                 ; src
+    lea rsi, [rsi + 16 * 8 * 2]         ; src
+    ; 32 * 32 * 6 + 16 * 16 * 6 + 8 * 8 * 4 = 7936
+    mov rdi, [rsp + 24]                 ; dst hi - HH3
+    lea rdi, [rdi + 7936]               ; dst hi - HH3
+    ; 32 * 32 * 6 + 16 * 16 * 6 + 8 * 8 * 2 = 7808
+    mov rdx, [rsp + 24]                 ; dst lo - LH3
+    lea rdx, [rdx + 7808]               ; dst lo - LH3
+    call rfx_dwt_2d_encode_block_horiz_16_16
+
+    mov rax, 0
+    ; restore registers
+    pop rdi
+    pop rsi
+    pop rcx
+    pop rdx
+    pop rbx
+
+    ; epilogue
+%ifdef DEBUG
+    mov rsp, rbp
+    pop rbp
+%endif
+
+    vzeroupper
+    ret
+
+;******************************************************************************
+;int
+;rfxcodec_encode_dwt_h1_shift_amd64_avx512(const char *qtable,
+;                                          short *out_buffer,
+;                                          short *v1_buffer);
+; rfxcodec_encode_dwt_shift_amd64_avx512 from the level 1 horizontal
+; pass on, v1_buffer holds the level 1 vertical pass and is used as the
+; work buffer
+PROC rfxcodec_encode_dwt_h1_shift_amd64_avx512
+    ; to the rfxcodec_encode_dwt_shift_amd64_avx512 arguments, there is no
+    ; in_buffer
+    mov rcx, rdx                        ; work_buffer
+    mov rdx, rsi                        ; out_buffer
+    xor esi, esi                        ; in_buffer
+    ; prologue. this will make the function appear to the debugger as
+    ; having a stack frame, so that a backtrace can be obtained
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    ; save registers
+    push rbx
+    push rdx  ; rsp+24: out_buffer
+    push rcx  ; rsp+16: work_buffer
+    push rsi  ; rsp+ 8: in_buffer
+    push rdi  ; rsp+ 0: qtable
+
+    jmp horiz_level1
+END_OF_FILE
@@ -1357,6 +1357,7 @@ PROC rfxcodec_encode_dwt_shift_amd64_sse2
     lea rdi, [rdi + 64 * 32 * 2]        ; dst hi
     mov rdx, [rsp + 16]                 ; dst lo
     call rfx_dwt_2d_encode_block_verti_8_64
+horiz_level1:
 
     ; horizontal DWT to out buffer, level 1, part 1
     xor rax, rax
@@ -1498,4 +1499,35 @@ PROC rfxcodec_encode_dwt_shift_amd64_sse2
 %endif
 
     ret
+
+;******************************************************************************
+;int
+;rfxcodec_encode_dwt_h1_shift_amd64_sse2(const char *qtable,
+;                                        short *out_buffer,
+;                                        short *v1_buffer);
+; rfxcodec_encode_dwt_shift_amd64_sse2 from the level 1 horizontal
+; pass on, v1_buffer holds the level 1 vertical pass and is used as the
+; work buffer
+PROC rfxcodec_encode_dwt_h1_shift_amd64_sse2
+    ; to the rfxcodec_encode_dwt_shift_amd64_sse2 arguments, there is no
+    ; in_buffer
+    mov rcx, rdx                        ; work_buffer
+    mov rdx, rsi                        ; out_buffer
+    xor esi, esi                        ; in_buffer
+    ; prologue. this will make the function appear to the debugger as
+    ; having a stack frame, so that a backtrace can be obtained
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    ; save registers
+    push rbx
+    push rdx  ; rsp+24: out_buffer
+    push rcx  ; rsp+16: work_buffer
+    push rsi  ; rsp+ 8: in_buffer
+    push rdi  ; rsp+ 0: qtable
+    pxor xmm0, xmm0
+
+    jmp horiz_level1
 END_OF_FILE
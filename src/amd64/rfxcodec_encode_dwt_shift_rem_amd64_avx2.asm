@@ -0,0 +1,798 @@
+;
+;Copyright 2026 librfxcodec contributors
+;
+;Permission to use, copy, modify, distribute, and sell this software and its
+;documentation for any purpose is hereby granted without fee, provided that
+;the above copyright notice appear in all copies and that both that
+;copyright notice and this permission notice appear in supporting
+;documentation.
+;
+;The above copyright notice and this permission notice shall be included in
+;all copies or substantial portions of the Software.
+;
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+;IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+;FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+;OPEN GROUP BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+;AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+;CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+;
+;amd64 asm progressive reduce-extrapolate DWT, avx2
+
+%include "common.asm"
+
+PREPARE_RODATA
+    cw128    times 16 dw 128
+    cw1      times 16 dw 1
+    cw8000   times 16 dw 0x8000
+    cw7FFF   times 16 dw 0x7FFF
+    cwtop0   times 15 dw 0xFFFF
+             dw 0
+    cwlane0  dw 0xFFFF, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+
+;******************************************************************************
+; unsigned 8 bit source, 16 columns, level 1, see rfx_rem_dwt_shift_encode_vert_lv1
+rem_vert_lv1:
+    vpmovzxbw ymm0, [rsi]
+    vpsubw ymm0, ymm0, [lsym(cw128)]
+    vpsllw ymm0, ymm0, 5
+    vpmovzxbw ymm1, [rsi + 64]
+    vpsubw ymm1, ymm1, [lsym(cw128)]
+    vpsllw ymm1, ymm1, 5
+    vpmovzxbw ymm2, [rsi + 128]
+    vpsubw ymm2, ymm2, [lsym(cw128)]
+    vpsllw ymm2, ymm2, 5
+    vpand ymm3, ymm0, ymm2
+    vpxor ymm5, ymm0, ymm2
+    vpsraw ymm5, ymm5, 1
+    vpaddw ymm5, ymm5, ymm3
+    vpxor ymm5, ymm5, [lsym(cw7FFF)]
+    vpxor ymm3, ymm1, [lsym(cw8000)]
+    vpavgw ymm3, ymm3, ymm5
+    vpxor ymm3, ymm3, [lsym(cw8000)]
+    vmovdqu [rdi + 4224], ymm3
+    vpaddw ymm5, ymm0, ymm3
+    vmovdqu [rdi], ymm5
+    mov ecx, 30
+rem_vert_lv1_loop:
+    lea rsi, [rsi + 128]
+    lea rdi, [rdi + 128]
+    vmovdqa ymm4, ymm3
+    vmovdqa ymm0, ymm2
+    vpmovzxbw ymm1, [rsi + 64]
+    vpsubw ymm1, ymm1, [lsym(cw128)]
+    vpsllw ymm1, ymm1, 5
+    vpmovzxbw ymm2, [rsi + 128]
+    vpsubw ymm2, ymm2, [lsym(cw128)]
+    vpsllw ymm2, ymm2, 5
+    vpand ymm3, ymm0, ymm2
+    vpxor ymm5, ymm0, ymm2
+    vpsraw ymm5, ymm5, 1
+    vpaddw ymm5, ymm5, ymm3
+    vpxor ymm5, ymm5, [lsym(cw7FFF)]
+    vpxor ymm3, ymm1, [lsym(cw8000)]
+    vpavgw ymm3, ymm3, ymm5
+    vpxor ymm3, ymm3, [lsym(cw8000)]
+    vmovdqu [rdi + 4224], ymm3
+    vpand ymm6, ymm4, ymm3
+    vpxor ymm5, ymm4, ymm3
+    vpsraw ymm5, ymm5, 1
+    vpaddw ymm5, ymm5, ymm6
+    vpaddw ymm5, ymm5, ymm0
+    vmovdqu [rdi], ymm5
+    dec ecx
+    jnz rem_vert_lv1_loop
+    ; 64 = 2 * 63 - 62, 65 mirrors to 63 and 66 to 62
+    lea rsi, [rsi + 128]
+    lea rdi, [rdi + 128]
+    vmovdqa ymm0, ymm2
+    vpmovzxbw ymm1, [rsi + 64]
+    vpsubw ymm1, ymm1, [lsym(cw128)]
+    vpsllw ymm1, ymm1, 5
+    vpaddw ymm2, ymm1, ymm1
+    vpsubw ymm2, ymm2, ymm0
+    vpsraw ymm5, ymm3, 1
+    vpaddw ymm5, ymm5, ymm0
+    vmovdqu [rdi], ymm5
+    vpand ymm3, ymm2, ymm0
+    vpxor ymm5, ymm2, ymm0
+    vpsraw ymm5, ymm5, 1
+    vpaddw ymm5, ymm5, ymm3
+    vpxor ymm5, ymm5, [lsym(cw7FFF)]
+    vpxor ymm3, ymm1, [lsym(cw8000)]
+    vpavgw ymm3, ymm3, ymm5
+    vpxor ymm3, ymm3, [lsym(cw8000)]
+    vpsraw ymm3, ymm3, 1
+    vpaddw ymm3, ymm3, ymm2
+    vmovdqu [rdi + 128], ymm3
+    ret
+
+;******************************************************************************
+; 16 columns, level 2, see rfx_rem_dwt_shift_encode_vert_lv2
+rem_vert_lv2:
+    vmovdqu ymm0, [rsi]
+    vmovdqu ymm1, [rsi + 66]
+    vmovdqu ymm2, [rsi + 132]
+    vpand ymm3, ymm0, ymm2
+    vpxor ymm5, ymm0, ymm2
+    vpsraw ymm5, ymm5, 1
+    vpaddw ymm5, ymm5, ymm3
+    vpxor ymm5, ymm5, [lsym(cw7FFF)]
+    vpxor ymm3, ymm1, [lsym(cw8000)]
+    vpavgw ymm3, ymm3, ymm5
+    vpxor ymm3, ymm3, [lsym(cw8000)]
+    vmovdqu [rdi + 1122], ymm3
+    vpaddw ymm5, ymm0, ymm3
+    vmovdqu [rdi], ymm5
+    mov ecx, 15
+rem_vert_lv2_loop:
+    lea rsi, [rsi + 132]
+    lea rdi, [rdi + 66]
+    vmovdqa ymm4, ymm3
+    vmovdqa ymm0, ymm2
+    vmovdqu ymm1, [rsi + 66]
+    vmovdqu ymm2, [rsi + 132]
+    vpand ymm3, ymm0, ymm2
+    vpxor ymm5, ymm0, ymm2
+    vpsraw ymm5, ymm5, 1
+    vpaddw ymm5, ymm5, ymm3
+    vpxor ymm5, ymm5, [lsym(cw7FFF)]
+    vpxor ymm3, ymm1, [lsym(cw8000)]
+    vpavgw ymm3, ymm3, ymm5
+    vpxor ymm3, ymm3, [lsym(cw8000)]
+    vmovdqu [rdi + 1122], ymm3
+    vpand ymm6, ymm4, ymm3
+    vpxor ymm5, ymm4, ymm3
+    vpsraw ymm5, ymm5, 1
+    vpaddw ymm5, ymm5, ymm6
+    vpaddw ymm5, ymm5, ymm0
+    vmovdqu [rdi], ymm5
+    dec ecx
+    jnz rem_vert_lv2_loop
+    ; mirrored, h[n + 1] == h[n]
+    vpaddw ymm2, ymm2, ymm3
+    vmovdqu [rdi + 66], ymm2
+    ret
+
+;******************************************************************************
+; 8 columns, level 3, see rfx_rem_dwt_shift_encode_vert_lv3
+rem_vert_lv3:
+    vmovdqu xmm0, [rsi]
+    vmovdqu xmm1, [rsi + 34]
+    vmovdqu xmm2, [rsi + 68]
+    vpand xmm3, xmm0, xmm2
+    vpxor xmm5, xmm0, xmm2
+    vpsraw xmm5, xmm5, 1
+    vpaddw xmm5, xmm5, xmm3
+    vpxor xmm5, xmm5, [lsym(cw7FFF)]
+    vpxor xmm3, xmm1, [lsym(cw8000)]
+    vpavgw xmm3, xmm3, xmm5
+    vpxor xmm3, xmm3, [lsym(cw8000)]
+    vmovdqu [rdi + 306], xmm3
+    vpaddw xmm5, xmm0, xmm3
+    vmovdqu [rdi], xmm5
+    mov ecx, 7
+rem_vert_lv3_loop:
+    lea rsi, [rsi + 68]
+    lea rdi, [rdi + 34]
+    vmovdqa xmm4, xmm3
+    vmovdqa xmm0, xmm2
+    vmovdqu xmm1, [rsi + 34]
+    vmovdqu xmm2, [rsi + 68]
+    vpand xmm3, xmm0, xmm2
+    vpxor xmm5, xmm0, xmm2
+    vpsraw xmm5, xmm5, 1
+    vpaddw xmm5, xmm5, xmm3
+    vpxor xmm5, xmm5, [lsym(cw7FFF)]
+    vpxor xmm3, xmm1, [lsym(cw8000)]
+    vpavgw xmm3, xmm3, xmm5
+    vpxor xmm3, xmm3, [lsym(cw8000)]
+    vmovdqu [rdi + 306], xmm3
+    vpand xmm6, xmm4, xmm3
+    vpxor xmm5, xmm4, xmm3
+    vpsraw xmm5, xmm5, 1
+    vpaddw xmm5, xmm5, xmm6
+    vpaddw xmm5, xmm5, xmm0
+    vmovdqu [rdi], xmm5
+    dec ecx
+    jnz rem_vert_lv3_loop
+    ; mirrored, h[n + 1] == h[n]
+    vpaddw xmm2, xmm2, xmm3
+    vmovdqu [rdi + 34], xmm2
+    ret
+
+;******************************************************************************
+; one row, 16 lanes, level 1, high band quantised
+rem_horz_lv1:
+    vmovdqu ymm0, [rsi]
+    vmovdqu ymm1, [rsi + 32]
+    vpslld ymm2, ymm0, 16
+    vpslld ymm3, ymm1, 16
+    vpsrad ymm2, ymm2, 16
+    vpsrad ymm3, ymm3, 16
+    vpackssdw ymm2, ymm2, ymm3
+    vpsrad ymm0, ymm0, 16
+    vpsrad ymm1, ymm1, 16
+    vpackssdw ymm0, ymm0, ymm1
+    vpermq ymm2, ymm2, 0xD8
+    vpermq ymm0, ymm0, 0xD8
+    vmovdqu [r11 + 0], ymm2
+    vmovdqu [r11 + 96], ymm0
+    vmovdqu ymm0, [rsi + 64]
+    vmovdqu ymm1, [rsi + 96]
+    vpslld ymm2, ymm0, 16
+    vpslld ymm3, ymm1, 16
+    vpsrad ymm2, ymm2, 16
+    vpsrad ymm3, ymm3, 16
+    vpackssdw ymm2, ymm2, ymm3
+    vpsrad ymm0, ymm0, 16
+    vpsrad ymm1, ymm1, 16
+    vpackssdw ymm0, ymm0, ymm1
+    vpermq ymm2, ymm2, 0xD8
+    vpermq ymm0, ymm0, 0xD8
+    vmovdqu [r11 + 32], ymm2
+    vmovdqu [r11 + 128], ymm0
+    ; samples 0 to 31
+    vmovdqu ymm0, [r11 + 0]
+    vmovdqu ymm2, [r11 + 96]
+    vmovdqu ymm1, [r11 + 32]
+    vperm2i128 ymm6, ymm0, ymm1, 0x21
+    vpalignr ymm3, ymm6, ymm0, 2
+    vpand ymm4, ymm0, ymm3
+    vpxor ymm6, ymm0, ymm3
+    vpsraw ymm6, ymm6, 1
+    vpaddw ymm6, ymm6, ymm4
+    vpxor ymm6, ymm6, [lsym(cw7FFF)]
+    vpxor ymm4, ymm2, [lsym(cw8000)]
+    vpavgw ymm4, ymm4, ymm6
+    vpxor ymm4, ymm4, [lsym(cw8000)]
+    ; h[-1] mirrors to h[0]
+    vperm2i128 ymm6, ymm4, ymm4, 0x21
+    vpalignr ymm5, ymm4, ymm6, 14
+    vmovdqu ymm6, [lsym(cwlane0)]
+    vpblendvb ymm5, ymm5, ymm4, ymm6
+    vmovdqa ymm3, ymm4
+    vpsraw ymm3, ymm3, [r11 + 320]
+    vpaddw ymm3, ymm3, [lsym(cw1)]
+    vpsraw ymm3, ymm3, 1
+    vmovdqu [rdx], ymm3
+    vpand ymm6, ymm5, ymm4
+    vpxor ymm3, ymm5, ymm4
+    vpsraw ymm3, ymm3, 1
+    vpaddw ymm3, ymm3, ymm6
+    vpaddw ymm3, ymm3, ymm0
+    vmovdqu [rdi], ymm3
+    vmovdqa ymm7, ymm4
+    ; samples 32 to 63
+    vmovdqu ymm0, [r11 + 32]
+    vmovdqu ymm2, [r11 + 128]
+    ; 64 = 2 * 63 - 62
+    vpaddw ymm3, ymm2, ymm2
+    vpsubw ymm3, ymm3, ymm0
+    vextracti128 xmm1, ymm3, 1
+    vpsrldq xmm1, xmm1, 14
+    vperm2i128 ymm6, ymm0, ymm1, 0x21
+    vpalignr ymm3, ymm6, ymm0, 2
+    vpand ymm4, ymm0, ymm3
+    vpxor ymm6, ymm0, ymm3
+    vpsraw ymm6, ymm6, 1
+    vpaddw ymm6, ymm6, ymm4
+    vpxor ymm6, ymm6, [lsym(cw7FFF)]
+    vpxor ymm4, ymm2, [lsym(cw8000)]
+    vpavgw ymm4, ymm4, ymm6
+    vpxor ymm4, ymm4, [lsym(cw8000)]
+    vperm2i128 ymm6, ymm7, ymm4, 0x21
+    vpalignr ymm5, ymm4, ymm6, 14
+    ; h[15] to h[30] from the shifted vector, h[31] is 0
+    vmovdqa ymm3, ymm5
+    vpsraw ymm3, ymm3, [r11 + 320]
+    vpaddw ymm3, ymm3, [lsym(cw1)]
+    vpsraw ymm3, ymm3, 1
+    vmovdqu [rdx + 30], ymm3
+    vpand ymm3, ymm4, [lsym(cwtop0)]
+    vpand ymm6, ymm3, ymm5
+    vpxor ymm3, ymm3, ymm5
+    vpsraw ymm3, ymm3, 1
+    vpaddw ymm3, ymm3, ymm6
+    vpaddw ymm3, ymm3, ymm0
+    vmovdqu [rdi + 32], ymm3
+    ; last low band sample
+    vextracti128 xmm5, ymm4, 1
+    vpsrldq xmm5, xmm5, 14
+    ; 65 mirrors to 63 and 66 to 62, h from 62, 63, 64
+    vpsraw xmm5, xmm5, 1
+    vpaddw xmm5, xmm5, xmm1
+    vpextrw [rdi + 64], xmm5, 0
+    ret
+
+;******************************************************************************
+; one row, 16 lanes, level 1, high band quantised, low band too
+rem_horz_lv1_q:
+    vmovdqu ymm0, [rsi]
+    vmovdqu ymm1, [rsi + 32]
+    vpslld ymm2, ymm0, 16
+    vpslld ymm3, ymm1, 16
+    vpsrad ymm2, ymm2, 16
+    vpsrad ymm3, ymm3, 16
+    vpackssdw ymm2, ymm2, ymm3
+    vpsrad ymm0, ymm0, 16
+    vpsrad ymm1, ymm1, 16
+    vpackssdw ymm0, ymm0, ymm1
+    vpermq ymm2, ymm2, 0xD8
+    vpermq ymm0, ymm0, 0xD8
+    vmovdqu [r11 + 0], ymm2
+    vmovdqu [r11 + 96], ymm0
+    vmovdqu ymm0, [rsi + 64]
+    vmovdqu ymm1, [rsi + 96]
+    vpslld ymm2, ymm0, 16
+    vpslld ymm3, ymm1, 16
+    vpsrad ymm2, ymm2, 16
+    vpsrad ymm3, ymm3, 16
+    vpackssdw ymm2, ymm2, ymm3
+    vpsrad ymm0, ymm0, 16
+    vpsrad ymm1, ymm1, 16
+    vpackssdw ymm0, ymm0, ymm1
+    vpermq ymm2, ymm2, 0xD8
+    vpermq ymm0, ymm0, 0xD8
+    vmovdqu [r11 + 32], ymm2
+    vmovdqu [r11 + 128], ymm0
+    ; samples 0 to 31
+    vmovdqu ymm0, [r11 + 0]
+    vmovdqu ymm2, [r11 + 96]
+    vmovdqu ymm1, [r11 + 32]
+    vperm2i128 ymm6, ymm0, ymm1, 0x21
+    vpalignr ymm3, ymm6, ymm0, 2
+    vpand ymm4, ymm0, ymm3
+    vpxor ymm6, ymm0, ymm3
+    vpsraw ymm6, ymm6, 1
+    vpaddw ymm6, ymm6, ymm4
+    vpxor ymm6, ymm6, [lsym(cw7FFF)]
+    vpxor ymm4, ymm2, [lsym(cw8000)]
+    vpavgw ymm4, ymm4, ymm6
+    vpxor ymm4, ymm4, [lsym(cw8000)]
+    ; h[-1] mirrors to h[0]
+    vperm2i128 ymm6, ymm4, ymm4, 0x21
+    vpalignr ymm5, ymm4, ymm6, 14
+    vmovdqu ymm6, [lsym(cwlane0)]
+    vpblendvb ymm5, ymm5, ymm4, ymm6
+    vmovdqa ymm3, ymm4
+    vpsraw ymm3, ymm3, [r11 + 320]
+    vpaddw ymm3, ymm3, [lsym(cw1)]
+    vpsraw ymm3, ymm3, 1
+    vmovdqu [rdx], ymm3
+    vpand ymm6, ymm5, ymm4
+    vpxor ymm3, ymm5, ymm4
+    vpsraw ymm3, ymm3, 1
+    vpaddw ymm3, ymm3, ymm6
+    vpaddw ymm3, ymm3, ymm0
+    vpsraw ymm3, ymm3, [r11 + 336]
+    vpaddw ymm3, ymm3, [lsym(cw1)]
+    vpsraw ymm3, ymm3, 1
+    vmovdqu [rdi], ymm3
+    vmovdqa ymm7, ymm4
+    ; samples 32 to 63
+    vmovdqu ymm0, [r11 + 32]
+    vmovdqu ymm2, [r11 + 128]
+    ; 64 = 2 * 63 - 62
+    vpaddw ymm3, ymm2, ymm2
+    vpsubw ymm3, ymm3, ymm0
+    vextracti128 xmm1, ymm3, 1
+    vpsrldq xmm1, xmm1, 14
+    vperm2i128 ymm6, ymm0, ymm1, 0x21
+    vpalignr ymm3, ymm6, ymm0, 2
+    vpand ymm4, ymm0, ymm3
+    vpxor ymm6, ymm0, ymm3
+    vpsraw ymm6, ymm6, 1
+    vpaddw ymm6, ymm6, ymm4
+    vpxor ymm6, ymm6, [lsym(cw7FFF)]
+    vpxor ymm4, ymm2, [lsym(cw8000)]
+    vpavgw ymm4, ymm4, ymm6
+    vpxor ymm4, ymm4, [lsym(cw8000)]
+    vperm2i128 ymm6, ymm7, ymm4, 0x21
+    vpalignr ymm5, ymm4, ymm6, 14
+    ; h[15] to h[30] from the shifted vector, h[31] is 0
+    vmovdqa ymm3, ymm5
+    vpsraw ymm3, ymm3, [r11 + 320]
+    vpaddw ymm3, ymm3, [lsym(cw1)]
+    vpsraw ymm3, ymm3, 1
+    vmovdqu [rdx + 30], ymm3
+    vpand ymm3, ymm4, [lsym(cwtop0)]
+    vpand ymm6, ymm3, ymm5
+    vpxor ymm3, ymm3, ymm5
+    vpsraw ymm3, ymm3, 1
+    vpaddw ymm3, ymm3, ymm6
+    vpaddw ymm3, ymm3, ymm0
+    vpsraw ymm3, ymm3, [r11 + 336]
+    vpaddw ymm3, ymm3, [lsym(cw1)]
+    vpsraw ymm3, ymm3, 1
+    vmovdqu [rdi + 32], ymm3
+    ; last low band sample
+    vextracti128 xmm5, ymm4, 1
+    vpsrldq xmm5, xmm5, 14
+    ; 65 mirrors to 63 and 66 to 62, h from 62, 63, 64
+    vpsraw xmm5, xmm5, 1
+    vpaddw xmm5, xmm5, xmm1
+    vpsraw xmm5, xmm5, [r11 + 336]
+    vpaddw xmm5, xmm5, [lsym(cw1)]
+    vpsraw xmm5, xmm5, 1
+    vpextrw [rdi + 64], xmm5, 0
+    ret
+
+;******************************************************************************
+; one row, 16 lanes, level 2, high band quantised
+rem_horz_lv2:
+    vmovdqu ymm0, [rsi]
+    vmovdqu ymm1, [rsi + 32]
+    vpslld ymm2, ymm0, 16
+    vpslld ymm3, ymm1, 16
+    vpsrad ymm2, ymm2, 16
+    vpsrad ymm3, ymm3, 16
+    vpackssdw ymm2, ymm2, ymm3
+    vpsrad ymm0, ymm0, 16
+    vpsrad ymm1, ymm1, 16
+    vpackssdw ymm0, ymm0, ymm1
+    vpermq ymm2, ymm2, 0xD8
+    vpermq ymm0, ymm0, 0xD8
+    vmovdqu [r11 + 0], ymm2
+    vmovdqu [r11 + 96], ymm0
+    ; samples 0 to 31
+    vmovdqu ymm0, [r11 + 0]
+    vmovdqu ymm2, [r11 + 96]
+    movzx eax, word [rsi + 64]
+    vmovd xmm1, eax
+    vperm2i128 ymm6, ymm0, ymm1, 0x21
+    vpalignr ymm3, ymm6, ymm0, 2
+    vpand ymm4, ymm0, ymm3
+    vpxor ymm6, ymm0, ymm3
+    vpsraw ymm6, ymm6, 1
+    vpaddw ymm6, ymm6, ymm4
+    vpxor ymm6, ymm6, [lsym(cw7FFF)]
+    vpxor ymm4, ymm2, [lsym(cw8000)]
+    vpavgw ymm4, ymm4, ymm6
+    vpxor ymm4, ymm4, [lsym(cw8000)]
+    ; h[-1] mirrors to h[0]
+    vperm2i128 ymm6, ymm4, ymm4, 0x21
+    vpalignr ymm5, ymm4, ymm6, 14
+    vmovdqu ymm6, [lsym(cwlane0)]
+    vpblendvb ymm5, ymm5, ymm4, ymm6
+    vmovdqa ymm3, ymm4
+    vpsraw ymm3, ymm3, [r11 + 320]
+    vpaddw ymm3, ymm3, [lsym(cw1)]
+    vpsraw ymm3, ymm3, 1
+    vmovdqu [rdx], ymm3
+    vpand ymm6, ymm5, ymm4
+    vpxor ymm3, ymm5, ymm4
+    vpsraw ymm3, ymm3, 1
+    vpaddw ymm3, ymm3, ymm6
+    vpaddw ymm3, ymm3, ymm0
+    vmovdqu [rdi], ymm3
+    ; last low band sample
+    vextracti128 xmm5, ymm4, 1
+    vpsrldq xmm5, xmm5, 14
+    vpaddw xmm5, xmm5, xmm1
+    vpextrw [rdi + 32], xmm5, 0
+    ret
+
+;******************************************************************************
+; one row, 16 lanes, level 2, high band quantised, low band too
+rem_horz_lv2_q:
+    vmovdqu ymm0, [rsi]
+    vmovdqu ymm1, [rsi + 32]
+    vpslld ymm2, ymm0, 16
+    vpslld ymm3, ymm1, 16
+    vpsrad ymm2, ymm2, 16
+    vpsrad ymm3, ymm3, 16
+    vpackssdw ymm2, ymm2, ymm3
+    vpsrad ymm0, ymm0, 16
+    vpsrad ymm1, ymm1, 16
+    vpackssdw ymm0, ymm0, ymm1
+    vpermq ymm2, ymm2, 0xD8
+    vpermq ymm0, ymm0, 0xD8
+    vmovdqu [r11 + 0], ymm2
+    vmovdqu [r11 + 96], ymm0
+    ; samples 0 to 31
+    vmovdqu ymm0, [r11 + 0]
+    vmovdqu ymm2, [r11 + 96]
+    movzx eax, word [rsi + 64]
+    vmovd xmm1, eax
+    vperm2i128 ymm6, ymm0, ymm1, 0x21
+    vpalignr ymm3, ymm6, ymm0, 2
+    vpand ymm4, ymm0, ymm3
+    vpxor ymm6, ymm0, ymm3
+    vpsraw ymm6, ymm6, 1
+    vpaddw ymm6, ymm6, ymm4
+    vpxor ymm6, ymm6, [lsym(cw7FFF)]
+    vpxor ymm4, ymm2, [lsym(cw8000)]
+    vpavgw ymm4, ymm4, ymm6
+    vpxor ymm4, ymm4, [lsym(cw8000)]
+    ; h[-1] mirrors to h[0]
+    vperm2i128 ymm6, ymm4, ymm4, 0x21
+    vpalignr ymm5, ymm4, ymm6, 14
+    vmovdqu ymm6, [lsym(cwlane0)]
+    vpblendvb ymm5, ymm5, ymm4, ymm6
+    vmovdqa ymm3, ymm4
+    vpsraw ymm3, ymm3, [r11 + 320]
+    vpaddw ymm3, ymm3, [lsym(cw1)]
+    vpsraw ymm3, ymm3, 1
+    vmovdqu [rdx], ymm3
+    vpand ymm6, ymm5, ymm4
+    vpxor ymm3, ymm5, ymm4
+    vpsraw ymm3, ymm3, 1
+    vpaddw ymm3, ymm3, ymm6
+    vpaddw ymm3, ymm3, ymm0
+    vpsraw ymm3, ymm3, [r11 + 336]
+    vpaddw ymm3, ymm3, [lsym(cw1)]
+    vpsraw ymm3, ymm3, 1
+    vmovdqu [rdi], ymm3
+    ; last low band sample
+    vextracti128 xmm5, ymm4, 1
+    vpsrldq xmm5, xmm5, 14
+    vpaddw xmm5, xmm5, xmm1
+    vpsraw xmm5, xmm5, [r11 + 336]
+    vpaddw xmm5, xmm5, [lsym(cw1)]
+    vpsraw xmm5, xmm5, 1
+    vpextrw [rdi + 32], xmm5, 0
+    ret
+
+;******************************************************************************
+; one row, 8 lanes, level 3, high band quantised, low band too
+rem_horz_lv3_q:
+    vmovdqu xmm0, [rsi]
+    vmovdqu xmm1, [rsi + 16]
+    vpslld xmm2, xmm0, 16
+    vpslld xmm3, xmm1, 16
+    vpsrad xmm2, xmm2, 16
+    vpsrad xmm3, xmm3, 16
+    vpackssdw xmm2, xmm2, xmm3
+    vpsrad xmm0, xmm0, 16
+    vpsrad xmm1, xmm1, 16
+    vpackssdw xmm0, xmm0, xmm1
+    vmovdqu [r11 + 0], xmm2
+    vmovdqu [r11 + 96], xmm0
+    ; samples 0 to 15
+    vmovdqu xmm0, [r11 + 0]
+    vmovdqu xmm2, [r11 + 96]
+    movzx eax, word [rsi + 32]
+    vmovd xmm1, eax
+    vpalignr xmm3, xmm1, xmm0, 2
+    vpand xmm4, xmm0, xmm3
+    vpxor xmm6, xmm0, xmm3
+    vpsraw xmm6, xmm6, 1
+    vpaddw xmm6, xmm6, xmm4
+    vpxor xmm6, xmm6, [lsym(cw7FFF)]
+    vpxor xmm4, xmm2, [lsym(cw8000)]
+    vpavgw xmm4, xmm4, xmm6
+    vpxor xmm4, xmm4, [lsym(cw8000)]
+    ; h[-1] mirrors to h[0]
+    vpalignr xmm5, xmm4, xmm4, 14
+    vpblendw xmm5, xmm5, xmm4, 1
+    vmovdqa xmm3, xmm4
+    vpsraw xmm3, xmm3, [r11 + 320]
+    vpaddw xmm3, xmm3, [lsym(cw1)]
+    vpsraw xmm3, xmm3, 1
+    vmovdqu [rdx], xmm3
+    vpand xmm6, xmm5, xmm4
+    vpxor xmm3, xmm5, xmm4
+    vpsraw xmm3, xmm3, 1
+    vpaddw xmm3, xmm3, xmm6
+    vpaddw xmm3, xmm3, xmm0
+    vpsraw xmm3, xmm3, [r11 + 336]
+    vpaddw xmm3, xmm3, [lsym(cw1)]
+    vpsraw xmm3, xmm3, 1
+    vmovdqu [rdi], xmm3
+    ; last low band sample
+    vpsrldq xmm5, xmm4, 14
+    vpaddw xmm5, xmm5, xmm1
+    vpsraw xmm5, xmm5, [r11 + 336]
+    vpaddw xmm5, xmm5, [lsym(cw1)]
+    vpsraw xmm5, xmm5, 1
+    vpextrw [rdi + 16], xmm5, 0
+    ret
+
+; Per System V AMD64 ABI, the first six integer or pointer arguments are
+; passed in registers RDI, RSI, RDX, RCX, R8, and R9
+
+;int
+;rfxcodec_encode_dwt_shift_rem_amd64_avx2(const unsigned char *in_buffer,
+;                                         short *out_buffer,
+;                                         short *tmp_buffer,
+;                                         const char *quants);
+; bit exact with rfx_rem_dwt_shift_encode, the lifting steps do not carry
+; out of 16 bits
+;******************************************************************************
+PROC rfxcodec_encode_dwt_shift_rem_amd64_avx2
+    ; prologue. this will make the function appear to the debugger as
+    ; having a stack frame, so that a backtrace can be obtained
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    mov r8, rdi                         ; in_buffer
+    mov r9, rsi                         ; out_buffer
+    mov r10, rdx                        ; tmp_buffer
+    sub rsp, 400
+    lea r11, [rsp + 15]
+    and r11, -16                        ; frame
+    mov [r11 + 352], rcx                ; quants
+
+    ; level 1
+    mov rsi, r8
+    mov rdi, r10
+    call rem_vert_lv1
+    lea rsi, [r8 + 16]
+    lea rdi, [r10 + 32]
+    call rem_vert_lv1
+    lea rsi, [r8 + 32]
+    lea rdi, [r10 + 64]
+    call rem_vert_lv1
+    lea rsi, [r8 + 48]
+    lea rdi, [r10 + 96]
+    call rem_vert_lv1
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 4]
+    and eax, 0xF
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 320], eax
+    mov dword [r11 + 324], 0
+    ; HL1 and LL1
+    mov rsi, r10
+    lea rdi, [r9 + 6014]
+    mov rdx, r9
+    mov ecx, 33
+rem_lv1_lo:
+    call rem_horz_lv1
+    lea rsi, [rsi + 128]
+    lea rdi, [rdi + 66]
+    lea rdx, [rdx + 62]
+    dec ecx
+    jnz rem_lv1_lo
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 4]
+    shr eax, 4
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 320], eax
+    mov dword [r11 + 324], 0
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 3]
+    shr eax, 4
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 336], eax
+    mov dword [r11 + 340], 0
+    ; HH1 and LH1
+    lea rsi, [r10 + 4224]
+    lea rdi, [r9 + 2046]
+    lea rdx, [r9 + 4092]
+    mov ecx, 31
+rem_lv1_hi:
+    call rem_horz_lv1_q
+    lea rsi, [rsi + 128]
+    lea rdi, [rdi + 66]
+    lea rdx, [rdx + 62]
+    dec ecx
+    jnz rem_lv1_hi
+
+    ; level 2
+    lea rsi, [r9 + 6014]
+    mov rdi, r10
+    call rem_vert_lv2
+    lea rsi, [r9 + 6046]
+    lea rdi, [r10 + 32]
+    call rem_vert_lv2
+    lea rsi, [r9 + 6048]
+    lea rdi, [r10 + 34]
+    call rem_vert_lv2
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 2]
+    shr eax, 4
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 320], eax
+    mov dword [r11 + 324], 0
+    ; HL2 and LL2
+    mov rsi, r10
+    lea rdi, [r9 + 7614]
+    lea rdx, [r9 + 6014]
+    mov ecx, 17
+rem_lv2_lo:
+    call rem_horz_lv2
+    lea rsi, [rsi + 66]
+    lea rdi, [rdi + 34]
+    lea rdx, [rdx + 32]
+    dec ecx
+    jnz rem_lv2_lo
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 3]
+    and eax, 0xF
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 320], eax
+    mov dword [r11 + 324], 0
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 2]
+    and eax, 0xF
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 336], eax
+    mov dword [r11 + 340], 0
+    ; HH2 and LH2
+    lea rsi, [r10 + 1122]
+    lea rdi, [r9 + 6558]
+    lea rdx, [r9 + 7102]
+    mov ecx, 16
+rem_lv2_hi:
+    call rem_horz_lv2_q
+    lea rsi, [rsi + 66]
+    lea rdi, [rdi + 34]
+    lea rdx, [rdx + 32]
+    dec ecx
+    jnz rem_lv2_hi
+
+    ; level 3
+    lea rsi, [r9 + 7614]
+    mov rdi, r10
+    call rem_vert_lv3
+    lea rsi, [r9 + 7630]
+    lea rdi, [r10 + 16]
+    call rem_vert_lv3
+    lea rsi, [r9 + 7632]
+    lea rdi, [r10 + 18]
+    call rem_vert_lv3
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 1]
+    and eax, 0xF
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 320], eax
+    mov dword [r11 + 324], 0
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 0]
+    and eax, 0xF
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 336], eax
+    mov dword [r11 + 340], 0
+    ; HL3 and LL3
+    mov rsi, r10
+    lea rdi, [r9 + 8030]
+    lea rdx, [r9 + 7614]
+    mov ecx, 9
+rem_lv3_lo:
+    call rem_horz_lv3_q
+    lea rsi, [rsi + 34]
+    lea rdi, [rdi + 18]
+    lea rdx, [rdx + 16]
+    dec ecx
+    jnz rem_lv3_lo
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 1]
+    shr eax, 4
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 320], eax
+    mov dword [r11 + 324], 0
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 0]
+    shr eax, 4
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 336], eax
+    mov dword [r11 + 340], 0
+    ; HH3 and LH3
+    lea rsi, [r10 + 306]
+    lea rdi, [r9 + 7758]
+    lea rdx, [r9 + 7902]
+    mov ecx, 8
+rem_lv3_hi:
+    call rem_horz_lv3_q
+    lea rsi, [rsi + 34]
+    lea rdi, [rdi + 18]
+    lea rdx, [rdx + 16]
+    dec ecx
+    jnz rem_lv3_hi
+
+    vzeroupper
+    add rsp, 400
+
+    ; epilogue
+%ifdef DEBUG
+    mov rsp, rbp
+    pop rbp
+%endif
+    mov eax, 0                          ; return value
+    ret
+
+END_OF_FILE
@@ -0,0 +1,1175 @@
+;
+;Copyright 2026 librfxcodec contributors
+;
+;Permission to use, copy, modify, distribute, and sell this software and its
+;documentation for any purpose is hereby granted without fee, provided that
+;the above copyright notice appear in all copies and that both that
+;copyright notice and this permission notice appear in supporting
+;documentation.
+;
+;The above copyright notice and this permission notice shall be included in
+;all copies or substantial portions of the Software.
+;
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+;IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+;FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+;OPEN GROUP BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+;AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+;CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+;
+;amd64 asm progressive reduce-extrapolate DWT, sse41
+
+%include "common.asm"
+
+PREPARE_RODATA
+    cw128    times 8 dw 128
+    cw1      times 8 dw 1
+    cw8000   times 8 dw 0x8000
+    cw7FFF   times 8 dw 0x7FFF
+    cwtop0   times 7 dw 0xFFFF
+             dw 0
+
+;******************************************************************************
+; unsigned 8 bit source, 8 columns, level 1, see rfx_rem_dwt_shift_encode_vert_lv1
+rem_vert_lv1:
+    pmovzxbw xmm0, [rsi]
+    psubw xmm0, [lsym(cw128)]
+    psllw xmm0, 5
+    pmovzxbw xmm1, [rsi + 64]
+    psubw xmm1, [lsym(cw128)]
+    psllw xmm1, 5
+    pmovzxbw xmm2, [rsi + 128]
+    psubw xmm2, [lsym(cw128)]
+    psllw xmm2, 5
+    movdqa xmm3, xmm0
+    pand xmm3, xmm2
+    movdqa xmm5, xmm0
+    pxor xmm5, xmm2
+    psraw xmm5, 1
+    paddw xmm5, xmm3
+    pxor xmm5, [lsym(cw7FFF)]
+    movdqa xmm3, xmm1
+    pxor xmm3, [lsym(cw8000)]
+    pavgw xmm3, xmm5
+    pxor xmm3, [lsym(cw8000)]
+    movdqu [rdi + 4224], xmm3
+    movdqa xmm5, xmm0
+    paddw xmm5, xmm3
+    movdqu [rdi], xmm5
+    mov ecx, 30
+rem_vert_lv1_loop:
+    lea rsi, [rsi + 128]
+    lea rdi, [rdi + 128]
+    movdqa xmm4, xmm3
+    movdqa xmm0, xmm2
+    pmovzxbw xmm1, [rsi + 64]
+    psubw xmm1, [lsym(cw128)]
+    psllw xmm1, 5
+    pmovzxbw xmm2, [rsi + 128]
+    psubw xmm2, [lsym(cw128)]
+    psllw xmm2, 5
+    movdqa xmm3, xmm0
+    pand xmm3, xmm2
+    movdqa xmm5, xmm0
+    pxor xmm5, xmm2
+    psraw xmm5, 1
+    paddw xmm5, xmm3
+    pxor xmm5, [lsym(cw7FFF)]
+    movdqa xmm3, xmm1
+    pxor xmm3, [lsym(cw8000)]
+    pavgw xmm3, xmm5
+    pxor xmm3, [lsym(cw8000)]
+    movdqu [rdi + 4224], xmm3
+    movdqa xmm6, xmm4
+    pand xmm6, xmm3
+    movdqa xmm5, xmm4
+    pxor xmm5, xmm3
+    psraw xmm5, 1
+    paddw xmm5, xmm6
+    paddw xmm5, xmm0
+    movdqu [rdi], xmm5
+    dec ecx
+    jnz rem_vert_lv1_loop
+    ; 64 = 2 * 63 - 62, 65 mirrors to 63 and 66 to 62
+    lea rsi, [rsi + 128]
+    lea rdi, [rdi + 128]
+    movdqa xmm0, xmm2
+    pmovzxbw xmm1, [rsi + 64]
+    psubw xmm1, [lsym(cw128)]
+    psllw xmm1, 5
+    movdqa xmm2, xmm1
+    paddw xmm2, xmm1
+    psubw xmm2, xmm0
+    movdqa xmm5, xmm3
+    psraw xmm5, 1
+    paddw xmm5, xmm0
+    movdqu [rdi], xmm5
+    movdqa xmm3, xmm2
+    pand xmm3, xmm0
+    movdqa xmm5, xmm2
+    pxor xmm5, xmm0
+    psraw xmm5, 1
+    paddw xmm5, xmm3
+    pxor xmm5, [lsym(cw7FFF)]
+    movdqa xmm3, xmm1
+    pxor xmm3, [lsym(cw8000)]
+    pavgw xmm3, xmm5
+    pxor xmm3, [lsym(cw8000)]
+    psraw xmm3, 1
+    paddw xmm3, xmm2
+    movdqu [rdi + 128], xmm3
+    ret
+
+;******************************************************************************
+; 8 columns, level 2, see rfx_rem_dwt_shift_encode_vert_lv2
+rem_vert_lv2:
+    movdqu xmm0, [rsi]
+    movdqu xmm1, [rsi + 66]
+    movdqu xmm2, [rsi + 132]
+    movdqa xmm3, xmm0
+    pand xmm3, xmm2
+    movdqa xmm5, xmm0
+    pxor xmm5, xmm2
+    psraw xmm5, 1
+    paddw xmm5, xmm3
+    pxor xmm5, [lsym(cw7FFF)]
+    movdqa xmm3, xmm1
+    pxor xmm3, [lsym(cw8000)]
+    pavgw xmm3, xmm5
+    pxor xmm3, [lsym(cw8000)]
+    movdqu [rdi + 1122], xmm3
+    movdqa xmm5, xmm0
+    paddw xmm5, xmm3
+    movdqu [rdi], xmm5
+    mov ecx, 15
+rem_vert_lv2_loop:
+    lea rsi, [rsi + 132]
+    lea rdi, [rdi + 66]
+    movdqa xmm4, xmm3
+    movdqa xmm0, xmm2
+    movdqu xmm1, [rsi + 66]
+    movdqu xmm2, [rsi + 132]
+    movdqa xmm3, xmm0
+    pand xmm3, xmm2
+    movdqa xmm5, xmm0
+    pxor xmm5, xmm2
+    psraw xmm5, 1
+    paddw xmm5, xmm3
+    pxor xmm5, [lsym(cw7FFF)]
+    movdqa xmm3, xmm1
+    pxor xmm3, [lsym(cw8000)]
+    pavgw xmm3, xmm5
+    pxor xmm3, [lsym(cw8000)]
+    movdqu [rdi + 1122], xmm3
+    movdqa xmm6, xmm4
+    pand xmm6, xmm3
+    movdqa xmm5, xmm4
+    pxor xmm5, xmm3
+    psraw xmm5, 1
+    paddw xmm5, xmm6
+    paddw xmm5, xmm0
+    movdqu [rdi], xmm5
+    dec ecx
+    jnz rem_vert_lv2_loop
+    ; mirrored, h[n + 1] == h[n]
+    paddw xmm2, xmm3
+    movdqu [rdi + 66], xmm2
+    ret
+
+;******************************************************************************
+; 8 columns, level 3, see rfx_rem_dwt_shift_encode_vert_lv3
+rem_vert_lv3:
+    movdqu xmm0, [rsi]
+    movdqu xmm1, [rsi + 34]
+    movdqu xmm2, [rsi + 68]
+    movdqa xmm3, xmm0
+    pand xmm3, xmm2
+    movdqa xmm5, xmm0
+    pxor xmm5, xmm2
+    psraw xmm5, 1
+    paddw xmm5, xmm3
+    pxor xmm5, [lsym(cw7FFF)]
+    movdqa xmm3, xmm1
+    pxor xmm3, [lsym(cw8000)]
+    pavgw xmm3, xmm5
+    pxor xmm3, [lsym(cw8000)]
+    movdqu [rdi + 306], xmm3
+    movdqa xmm5, xmm0
+    paddw xmm5, xmm3
+    movdqu [rdi], xmm5
+    mov ecx, 7
+rem_vert_lv3_loop:
+    lea rsi, [rsi + 68]
+    lea rdi, [rdi + 34]
+    movdqa xmm4, xmm3
+    movdqa xmm0, xmm2
+    movdqu xmm1, [rsi + 34]
+    movdqu xmm2, [rsi + 68]
+    movdqa xmm3, xmm0
+    pand xmm3, xmm2
+    movdqa xmm5, xmm0
+    pxor xmm5, xmm2
+    psraw xmm5, 1
+    paddw xmm5, xmm3
+    pxor xmm5, [lsym(cw7FFF)]
+    movdqa xmm3, xmm1
+    pxor xmm3, [lsym(cw8000)]
+    pavgw xmm3, xmm5
+    pxor xmm3, [lsym(cw8000)]
+    movdqu [rdi + 306], xmm3
+    movdqa xmm6, xmm4
+    pand xmm6, xmm3
+    movdqa xmm5, xmm4
+    pxor xmm5, xmm3
+    psraw xmm5, 1
+    paddw xmm5, xmm6
+    paddw xmm5, xmm0
+    movdqu [rdi], xmm5
+    dec ecx
+    jnz rem_vert_lv3_loop
+    ; mirrored, h[n + 1] == h[n]
+    paddw xmm2, xmm3
+    movdqu [rdi + 34], xmm2
+    ret
+
+;******************************************************************************
+; one row, 8 lanes, level 1, high band quantised
+rem_horz_lv1:
+    movdqu xmm0, [rsi]
+    movdqu xmm1, [rsi + 16]
+    movdqa xmm2, xmm0
+    pslld xmm2, 16
+    movdqa xmm3, xmm1
+    pslld xmm3, 16
+    psrad xmm2, 16
+    psrad xmm3, 16
+    packssdw xmm2, xmm3
+    psrad xmm0, 16
+    psrad xmm1, 16
+    packssdw xmm0, xmm1
+    movdqu [r11 + 0], xmm2
+    movdqu [r11 + 96], xmm0
+    movdqu xmm0, [rsi + 32]
+    movdqu xmm1, [rsi + 48]
+    movdqa xmm2, xmm0
+    pslld xmm2, 16
+    movdqa xmm3, xmm1
+    pslld xmm3, 16
+    psrad xmm2, 16
+    psrad xmm3, 16
+    packssdw xmm2, xmm3
+    psrad xmm0, 16
+    psrad xmm1, 16
+    packssdw xmm0, xmm1
+    movdqu [r11 + 16], xmm2
+    movdqu [r11 + 112], xmm0
+    movdqu xmm0, [rsi + 64]
+    movdqu xmm1, [rsi + 80]
+    movdqa xmm2, xmm0
+    pslld xmm2, 16
+    movdqa xmm3, xmm1
+    pslld xmm3, 16
+    psrad xmm2, 16
+    psrad xmm3, 16
+    packssdw xmm2, xmm3
+    psrad xmm0, 16
+    psrad xmm1, 16
+    packssdw xmm0, xmm1
+    movdqu [r11 + 32], xmm2
+    movdqu [r11 + 128], xmm0
+    movdqu xmm0, [rsi + 96]
+    movdqu xmm1, [rsi + 112]
+    movdqa xmm2, xmm0
+    pslld xmm2, 16
+    movdqa xmm3, xmm1
+    pslld xmm3, 16
+    psrad xmm2, 16
+    psrad xmm3, 16
+    packssdw xmm2, xmm3
+    psrad xmm0, 16
+    psrad xmm1, 16
+    packssdw xmm0, xmm1
+    movdqu [r11 + 48], xmm2
+    movdqu [r11 + 144], xmm0
+    ; samples 0 to 15
+    movdqu xmm0, [r11 + 0]
+    movdqu xmm2, [r11 + 96]
+    movdqu xmm1, [r11 + 16]
+    movdqa xmm3, xmm1
+    palignr xmm3, xmm0, 2
+    movdqa xmm4, xmm0
+    pand xmm4, xmm3
+    movdqa xmm6, xmm0
+    pxor xmm6, xmm3
+    psraw xmm6, 1
+    paddw xmm6, xmm4
+    pxor xmm6, [lsym(cw7FFF)]
+    movdqa xmm4, xmm2
+    pxor xmm4, [lsym(cw8000)]
+    pavgw xmm4, xmm6
+    pxor xmm4, [lsym(cw8000)]
+    ; h[-1] mirrors to h[0]
+    movdqa xmm5, xmm4
+    palignr xmm5, xmm4, 14
+    pblendw xmm5, xmm4, 1
+    movdqa xmm3, xmm4
+    psraw xmm3, [r11 + 320]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdx], xmm3
+    movdqa xmm6, xmm5
+    pand xmm6, xmm4
+    movdqa xmm3, xmm5
+    pxor xmm3, xmm4
+    psraw xmm3, 1
+    paddw xmm3, xmm6
+    paddw xmm3, xmm0
+    movdqu [rdi], xmm3
+    movdqa xmm7, xmm4
+    ; samples 16 to 31
+    movdqu xmm0, [r11 + 16]
+    movdqu xmm2, [r11 + 112]
+    movdqu xmm1, [r11 + 32]
+    movdqa xmm3, xmm1
+    palignr xmm3, xmm0, 2
+    movdqa xmm4, xmm0
+    pand xmm4, xmm3
+    movdqa xmm6, xmm0
+    pxor xmm6, xmm3
+    psraw xmm6, 1
+    paddw xmm6, xmm4
+    pxor xmm6, [lsym(cw7FFF)]
+    movdqa xmm4, xmm2
+    pxor xmm4, [lsym(cw8000)]
+    pavgw xmm4, xmm6
+    pxor xmm4, [lsym(cw8000)]
+    movdqa xmm5, xmm4
+    palignr xmm5, xmm7, 14
+    movdqa xmm3, xmm4
+    psraw xmm3, [r11 + 320]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdx + 16], xmm3
+    movdqa xmm6, xmm5
+    pand xmm6, xmm4
+    movdqa xmm3, xmm5
+    pxor xmm3, xmm4
+    psraw xmm3, 1
+    paddw xmm3, xmm6
+    paddw xmm3, xmm0
+    movdqu [rdi + 16], xmm3
+    movdqa xmm7, xmm4
+    ; samples 32 to 47
+    movdqu xmm0, [r11 + 32]
+    movdqu xmm2, [r11 + 128]
+    movdqu xmm1, [r11 + 48]
+    movdqa xmm3, xmm1
+    palignr xmm3, xmm0, 2
+    movdqa xmm4, xmm0
+    pand xmm4, xmm3
+    movdqa xmm6, xmm0
+    pxor xmm6, xmm3
+    psraw xmm6, 1
+    paddw xmm6, xmm4
+    pxor xmm6, [lsym(cw7FFF)]
+    movdqa xmm4, xmm2
+    pxor xmm4, [lsym(cw8000)]
+    pavgw xmm4, xmm6
+    pxor xmm4, [lsym(cw8000)]
+    movdqa xmm5, xmm4
+    palignr xmm5, xmm7, 14
+    movdqa xmm3, xmm4
+    psraw xmm3, [r11 + 320]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdx + 32], xmm3
+    movdqa xmm6, xmm5
+    pand xmm6, xmm4
+    movdqa xmm3, xmm5
+    pxor xmm3, xmm4
+    psraw xmm3, 1
+    paddw xmm3, xmm6
+    paddw xmm3, xmm0
+    movdqu [rdi + 32], xmm3
+    movdqa xmm7, xmm4
+    ; samples 48 to 63
+    movdqu xmm0, [r11 + 48]
+    movdqu xmm2, [r11 + 144]
+    ; 64 = 2 * 63 - 62
+    movdqa xmm3, xmm2
+    paddw xmm3, xmm2
+    psubw xmm3, xmm0
+    movdqa xmm1, xmm3
+    psrldq xmm1, 14
+    movdqa xmm3, xmm1
+    palignr xmm3, xmm0, 2
+    movdqa xmm4, xmm0
+    pand xmm4, xmm3
+    movdqa xmm6, xmm0
+    pxor xmm6, xmm3
+    psraw xmm6, 1
+    paddw xmm6, xmm4
+    pxor xmm6, [lsym(cw7FFF)]
+    movdqa xmm4, xmm2
+    pxor xmm4, [lsym(cw8000)]
+    pavgw xmm4, xmm6
+    pxor xmm4, [lsym(cw8000)]
+    movdqa xmm5, xmm4
+    palignr xmm5, xmm7, 14
+    ; h[23] to h[30] from the shifted vector, h[31] is 0
+    movdqa xmm3, xmm5
+    psraw xmm3, [r11 + 320]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdx + 46], xmm3
+    movdqa xmm3, xmm4
+    pand xmm3, [lsym(cwtop0)]
+    movdqa xmm6, xmm3
+    pand xmm6, xmm5
+    pxor xmm3, xmm5
+    psraw xmm3, 1
+    paddw xmm3, xmm6
+    paddw xmm3, xmm0
+    movdqu [rdi + 48], xmm3
+    ; last low band sample
+    movdqa xmm5, xmm4
+    psrldq xmm5, 14
+    ; 65 mirrors to 63 and 66 to 62, h from 62, 63, 64
+    psraw xmm5, 1
+    paddw xmm5, xmm1
+    pextrw [rdi + 64], xmm5, 0
+    ret
+
+;******************************************************************************
+; one row, 8 lanes, level 1, high band quantised, low band too
+rem_horz_lv1_q:
+    movdqu xmm0, [rsi]
+    movdqu xmm1, [rsi + 16]
+    movdqa xmm2, xmm0
+    pslld xmm2, 16
+    movdqa xmm3, xmm1
+    pslld xmm3, 16
+    psrad xmm2, 16
+    psrad xmm3, 16
+    packssdw xmm2, xmm3
+    psrad xmm0, 16
+    psrad xmm1, 16
+    packssdw xmm0, xmm1
+    movdqu [r11 + 0], xmm2
+    movdqu [r11 + 96], xmm0
+    movdqu xmm0, [rsi + 32]
+    movdqu xmm1, [rsi + 48]
+    movdqa xmm2, xmm0
+    pslld xmm2, 16
+    movdqa xmm3, xmm1
+    pslld xmm3, 16
+    psrad xmm2, 16
+    psrad xmm3, 16
+    packssdw xmm2, xmm3
+    psrad xmm0, 16
+    psrad xmm1, 16
+    packssdw xmm0, xmm1
+    movdqu [r11 + 16], xmm2
+    movdqu [r11 + 112], xmm0
+    movdqu xmm0, [rsi + 64]
+    movdqu xmm1, [rsi + 80]
+    movdqa xmm2, xmm0
+    pslld xmm2, 16
+    movdqa xmm3, xmm1
+    pslld xmm3, 16
+    psrad xmm2, 16
+    psrad xmm3, 16
+    packssdw xmm2, xmm3
+    psrad xmm0, 16
+    psrad xmm1, 16
+    packssdw xmm0, xmm1
+    movdqu [r11 + 32], xmm2
+    movdqu [r11 + 128], xmm0
+    movdqu xmm0, [rsi + 96]
+    movdqu xmm1, [rsi + 112]
+    movdqa xmm2, xmm0
+    pslld xmm2, 16
+    movdqa xmm3, xmm1
+    pslld xmm3, 16
+    psrad xmm2, 16
+    psrad xmm3, 16
+    packssdw xmm2, xmm3
+    psrad xmm0, 16
+    psrad xmm1, 16
+    packssdw xmm0, xmm1
+    movdqu [r11 + 48], xmm2
+    movdqu [r11 + 144], xmm0
+    ; samples 0 to 15
+    movdqu xmm0, [r11 + 0]
+    movdqu xmm2, [r11 + 96]
+    movdqu xmm1, [r11 + 16]
+    movdqa xmm3, xmm1
+    palignr xmm3, xmm0, 2
+    movdqa xmm4, xmm0
+    pand xmm4, xmm3
+    movdqa xmm6, xmm0
+    pxor xmm6, xmm3
+    psraw xmm6, 1
+    paddw xmm6, xmm4
+    pxor xmm6, [lsym(cw7FFF)]
+    movdqa xmm4, xmm2
+    pxor xmm4, [lsym(cw8000)]
+    pavgw xmm4, xmm6
+    pxor xmm4, [lsym(cw8000)]
+    ; h[-1] mirrors to h[0]
+    movdqa xmm5, xmm4
+    palignr xmm5, xmm4, 14
+    pblendw xmm5, xmm4, 1
+    movdqa xmm3, xmm4
+    psraw xmm3, [r11 + 320]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdx], xmm3
+    movdqa xmm6, xmm5
+    pand xmm6, xmm4
+    movdqa xmm3, xmm5
+    pxor xmm3, xmm4
+    psraw xmm3, 1
+    paddw xmm3, xmm6
+    paddw xmm3, xmm0
+    psraw xmm3, [r11 + 336]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdi], xmm3
+    movdqa xmm7, xmm4
+    ; samples 16 to 31
+    movdqu xmm0, [r11 + 16]
+    movdqu xmm2, [r11 + 112]
+    movdqu xmm1, [r11 + 32]
+    movdqa xmm3, xmm1
+    palignr xmm3, xmm0, 2
+    movdqa xmm4, xmm0
+    pand xmm4, xmm3
+    movdqa xmm6, xmm0
+    pxor xmm6, xmm3
+    psraw xmm6, 1
+    paddw xmm6, xmm4
+    pxor xmm6, [lsym(cw7FFF)]
+    movdqa xmm4, xmm2
+    pxor xmm4, [lsym(cw8000)]
+    pavgw xmm4, xmm6
+    pxor xmm4, [lsym(cw8000)]
+    movdqa xmm5, xmm4
+    palignr xmm5, xmm7, 14
+    movdqa xmm3, xmm4
+    psraw xmm3, [r11 + 320]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdx + 16], xmm3
+    movdqa xmm6, xmm5
+    pand xmm6, xmm4
+    movdqa xmm3, xmm5
+    pxor xmm3, xmm4
+    psraw xmm3, 1
+    paddw xmm3, xmm6
+    paddw xmm3, xmm0
+    psraw xmm3, [r11 + 336]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdi + 16], xmm3
+    movdqa xmm7, xmm4
+    ; samples 32 to 47
+    movdqu xmm0, [r11 + 32]
+    movdqu xmm2, [r11 + 128]
+    movdqu xmm1, [r11 + 48]
+    movdqa xmm3, xmm1
+    palignr xmm3, xmm0, 2
+    movdqa xmm4, xmm0
+    pand xmm4, xmm3
+    movdqa xmm6, xmm0
+    pxor xmm6, xmm3
+    psraw xmm6, 1
+    paddw xmm6, xmm4
+    pxor xmm6, [lsym(cw7FFF)]
+    movdqa xmm4, xmm2
+    pxor xmm4, [lsym(cw8000)]
+    pavgw xmm4, xmm6
+    pxor xmm4, [lsym(cw8000)]
+    movdqa xmm5, xmm4
+    palignr xmm5, xmm7, 14
+    movdqa xmm3, xmm4
+    psraw xmm3, [r11 + 320]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdx + 32], xmm3
+    movdqa xmm6, xmm5
+    pand xmm6, xmm4
+    movdqa xmm3, xmm5
+    pxor xmm3, xmm4
+    psraw xmm3, 1
+    paddw xmm3, xmm6
+    paddw xmm3, xmm0
+    psraw xmm3, [r11 + 336]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdi + 32], xmm3
+    movdqa xmm7, xmm4
+    ; samples 48 to 63
+    movdqu xmm0, [r11 + 48]
+    movdqu xmm2, [r11 + 144]
+    ; 64 = 2 * 63 - 62
+    movdqa xmm3, xmm2
+    paddw xmm3, xmm2
+    psubw xmm3, xmm0
+    movdqa xmm1, xmm3
+    psrldq xmm1, 14
+    movdqa xmm3, xmm1
+    palignr xmm3, xmm0, 2
+    movdqa xmm4, xmm0
+    pand xmm4, xmm3
+    movdqa xmm6, xmm0
+    pxor xmm6, xmm3
+    psraw xmm6, 1
+    paddw xmm6, xmm4
+    pxor xmm6, [lsym(cw7FFF)]
+    movdqa xmm4, xmm2
+    pxor xmm4, [lsym(cw8000)]
+    pavgw xmm4, xmm6
+    pxor xmm4, [lsym(cw8000)]
+    movdqa xmm5, xmm4
+    palignr xmm5, xmm7, 14
+    ; h[23] to h[30] from the shifted vector, h[31] is 0
+    movdqa xmm3, xmm5
+    psraw xmm3, [r11 + 320]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdx + 46], xmm3
+    movdqa xmm3, xmm4
+    pand xmm3, [lsym(cwtop0)]
+    movdqa xmm6, xmm3
+    pand xmm6, xmm5
+    pxor xmm3, xmm5
+    psraw xmm3, 1
+    paddw xmm3, xmm6
+    paddw xmm3, xmm0
+    psraw xmm3, [r11 + 336]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdi + 48], xmm3
+    ; last low band sample
+    movdqa xmm5, xmm4
+    psrldq xmm5, 14
+    ; 65 mirrors to 63 and 66 to 62, h from 62, 63, 64
+    psraw xmm5, 1
+    paddw xmm5, xmm1
+    psraw xmm5, [r11 + 336]
+    paddw xmm5, [lsym(cw1)]
+    psraw xmm5, 1
+    pextrw [rdi + 64], xmm5, 0
+    ret
+
+;******************************************************************************
+; one row, 8 lanes, level 2, high band quantised
+rem_horz_lv2:
+    movdqu xmm0, [rsi]
+    movdqu xmm1, [rsi + 16]
+    movdqa xmm2, xmm0
+    pslld xmm2, 16
+    movdqa xmm3, xmm1
+    pslld xmm3, 16
+    psrad xmm2, 16
+    psrad xmm3, 16
+    packssdw xmm2, xmm3
+    psrad xmm0, 16
+    psrad xmm1, 16
+    packssdw xmm0, xmm1
+    movdqu [r11 + 0], xmm2
+    movdqu [r11 + 96], xmm0
+    movdqu xmm0, [rsi + 32]
+    movdqu xmm1, [rsi + 48]
+    movdqa xmm2, xmm0
+    pslld xmm2, 16
+    movdqa xmm3, xmm1
+    pslld xmm3, 16
+    psrad xmm2, 16
+    psrad xmm3, 16
+    packssdw xmm2, xmm3
+    psrad xmm0, 16
+    psrad xmm1, 16
+    packssdw xmm0, xmm1
+    movdqu [r11 + 16], xmm2
+    movdqu [r11 + 112], xmm0
+    ; samples 0 to 15
+    movdqu xmm0, [r11 + 0]
+    movdqu xmm2, [r11 + 96]
+    movdqu xmm1, [r11 + 16]
+    movdqa xmm3, xmm1
+    palignr xmm3, xmm0, 2
+    movdqa xmm4, xmm0
+    pand xmm4, xmm3
+    movdqa xmm6, xmm0
+    pxor xmm6, xmm3
+    psraw xmm6, 1
+    paddw xmm6, xmm4
+    pxor xmm6, [lsym(cw7FFF)]
+    movdqa xmm4, xmm2
+    pxor xmm4, [lsym(cw8000)]
+    pavgw xmm4, xmm6
+    pxor xmm4, [lsym(cw8000)]
+    ; h[-1] mirrors to h[0]
+    movdqa xmm5, xmm4
+    palignr xmm5, xmm4, 14
+    pblendw xmm5, xmm4, 1
+    movdqa xmm3, xmm4
+    psraw xmm3, [r11 + 320]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdx], xmm3
+    movdqa xmm6, xmm5
+    pand xmm6, xmm4
+    movdqa xmm3, xmm5
+    pxor xmm3, xmm4
+    psraw xmm3, 1
+    paddw xmm3, xmm6
+    paddw xmm3, xmm0
+    movdqu [rdi], xmm3
+    movdqa xmm7, xmm4
+    ; samples 16 to 31
+    movdqu xmm0, [r11 + 16]
+    movdqu xmm2, [r11 + 112]
+    movzx eax, word [rsi + 64]
+    movd xmm1, eax
+    movdqa xmm3, xmm1
+    palignr xmm3, xmm0, 2
+    movdqa xmm4, xmm0
+    pand xmm4, xmm3
+    movdqa xmm6, xmm0
+    pxor xmm6, xmm3
+    psraw xmm6, 1
+    paddw xmm6, xmm4
+    pxor xmm6, [lsym(cw7FFF)]
+    movdqa xmm4, xmm2
+    pxor xmm4, [lsym(cw8000)]
+    pavgw xmm4, xmm6
+    pxor xmm4, [lsym(cw8000)]
+    movdqa xmm5, xmm4
+    palignr xmm5, xmm7, 14
+    movdqa xmm3, xmm4
+    psraw xmm3, [r11 + 320]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdx + 16], xmm3
+    movdqa xmm6, xmm5
+    pand xmm6, xmm4
+    movdqa xmm3, xmm5
+    pxor xmm3, xmm4
+    psraw xmm3, 1
+    paddw xmm3, xmm6
+    paddw xmm3, xmm0
+    movdqu [rdi + 16], xmm3
+    ; last low band sample
+    movdqa xmm5, xmm4
+    psrldq xmm5, 14
+    paddw xmm5, xmm1
+    pextrw [rdi + 32], xmm5, 0
+    ret
+
+;******************************************************************************
+; one row, 8 lanes, level 2, high band quantised, low band too
+rem_horz_lv2_q:
+    movdqu xmm0, [rsi]
+    movdqu xmm1, [rsi + 16]
+    movdqa xmm2, xmm0
+    pslld xmm2, 16
+    movdqa xmm3, xmm1
+    pslld xmm3, 16
+    psrad xmm2, 16
+    psrad xmm3, 16
+    packssdw xmm2, xmm3
+    psrad xmm0, 16
+    psrad xmm1, 16
+    packssdw xmm0, xmm1
+    movdqu [r11 + 0], xmm2
+    movdqu [r11 + 96], xmm0
+    movdqu xmm0, [rsi + 32]
+    movdqu xmm1, [rsi + 48]
+    movdqa xmm2, xmm0
+    pslld xmm2, 16
+    movdqa xmm3, xmm1
+    pslld xmm3, 16
+    psrad xmm2, 16
+    psrad xmm3, 16
+    packssdw xmm2, xmm3
+    psrad xmm0, 16
+    psrad xmm1, 16
+    packssdw xmm0, xmm1
+    movdqu [r11 + 16], xmm2
+    movdqu [r11 + 112], xmm0
+    ; samples 0 to 15
+    movdqu xmm0, [r11 + 0]
+    movdqu xmm2, [r11 + 96]
+    movdqu xmm1, [r11 + 16]
+    movdqa xmm3, xmm1
+    palignr xmm3, xmm0, 2
+    movdqa xmm4, xmm0
+    pand xmm4, xmm3
+    movdqa xmm6, xmm0
+    pxor xmm6, xmm3
+    psraw xmm6, 1
+    paddw xmm6, xmm4
+    pxor xmm6, [lsym(cw7FFF)]
+    movdqa xmm4, xmm2
+    pxor xmm4, [lsym(cw8000)]
+    pavgw xmm4, xmm6
+    pxor xmm4, [lsym(cw8000)]
+    ; h[-1] mirrors to h[0]
+    movdqa xmm5, xmm4
+    palignr xmm5, xmm4, 14
+    pblendw xmm5, xmm4, 1
+    movdqa xmm3, xmm4
+    psraw xmm3, [r11 + 320]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdx], xmm3
+    movdqa xmm6, xmm5
+    pand xmm6, xmm4
+    movdqa xmm3, xmm5
+    pxor xmm3, xmm4
+    psraw xmm3, 1
+    paddw xmm3, xmm6
+    paddw xmm3, xmm0
+    psraw xmm3, [r11 + 336]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdi], xmm3
+    movdqa xmm7, xmm4
+    ; samples 16 to 31
+    movdqu xmm0, [r11 + 16]
+    movdqu xmm2, [r11 + 112]
+    movzx eax, word [rsi + 64]
+    movd xmm1, eax
+    movdqa xmm3, xmm1
+    palignr xmm3, xmm0, 2
+    movdqa xmm4, xmm0
+    pand xmm4, xmm3
+    movdqa xmm6, xmm0
+    pxor xmm6, xmm3
+    psraw xmm6, 1
+    paddw xmm6, xmm4
+    pxor xmm6, [lsym(cw7FFF)]
+    movdqa xmm4, xmm2
+    pxor xmm4, [lsym(cw8000)]
+    pavgw xmm4, xmm6
+    pxor xmm4, [lsym(cw8000)]
+    movdqa xmm5, xmm4
+    palignr xmm5, xmm7, 14
+    movdqa xmm3, xmm4
+    psraw xmm3, [r11 + 320]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdx + 16], xmm3
+    movdqa xmm6, xmm5
+    pand xmm6, xmm4
+    movdqa xmm3, xmm5
+    pxor xmm3, xmm4
+    psraw xmm3, 1
+    paddw xmm3, xmm6
+    paddw xmm3, xmm0
+    psraw xmm3, [r11 + 336]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdi + 16], xmm3
+    ; last low band sample
+    movdqa xmm5, xmm4
+    psrldq xmm5, 14
+    paddw xmm5, xmm1
+    psraw xmm5, [r11 + 336]
+    paddw xmm5, [lsym(cw1)]
+    psraw xmm5, 1
+    pextrw [rdi + 32], xmm5, 0
+    ret
+
+;******************************************************************************
+; one row, 8 lanes, level 3, high band quantised, low band too
+rem_horz_lv3_q:
+    movdqu xmm0, [rsi]
+    movdqu xmm1, [rsi + 16]
+    movdqa xmm2, xmm0
+    pslld xmm2, 16
+    movdqa xmm3, xmm1
+    pslld xmm3, 16
+    psrad xmm2, 16
+    psrad xmm3, 16
+    packssdw xmm2, xmm3
+    psrad xmm0, 16
+    psrad xmm1, 16
+    packssdw xmm0, xmm1
+    movdqu [r11 + 0], xmm2
+    movdqu [r11 + 96], xmm0
+    ; samples 0 to 15
+    movdqu xmm0, [r11 + 0]
+    movdqu xmm2, [r11 + 96]
+    movzx eax, word [rsi + 32]
+    movd xmm1, eax
+    movdqa xmm3, xmm1
+    palignr xmm3, xmm0, 2
+    movdqa xmm4, xmm0
+    pand xmm4, xmm3
+    movdqa xmm6, xmm0
+    pxor xmm6, xmm3
+    psraw xmm6, 1
+    paddw xmm6, xmm4
+    pxor xmm6, [lsym(cw7FFF)]
+    movdqa xmm4, xmm2
+    pxor xmm4, [lsym(cw8000)]
+    pavgw xmm4, xmm6
+    pxor xmm4, [lsym(cw8000)]
+    ; h[-1] mirrors to h[0]
+    movdqa xmm5, xmm4
+    palignr xmm5, xmm4, 14
+    pblendw xmm5, xmm4, 1
+    movdqa xmm3, xmm4
+    psraw xmm3, [r11 + 320]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdx], xmm3
+    movdqa xmm6, xmm5
+    pand xmm6, xmm4
+    movdqa xmm3, xmm5
+    pxor xmm3, xmm4
+    psraw xmm3, 1
+    paddw xmm3, xmm6
+    paddw xmm3, xmm0
+    psraw xmm3, [r11 + 336]
+    paddw xmm3, [lsym(cw1)]
+    psraw xmm3, 1
+    movdqu [rdi], xmm3
+    ; last low band sample
+    movdqa xmm5, xmm4
+    psrldq xmm5, 14
+    paddw xmm5, xmm1
+    psraw xmm5, [r11 + 336]
+    paddw xmm5, [lsym(cw1)]
+    psraw xmm5, 1
+    pextrw [rdi + 16], xmm5, 0
+    ret
+
+; Per System V AMD64 ABI, the first six integer or pointer arguments are
+; passed in registers RDI, RSI, RDX, RCX, R8, and R9
+
+;int
+;rfxcodec_encode_dwt_shift_rem_amd64_sse41(const unsigned char *in_buffer,
+;                                          short *out_buffer,
+;                                          short *tmp_buffer,
+;                                          const char *quants);
+; bit exact with rfx_rem_dwt_shift_encode, the lifting steps do not carry
+; out of 16 bits
+;******************************************************************************
+PROC rfxcodec_encode_dwt_shift_rem_amd64_sse41
+    ; prologue. this will make the function appear to the debugger as
+    ; having a stack frame, so that a backtrace can be obtained
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    mov r8, rdi                         ; in_buffer
+    mov r9, rsi                         ; out_buffer
+    mov r10, rdx                        ; tmp_buffer
+    sub rsp, 400
+    lea r11, [rsp + 15]
+    and r11, -16                        ; frame
+    mov [r11 + 352], rcx                ; quants
+
+    ; level 1
+    mov rsi, r8
+    mov rdi, r10
+    call rem_vert_lv1
+    lea rsi, [r8 + 8]
+    lea rdi, [r10 + 16]
+    call rem_vert_lv1
+    lea rsi, [r8 + 16]
+    lea rdi, [r10 + 32]
+    call rem_vert_lv1
+    lea rsi, [r8 + 24]
+    lea rdi, [r10 + 48]
+    call rem_vert_lv1
+    lea rsi, [r8 + 32]
+    lea rdi, [r10 + 64]
+    call rem_vert_lv1
+    lea rsi, [r8 + 40]
+    lea rdi, [r10 + 80]
+    call rem_vert_lv1
+    lea rsi, [r8 + 48]
+    lea rdi, [r10 + 96]
+    call rem_vert_lv1
+    lea rsi, [r8 + 56]
+    lea rdi, [r10 + 112]
+    call rem_vert_lv1
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 4]
+    and eax, 0xF
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 320], eax
+    mov dword [r11 + 324], 0
+    ; HL1 and LL1
+    mov rsi, r10
+    lea rdi, [r9 + 6014]
+    mov rdx, r9
+    mov ecx, 33
+rem_lv1_lo:
+    call rem_horz_lv1
+    lea rsi, [rsi + 128]
+    lea rdi, [rdi + 66]
+    lea rdx, [rdx + 62]
+    dec ecx
+    jnz rem_lv1_lo
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 4]
+    shr eax, 4
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 320], eax
+    mov dword [r11 + 324], 0
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 3]
+    shr eax, 4
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 336], eax
+    mov dword [r11 + 340], 0
+    ; HH1 and LH1
+    lea rsi, [r10 + 4224]
+    lea rdi, [r9 + 2046]
+    lea rdx, [r9 + 4092]
+    mov ecx, 31
+rem_lv1_hi:
+    call rem_horz_lv1_q
+    lea rsi, [rsi + 128]
+    lea rdi, [rdi + 66]
+    lea rdx, [rdx + 62]
+    dec ecx
+    jnz rem_lv1_hi
+
+    ; level 2
+    lea rsi, [r9 + 6014]
+    mov rdi, r10
+    call rem_vert_lv2
+    lea rsi, [r9 + 6030]
+    lea rdi, [r10 + 16]
+    call rem_vert_lv2
+    lea rsi, [r9 + 6046]
+    lea rdi, [r10 + 32]
+    call rem_vert_lv2
+    lea rsi, [r9 + 6062]
+    lea rdi, [r10 + 48]
+    call rem_vert_lv2
+    lea rsi, [r9 + 6064]
+    lea rdi, [r10 + 50]
+    call rem_vert_lv2
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 2]
+    shr eax, 4
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 320], eax
+    mov dword [r11 + 324], 0
+    ; HL2 and LL2
+    mov rsi, r10
+    lea rdi, [r9 + 7614]
+    lea rdx, [r9 + 6014]
+    mov ecx, 17
+rem_lv2_lo:
+    call rem_horz_lv2
+    lea rsi, [rsi + 66]
+    lea rdi, [rdi + 34]
+    lea rdx, [rdx + 32]
+    dec ecx
+    jnz rem_lv2_lo
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 3]
+    and eax, 0xF
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 320], eax
+    mov dword [r11 + 324], 0
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 2]
+    and eax, 0xF
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 336], eax
+    mov dword [r11 + 340], 0
+    ; HH2 and LH2
+    lea rsi, [r10 + 1122]
+    lea rdi, [r9 + 6558]
+    lea rdx, [r9 + 7102]
+    mov ecx, 16
+rem_lv2_hi:
+    call rem_horz_lv2_q
+    lea rsi, [rsi + 66]
+    lea rdi, [rdi + 34]
+    lea rdx, [rdx + 32]
+    dec ecx
+    jnz rem_lv2_hi
+
+    ; level 3
+    lea rsi, [r9 + 7614]
+    mov rdi, r10
+    call rem_vert_lv3
+    lea rsi, [r9 + 7630]
+    lea rdi, [r10 + 16]
+    call rem_vert_lv3
+    lea rsi, [r9 + 7632]
+    lea rdi, [r10 + 18]
+    call rem_vert_lv3
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 1]
+    and eax, 0xF
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 320], eax
+    mov dword [r11 + 324], 0
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 0]
+    and eax, 0xF
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 336], eax
+    mov dword [r11 + 340], 0
+    ; HL3 and LL3
+    mov rsi, r10
+    lea rdi, [r9 + 8030]
+    lea rdx, [r9 + 7614]
+    mov ecx, 9
+rem_lv3_lo:
+    call rem_horz_lv3_q
+    lea rsi, [rsi + 34]
+    lea rdi, [rdi + 18]
+    lea rdx, [rdx + 16]
+    dec ecx
+    jnz rem_lv3_lo
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 1]
+    shr eax, 4
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 320], eax
+    mov dword [r11 + 324], 0
+    mov rax, [r11 + 352]
+    movzx eax, byte [rax + 0]
+    shr eax, 4
+    sub eax, 2                          ; fact - 1
+    mov dword [r11 + 336], eax
+    mov dword [r11 + 340], 0
+    ; HH3 and LH3
+    lea rsi, [r10 + 306]
+    lea rdi, [r9 + 7758]
+    lea rdx, [r9 + 7902]
+    mov ecx, 8
+rem_lv3_hi:
+    call rem_horz_lv3_q
+    lea rsi, [rsi + 34]
+    lea rdi, [rdi + 18]
+    lea rdx, [rdx + 16]
+    dec ecx
+    jnz rem_lv3_hi
+
+    add rsp, 400
+
+    ; epilogue
+%ifdef DEBUG
+    mov rsp, rbp
+    pop rbp
+%endif
+    mov eax, 0                          ; return value
+    ret
+
+END_OF_FILE
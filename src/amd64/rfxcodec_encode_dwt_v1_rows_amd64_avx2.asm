@@ -0,0 +1,240 @@
+;
+;Copyright 2026 librfxcodec contributors
+;
+;Permission to use, copy, modify, distribute, and sell this software and its
+;documentation for any purpose is hereby granted without fee, provided that
+;the above copyright notice appear in all copies and that both that
+;copyright notice and this permission notice appear in supporting
+;documentation.
+;
+;The above copyright notice and this permission notice shall be included in
+;all copies or substantial portions of the Software.
+;
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+;IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+;FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+;OPEN GROUP BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+;AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+;CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+;
+;amd64 asm level 1 vertical DWT row pair, avx2, 16 columns per step
+
+%include "common.asm"
+
+PREPARE_RODATA
+    cw128    times 16 dw 128
+
+; Per System V AMD64 ABI, the first six integer or pointer arguments are
+; passed in registers RDI, RSI, RDX, RCX, R8, and R9
+
+;******************************************************************************
+;int
+;rfxcodec_encode_dwt_v1_rows_amd64_avx2(const unsigned char *s0,
+;                                       const unsigned char *s1,
+;                                       const unsigned char *s2,
+;                                       int n,
+;                                       short *y_v1,
+;                                       short *u_v1,
+;                                       short *v_v1);
+; s0, s1 and s2 are rows 2n, 2n + 1 and 2n + 2, each the y, u then v
+; 64 bytes, see rfx_dwt_2d_encode_v1_rows
+PROC rfxcodec_encode_dwt_v1_rows_amd64_avx2
+    ; stack arg first, the prologue moves rsp
+    mov r10, [rsp + 8]                  ; v_v1
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    ; y, u, v buffers in order on the stack
+    push r10
+    push r9
+    push r8
+    mov r10, rsp
+    vmovdqu ymm6, [lsym(cw128)]
+    movsxd rax, ecx
+    shl rax, 7                          ; n * 64 * 2, row offset
+    mov ecx, 3                          ; components
+    test rax, rax
+    jz loop_first
+
+loop_pair:
+    mov r8, [r10]                       ; v1 buffer of this component
+    ; columns 0 to 15
+    vpmovzxbw ymm0, [rdi + 0]
+    vpsubw ymm0, ymm0, ymm6
+    vpsllw ymm0, ymm0, 5                ; DWT_FACTOR
+    vpmovzxbw ymm1, [rsi + 0]
+    vpsubw ymm1, ymm1, ymm6
+    vpsllw ymm1, ymm1, 5                ; DWT_FACTOR
+    vpmovzxbw ymm2, [rdx + 0]
+    vpsubw ymm2, ymm2, ymm6
+    vpsllw ymm2, ymm2, 5                ; DWT_FACTOR
+    vpaddw ymm2, ymm2, ymm0
+    vpsraw ymm2, ymm2, 1
+    vpsubw ymm1, ymm1, ymm2
+    vpsraw ymm1, ymm1, 1                ; h
+    vmovdqu [r8 + rax + 4096], ymm1
+    vpaddw ymm1, ymm1, [r8 + rax + 3968]; h of the pair before
+    vpsraw ymm1, ymm1, 1
+    vpaddw ymm0, ymm0, ymm1             ; l
+    vmovdqu [r8 + rax + 0], ymm0
+    ; columns 16 to 31
+    vpmovzxbw ymm0, [rdi + 16]
+    vpsubw ymm0, ymm0, ymm6
+    vpsllw ymm0, ymm0, 5                ; DWT_FACTOR
+    vpmovzxbw ymm1, [rsi + 16]
+    vpsubw ymm1, ymm1, ymm6
+    vpsllw ymm1, ymm1, 5                ; DWT_FACTOR
+    vpmovzxbw ymm2, [rdx + 16]
+    vpsubw ymm2, ymm2, ymm6
+    vpsllw ymm2, ymm2, 5                ; DWT_FACTOR
+    vpaddw ymm2, ymm2, ymm0
+    vpsraw ymm2, ymm2, 1
+    vpsubw ymm1, ymm1, ymm2
+    vpsraw ymm1, ymm1, 1                ; h
+    vmovdqu [r8 + rax + 4128], ymm1
+    vpaddw ymm1, ymm1, [r8 + rax + 4000]; h of the pair before
+    vpsraw ymm1, ymm1, 1
+    vpaddw ymm0, ymm0, ymm1             ; l
+    vmovdqu [r8 + rax + 32], ymm0
+    ; columns 32 to 47
+    vpmovzxbw ymm0, [rdi + 32]
+    vpsubw ymm0, ymm0, ymm6
+    vpsllw ymm0, ymm0, 5                ; DWT_FACTOR
+    vpmovzxbw ymm1, [rsi + 32]
+    vpsubw ymm1, ymm1, ymm6
+    vpsllw ymm1, ymm1, 5                ; DWT_FACTOR
+    vpmovzxbw ymm2, [rdx + 32]
+    vpsubw ymm2, ymm2, ymm6
+    vpsllw ymm2, ymm2, 5                ; DWT_FACTOR
+    vpaddw ymm2, ymm2, ymm0
+    vpsraw ymm2, ymm2, 1
+    vpsubw ymm1, ymm1, ymm2
+    vpsraw ymm1, ymm1, 1                ; h
+    vmovdqu [r8 + rax + 4160], ymm1
+    vpaddw ymm1, ymm1, [r8 + rax + 4032]; h of the pair before
+    vpsraw ymm1, ymm1, 1
+    vpaddw ymm0, ymm0, ymm1             ; l
+    vmovdqu [r8 + rax + 64], ymm0
+    ; columns 48 to 63
+    vpmovzxbw ymm0, [rdi + 48]
+    vpsubw ymm0, ymm0, ymm6
+    vpsllw ymm0, ymm0, 5                ; DWT_FACTOR
+    vpmovzxbw ymm1, [rsi + 48]
+    vpsubw ymm1, ymm1, ymm6
+    vpsllw ymm1, ymm1, 5                ; DWT_FACTOR
+    vpmovzxbw ymm2, [rdx + 48]
+    vpsubw ymm2, ymm2, ymm6
+    vpsllw ymm2, ymm2, 5                ; DWT_FACTOR
+    vpaddw ymm2, ymm2, ymm0
+    vpsraw ymm2, ymm2, 1
+    vpsubw ymm1, ymm1, ymm2
+    vpsraw ymm1, ymm1, 1                ; h
+    vmovdqu [r8 + rax + 4192], ymm1
+    vpaddw ymm1, ymm1, [r8 + rax + 4064]; h of the pair before
+    vpsraw ymm1, ymm1, 1
+    vpaddw ymm0, ymm0, ymm1             ; l
+    vmovdqu [r8 + rax + 96], ymm0
+    ; next component
+    lea rdi, [rdi + 64]
+    lea rsi, [rsi + 64]
+    lea rdx, [rdx + 64]
+    lea r10, [r10 + 8]
+    dec ecx
+    jnz loop_pair
+    jmp loop_done
+
+    ; first pair, no h before
+loop_first:
+    mov r8, [r10]                       ; v1 buffer of this component
+    ; columns 0 to 15
+    vpmovzxbw ymm0, [rdi + 0]
+    vpsubw ymm0, ymm0, ymm6
+    vpsllw ymm0, ymm0, 5                ; DWT_FACTOR
+    vpmovzxbw ymm1, [rsi + 0]
+    vpsubw ymm1, ymm1, ymm6
+    vpsllw ymm1, ymm1, 5                ; DWT_FACTOR
+    vpmovzxbw ymm2, [rdx + 0]
+    vpsubw ymm2, ymm2, ymm6
+    vpsllw ymm2, ymm2, 5                ; DWT_FACTOR
+    vpaddw ymm2, ymm2, ymm0
+    vpsraw ymm2, ymm2, 1
+    vpsubw ymm1, ymm1, ymm2
+    vpsraw ymm1, ymm1, 1                ; h
+    vmovdqu [r8 + rax + 4096], ymm1
+    vpaddw ymm0, ymm0, ymm1             ; l
+    vmovdqu [r8 + rax + 0], ymm0
+    ; columns 16 to 31
+    vpmovzxbw ymm0, [rdi + 16]
+    vpsubw ymm0, ymm0, ymm6
+    vpsllw ymm0, ymm0, 5                ; DWT_FACTOR
+    vpmovzxbw ymm1, [rsi + 16]
+    vpsubw ymm1, ymm1, ymm6
+    vpsllw ymm1, ymm1, 5                ; DWT_FACTOR
+    vpmovzxbw ymm2, [rdx + 16]
+    vpsubw ymm2, ymm2, ymm6
+    vpsllw ymm2, ymm2, 5                ; DWT_FACTOR
+    vpaddw ymm2, ymm2, ymm0
+    vpsraw ymm2, ymm2, 1
+    vpsubw ymm1, ymm1, ymm2
+    vpsraw ymm1, ymm1, 1                ; h
+    vmovdqu [r8 + rax + 4128], ymm1
+    vpaddw ymm0, ymm0, ymm1             ; l
+    vmovdqu [r8 + rax + 32], ymm0
+    ; columns 32 to 47
+    vpmovzxbw ymm0, [rdi + 32]
+    vpsubw ymm0, ymm0, ymm6
+    vpsllw ymm0, ymm0, 5                ; DWT_FACTOR
+    vpmovzxbw ymm1, [rsi + 32]
+    vpsubw ymm1, ymm1, ymm6
+    vpsllw ymm1, ymm1, 5                ; DWT_FACTOR
+    vpmovzxbw ymm2, [rdx + 32]
+    vpsubw ymm2, ymm2, ymm6
+    vpsllw ymm2, ymm2, 5                ; DWT_FACTOR
+    vpaddw ymm2, ymm2, ymm0
+    vpsraw ymm2, ymm2, 1
+    vpsubw ymm1, ymm1, ymm2
+    vpsraw ymm1, ymm1, 1                ; h
+    vmovdqu [r8 + rax + 4160], ymm1
+    vpaddw ymm0, ymm0, ymm1             ; l
+    vmovdqu [r8 + rax + 64], ymm0
+    ; columns 48 to 63
+    vpmovzxbw ymm0, [rdi + 48]
+    vpsubw ymm0, ymm0, ymm6
+    vpsllw ymm0, ymm0, 5                ; DWT_FACTOR
+    vpmovzxbw ymm1, [rsi + 48]
+    vpsubw ymm1, ymm1, ymm6
+    vpsllw ymm1, ymm1, 5                ; DWT_FACTOR
+    vpmovzxbw ymm2, [rdx + 48]
+    vpsubw ymm2, ymm2, ymm6
+    vpsllw ymm2, ymm2, 5                ; DWT_FACTOR
+    vpaddw ymm2, ymm2, ymm0
+    vpsraw ymm2, ymm2, 1
+    vpsubw ymm1, ymm1, ymm2
+    vpsraw ymm1, ymm1, 1                ; h
+    vmovdqu [r8 + rax + 4192], ymm1
+    vpaddw ymm0, ymm0, ymm1             ; l
+    vmovdqu [r8 + rax + 96], ymm0
+    ; next component
+    lea rdi, [rdi + 64]
+    lea rsi, [rsi + 64]
+    lea rdx, [rdx + 64]
+    lea r10, [r10 + 8]
+    dec ecx
+    jnz loop_first
+
+loop_done:
+    vzeroupper
+    add rsp, 24
+
+    ; epilogue
+%ifdef DEBUG
+    mov rsp, rbp
+    pop rbp
+%endif
+
+    mov eax, 0                          ; return value
+    ret
+
+END_OF_FILE
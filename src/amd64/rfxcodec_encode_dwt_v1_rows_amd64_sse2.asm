@@ -0,0 +1,432 @@
+;
+;Copyright 2026 librfxcodec contributors
+;
+;Permission to use, copy, modify, distribute, and sell this software and its
+;documentation for any purpose is hereby granted without fee, provided that
+;the above copyright notice appear in all copies and that both that
+;copyright notice and this permission notice appear in supporting
+;documentation.
+;
+;The above copyright notice and this permission notice shall be included in
+;all copies or substantial portions of the Software.
+;
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+;IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+;FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+;OPEN GROUP BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+;AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+;CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+;
+;amd64 asm level 1 vertical DWT row pair, sse2, 16 columns per step
+
+%include "common.asm"
+
+PREPARE_RODATA
+    cw128    times 8 dw 128
+
+; Per System V AMD64 ABI, the first six integer or pointer arguments are
+; passed in registers RDI, RSI, RDX, RCX, R8, and R9
+
+;******************************************************************************
+;int
+;rfxcodec_encode_dwt_v1_rows_amd64_sse2(const unsigned char *s0,
+;                                       const unsigned char *s1,
+;                                       const unsigned char *s2,
+;                                       int n,
+;                                       short *y_v1,
+;                                       short *u_v1,
+;                                       short *v_v1);
+; s0, s1 and s2 are rows 2n, 2n + 1 and 2n + 2, each the y, u then v
+; 64 bytes, see rfx_dwt_2d_encode_v1_rows
+PROC rfxcodec_encode_dwt_v1_rows_amd64_sse2
+    ; stack arg first, the prologue moves rsp
+    mov r10, [rsp + 8]                  ; v_v1
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    ; y, u, v buffers in order on the stack
+    push r10
+    push r9
+    push r8
+    mov r10, rsp
+    pxor xmm7, xmm7
+    movdqa xmm6, [lsym(cw128)]
+    movsxd rax, ecx
+    shl rax, 7                          ; n * 64 * 2, row offset
+    mov ecx, 3                          ; components
+    test rax, rax
+    jz loop_first
+
+loop_pair:
+    mov r8, [r10]                       ; v1 buffer of this component
+    ; columns 0 to 15
+    movdqu xmm0, [rdi + 0]
+    movdqa xmm3, xmm0
+    punpcklbw xmm0, xmm7
+    punpckhbw xmm3, xmm7
+    psubw xmm0, xmm6
+    psllw xmm0, 5                       ; DWT_FACTOR
+    psubw xmm3, xmm6
+    psllw xmm3, 5                       ; DWT_FACTOR
+    movdqu xmm1, [rsi + 0]
+    movdqa xmm4, xmm1
+    punpcklbw xmm1, xmm7
+    punpckhbw xmm4, xmm7
+    psubw xmm1, xmm6
+    psllw xmm1, 5                       ; DWT_FACTOR
+    psubw xmm4, xmm6
+    psllw xmm4, 5                       ; DWT_FACTOR
+    movdqu xmm2, [rdx + 0]
+    movdqa xmm5, xmm2
+    punpcklbw xmm2, xmm7
+    punpckhbw xmm5, xmm7
+    psubw xmm2, xmm6
+    psllw xmm2, 5                       ; DWT_FACTOR
+    psubw xmm5, xmm6
+    psllw xmm5, 5                       ; DWT_FACTOR
+    paddw xmm2, xmm0
+    psraw xmm2, 1
+    psubw xmm1, xmm2
+    psraw xmm1, 1                       ; h
+    movdqu [r8 + rax + 4096], xmm1
+    movdqu xmm2, [r8 + rax + 3968]      ; h of the pair before
+    paddw xmm1, xmm2
+    psraw xmm1, 1
+    paddw xmm0, xmm1                    ; l
+    movdqu [r8 + rax + 0], xmm0
+    paddw xmm5, xmm3
+    psraw xmm5, 1
+    psubw xmm4, xmm5
+    psraw xmm4, 1                       ; h
+    movdqu [r8 + rax + 4112], xmm4
+    movdqu xmm5, [r8 + rax + 3984]      ; h of the pair before
+    paddw xmm4, xmm5
+    psraw xmm4, 1
+    paddw xmm3, xmm4                    ; l
+    movdqu [r8 + rax + 16], xmm3
+    ; columns 16 to 31
+    movdqu xmm0, [rdi + 16]
+    movdqa xmm3, xmm0
+    punpcklbw xmm0, xmm7
+    punpckhbw xmm3, xmm7
+    psubw xmm0, xmm6
+    psllw xmm0, 5                       ; DWT_FACTOR
+    psubw xmm3, xmm6
+    psllw xmm3, 5                       ; DWT_FACTOR
+    movdqu xmm1, [rsi + 16]
+    movdqa xmm4, xmm1
+    punpcklbw xmm1, xmm7
+    punpckhbw xmm4, xmm7
+    psubw xmm1, xmm6
+    psllw xmm1, 5                       ; DWT_FACTOR
+    psubw xmm4, xmm6
+    psllw xmm4, 5                       ; DWT_FACTOR
+    movdqu xmm2, [rdx + 16]
+    movdqa xmm5, xmm2
+    punpcklbw xmm2, xmm7
+    punpckhbw xmm5, xmm7
+    psubw xmm2, xmm6
+    psllw xmm2, 5                       ; DWT_FACTOR
+    psubw xmm5, xmm6
+    psllw xmm5, 5                       ; DWT_FACTOR
+    paddw xmm2, xmm0
+    psraw xmm2, 1
+    psubw xmm1, xmm2
+    psraw xmm1, 1                       ; h
+    movdqu [r8 + rax + 4128], xmm1
+    movdqu xmm2, [r8 + rax + 4000]      ; h of the pair before
+    paddw xmm1, xmm2
+    psraw xmm1, 1
+    paddw xmm0, xmm1                    ; l
+    movdqu [r8 + rax + 32], xmm0
+    paddw xmm5, xmm3
+    psraw xmm5, 1
+    psubw xmm4, xmm5
+    psraw xmm4, 1                       ; h
+    movdqu [r8 + rax + 4144], xmm4
+    movdqu xmm5, [r8 + rax + 4016]      ; h of the pair before
+    paddw xmm4, xmm5
+    psraw xmm4, 1
+    paddw xmm3, xmm4                    ; l
+    movdqu [r8 + rax + 48], xmm3
+    ; columns 32 to 47
+    movdqu xmm0, [rdi + 32]
+    movdqa xmm3, xmm0
+    punpcklbw xmm0, xmm7
+    punpckhbw xmm3, xmm7
+    psubw xmm0, xmm6
+    psllw xmm0, 5                       ; DWT_FACTOR
+    psubw xmm3, xmm6
+    psllw xmm3, 5                       ; DWT_FACTOR
+    movdqu xmm1, [rsi + 32]
+    movdqa xmm4, xmm1
+    punpcklbw xmm1, xmm7
+    punpckhbw xmm4, xmm7
+    psubw xmm1, xmm6
+    psllw xmm1, 5                       ; DWT_FACTOR
+    psubw xmm4, xmm6
+    psllw xmm4, 5                       ; DWT_FACTOR
+    movdqu xmm2, [rdx + 32]
+    movdqa xmm5, xmm2
+    punpcklbw xmm2, xmm7
+    punpckhbw xmm5, xmm7
+    psubw xmm2, xmm6
+    psllw xmm2, 5                       ; DWT_FACTOR
+    psubw xmm5, xmm6
+    psllw xmm5, 5                       ; DWT_FACTOR
+    paddw xmm2, xmm0
+    psraw xmm2, 1
+    psubw xmm1, xmm2
+    psraw xmm1, 1                       ; h
+    movdqu [r8 + rax + 4160], xmm1
+    movdqu xmm2, [r8 + rax + 4032]      ; h of the pair before
+    paddw xmm1, xmm2
+    psraw xmm1, 1
+    paddw xmm0, xmm1                    ; l
+    movdqu [r8 + rax + 64], xmm0
+    paddw xmm5, xmm3
+    psraw xmm5, 1
+    psubw xmm4, xmm5
+    psraw xmm4, 1                       ; h
+    movdqu [r8 + rax + 4176], xmm4
+    movdqu xmm5, [r8 + rax + 4048]      ; h of the pair before
+    paddw xmm4, xmm5
+    psraw xmm4, 1
+    paddw xmm3, xmm4                    ; l
+    movdqu [r8 + rax + 80], xmm3
+    ; columns 48 to 63
+    movdqu xmm0, [rdi + 48]
+    movdqa xmm3, xmm0
+    punpcklbw xmm0, xmm7
+    punpckhbw xmm3, xmm7
+    psubw xmm0, xmm6
+    psllw xmm0, 5                       ; DWT_FACTOR
+    psubw xmm3, xmm6
+    psllw xmm3, 5                       ; DWT_FACTOR
+    movdqu xmm1, [rsi + 48]
+    movdqa xmm4, xmm1
+    punpcklbw xmm1, xmm7
+    punpckhbw xmm4, xmm7
+    psubw xmm1, xmm6
+    psllw xmm1, 5                       ; DWT_FACTOR
+    psubw xmm4, xmm6
+    psllw xmm4, 5                       ; DWT_FACTOR
+    movdqu xmm2, [rdx + 48]
+    movdqa xmm5, xmm2
+    punpcklbw xmm2, xmm7
+    punpckhbw xmm5, xmm7
+    psubw xmm2, xmm6
+    psllw xmm2, 5                       ; DWT_FACTOR
+    psubw xmm5, xmm6
+    psllw xmm5, 5                       ; DWT_FACTOR
+    paddw xmm2, xmm0
+    psraw xmm2, 1
+    psubw xmm1, xmm2
+    psraw xmm1, 1                       ; h
+    movdqu [r8 + rax + 4192], xmm1
+    movdqu xmm2, [r8 + rax + 4064]      ; h of the pair before
+    paddw xmm1, xmm2
+    psraw xmm1, 1
+    paddw xmm0, xmm1                    ; l
+    movdqu [r8 + rax + 96], xmm0
+    paddw xmm5, xmm3
+    psraw xmm5, 1
+    psubw xmm4, xmm5
+    psraw xmm4, 1                       ; h
+    movdqu [r8 + rax + 4208], xmm4
+    movdqu xmm5, [r8 + rax + 4080]      ; h of the pair before
+    paddw xmm4, xmm5
+    psraw xmm4, 1
+    paddw xmm3, xmm4                    ; l
+    movdqu [r8 + rax + 112], xmm3
+    ; next component
+    lea rdi, [rdi + 64]
+    lea rsi, [rsi + 64]
+    lea rdx, [rdx + 64]
+    lea r10, [r10 + 8]
+    dec ecx
+    jnz loop_pair
+    jmp loop_done
+
+    ; first pair, no h before
+loop_first:
+    mov r8, [r10]                       ; v1 buffer of this component
+    ; columns 0 to 15
+    movdqu xmm0, [rdi + 0]
+    movdqa xmm3, xmm0
+    punpcklbw xmm0, xmm7
+    punpckhbw xmm3, xmm7
+    psubw xmm0, xmm6
+    psllw xmm0, 5                       ; DWT_FACTOR
+    psubw xmm3, xmm6
+    psllw xmm3, 5                       ; DWT_FACTOR
+    movdqu xmm1, [rsi + 0]
+    movdqa xmm4, xmm1
+    punpcklbw xmm1, xmm7
+    punpckhbw xmm4, xmm7
+    psubw xmm1, xmm6
+    psllw xmm1, 5                       ; DWT_FACTOR
+    psubw xmm4, xmm6
+    psllw xmm4, 5                       ; DWT_FACTOR
+    movdqu xmm2, [rdx + 0]
+    movdqa xmm5, xmm2
+    punpcklbw xmm2, xmm7
+    punpckhbw xmm5, xmm7
+    psubw xmm2, xmm6
+    psllw xmm2, 5                       ; DWT_FACTOR
+    psubw xmm5, xmm6
+    psllw xmm5, 5                       ; DWT_FACTOR
+    paddw xmm2, xmm0
+    psraw xmm2, 1
+    psubw xmm1, xmm2
+    psraw xmm1, 1                       ; h
+    movdqu [r8 + rax + 4096], xmm1
+    paddw xmm0, xmm1                    ; l
+    movdqu [r8 + rax + 0], xmm0
+    paddw xmm5, xmm3
+    psraw xmm5, 1
+    psubw xmm4, xmm5
+    psraw xmm4, 1                       ; h
+    movdqu [r8 + rax + 4112], xmm4
+    paddw xmm3, xmm4                    ; l
+    movdqu [r8 + rax + 16], xmm3
+    ; columns 16 to 31
+    movdqu xmm0, [rdi + 16]
+    movdqa xmm3, xmm0
+    punpcklbw xmm0, xmm7
+    punpckhbw xmm3, xmm7
+    psubw xmm0, xmm6
+    psllw xmm0, 5                       ; DWT_FACTOR
+    psubw xmm3, xmm6
+    psllw xmm3, 5                       ; DWT_FACTOR
+    movdqu xmm1, [rsi + 16]
+    movdqa xmm4, xmm1
+    punpcklbw xmm1, xmm7
+    punpckhbw xmm4, xmm7
+    psubw xmm1, xmm6
+    psllw xmm1, 5                       ; DWT_FACTOR
+    psubw xmm4, xmm6
+    psllw xmm4, 5                       ; DWT_FACTOR
+    movdqu xmm2, [rdx + 16]
+    movdqa xmm5, xmm2
+    punpcklbw xmm2, xmm7
+    punpckhbw xmm5, xmm7
+    psubw xmm2, xmm6
+    psllw xmm2, 5                       ; DWT_FACTOR
+    psubw xmm5, xmm6
+    psllw xmm5, 5                       ; DWT_FACTOR
+    paddw xmm2, xmm0
+    psraw xmm2, 1
+    psubw xmm1, xmm2
+    psraw xmm1, 1                       ; h
+    movdqu [r8 + rax + 4128], xmm1
+    paddw xmm0, xmm1                    ; l
+    movdqu [r8 + rax + 32], xmm0
+    paddw xmm5, xmm3
+    psraw xmm5, 1
+    psubw xmm4, xmm5
+    psraw xmm4, 1                       ; h
+    movdqu [r8 + rax + 4144], xmm4
+    paddw xmm3, xmm4                    ; l
+    movdqu [r8 + rax + 48], xmm3
+    ; columns 32 to 47
+    movdqu xmm0, [rdi + 32]
+    movdqa xmm3, xmm0
+    punpcklbw xmm0, xmm7
+    punpckhbw xmm3, xmm7
+    psubw xmm0, xmm6
+    psllw xmm0, 5                       ; DWT_FACTOR
+    psubw xmm3, xmm6
+    psllw xmm3, 5                       ; DWT_FACTOR
+    movdqu xmm1, [rsi + 32]
+    movdqa xmm4, xmm1
+    punpcklbw xmm1, xmm7
+    punpckhbw xmm4, xmm7
+    psubw xmm1, xmm6
+    psllw xmm1, 5                       ; DWT_FACTOR
+    psubw xmm4, xmm6
+    psllw xmm4, 5                       ; DWT_FACTOR
+    movdqu xmm2, [rdx + 32]
+    movdqa xmm5, xmm2
+    punpcklbw xmm2, xmm7
+    punpckhbw xmm5, xmm7
+    psubw xmm2, xmm6
+    psllw xmm2, 5                       ; DWT_FACTOR
+    psubw xmm5, xmm6
+    psllw xmm5, 5                       ; DWT_FACTOR
+    paddw xmm2, xmm0
+    psraw xmm2, 1
+    psubw xmm1, xmm2
+    psraw xmm1, 1                       ; h
+    movdqu [r8 + rax + 4160], xmm1
+    paddw xmm0, xmm1                    ; l
+    movdqu [r8 + rax + 64], xmm0
+    paddw xmm5, xmm3
+    psraw xmm5, 1
+    psubw xmm4, xmm5
+    psraw xmm4, 1                       ; h
+    movdqu [r8 + rax + 4176], xmm4
+    paddw xmm3, xmm4                    ; l
+    movdqu [r8 + rax + 80], xmm3
+    ; columns 48 to 63
+    movdqu xmm0, [rdi + 48]
+    movdqa xmm3, xmm0
+    punpcklbw xmm0, xmm7
+    punpckhbw xmm3, xmm7
+    psubw xmm0, xmm6
+    psllw xmm0, 5                       ; DWT_FACTOR
+    psubw xmm3, xmm6
+    psllw xmm3, 5                       ; DWT_FACTOR
+    movdqu xmm1, [rsi + 48]
+    movdqa xmm4, xmm1
+    punpcklbw xmm1, xmm7
+    punpckhbw xmm4, xmm7
+    psubw xmm1, xmm6
+    psllw xmm1, 5                       ; DWT_FACTOR
+    psubw xmm4, xmm6
+    psllw xmm4, 5                       ; DWT_FACTOR
+    movdqu xmm2, [rdx + 48]
+    movdqa xmm5, xmm2
+    punpcklbw xmm2, xmm7
+    punpckhbw xmm5, xmm7
+    psubw xmm2, xmm6
+    psllw xmm2, 5                       ; DWT_FACTOR
+    psubw xmm5, xmm6
+    psllw xmm5, 5                       ; DWT_FACTOR
+    paddw xmm2, xmm0
+    psraw xmm2, 1
+    psubw xmm1, xmm2
+    psraw xmm1, 1                       ; h
+    movdqu [r8 + rax + 4192], xmm1
+    paddw xmm0, xmm1                    ; l
+    movdqu [r8 + rax + 96], xmm0
+    paddw xmm5, xmm3
+    psraw xmm5, 1
+    psubw xmm4, xmm5
+    psraw xmm4, 1                       ; h
+    movdqu [r8 + rax + 4208], xmm4
+    paddw xmm3, xmm4                    ; l
+    movdqu [r8 + rax + 112], xmm3
+    ; next component
+    lea rdi, [rdi + 64]
+    lea rsi, [rsi + 64]
+    lea rdx, [rdx + 64]
+    lea r10, [r10 + 8]
+    dec ecx
+    jnz loop_first
+
+loop_done:
+    add rsp, 24
+
+    ; epilogue
+%ifdef DEBUG
+    mov rsp, rbp
+    pop rbp
+%endif
+
+    mov eax, 0                          ; return value
+    ret
+
+END_OF_FILE
@@ -0,0 +1,778 @@
+;
+;Copyright 2026 librfxcodec contributors
+;
+;Permission to use, copy, modify, distribute, and sell this software and its
+;documentation for any purpose is hereby granted without fee, provided that
+;the above copyright notice appear in all copies and that both that
+;copyright notice and this permission notice appear in supporting
+;documentation.
+;
+;The above copyright notice and this permission notice shall be included in
+;all copies or substantial portions of the Software.
+;
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+;IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+;FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+;OPEN GROUP BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+;AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+;CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+;
+;amd64 asm packed pixels to yuv in one pass, avx2, 16 pixels per loop
+
+%include "common.asm"
+
+PREPARE_RODATA
+    cw128    times 16 dw 128
+    ; dword = r + (g << 16) is added to y, so r is 19595 - 1 and g is
+    ; 38470 - 65536 split over the two pairs
+    cwy_rg   times 8 dw 19594, -13533
+    cwy_gb   times 8 dw -13533, 7471
+    ; dword = g + (b << 16) is added to u, so g is -21736 - 1 and b is
+    ; 32807 - 65536
+    cwu_rg   times 8 dw -11071, -21737
+    cwu_gb   times 8 dw 0, -32729
+    cwv_rg   times 8 dw 32756, -27429
+    cwv_gb   times 8 dw 0, -5327
+    ; 4 bytes per pixel, group each channel of 4 pixels in a dword
+    cb_4     db 0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15
+    ; 3 bytes per pixel, channel k from the 16 bytes at 16 * j
+    cb_3_00  db 0, 3, 6, 9, 12, 15, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_01  db 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 2, 5, 8, 11, 14, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_02  db 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 1, 4, 7, 10, 13
+    cb_3_10  db 1, 4, 7, 10, 13, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_11  db 0x80, 0x80, 0x80, 0x80, 0x80, 0, 3, 6, 9, 12, 15, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_12  db 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 2, 5, 8, 11, 14
+    cb_3_20  db 2, 5, 8, 11, 14, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_21  db 0x80, 0x80, 0x80, 0x80, 0x80, 1, 4, 7, 10, 13, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_22  db 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0, 3, 6, 9, 12, 15
+
+; Per System V AMD64 ABI, the first six integer or pointer arguments are
+; passed in registers RDI, RSI, RDX, RCX, R8, and R9
+
+;******************************************************************************
+;int
+;rfxcodec_encode_bgra_to_yuva_amd64_avx2(const char *src,
+;                                        int stride_bytes,
+;                                        int count,
+;                                        int height,
+;                                        unsigned char *y_buf,
+;                                        unsigned char *u_buf,
+;                                        unsigned char *v_buf,
+;                                        unsigned char *a_buf);
+PROC rfxcodec_encode_bgra_to_yuva_amd64_avx2
+    ; stack args first, the prologue moves rsp
+    mov r10, [rsp + 8]                  ; v_buf
+    mov r11, [rsp + 16]                 ; a_buf, can be NULL
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    ; save registers
+    push rbx
+    push r12
+    movsxd rsi, esi
+    movsxd rdx, edx
+    xor eax, eax                        ; dst offset
+    test ecx, ecx
+    jz loop1_done
+    test edx, edx
+    jz loop1_done
+    test r11, r11
+    jz loop13_y                         ; no alpha
+
+loop1_y:
+    mov rbx, rdi
+    mov r12d, edx
+loop1_x16:
+    ; 16 pixels, split
+    vmovdqu xmm0, [rbx]
+    vmovdqu xmm1, [rbx + 16]
+    vmovdqu xmm2, [rbx + 32]
+    vmovdqu xmm3, [rbx + 48]
+    vpshufb xmm0, xmm0, [lsym(cb_4)]
+    vpshufb xmm1, xmm1, [lsym(cb_4)]
+    vpshufb xmm2, xmm2, [lsym(cb_4)]
+    vpshufb xmm3, xmm3, [lsym(cb_4)]
+    ; 4 x 4 dword transpose
+    vpunpckhdq xmm4, xmm0, xmm1
+    vpunpckldq xmm0, xmm0, xmm1
+    vpunpckhdq xmm5, xmm2, xmm3
+    vpunpckldq xmm2, xmm2, xmm3
+    vpunpckhqdq xmm1, xmm0, xmm2
+    vpunpcklqdq xmm0, xmm0, xmm2
+    vpunpckhqdq xmm3, xmm4, xmm5
+    vmovdqu [r11 + rax], xmm3           ; a
+    vpunpcklqdq xmm4, xmm4, xmm5
+    ; zero extend, order matters, the sources overlap ymm1 to 3
+    vpmovzxbw ymm2, xmm1                ; g
+    vpmovzxbw ymm3, xmm0                ; b
+    vpmovzxbw ymm1, xmm4                ; r
+    vpunpcklwd ymm4, ymm1, ymm2         ; r, g
+    vpunpckhwd ymm1, ymm1, ymm2
+    vpunpcklwd ymm5, ymm2, ymm3         ; g, b
+    vpunpckhwd ymm2, ymm2, ymm3
+
+    ; y = (r *  19595 + g *  38470 + b *   7471) >> 16
+    vpmaddwd ymm3, ymm4, [lsym(cwy_rg)]
+    vpmaddwd ymm6, ymm5, [lsym(cwy_gb)]
+    vpaddd ymm3, ymm3, ymm6
+    vpaddd ymm3, ymm3, ymm4
+    vpsrad ymm3, ymm3, 16
+    vpmaddwd ymm6, ymm1, [lsym(cwy_rg)]
+    vpmaddwd ymm7, ymm2, [lsym(cwy_gb)]
+    vpaddd ymm6, ymm6, ymm7
+    vpaddd ymm6, ymm6, ymm1
+    vpsrad ymm6, ymm6, 16
+    vpackssdw ymm3, ymm3, ymm6
+    vextracti128 xmm6, ymm3, 1
+    vpackuswb xmm3, xmm3, xmm6          ; clamp 0 to 255
+    vmovdqu [r8 + rax], xmm3
+
+    ; u = ((r * -11071 + g * -21736 + b *  32807) >> 16) + 128
+    vpmaddwd ymm3, ymm4, [lsym(cwu_rg)]
+    vpmaddwd ymm6, ymm5, [lsym(cwu_gb)]
+    vpaddd ymm3, ymm3, ymm6
+    vpaddd ymm3, ymm3, ymm5
+    vpsrad ymm3, ymm3, 16
+    vpmaddwd ymm6, ymm1, [lsym(cwu_rg)]
+    vpmaddwd ymm7, ymm2, [lsym(cwu_gb)]
+    vpaddd ymm6, ymm6, ymm7
+    vpaddd ymm6, ymm6, ymm2
+    vpsrad ymm6, ymm6, 16
+    vpackssdw ymm3, ymm3, ymm6
+    vpaddw ymm3, ymm3, [lsym(cw128)]
+    vextracti128 xmm6, ymm3, 1
+    vpackuswb xmm3, xmm3, xmm6          ; clamp 0 to 255
+    vmovdqu [r9 + rax], xmm3
+
+    ; v = ((r *  32756 + g * -27429 + b *  -5327) >> 16) + 128
+    vpmaddwd ymm3, ymm4, [lsym(cwv_rg)]
+    vpmaddwd ymm6, ymm5, [lsym(cwv_gb)]
+    vpaddd ymm3, ymm3, ymm6
+    vpsrad ymm3, ymm3, 16
+    vpmaddwd ymm6, ymm1, [lsym(cwv_rg)]
+    vpmaddwd ymm7, ymm2, [lsym(cwv_gb)]
+    vpaddd ymm6, ymm6, ymm7
+    vpsrad ymm6, ymm6, 16
+    vpackssdw ymm3, ymm3, ymm6
+    vpaddw ymm3, ymm3, [lsym(cw128)]
+    vextracti128 xmm6, ymm3, 1
+    vpackuswb xmm3, xmm3, xmm6          ; clamp 0 to 255
+    vmovdqu [r10 + rax], xmm3
+
+    lea rbx, [rbx + 16 * 4]
+    lea rax, [rax + 16]
+    sub r12d, 16
+    jnz loop1_x16
+    ; next row
+    lea rax, [rax + 64]
+    sub rax, rdx
+    add rdi, rsi
+    dec ecx
+    jnz loop1_y
+    jmp loop1_done
+
+    ; no alpha
+loop13_y:
+    mov rbx, rdi
+    mov r12d, edx
+loop13_x16:
+    ; 16 pixels, split
+    vmovdqu xmm0, [rbx]
+    vmovdqu xmm1, [rbx + 16]
+    vmovdqu xmm2, [rbx + 32]
+    vmovdqu xmm3, [rbx + 48]
+    vpshufb xmm0, xmm0, [lsym(cb_4)]
+    vpshufb xmm1, xmm1, [lsym(cb_4)]
+    vpshufb xmm2, xmm2, [lsym(cb_4)]
+    vpshufb xmm3, xmm3, [lsym(cb_4)]
+    ; 4 x 4 dword transpose
+    vpunpckhdq xmm4, xmm0, xmm1
+    vpunpckldq xmm0, xmm0, xmm1
+    vpunpckhdq xmm5, xmm2, xmm3
+    vpunpckldq xmm2, xmm2, xmm3
+    vpunpckhqdq xmm1, xmm0, xmm2
+    vpunpcklqdq xmm0, xmm0, xmm2
+    vpunpcklqdq xmm4, xmm4, xmm5
+    ; zero extend, order matters, the sources overlap ymm1 to 3
+    vpmovzxbw ymm2, xmm1                ; g
+    vpmovzxbw ymm3, xmm0                ; b
+    vpmovzxbw ymm1, xmm4                ; r
+    vpunpcklwd ymm4, ymm1, ymm2         ; r, g
+    vpunpckhwd ymm1, ymm1, ymm2
+    vpunpcklwd ymm5, ymm2, ymm3         ; g, b
+    vpunpckhwd ymm2, ymm2, ymm3
+
+    ; y = (r *  19595 + g *  38470 + b *   7471) >> 16
+    vpmaddwd ymm3, ymm4, [lsym(cwy_rg)]
+    vpmaddwd ymm6, ymm5, [lsym(cwy_gb)]
+    vpaddd ymm3, ymm3, ymm6
+    vpaddd ymm3, ymm3, ymm4
+    vpsrad ymm3, ymm3, 16
+    vpmaddwd ymm6, ymm1, [lsym(cwy_rg)]
+    vpmaddwd ymm7, ymm2, [lsym(cwy_gb)]
+    vpaddd ymm6, ymm6, ymm7
+    vpaddd ymm6, ymm6, ymm1
+    vpsrad ymm6, ymm6, 16
+    vpackssdw ymm3, ymm3, ymm6
+    vextracti128 xmm6, ymm3, 1
+    vpackuswb xmm3, xmm3, xmm6          ; clamp 0 to 255
+    vmovdqu [r8 + rax], xmm3
+
+    ; u = ((r * -11071 + g * -21736 + b *  32807) >> 16) + 128
+    vpmaddwd ymm3, ymm4, [lsym(cwu_rg)]
+    vpmaddwd ymm6, ymm5, [lsym(cwu_gb)]
+    vpaddd ymm3, ymm3, ymm6
+    vpaddd ymm3, ymm3, ymm5
+    vpsrad ymm3, ymm3, 16
+    vpmaddwd ymm6, ymm1, [lsym(cwu_rg)]
+    vpmaddwd ymm7, ymm2, [lsym(cwu_gb)]
+    vpaddd ymm6, ymm6, ymm7
+    vpaddd ymm6, ymm6, ymm2
+    vpsrad ymm6, ymm6, 16
+    vpackssdw ymm3, ymm3, ymm6
+    vpaddw ymm3, ymm3, [lsym(cw128)]
+    vextracti128 xmm6, ymm3, 1
+    vpackuswb xmm3, xmm3, xmm6          ; clamp 0 to 255
+    vmovdqu [r9 + rax], xmm3
+
+    ; v = ((r *  32756 + g * -27429 + b *  -5327) >> 16) + 128
+    vpmaddwd ymm3, ymm4, [lsym(cwv_rg)]
+    vpmaddwd ymm6, ymm5, [lsym(cwv_gb)]
+    vpaddd ymm3, ymm3, ymm6
+    vpsrad ymm3, ymm3, 16
+    vpmaddwd ymm6, ymm1, [lsym(cwv_rg)]
+    vpmaddwd ymm7, ymm2, [lsym(cwv_gb)]
+    vpaddd ymm6, ymm6, ymm7
+    vpsrad ymm6, ymm6, 16
+    vpackssdw ymm3, ymm3, ymm6
+    vpaddw ymm3, ymm3, [lsym(cw128)]
+    vextracti128 xmm6, ymm3, 1
+    vpackuswb xmm3, xmm3, xmm6          ; clamp 0 to 255
+    vmovdqu [r10 + rax], xmm3
+
+    lea rbx, [rbx + 16 * 4]
+    lea rax, [rax + 16]
+    sub r12d, 16
+    jnz loop13_x16
+    ; next row
+    lea rax, [rax + 64]
+    sub rax, rdx
+    add rdi, rsi
+    dec ecx
+    jnz loop13_y
+
+loop1_done:
+    vzeroupper
+    ; restore registers
+    pop r12
+    pop rbx
+
+    ; epilogue
+%ifdef DEBUG
+    mov rsp, rbp
+    pop rbp
+%endif
+
+    mov eax, 0                          ; return value
+    ret
+
+;******************************************************************************
+;int
+;rfxcodec_encode_rgba_to_yuva_amd64_avx2(const char *src,
+;                                        int stride_bytes,
+;                                        int count,
+;                                        int height,
+;                                        unsigned char *y_buf,
+;                                        unsigned char *u_buf,
+;                                        unsigned char *v_buf,
+;                                        unsigned char *a_buf);
+PROC rfxcodec_encode_rgba_to_yuva_amd64_avx2
+    ; stack args first, the prologue moves rsp
+    mov r10, [rsp + 8]                  ; v_buf
+    mov r11, [rsp + 16]                 ; a_buf, can be NULL
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    ; save registers
+    push rbx
+    push r12
+    movsxd rsi, esi
+    movsxd rdx, edx
+    xor eax, eax                        ; dst offset
+    test ecx, ecx
+    jz loop2_done
+    test edx, edx
+    jz loop2_done
+    test r11, r11
+    jz loop23_y                         ; no alpha
+
+loop2_y:
+    mov rbx, rdi
+    mov r12d, edx
+loop2_x16:
+    ; 16 pixels, split
+    vmovdqu xmm0, [rbx]
+    vmovdqu xmm1, [rbx + 16]
+    vmovdqu xmm2, [rbx + 32]
+    vmovdqu xmm3, [rbx + 48]
+    vpshufb xmm0, xmm0, [lsym(cb_4)]
+    vpshufb xmm1, xmm1, [lsym(cb_4)]
+    vpshufb xmm2, xmm2, [lsym(cb_4)]
+    vpshufb xmm3, xmm3, [lsym(cb_4)]
+    ; 4 x 4 dword transpose
+    vpunpckhdq xmm4, xmm0, xmm1
+    vpunpckldq xmm0, xmm0, xmm1
+    vpunpckhdq xmm5, xmm2, xmm3
+    vpunpckldq xmm2, xmm2, xmm3
+    vpunpckhqdq xmm1, xmm0, xmm2
+    vpunpcklqdq xmm0, xmm0, xmm2
+    vpunpckhqdq xmm3, xmm4, xmm5
+    vmovdqu [r11 + rax], xmm3           ; a
+    vpunpcklqdq xmm4, xmm4, xmm5
+    ; zero extend, order matters, the sources overlap ymm1 to 3
+    vpmovzxbw ymm2, xmm1                ; g
+    vpmovzxbw ymm3, xmm4                ; b
+    vpmovzxbw ymm1, xmm0                ; r
+    vpunpcklwd ymm4, ymm1, ymm2         ; r, g
+    vpunpckhwd ymm1, ymm1, ymm2
+    vpunpcklwd ymm5, ymm2, ymm3         ; g, b
+    vpunpckhwd ymm2, ymm2, ymm3
+
+    ; y = (r *  19595 + g *  38470 + b *   7471) >> 16
+    vpmaddwd ymm3, ymm4, [lsym(cwy_rg)]
+    vpmaddwd ymm6, ymm5, [lsym(cwy_gb)]
+    vpaddd ymm3, ymm3, ymm6
+    vpaddd ymm3, ymm3, ymm4
+    vpsrad ymm3, ymm3, 16
+    vpmaddwd ymm6, ymm1, [lsym(cwy_rg)]
+    vpmaddwd ymm7, ymm2, [lsym(cwy_gb)]
+    vpaddd ymm6, ymm6, ymm7
+    vpaddd ymm6, ymm6, ymm1
+    vpsrad ymm6, ymm6, 16
+    vpackssdw ymm3, ymm3, ymm6
+    vextracti128 xmm6, ymm3, 1
+    vpackuswb xmm3, xmm3, xmm6          ; clamp 0 to 255
+    vmovdqu [r8 + rax], xmm3
+
+    ; u = ((r * -11071 + g * -21736 + b *  32807) >> 16) + 128
+    vpmaddwd ymm3, ymm4, [lsym(cwu_rg)]
+    vpmaddwd ymm6, ymm5, [lsym(cwu_gb)]
+    vpaddd ymm3, ymm3, ymm6
+    vpaddd ymm3, ymm3, ymm5
+    vpsrad ymm3, ymm3, 16
+    vpmaddwd ymm6, ymm1, [lsym(cwu_rg)]
+    vpmaddwd ymm7, ymm2, [lsym(cwu_gb)]
+    vpaddd ymm6, ymm6, ymm7
+    vpaddd ymm6, ymm6, ymm2
+    vpsrad ymm6, ymm6, 16
+    vpackssdw ymm3, ymm3, ymm6
+    vpaddw ymm3, ymm3, [lsym(cw128)]
+    vextracti128 xmm6, ymm3, 1
+    vpackuswb xmm3, xmm3, xmm6          ; clamp 0 to 255
+    vmovdqu [r9 + rax], xmm3
+
+    ; v = ((r *  32756 + g * -27429 + b *  -5327) >> 16) + 128
+    vpmaddwd ymm3, ymm4, [lsym(cwv_rg)]
+    vpmaddwd ymm6, ymm5, [lsym(cwv_gb)]
+    vpaddd ymm3, ymm3, ymm6
+    vpsrad ymm3, ymm3, 16
+    vpmaddwd ymm6, ymm1, [lsym(cwv_rg)]
+    vpmaddwd ymm7, ymm2, [lsym(cwv_gb)]
+    vpaddd ymm6, ymm6, ymm7
+    vpsrad ymm6, ymm6, 16
+    vpackssdw ymm3, ymm3, ymm6
+    vpaddw ymm3, ymm3, [lsym(cw128)]
+    vextracti128 xmm6, ymm3, 1
+    vpackuswb xmm3, xmm3, xmm6          ; clamp 0 to 255
+    vmovdqu [r10 + rax], xmm3
+
+    lea rbx, [rbx + 16 * 4]
+    lea rax, [rax + 16]
+    sub r12d, 16
+    jnz loop2_x16
+    ; next row
+    lea rax, [rax + 64]
+    sub rax, rdx
+    add rdi, rsi
+    dec ecx
+    jnz loop2_y
+    jmp loop2_done
+
+    ; no alpha
+loop23_y:
+    mov rbx, rdi
+    mov r12d, edx
+loop23_x16:
+    ; 16 pixels, split
+    vmovdqu xmm0, [rbx]
+    vmovdqu xmm1, [rbx + 16]
+    vmovdqu xmm2, [rbx + 32]
+    vmovdqu xmm3, [rbx + 48]
+    vpshufb xmm0, xmm0, [lsym(cb_4)]
+    vpshufb xmm1, xmm1, [lsym(cb_4)]
+    vpshufb xmm2, xmm2, [lsym(cb_4)]
+    vpshufb xmm3, xmm3, [lsym(cb_4)]
+    ; 4 x 4 dword transpose
+    vpunpckhdq xmm4, xmm0, xmm1
+    vpunpckldq xmm0, xmm0, xmm1
+    vpunpckhdq xmm5, xmm2, xmm3
+    vpunpckldq xmm2, xmm2, xmm3
+    vpunpckhqdq xmm1, xmm0, xmm2
+    vpunpcklqdq xmm0, xmm0, xmm2
+    vpunpcklqdq xmm4, xmm4, xmm5
+    ; zero extend, order matters, the sources overlap ymm1 to 3
+    vpmovzxbw ymm2, xmm1                ; g
+    vpmovzxbw ymm3, xmm4                ; b
+    vpmovzxbw ymm1, xmm0                ; r
+    vpunpcklwd ymm4, ymm1, ymm2         ; r, g
+    vpunpckhwd ymm1, ymm1, ymm2
+    vpunpcklwd ymm5, ymm2, ymm3         ; g, b
+    vpunpckhwd ymm2, ymm2, ymm3
+
+    ; y = (r *  19595 + g *  38470 + b *   7471) >> 16
+    vpmaddwd ymm3, ymm4, [lsym(cwy_rg)]
+    vpmaddwd ymm6, ymm5, [lsym(cwy_gb)]
+    vpaddd ymm3, ymm3, ymm6
+    vpaddd ymm3, ymm3, ymm4
+    vpsrad ymm3, ymm3, 16
+    vpmaddwd ymm6, ymm1, [lsym(cwy_rg)]
+    vpmaddwd ymm7, ymm2, [lsym(cwy_gb)]
+    vpaddd ymm6, ymm6, ymm7
+    vpaddd ymm6, ymm6, ymm1
+    vpsrad ymm6, ymm6, 16
+    vpackssdw ymm3, ymm3, ymm6
+    vextracti128 xmm6, ymm3, 1
+    vpackuswb xmm3, xmm3, xmm6          ; clamp 0 to 255
+    vmovdqu [r8 + rax], xmm3
+
+    ; u = ((r * -11071 + g * -21736 + b *  32807) >> 16) + 128
+    vpmaddwd ymm3, ymm4, [lsym(cwu_rg)]
+    vpmaddwd ymm6, ymm5, [lsym(cwu_gb)]
+    vpaddd ymm3, ymm3, ymm6
+    vpaddd ymm3, ymm3, ymm5
+    vpsrad ymm3, ymm3, 16
+    vpmaddwd ymm6, ymm1, [lsym(cwu_rg)]
+    vpmaddwd ymm7, ymm2, [lsym(cwu_gb)]
+    vpaddd ymm6, ymm6, ymm7
+    vpaddd ymm6, ymm6, ymm2
+    vpsrad ymm6, ymm6, 16
+    vpackssdw ymm3, ymm3, ymm6
+    vpaddw ymm3, ymm3, [lsym(cw128)]
+    vextracti128 xmm6, ymm3, 1
+    vpackuswb xmm3, xmm3, xmm6          ; clamp 0 to 255
+    vmovdqu [r9 + rax], xmm3
+
+    ; v = ((r *  32756 + g * -27429 + b *  -5327) >> 16) + 128
+    vpmaddwd ymm3, ymm4, [lsym(cwv_rg)]
+    vpmaddwd ymm6, ymm5, [lsym(cwv_gb)]
+    vpaddd ymm3, ymm3, ymm6
+    vpsrad ymm3, ymm3, 16
+    vpmaddwd ymm6, ymm1, [lsym(cwv_rg)]
+    vpmaddwd ymm7, ymm2, [lsym(cwv_gb)]
+    vpaddd ymm6, ymm6, ymm7
+    vpsrad ymm6, ymm6, 16
+    vpackssdw ymm3, ymm3, ymm6
+    vpaddw ymm3, ymm3, [lsym(cw128)]
+    vextracti128 xmm6, ymm3, 1
+    vpackuswb xmm3, xmm3, xmm6          ; clamp 0 to 255
+    vmovdqu [r10 + rax], xmm3
+
+    lea rbx, [rbx + 16 * 4]
+    lea rax, [rax + 16]
+    sub r12d, 16
+    jnz loop23_x16
+    ; next row
+    lea rax, [rax + 64]
+    sub rax, rdx
+    add rdi, rsi
+    dec ecx
+    jnz loop23_y
+
+loop2_done:
+    vzeroupper
+    ; restore registers
+    pop r12
+    pop rbx
+
+    ; epilogue
+%ifdef DEBUG
+    mov rsp, rbp
+    pop rbp
+%endif
+
+    mov eax, 0                          ; return value
+    ret
+
+;******************************************************************************
+;int
+;rfxcodec_encode_bgr_to_yuv_amd64_avx2(const char *src,
+;                                      int stride_bytes,
+;                                      int count,
+;                                      int height,
+;                                      unsigned char *y_buf,
+;                                      unsigned char *u_buf,
+;                                      unsigned char *v_buf);
+PROC rfxcodec_encode_bgr_to_yuv_amd64_avx2
+    ; stack args first, the prologue moves rsp
+    mov r10, [rsp + 8]                  ; v_buf
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    ; save registers
+    push rbx
+    push r12
+    movsxd rsi, esi
+    movsxd rdx, edx
+    xor eax, eax                        ; dst offset
+    test ecx, ecx
+    jz loop3_done
+    test edx, edx
+    jz loop3_done
+
+loop3_y:
+    mov rbx, rdi
+    mov r12d, edx
+loop3_x16:
+    ; 16 pixels, split
+    vmovdqu xmm0, [rbx]
+    vmovdqu xmm1, [rbx + 16]
+    vmovdqu xmm2, [rbx + 32]
+    vpshufb xmm5, xmm0, [lsym(cb_3_00)]
+    vpshufb xmm4, xmm1, [lsym(cb_3_01)]
+    vpor xmm5, xmm5, xmm4
+    vpshufb xmm4, xmm2, [lsym(cb_3_02)]
+    vpor xmm5, xmm5, xmm4
+    vpshufb xmm6, xmm0, [lsym(cb_3_10)]
+    vpshufb xmm4, xmm1, [lsym(cb_3_11)]
+    vpor xmm6, xmm6, xmm4
+    vpshufb xmm4, xmm2, [lsym(cb_3_12)]
+    vpor xmm6, xmm6, xmm4
+    vpshufb xmm7, xmm0, [lsym(cb_3_20)]
+    vpshufb xmm4, xmm1, [lsym(cb_3_21)]
+    vpor xmm7, xmm7, xmm4
+    vpshufb xmm4, xmm2, [lsym(cb_3_22)]
+    vpor xmm7, xmm7, xmm4
+    ; zero extend, order matters, the sources overlap ymm1 to 3
+    vpmovzxbw ymm1, xmm7                ; r
+    vpmovzxbw ymm2, xmm6                ; g
+    vpmovzxbw ymm3, xmm5                ; b
+    vpunpcklwd ymm4, ymm1, ymm2         ; r, g
+    vpunpckhwd ymm1, ymm1, ymm2
+    vpunpcklwd ymm5, ymm2, ymm3         ; g, b
+    vpunpckhwd ymm2, ymm2, ymm3
+
+    ; y = (r *  19595 + g *  38470 + b *   7471) >> 16
+    vpmaddwd ymm3, ymm4, [lsym(cwy_rg)]
+    vpmaddwd ymm6, ymm5, [lsym(cwy_gb)]
+    vpaddd ymm3, ymm3, ymm6
+    vpaddd ymm3, ymm3, ymm4
+    vpsrad ymm3, ymm3, 16
+    vpmaddwd ymm6, ymm1, [lsym(cwy_rg)]
+    vpmaddwd ymm7, ymm2, [lsym(cwy_gb)]
+    vpaddd ymm6, ymm6, ymm7
+    vpaddd ymm6, ymm6, ymm1
+    vpsrad ymm6, ymm6, 16
+    vpackssdw ymm3, ymm3, ymm6
+    vextracti128 xmm6, ymm3, 1
+    vpackuswb xmm3, xmm3, xmm6          ; clamp 0 to 255
+    vmovdqu [r8 + rax], xmm3
+
+    ; u = ((r * -11071 + g * -21736 + b *  32807) >> 16) + 128
+    vpmaddwd ymm3, ymm4, [lsym(cwu_rg)]
+    vpmaddwd ymm6, ymm5, [lsym(cwu_gb)]
+    vpaddd ymm3, ymm3, ymm6
+    vpaddd ymm3, ymm3, ymm5
+    vpsrad ymm3, ymm3, 16
+    vpmaddwd ymm6, ymm1, [lsym(cwu_rg)]
+    vpmaddwd ymm7, ymm2, [lsym(cwu_gb)]
+    vpaddd ymm6, ymm6, ymm7
+    vpaddd ymm6, ymm6, ymm2
+    vpsrad ymm6, ymm6, 16
+    vpackssdw ymm3, ymm3, ymm6
+    vpaddw ymm3, ymm3, [lsym(cw128)]
+    vextracti128 xmm6, ymm3, 1
+    vpackuswb xmm3, xmm3, xmm6          ; clamp 0 to 255
+    vmovdqu [r9 + rax], xmm3
+
+    ; v = ((r *  32756 + g * -27429 + b *  -5327) >> 16) + 128
+    vpmaddwd ymm3, ymm4, [lsym(cwv_rg)]
+    vpmaddwd ymm6, ymm5, [lsym(cwv_gb)]
+    vpaddd ymm3, ymm3, ymm6
+    vpsrad ymm3, ymm3, 16
+    vpmaddwd ymm6, ymm1, [lsym(cwv_rg)]
+    vpmaddwd ymm7, ymm2, [lsym(cwv_gb)]
+    vpaddd ymm6, ymm6, ymm7
+    vpsrad ymm6, ymm6, 16
+    vpackssdw ymm3, ymm3, ymm6
+    vpaddw ymm3, ymm3, [lsym(cw128)]
+    vextracti128 xmm6, ymm3, 1
+    vpackuswb xmm3, xmm3, xmm6          ; clamp 0 to 255
+    vmovdqu [r10 + rax], xmm3
+
+    lea rbx, [rbx + 16 * 3]
+    lea rax, [rax + 16]
+    sub r12d, 16
+    jnz loop3_x16
+    ; next row
+    lea rax, [rax + 64]
+    sub rax, rdx
+    add rdi, rsi
+    dec ecx
+    jnz loop3_y
+
+loop3_done:
+    vzeroupper
+    ; restore registers
+    pop r12
+    pop rbx
+
+    ; epilogue
+%ifdef DEBUG
+    mov rsp, rbp
+    pop rbp
+%endif
+
+    mov eax, 0                          ; return value
+    ret
+
+;******************************************************************************
+;int
+;rfxcodec_encode_rgb_to_yuv_amd64_avx2(const char *src,
+;                                      int stride_bytes,
+;                                      int count,
+;                                      int height,
+;                                      unsigned char *y_buf,
+;                                      unsigned char *u_buf,
+;                                      unsigned char *v_buf);
+PROC rfxcodec_encode_rgb_to_yuv_amd64_avx2
+    ; stack args first, the prologue moves rsp
+    mov r10, [rsp + 8]                  ; v_buf
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    ; save registers
+    push rbx
+    push r12
+    movsxd rsi, esi
+    movsxd rdx, edx
+    xor eax, eax                        ; dst offset
+    test ecx, ecx
+    jz loop4_done
+    test edx, edx
+    jz loop4_done
+
+loop4_y:
+    mov rbx, rdi
+    mov r12d, edx
+loop4_x16:
+    ; 16 pixels, split
+    vmovdqu xmm0, [rbx]
+    vmovdqu xmm1, [rbx + 16]
+    vmovdqu xmm2, [rbx + 32]
+    vpshufb xmm5, xmm0, [lsym(cb_3_00)]
+    vpshufb xmm4, xmm1, [lsym(cb_3_01)]
+    vpor xmm5, xmm5, xmm4
+    vpshufb xmm4, xmm2, [lsym(cb_3_02)]
+    vpor xmm5, xmm5, xmm4
+    vpshufb xmm6, xmm0, [lsym(cb_3_10)]
+    vpshufb xmm4, xmm1, [lsym(cb_3_11)]
+    vpor xmm6, xmm6, xmm4
+    vpshufb xmm4, xmm2, [lsym(cb_3_12)]
+    vpor xmm6, xmm6, xmm4
+    vpshufb xmm7, xmm0, [lsym(cb_3_20)]
+    vpshufb xmm4, xmm1, [lsym(cb_3_21)]
+    vpor xmm7, xmm7, xmm4
+    vpshufb xmm4, xmm2, [lsym(cb_3_22)]
+    vpor xmm7, xmm7, xmm4
+    ; zero extend, order matters, the sources overlap ymm1 to 3
+    vpmovzxbw ymm1, xmm5                ; r
+    vpmovzxbw ymm2, xmm6                ; g
+    vpmovzxbw ymm3, xmm7                ; b
+    vpunpcklwd ymm4, ymm1, ymm2         ; r, g
+    vpunpckhwd ymm1, ymm1, ymm2
+    vpunpcklwd ymm5, ymm2, ymm3         ; g, b
+    vpunpckhwd ymm2, ymm2, ymm3
+
+    ; y = (r *  19595 + g *  38470 + b *   7471) >> 16
+    vpmaddwd ymm3, ymm4, [lsym(cwy_rg)]
+    vpmaddwd ymm6, ymm5, [lsym(cwy_gb)]
+    vpaddd ymm3, ymm3, ymm6
+    vpaddd ymm3, ymm3, ymm4
+    vpsrad ymm3, ymm3, 16
+    vpmaddwd ymm6, ymm1, [lsym(cwy_rg)]
+    vpmaddwd ymm7, ymm2, [lsym(cwy_gb)]
+    vpaddd ymm6, ymm6, ymm7
+    vpaddd ymm6, ymm6, ymm1
+    vpsrad ymm6, ymm6, 16
+    vpackssdw ymm3, ymm3, ymm6
+    vextracti128 xmm6, ymm3, 1
+    vpackuswb xmm3, xmm3, xmm6          ; clamp 0 to 255
+    vmovdqu [r8 + rax], xmm3
+
+    ; u = ((r * -11071 + g * -21736 + b *  32807) >> 16) + 128
+    vpmaddwd ymm3, ymm4, [lsym(cwu_rg)]
+    vpmaddwd ymm6, ymm5, [lsym(cwu_gb)]
+    vpaddd ymm3, ymm3, ymm6
+    vpaddd ymm3, ymm3, ymm5
+    vpsrad ymm3, ymm3, 16
+    vpmaddwd ymm6, ymm1, [lsym(cwu_rg)]
+    vpmaddwd ymm7, ymm2, [lsym(cwu_gb)]
+    vpaddd ymm6, ymm6, ymm7
+    vpaddd ymm6, ymm6, ymm2
+    vpsrad ymm6, ymm6, 16
+    vpackssdw ymm3, ymm3, ymm6
+    vpaddw ymm3, ymm3, [lsym(cw128)]
+    vextracti128 xmm6, ymm3, 1
+    vpackuswb xmm3, xmm3, xmm6          ; clamp 0 to 255
+    vmovdqu [r9 + rax], xmm3
+
+    ; v = ((r *  32756 + g * -27429 + b *  -5327) >> 16) + 128
+    vpmaddwd ymm3, ymm4, [lsym(cwv_rg)]
+    vpmaddwd ymm6, ymm5, [lsym(cwv_gb)]
+    vpaddd ymm3, ymm3, ymm6
+    vpsrad ymm3, ymm3, 16
+    vpmaddwd ymm6, ymm1, [lsym(cwv_rg)]
+    vpmaddwd ymm7, ymm2, [lsym(cwv_gb)]
+    vpaddd ymm6, ymm6, ymm7
+    vpsrad ymm6, ymm6, 16
+    vpackssdw ymm3, ymm3, ymm6
+    vpaddw ymm3, ymm3, [lsym(cw128)]
+    vextracti128 xmm6, ymm3, 1
+    vpackuswb xmm3, xmm3, xmm6          ; clamp 0 to 255
+    vmovdqu [r10 + rax], xmm3
+
+    lea rbx, [rbx + 16 * 3]
+    lea rax, [rax + 16]
+    sub r12d, 16
+    jnz loop4_x16
+    ; next row
+    lea rax, [rax + 64]
+    sub rax, rdx
+    add rdi, rsi
+    dec ecx
+    jnz loop4_y
+
+loop4_done:
+    vzeroupper
+    ; restore registers
+    pop r12
+    pop rbx
+
+    ; epilogue
+%ifdef DEBUG
+    mov rsp, rbp
+    pop rbp
+%endif
+
+    mov eax, 0                          ; return value
+    ret
+
+END_OF_FILE
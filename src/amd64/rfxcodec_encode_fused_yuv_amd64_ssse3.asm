@@ -0,0 +1,1340 @@
+;
+;Copyright 2026 librfxcodec contributors
+;
+;Permission to use, copy, modify, distribute, and sell this software and its
+;documentation for any purpose is hereby granted without fee, provided that
+;the above copyright notice appear in all copies and that both that
+;copyright notice and this permission notice appear in supporting
+;documentation.
+;
+;The above copyright notice and this permission notice shall be included in
+;all copies or substantial portions of the Software.
+;
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+;IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+;FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+;OPEN GROUP BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+;AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+;CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+;
+;amd64 asm packed pixels to yuv in one pass, ssse3, 16 pixels per loop
+
+%include "common.asm"
+
+PREPARE_RODATA
+    cw128    times 8 dw 128
+    ; dword = r + (g << 16) is added to y, so r is 19595 - 1 and g is
+    ; 38470 - 65536 split over the two pairs
+    cwy_rg   times 4 dw 19594, -13533
+    cwy_gb   times 4 dw -13533, 7471
+    ; dword = g + (b << 16) is added to u, so g is -21736 - 1 and b is
+    ; 32807 - 65536
+    cwu_rg   times 4 dw -11071, -21737
+    cwu_gb   times 4 dw 0, -32729
+    cwv_rg   times 4 dw 32756, -27429
+    cwv_gb   times 4 dw 0, -5327
+    ; 4 bytes per pixel, group each channel of 4 pixels in a dword
+    cb_4     db 0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15
+    ; 3 bytes per pixel, channel k from the 16 bytes at 16 * j
+    cb_3_00  db 0, 3, 6, 9, 12, 15, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_01  db 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 2, 5, 8, 11, 14, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_02  db 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 1, 4, 7, 10, 13
+    cb_3_10  db 1, 4, 7, 10, 13, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_11  db 0x80, 0x80, 0x80, 0x80, 0x80, 0, 3, 6, 9, 12, 15, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_12  db 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 2, 5, 8, 11, 14
+    cb_3_20  db 2, 5, 8, 11, 14, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_21  db 0x80, 0x80, 0x80, 0x80, 0x80, 1, 4, 7, 10, 13, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+    cb_3_22  db 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0, 3, 6, 9, 12, 15
+
+; Per System V AMD64 ABI, the first six integer or pointer arguments are
+; passed in registers RDI, RSI, RDX, RCX, R8, and R9
+
+;******************************************************************************
+;int
+;rfxcodec_encode_bgra_to_yuva_amd64_ssse3(const char *src,
+;                                         int stride_bytes,
+;                                         int count,
+;                                         int height,
+;                                         unsigned char *y_buf,
+;                                         unsigned char *u_buf,
+;                                         unsigned char *v_buf,
+;                                         unsigned char *a_buf);
+PROC rfxcodec_encode_bgra_to_yuva_amd64_ssse3
+    ; stack args first, the prologue moves rsp
+    mov r10, [rsp + 8]                  ; v_buf
+    mov r11, [rsp + 16]                 ; a_buf, can be NULL
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    ; save registers
+    push rbx
+    push r12
+    movsxd rsi, esi
+    movsxd rdx, edx
+    xor eax, eax                        ; dst offset
+    test ecx, ecx
+    jz loop1_done
+    test edx, edx
+    jz loop1_done
+    test r11, r11
+    jz loop13_y                         ; no alpha
+
+loop1_y:
+    mov rbx, rdi
+    mov r12d, edx
+loop1_x16:
+    ; 16 pixels, split
+    movdqu xmm0, [rbx]
+    movdqu xmm1, [rbx + 16]
+    movdqu xmm2, [rbx + 32]
+    movdqu xmm3, [rbx + 48]
+    pshufb xmm0, [lsym(cb_4)]
+    pshufb xmm1, [lsym(cb_4)]
+    pshufb xmm2, [lsym(cb_4)]
+    pshufb xmm3, [lsym(cb_4)]
+    ; 4 x 4 dword transpose
+    movdqa xmm4, xmm0
+    punpckhdq xmm4, xmm1
+    punpckldq xmm0, xmm1
+    movdqa xmm5, xmm2
+    punpckhdq xmm5, xmm3
+    punpckldq xmm2, xmm3
+    movdqa xmm1, xmm0
+    punpckhqdq xmm1, xmm2
+    punpcklqdq xmm0, xmm2
+    movdqa xmm3, xmm4
+    punpckhqdq xmm3, xmm5
+    movdqu [r11 + rax], xmm3            ; a
+    punpcklqdq xmm4, xmm5
+    movdqa xmm8, xmm4                   ; r
+    movdqa xmm9, xmm1                   ; g
+    movdqa xmm10, xmm0                  ; b
+    pxor xmm0, xmm0
+    ; pixels 0 to 7
+    movdqa xmm1, xmm8
+    movdqa xmm2, xmm9
+    movdqa xmm3, xmm10
+    punpcklbw xmm1, xmm0
+    punpcklbw xmm2, xmm0
+    punpcklbw xmm3, xmm0
+    movdqa xmm4, xmm1                   ; r, g
+    punpcklwd xmm4, xmm2
+    punpckhwd xmm1, xmm2
+    movdqa xmm5, xmm2                   ; g, b
+    punpcklwd xmm5, xmm3
+    punpckhwd xmm2, xmm3
+
+    ; y = (r *  19595 + g *  38470 + b *   7471) >> 16
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwy_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwy_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm4
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwy_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwy_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm1
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r8 + rax], xmm3
+
+    ; u = ((r * -11071 + g * -21736 + b *  32807) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwu_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwu_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm5
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwu_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwu_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm2
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r9 + rax], xmm3
+
+    ; v = ((r *  32756 + g * -27429 + b *  -5327) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwv_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwv_gb)]
+    paddd xmm3, xmm6
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwv_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwv_gb)]
+    paddd xmm6, xmm7
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r10 + rax], xmm3
+
+    ; pixels 8 to 15
+    movdqa xmm1, xmm8
+    movdqa xmm2, xmm9
+    movdqa xmm3, xmm10
+    punpckhbw xmm1, xmm0
+    punpckhbw xmm2, xmm0
+    punpckhbw xmm3, xmm0
+    movdqa xmm4, xmm1                   ; r, g
+    punpcklwd xmm4, xmm2
+    punpckhwd xmm1, xmm2
+    movdqa xmm5, xmm2                   ; g, b
+    punpcklwd xmm5, xmm3
+    punpckhwd xmm2, xmm3
+
+    ; y = (r *  19595 + g *  38470 + b *   7471) >> 16
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwy_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwy_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm4
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwy_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwy_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm1
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r8 + rax + 8], xmm3
+
+    ; u = ((r * -11071 + g * -21736 + b *  32807) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwu_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwu_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm5
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwu_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwu_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm2
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r9 + rax + 8], xmm3
+
+    ; v = ((r *  32756 + g * -27429 + b *  -5327) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwv_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwv_gb)]
+    paddd xmm3, xmm6
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwv_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwv_gb)]
+    paddd xmm6, xmm7
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r10 + rax + 8], xmm3
+
+    lea rbx, [rbx + 16 * 4]
+    lea rax, [rax + 16]
+    sub r12d, 16
+    jnz loop1_x16
+    ; next row
+    lea rax, [rax + 64]
+    sub rax, rdx
+    add rdi, rsi
+    dec ecx
+    jnz loop1_y
+    jmp loop1_done
+
+    ; no alpha
+loop13_y:
+    mov rbx, rdi
+    mov r12d, edx
+loop13_x16:
+    ; 16 pixels, split
+    movdqu xmm0, [rbx]
+    movdqu xmm1, [rbx + 16]
+    movdqu xmm2, [rbx + 32]
+    movdqu xmm3, [rbx + 48]
+    pshufb xmm0, [lsym(cb_4)]
+    pshufb xmm1, [lsym(cb_4)]
+    pshufb xmm2, [lsym(cb_4)]
+    pshufb xmm3, [lsym(cb_4)]
+    ; 4 x 4 dword transpose
+    movdqa xmm4, xmm0
+    punpckhdq xmm4, xmm1
+    punpckldq xmm0, xmm1
+    movdqa xmm5, xmm2
+    punpckhdq xmm5, xmm3
+    punpckldq xmm2, xmm3
+    movdqa xmm1, xmm0
+    punpckhqdq xmm1, xmm2
+    punpcklqdq xmm0, xmm2
+    punpcklqdq xmm4, xmm5
+    movdqa xmm8, xmm4                   ; r
+    movdqa xmm9, xmm1                   ; g
+    movdqa xmm10, xmm0                  ; b
+    pxor xmm0, xmm0
+    ; pixels 0 to 7
+    movdqa xmm1, xmm8
+    movdqa xmm2, xmm9
+    movdqa xmm3, xmm10
+    punpcklbw xmm1, xmm0
+    punpcklbw xmm2, xmm0
+    punpcklbw xmm3, xmm0
+    movdqa xmm4, xmm1                   ; r, g
+    punpcklwd xmm4, xmm2
+    punpckhwd xmm1, xmm2
+    movdqa xmm5, xmm2                   ; g, b
+    punpcklwd xmm5, xmm3
+    punpckhwd xmm2, xmm3
+
+    ; y = (r *  19595 + g *  38470 + b *   7471) >> 16
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwy_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwy_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm4
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwy_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwy_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm1
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r8 + rax], xmm3
+
+    ; u = ((r * -11071 + g * -21736 + b *  32807) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwu_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwu_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm5
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwu_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwu_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm2
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r9 + rax], xmm3
+
+    ; v = ((r *  32756 + g * -27429 + b *  -5327) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwv_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwv_gb)]
+    paddd xmm3, xmm6
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwv_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwv_gb)]
+    paddd xmm6, xmm7
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r10 + rax], xmm3
+
+    ; pixels 8 to 15
+    movdqa xmm1, xmm8
+    movdqa xmm2, xmm9
+    movdqa xmm3, xmm10
+    punpckhbw xmm1, xmm0
+    punpckhbw xmm2, xmm0
+    punpckhbw xmm3, xmm0
+    movdqa xmm4, xmm1                   ; r, g
+    punpcklwd xmm4, xmm2
+    punpckhwd xmm1, xmm2
+    movdqa xmm5, xmm2                   ; g, b
+    punpcklwd xmm5, xmm3
+    punpckhwd xmm2, xmm3
+
+    ; y = (r *  19595 + g *  38470 + b *   7471) >> 16
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwy_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwy_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm4
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwy_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwy_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm1
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r8 + rax + 8], xmm3
+
+    ; u = ((r * -11071 + g * -21736 + b *  32807) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwu_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwu_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm5
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwu_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwu_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm2
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r9 + rax + 8], xmm3
+
+    ; v = ((r *  32756 + g * -27429 + b *  -5327) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwv_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwv_gb)]
+    paddd xmm3, xmm6
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwv_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwv_gb)]
+    paddd xmm6, xmm7
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r10 + rax + 8], xmm3
+
+    lea rbx, [rbx + 16 * 4]
+    lea rax, [rax + 16]
+    sub r12d, 16
+    jnz loop13_x16
+    ; next row
+    lea rax, [rax + 64]
+    sub rax, rdx
+    add rdi, rsi
+    dec ecx
+    jnz loop13_y
+
+loop1_done:
+    ; restore registers
+    pop r12
+    pop rbx
+
+    ; epilogue
+%ifdef DEBUG
+    mov rsp, rbp
+    pop rbp
+%endif
+
+    mov eax, 0                          ; return value
+    ret
+
+;******************************************************************************
+;int
+;rfxcodec_encode_rgba_to_yuva_amd64_ssse3(const char *src,
+;                                         int stride_bytes,
+;                                         int count,
+;                                         int height,
+;                                         unsigned char *y_buf,
+;                                         unsigned char *u_buf,
+;                                         unsigned char *v_buf,
+;                                         unsigned char *a_buf);
+PROC rfxcodec_encode_rgba_to_yuva_amd64_ssse3
+    ; stack args first, the prologue moves rsp
+    mov r10, [rsp + 8]                  ; v_buf
+    mov r11, [rsp + 16]                 ; a_buf, can be NULL
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    ; save registers
+    push rbx
+    push r12
+    movsxd rsi, esi
+    movsxd rdx, edx
+    xor eax, eax                        ; dst offset
+    test ecx, ecx
+    jz loop2_done
+    test edx, edx
+    jz loop2_done
+    test r11, r11
+    jz loop23_y                         ; no alpha
+
+loop2_y:
+    mov rbx, rdi
+    mov r12d, edx
+loop2_x16:
+    ; 16 pixels, split
+    movdqu xmm0, [rbx]
+    movdqu xmm1, [rbx + 16]
+    movdqu xmm2, [rbx + 32]
+    movdqu xmm3, [rbx + 48]
+    pshufb xmm0, [lsym(cb_4)]
+    pshufb xmm1, [lsym(cb_4)]
+    pshufb xmm2, [lsym(cb_4)]
+    pshufb xmm3, [lsym(cb_4)]
+    ; 4 x 4 dword transpose
+    movdqa xmm4, xmm0
+    punpckhdq xmm4, xmm1
+    punpckldq xmm0, xmm1
+    movdqa xmm5, xmm2
+    punpckhdq xmm5, xmm3
+    punpckldq xmm2, xmm3
+    movdqa xmm1, xmm0
+    punpckhqdq xmm1, xmm2
+    punpcklqdq xmm0, xmm2
+    movdqa xmm3, xmm4
+    punpckhqdq xmm3, xmm5
+    movdqu [r11 + rax], xmm3            ; a
+    punpcklqdq xmm4, xmm5
+    movdqa xmm8, xmm0                   ; r
+    movdqa xmm9, xmm1                   ; g
+    movdqa xmm10, xmm4                  ; b
+    pxor xmm0, xmm0
+    ; pixels 0 to 7
+    movdqa xmm1, xmm8
+    movdqa xmm2, xmm9
+    movdqa xmm3, xmm10
+    punpcklbw xmm1, xmm0
+    punpcklbw xmm2, xmm0
+    punpcklbw xmm3, xmm0
+    movdqa xmm4, xmm1                   ; r, g
+    punpcklwd xmm4, xmm2
+    punpckhwd xmm1, xmm2
+    movdqa xmm5, xmm2                   ; g, b
+    punpcklwd xmm5, xmm3
+    punpckhwd xmm2, xmm3
+
+    ; y = (r *  19595 + g *  38470 + b *   7471) >> 16
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwy_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwy_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm4
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwy_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwy_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm1
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r8 + rax], xmm3
+
+    ; u = ((r * -11071 + g * -21736 + b *  32807) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwu_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwu_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm5
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwu_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwu_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm2
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r9 + rax], xmm3
+
+    ; v = ((r *  32756 + g * -27429 + b *  -5327) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwv_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwv_gb)]
+    paddd xmm3, xmm6
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwv_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwv_gb)]
+    paddd xmm6, xmm7
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r10 + rax], xmm3
+
+    ; pixels 8 to 15
+    movdqa xmm1, xmm8
+    movdqa xmm2, xmm9
+    movdqa xmm3, xmm10
+    punpckhbw xmm1, xmm0
+    punpckhbw xmm2, xmm0
+    punpckhbw xmm3, xmm0
+    movdqa xmm4, xmm1                   ; r, g
+    punpcklwd xmm4, xmm2
+    punpckhwd xmm1, xmm2
+    movdqa xmm5, xmm2                   ; g, b
+    punpcklwd xmm5, xmm3
+    punpckhwd xmm2, xmm3
+
+    ; y = (r *  19595 + g *  38470 + b *   7471) >> 16
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwy_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwy_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm4
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwy_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwy_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm1
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r8 + rax + 8], xmm3
+
+    ; u = ((r * -11071 + g * -21736 + b *  32807) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwu_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwu_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm5
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwu_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwu_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm2
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r9 + rax + 8], xmm3
+
+    ; v = ((r *  32756 + g * -27429 + b *  -5327) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwv_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwv_gb)]
+    paddd xmm3, xmm6
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwv_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwv_gb)]
+    paddd xmm6, xmm7
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r10 + rax + 8], xmm3
+
+    lea rbx, [rbx + 16 * 4]
+    lea rax, [rax + 16]
+    sub r12d, 16
+    jnz loop2_x16
+    ; next row
+    lea rax, [rax + 64]
+    sub rax, rdx
+    add rdi, rsi
+    dec ecx
+    jnz loop2_y
+    jmp loop2_done
+
+    ; no alpha
+loop23_y:
+    mov rbx, rdi
+    mov r12d, edx
+loop23_x16:
+    ; 16 pixels, split
+    movdqu xmm0, [rbx]
+    movdqu xmm1, [rbx + 16]
+    movdqu xmm2, [rbx + 32]
+    movdqu xmm3, [rbx + 48]
+    pshufb xmm0, [lsym(cb_4)]
+    pshufb xmm1, [lsym(cb_4)]
+    pshufb xmm2, [lsym(cb_4)]
+    pshufb xmm3, [lsym(cb_4)]
+    ; 4 x 4 dword transpose
+    movdqa xmm4, xmm0
+    punpckhdq xmm4, xmm1
+    punpckldq xmm0, xmm1
+    movdqa xmm5, xmm2
+    punpckhdq xmm5, xmm3
+    punpckldq xmm2, xmm3
+    movdqa xmm1, xmm0
+    punpckhqdq xmm1, xmm2
+    punpcklqdq xmm0, xmm2
+    punpcklqdq xmm4, xmm5
+    movdqa xmm8, xmm0                   ; r
+    movdqa xmm9, xmm1                   ; g
+    movdqa xmm10, xmm4                  ; b
+    pxor xmm0, xmm0
+    ; pixels 0 to 7
+    movdqa xmm1, xmm8
+    movdqa xmm2, xmm9
+    movdqa xmm3, xmm10
+    punpcklbw xmm1, xmm0
+    punpcklbw xmm2, xmm0
+    punpcklbw xmm3, xmm0
+    movdqa xmm4, xmm1                   ; r, g
+    punpcklwd xmm4, xmm2
+    punpckhwd xmm1, xmm2
+    movdqa xmm5, xmm2                   ; g, b
+    punpcklwd xmm5, xmm3
+    punpckhwd xmm2, xmm3
+
+    ; y = (r *  19595 + g *  38470 + b *   7471) >> 16
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwy_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwy_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm4
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwy_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwy_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm1
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r8 + rax], xmm3
+
+    ; u = ((r * -11071 + g * -21736 + b *  32807) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwu_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwu_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm5
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwu_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwu_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm2
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r9 + rax], xmm3
+
+    ; v = ((r *  32756 + g * -27429 + b *  -5327) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwv_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwv_gb)]
+    paddd xmm3, xmm6
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwv_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwv_gb)]
+    paddd xmm6, xmm7
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r10 + rax], xmm3
+
+    ; pixels 8 to 15
+    movdqa xmm1, xmm8
+    movdqa xmm2, xmm9
+    movdqa xmm3, xmm10
+    punpckhbw xmm1, xmm0
+    punpckhbw xmm2, xmm0
+    punpckhbw xmm3, xmm0
+    movdqa xmm4, xmm1                   ; r, g
+    punpcklwd xmm4, xmm2
+    punpckhwd xmm1, xmm2
+    movdqa xmm5, xmm2                   ; g, b
+    punpcklwd xmm5, xmm3
+    punpckhwd xmm2, xmm3
+
+    ; y = (r *  19595 + g *  38470 + b *   7471) >> 16
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwy_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwy_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm4
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwy_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwy_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm1
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r8 + rax + 8], xmm3
+
+    ; u = ((r * -11071 + g * -21736 + b *  32807) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwu_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwu_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm5
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwu_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwu_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm2
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r9 + rax + 8], xmm3
+
+    ; v = ((r *  32756 + g * -27429 + b *  -5327) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwv_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwv_gb)]
+    paddd xmm3, xmm6
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwv_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwv_gb)]
+    paddd xmm6, xmm7
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r10 + rax + 8], xmm3
+
+    lea rbx, [rbx + 16 * 4]
+    lea rax, [rax + 16]
+    sub r12d, 16
+    jnz loop23_x16
+    ; next row
+    lea rax, [rax + 64]
+    sub rax, rdx
+    add rdi, rsi
+    dec ecx
+    jnz loop23_y
+
+loop2_done:
+    ; restore registers
+    pop r12
+    pop rbx
+
+    ; epilogue
+%ifdef DEBUG
+    mov rsp, rbp
+    pop rbp
+%endif
+
+    mov eax, 0                          ; return value
+    ret
+
+;******************************************************************************
+;int
+;rfxcodec_encode_bgr_to_yuv_amd64_ssse3(const char *src,
+;                                       int stride_bytes,
+;                                       int count,
+;                                       int height,
+;                                       unsigned char *y_buf,
+;                                       unsigned char *u_buf,
+;                                       unsigned char *v_buf);
+PROC rfxcodec_encode_bgr_to_yuv_amd64_ssse3
+    ; stack args first, the prologue moves rsp
+    mov r10, [rsp + 8]                  ; v_buf
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    ; save registers
+    push rbx
+    push r12
+    movsxd rsi, esi
+    movsxd rdx, edx
+    xor eax, eax                        ; dst offset
+    test ecx, ecx
+    jz loop3_done
+    test edx, edx
+    jz loop3_done
+
+loop3_y:
+    mov rbx, rdi
+    mov r12d, edx
+loop3_x16:
+    ; 16 pixels, split
+    movdqu xmm0, [rbx]
+    movdqu xmm1, [rbx + 16]
+    movdqu xmm2, [rbx + 32]
+    movdqa xmm5, xmm0
+    pshufb xmm5, [lsym(cb_3_00)]
+    movdqa xmm4, xmm1
+    pshufb xmm4, [lsym(cb_3_01)]
+    por xmm5, xmm4
+    movdqa xmm4, xmm2
+    pshufb xmm4, [lsym(cb_3_02)]
+    por xmm5, xmm4
+    movdqa xmm6, xmm0
+    pshufb xmm6, [lsym(cb_3_10)]
+    movdqa xmm4, xmm1
+    pshufb xmm4, [lsym(cb_3_11)]
+    por xmm6, xmm4
+    movdqa xmm4, xmm2
+    pshufb xmm4, [lsym(cb_3_12)]
+    por xmm6, xmm4
+    movdqa xmm7, xmm0
+    pshufb xmm7, [lsym(cb_3_20)]
+    movdqa xmm4, xmm1
+    pshufb xmm4, [lsym(cb_3_21)]
+    por xmm7, xmm4
+    movdqa xmm4, xmm2
+    pshufb xmm4, [lsym(cb_3_22)]
+    por xmm7, xmm4
+    movdqa xmm8, xmm7                   ; r
+    movdqa xmm9, xmm6                   ; g
+    movdqa xmm10, xmm5                  ; b
+    pxor xmm0, xmm0
+    ; pixels 0 to 7
+    movdqa xmm1, xmm8
+    movdqa xmm2, xmm9
+    movdqa xmm3, xmm10
+    punpcklbw xmm1, xmm0
+    punpcklbw xmm2, xmm0
+    punpcklbw xmm3, xmm0
+    movdqa xmm4, xmm1                   ; r, g
+    punpcklwd xmm4, xmm2
+    punpckhwd xmm1, xmm2
+    movdqa xmm5, xmm2                   ; g, b
+    punpcklwd xmm5, xmm3
+    punpckhwd xmm2, xmm3
+
+    ; y = (r *  19595 + g *  38470 + b *   7471) >> 16
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwy_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwy_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm4
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwy_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwy_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm1
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r8 + rax], xmm3
+
+    ; u = ((r * -11071 + g * -21736 + b *  32807) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwu_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwu_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm5
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwu_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwu_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm2
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r9 + rax], xmm3
+
+    ; v = ((r *  32756 + g * -27429 + b *  -5327) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwv_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwv_gb)]
+    paddd xmm3, xmm6
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwv_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwv_gb)]
+    paddd xmm6, xmm7
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r10 + rax], xmm3
+
+    ; pixels 8 to 15
+    movdqa xmm1, xmm8
+    movdqa xmm2, xmm9
+    movdqa xmm3, xmm10
+    punpckhbw xmm1, xmm0
+    punpckhbw xmm2, xmm0
+    punpckhbw xmm3, xmm0
+    movdqa xmm4, xmm1                   ; r, g
+    punpcklwd xmm4, xmm2
+    punpckhwd xmm1, xmm2
+    movdqa xmm5, xmm2                   ; g, b
+    punpcklwd xmm5, xmm3
+    punpckhwd xmm2, xmm3
+
+    ; y = (r *  19595 + g *  38470 + b *   7471) >> 16
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwy_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwy_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm4
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwy_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwy_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm1
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r8 + rax + 8], xmm3
+
+    ; u = ((r * -11071 + g * -21736 + b *  32807) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwu_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwu_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm5
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwu_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwu_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm2
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r9 + rax + 8], xmm3
+
+    ; v = ((r *  32756 + g * -27429 + b *  -5327) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwv_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwv_gb)]
+    paddd xmm3, xmm6
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwv_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwv_gb)]
+    paddd xmm6, xmm7
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r10 + rax + 8], xmm3
+
+    lea rbx, [rbx + 16 * 3]
+    lea rax, [rax + 16]
+    sub r12d, 16
+    jnz loop3_x16
+    ; next row
+    lea rax, [rax + 64]
+    sub rax, rdx
+    add rdi, rsi
+    dec ecx
+    jnz loop3_y
+
+loop3_done:
+    ; restore registers
+    pop r12
+    pop rbx
+
+    ; epilogue
+%ifdef DEBUG
+    mov rsp, rbp
+    pop rbp
+%endif
+
+    mov eax, 0                          ; return value
+    ret
+
+;******************************************************************************
+;int
+;rfxcodec_encode_rgb_to_yuv_amd64_ssse3(const char *src,
+;                                       int stride_bytes,
+;                                       int count,
+;                                       int height,
+;                                       unsigned char *y_buf,
+;                                       unsigned char *u_buf,
+;                                       unsigned char *v_buf);
+PROC rfxcodec_encode_rgb_to_yuv_amd64_ssse3
+    ; stack args first, the prologue moves rsp
+    mov r10, [rsp + 8]                  ; v_buf
+%ifdef DEBUG
+    push rbp
+    mov rbp, rsp
+%endif
+
+    ; save registers
+    push rbx
+    push r12
+    movsxd rsi, esi
+    movsxd rdx, edx
+    xor eax, eax                        ; dst offset
+    test ecx, ecx
+    jz loop4_done
+    test edx, edx
+    jz loop4_done
+
+loop4_y:
+    mov rbx, rdi
+    mov r12d, edx
+loop4_x16:
+    ; 16 pixels, split
+    movdqu xmm0, [rbx]
+    movdqu xmm1, [rbx + 16]
+    movdqu xmm2, [rbx + 32]
+    movdqa xmm5, xmm0
+    pshufb xmm5, [lsym(cb_3_00)]
+    movdqa xmm4, xmm1
+    pshufb xmm4, [lsym(cb_3_01)]
+    por xmm5, xmm4
+    movdqa xmm4, xmm2
+    pshufb xmm4, [lsym(cb_3_02)]
+    por xmm5, xmm4
+    movdqa xmm6, xmm0
+    pshufb xmm6, [lsym(cb_3_10)]
+    movdqa xmm4, xmm1
+    pshufb xmm4, [lsym(cb_3_11)]
+    por xmm6, xmm4
+    movdqa xmm4, xmm2
+    pshufb xmm4, [lsym(cb_3_12)]
+    por xmm6, xmm4
+    movdqa xmm7, xmm0
+    pshufb xmm7, [lsym(cb_3_20)]
+    movdqa xmm4, xmm1
+    pshufb xmm4, [lsym(cb_3_21)]
+    por xmm7, xmm4
+    movdqa xmm4, xmm2
+    pshufb xmm4, [lsym(cb_3_22)]
+    por xmm7, xmm4
+    movdqa xmm8, xmm5                   ; r
+    movdqa xmm9, xmm6                   ; g
+    movdqa xmm10, xmm7                  ; b
+    pxor xmm0, xmm0
+    ; pixels 0 to 7
+    movdqa xmm1, xmm8
+    movdqa xmm2, xmm9
+    movdqa xmm3, xmm10
+    punpcklbw xmm1, xmm0
+    punpcklbw xmm2, xmm0
+    punpcklbw xmm3, xmm0
+    movdqa xmm4, xmm1                   ; r, g
+    punpcklwd xmm4, xmm2
+    punpckhwd xmm1, xmm2
+    movdqa xmm5, xmm2                   ; g, b
+    punpcklwd xmm5, xmm3
+    punpckhwd xmm2, xmm3
+
+    ; y = (r *  19595 + g *  38470 + b *   7471) >> 16
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwy_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwy_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm4
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwy_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwy_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm1
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r8 + rax], xmm3
+
+    ; u = ((r * -11071 + g * -21736 + b *  32807) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwu_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwu_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm5
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwu_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwu_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm2
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r9 + rax], xmm3
+
+    ; v = ((r *  32756 + g * -27429 + b *  -5327) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwv_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwv_gb)]
+    paddd xmm3, xmm6
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwv_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwv_gb)]
+    paddd xmm6, xmm7
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r10 + rax], xmm3
+
+    ; pixels 8 to 15
+    movdqa xmm1, xmm8
+    movdqa xmm2, xmm9
+    movdqa xmm3, xmm10
+    punpckhbw xmm1, xmm0
+    punpckhbw xmm2, xmm0
+    punpckhbw xmm3, xmm0
+    movdqa xmm4, xmm1                   ; r, g
+    punpcklwd xmm4, xmm2
+    punpckhwd xmm1, xmm2
+    movdqa xmm5, xmm2                   ; g, b
+    punpcklwd xmm5, xmm3
+    punpckhwd xmm2, xmm3
+
+    ; y = (r *  19595 + g *  38470 + b *   7471) >> 16
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwy_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwy_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm4
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwy_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwy_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm1
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r8 + rax + 8], xmm3
+
+    ; u = ((r * -11071 + g * -21736 + b *  32807) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwu_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwu_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm5
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwu_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwu_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm2
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r9 + rax + 8], xmm3
+
+    ; v = ((r *  32756 + g * -27429 + b *  -5327) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwv_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwv_gb)]
+    paddd xmm3, xmm6
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwv_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwv_gb)]
+    paddd xmm6, xmm7
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [r10 + rax + 8], xmm3
+
+    lea rbx, [rbx + 16 * 3]
+    lea rax, [rax + 16]
+    sub r12d, 16
+    jnz loop4_x16
+    ; next row
+    lea rax, [rax + 64]
+    sub rax, rdx
+    add rdi, rsi
+    dec ecx
+    jnz loop4_y
+
+loop4_done:
+    ; restore registers
+    pop r12
+    pop rbx
+
+    ; epilogue
+%ifdef DEBUG
+    mov rsp, rbp
+    pop rbp
+%endif
+
+    mov eax, 0                          ; return value
+    ret
+
+END_OF_FILE
@@ -26,6 +26,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <rfxcodec_encode.h>
+
 #include "rfxcommon.h"
 #include "rfxencode.h"
 #include "rfxencode_differential.h"
@@ -35,6 +37,7 @@
 #include "rfxencode_diff_rlgr1.h"
 #include "rfxencode_diff_rlgr3.h"
 #include "rfxencode_tile.h"
+#include "rfxencode_rgb_to_yuv.h"
 
 #include "amd64/funcs_amd64.h"
 
@@ -42,6 +45,23 @@
 #define LLOGLN(_level, _args) \
     do { if (_level < LLOG_LEVEL) { printf _args ; printf("\n"); } } while (0)
 
+/******************************************************************************/
+/* columns up to a multiple of 16 go through the SIMD kernels, the rest and
+   the 64 x 64 padding through the C tail, the padding repeats the last pixel
+   the tail read so a tile narrower than 64 always leaves it some columns */
+static int
+get_simd_count(int width)
+{
+    int count;
+
+    count = width & ~15;
+    if ((count == width) && (width < 64))
+    {
+        count -= 16;
+    }
+    return count;
+}
+
 /******************************************************************************/
 int
 rfx_encode_component_rlgr1_amd64_sse2(struct rfxencode *enc, const char *qtable,
@@ -54,7 +74,9 @@ rfx_encode_component_rlgr1_amd64_sse2(struct rfxencode *enc, const char *qtable,
     {
         return 1;
     }
-    *size = rfx_encode_diff_rlgr1(enc->dwt_buffer1, buffer, buffer_size, 64);
+    *size = enc->rfx_encode_diff_rlgr1(enc->dwt_buffer1, buffer,
+                                       buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
     return 0;
 }
 
@@ -70,7 +92,9 @@ rfx_encode_component_rlgr3_amd64_sse2(struct rfxencode *enc, const char *qtable,
     {
         return 1;
     }
-    *size = rfx_encode_diff_rlgr3(enc->dwt_buffer1, buffer, buffer_size, 64);
+    *size = enc->rfx_encode_diff_rlgr3(enc->dwt_buffer1, buffer,
+                                       buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
     return 0;
 }
 
@@ -86,7 +110,9 @@ rfx_encode_component_rlgr1_amd64_sse41(struct rfxencode *enc, const char *qtable
     {
         return 1;
     }
-    *size = rfx_encode_diff_rlgr1(enc->dwt_buffer1, buffer, buffer_size, 64);
+    *size = enc->rfx_encode_diff_rlgr1(enc->dwt_buffer1, buffer,
+                                       buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
     return 0;
 }
 
@@ -102,6 +128,629 @@ rfx_encode_component_rlgr3_amd64_sse41(struct rfxencode *enc, const char *qtable
     {
         return 1;
     }
-    *size = rfx_encode_diff_rlgr3(enc->dwt_buffer1, buffer, buffer_size, 64);
+    *size = enc->rfx_encode_diff_rlgr3(enc->dwt_buffer1, buffer,
+                                       buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_encode_dwt_shift_amd64_sse2(struct rfxencode *enc, const char *qtable,
+                                const uint8 *data, sint16 *coefs)
+{
+    return rfxcodec_encode_dwt_shift_amd64_sse2(qtable, data, coefs,
+                                                enc->dwt_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_dwt_h1_shift_amd64_sse2(struct rfxencode *enc, const char *qtable,
+                                   sint16 *v1_buffer, sint16 *coefs)
+{
+    return rfxcodec_encode_dwt_h1_shift_amd64_sse2(qtable, coefs, v1_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_dwt_shift_amd64_sse41(struct rfxencode *enc, const char *qtable,
+                                 const uint8 *data, sint16 *coefs)
+{
+    return rfxcodec_encode_dwt_shift_amd64_sse41(qtable, data, coefs,
+                                                 enc->dwt_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_dwt_h1_shift_amd64_sse41(struct rfxencode *enc, const char *qtable,
+                                    sint16 *v1_buffer, sint16 *coefs)
+{
+    return rfxcodec_encode_dwt_h1_shift_amd64_sse41(qtable, coefs, v1_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_component_rlgr1_amd64_avx2(struct rfxencode *enc, const char *qtable,
+                                      const uint8 *data,
+                                      uint8 *buffer, int buffer_size, int *size)
+{
+    LLOGLN(10, ("rfx_encode_component_rlgr1_amd64_avx2:"));
+    if (rfxcodec_encode_dwt_shift_amd64_avx2(qtable, data, enc->dwt_buffer1,
+                                             enc->dwt_buffer) != 0)
+    {
+        return 1;
+    }
+    *size = enc->rfx_encode_diff_rlgr1(enc->dwt_buffer1, buffer,
+                                       buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_encode_component_rlgr3_amd64_avx2(struct rfxencode *enc, const char *qtable,
+                                      const uint8 *data,
+                                      uint8 *buffer, int buffer_size, int *size)
+{
+    LLOGLN(10, ("rfx_encode_component_rlgr3_amd64_avx2:"));
+    if (rfxcodec_encode_dwt_shift_amd64_avx2(qtable, data, enc->dwt_buffer1,
+                                             enc->dwt_buffer) != 0)
+    {
+        return 1;
+    }
+    *size = enc->rfx_encode_diff_rlgr3(enc->dwt_buffer1, buffer,
+                                       buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
     return 0;
 }
+
+/******************************************************************************/
+int
+rfx_encode_dwt_shift_amd64_avx2(struct rfxencode *enc, const char *qtable,
+                                const uint8 *data, sint16 *coefs)
+{
+    return rfxcodec_encode_dwt_shift_amd64_avx2(qtable, data, coefs,
+                                                enc->dwt_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_dwt_h1_shift_amd64_avx2(struct rfxencode *enc, const char *qtable,
+                                   sint16 *v1_buffer, sint16 *coefs)
+{
+    return rfxcodec_encode_dwt_h1_shift_amd64_avx2(qtable, coefs, v1_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_component_rlgr1_amd64_avx512(struct rfxencode *enc, const char *qtable,
+                                        const uint8 *data,
+                                        uint8 *buffer, int buffer_size, int *size)
+{
+    LLOGLN(10, ("rfx_encode_component_rlgr1_amd64_avx512:"));
+    if (rfxcodec_encode_dwt_shift_amd64_avx512(qtable, data, enc->dwt_buffer1,
+                                               enc->dwt_buffer) != 0)
+    {
+        return 1;
+    }
+    *size = enc->rfx_encode_diff_rlgr1(enc->dwt_buffer1, buffer,
+                                       buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_encode_component_rlgr3_amd64_avx512(struct rfxencode *enc, const char *qtable,
+                                        const uint8 *data,
+                                        uint8 *buffer, int buffer_size, int *size)
+{
+    LLOGLN(10, ("rfx_encode_component_rlgr3_amd64_avx512:"));
+    if (rfxcodec_encode_dwt_shift_amd64_avx512(qtable, data, enc->dwt_buffer1,
+                                               enc->dwt_buffer) != 0)
+    {
+        return 1;
+    }
+    *size = enc->rfx_encode_diff_rlgr3(enc->dwt_buffer1, buffer,
+                                       buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_encode_dwt_shift_amd64_avx512(struct rfxencode *enc, const char *qtable,
+                                  const uint8 *data, sint16 *coefs)
+{
+    return rfxcodec_encode_dwt_shift_amd64_avx512(qtable, data, coefs,
+                                                  enc->dwt_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_dwt_h1_shift_amd64_avx512(struct rfxencode *enc, const char *qtable,
+                                     sint16 *v1_buffer, sint16 *coefs)
+{
+    return rfxcodec_encode_dwt_h1_shift_amd64_avx512(qtable, coefs, v1_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_rgb_to_yuv_amd64_sse2(struct rfxencode *enc, const char *rgb_data,
+                                 int width, int height, int stride_bytes)
+{
+    if (enc->rfx_encode_format_rgb(rgb_data, width, height, stride_bytes,
+                                   enc->format, enc->y_r_buffer,
+                                   enc->u_g_buffer, enc->v_b_buffer) != 0)
+    {
+        return 1;
+    }
+    return rfxcodec_encode_rgb_to_yuv_tile_amd64_sse2(enc->y_r_buffer,
+                                                      enc->u_g_buffer,
+                                                      enc->v_b_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_argb_to_yuva_amd64_sse2(struct rfxencode *enc,
+                                   const char *argb_data, int width,
+                                   int height, int stride_bytes)
+{
+    if (enc->rfx_encode_format_argb(argb_data, width, height, stride_bytes,
+                                    enc->format, enc->a_buffer,
+                                    enc->y_r_buffer, enc->u_g_buffer,
+                                    enc->v_b_buffer) != 0)
+    {
+        return 1;
+    }
+    return rfxcodec_encode_rgb_to_yuv_tile_amd64_sse2(enc->y_r_buffer,
+                                                      enc->u_g_buffer,
+                                                      enc->v_b_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_format_rgb_amd64_ssse3(const char *rgb_data, int width, int height,
+                                  int stride_bytes, int pixel_format,
+                                  uint8 *r_buf, uint8 *g_buf, uint8 *b_buf)
+{
+    int count;
+
+    count = get_simd_count(width);
+    if (count > 0)
+    {
+        switch (pixel_format)
+        {
+            case RFX_FORMAT_BGRA:
+                rfxcodec_encode_deinterleave4_amd64_ssse3(rgb_data, stride_bytes,
+                    count, height, b_buf, g_buf, r_buf, NULL);
+                break;
+            case RFX_FORMAT_RGBA:
+                rfxcodec_encode_deinterleave4_amd64_ssse3(rgb_data, stride_bytes,
+                    count, height, r_buf, g_buf, b_buf, NULL);
+                break;
+            case RFX_FORMAT_BGR:
+                rfxcodec_encode_deinterleave3_amd64_ssse3(rgb_data, stride_bytes,
+                    count, height, b_buf, g_buf, r_buf);
+                break;
+            case RFX_FORMAT_RGB:
+                rfxcodec_encode_deinterleave3_amd64_ssse3(rgb_data, stride_bytes,
+                    count, height, r_buf, g_buf, b_buf);
+                break;
+            default:
+                count = 0;
+                break;
+        }
+    }
+    else
+    {
+        count = 0;
+    }
+    return rfx_encode_format_rgb_tail(rgb_data, width, height, stride_bytes,
+                                      pixel_format, count,
+                                      r_buf, g_buf, b_buf);
+}
+
+/******************************************************************************/
+int
+rfx_encode_format_argb_amd64_ssse3(const char *argb_data, int width, int height,
+                                   int stride_bytes, int pixel_format,
+                                   uint8 *a_buf, uint8 *r_buf, uint8 *g_buf,
+                                   uint8 *b_buf)
+{
+    int count;
+
+    count = get_simd_count(width);
+    if (count > 0)
+    {
+        switch (pixel_format)
+        {
+            case RFX_FORMAT_BGRA:
+                rfxcodec_encode_deinterleave4_amd64_ssse3(argb_data, stride_bytes,
+                    count, height, b_buf, g_buf, r_buf, a_buf);
+                break;
+            case RFX_FORMAT_RGBA:
+                rfxcodec_encode_deinterleave4_amd64_ssse3(argb_data, stride_bytes,
+                    count, height, r_buf, g_buf, b_buf, a_buf);
+                break;
+            case RFX_FORMAT_BGR:
+                rfxcodec_encode_deinterleave3_amd64_ssse3(argb_data, stride_bytes,
+                    count, height, b_buf, g_buf, r_buf);
+                break;
+            case RFX_FORMAT_RGB:
+                rfxcodec_encode_deinterleave3_amd64_ssse3(argb_data, stride_bytes,
+                    count, height, r_buf, g_buf, b_buf);
+                break;
+            default:
+                count = 0;
+                break;
+        }
+    }
+    else
+    {
+        count = 0;
+    }
+    return rfx_encode_format_argb_tail(argb_data, width, height, stride_bytes,
+                                       pixel_format, count,
+                                       a_buf, r_buf, g_buf, b_buf);
+}
+
+/******************************************************************************/
+int
+rfx_encode_format_rgb_amd64_avx2(const char *rgb_data, int width, int height,
+                                 int stride_bytes, int pixel_format,
+                                 uint8 *r_buf, uint8 *g_buf, uint8 *b_buf)
+{
+    int count;
+
+    count = get_simd_count(width);
+    if (count > 0)
+    {
+        switch (pixel_format)
+        {
+            case RFX_FORMAT_BGRA:
+                rfxcodec_encode_deinterleave4_amd64_avx2(rgb_data, stride_bytes,
+                    count, height, b_buf, g_buf, r_buf, NULL);
+                break;
+            case RFX_FORMAT_RGBA:
+                rfxcodec_encode_deinterleave4_amd64_avx2(rgb_data, stride_bytes,
+                    count, height, r_buf, g_buf, b_buf, NULL);
+                break;
+            case RFX_FORMAT_BGR:
+                rfxcodec_encode_deinterleave3_amd64_avx2(rgb_data, stride_bytes,
+                    count, height, b_buf, g_buf, r_buf);
+                break;
+            case RFX_FORMAT_RGB:
+                rfxcodec_encode_deinterleave3_amd64_avx2(rgb_data, stride_bytes,
+                    count, height, r_buf, g_buf, b_buf);
+                break;
+            default:
+                count = 0;
+                break;
+        }
+    }
+    else
+    {
+        count = 0;
+    }
+    return rfx_encode_format_rgb_tail(rgb_data, width, height, stride_bytes,
+                                      pixel_format, count,
+                                      r_buf, g_buf, b_buf);
+}
+
+/******************************************************************************/
+int
+rfx_encode_format_argb_amd64_avx2(const char *argb_data, int width, int height,
+                                  int stride_bytes, int pixel_format,
+                                  uint8 *a_buf, uint8 *r_buf, uint8 *g_buf,
+                                  uint8 *b_buf)
+{
+    int count;
+
+    count = get_simd_count(width);
+    if (count > 0)
+    {
+        switch (pixel_format)
+        {
+            case RFX_FORMAT_BGRA:
+                rfxcodec_encode_deinterleave4_amd64_avx2(argb_data, stride_bytes,
+                    count, height, b_buf, g_buf, r_buf, a_buf);
+                break;
+            case RFX_FORMAT_RGBA:
+                rfxcodec_encode_deinterleave4_amd64_avx2(argb_data, stride_bytes,
+                    count, height, r_buf, g_buf, b_buf, a_buf);
+                break;
+            case RFX_FORMAT_BGR:
+                rfxcodec_encode_deinterleave3_amd64_avx2(argb_data, stride_bytes,
+                    count, height, b_buf, g_buf, r_buf);
+                break;
+            case RFX_FORMAT_RGB:
+                rfxcodec_encode_deinterleave3_amd64_avx2(argb_data, stride_bytes,
+                    count, height, r_buf, g_buf, b_buf);
+                break;
+            default:
+                count = 0;
+                break;
+        }
+    }
+    else
+    {
+        count = 0;
+    }
+    return rfx_encode_format_argb_tail(argb_data, width, height, stride_bytes,
+                                       pixel_format, count,
+                                       a_buf, r_buf, g_buf, b_buf);
+}
+
+/******************************************************************************/
+int
+rfx_encode_rgb_to_yuv_amd64_ssse3(struct rfxencode *enc, const char *rgb_data,
+                                  int width, int height, int stride_bytes)
+{
+    int count;
+
+    count = get_simd_count(width);
+    if (count > 0)
+    {
+        switch (enc->format)
+        {
+            case RFX_FORMAT_BGRA:
+                rfxcodec_encode_bgra_to_yuva_amd64_ssse3(rgb_data, stride_bytes,
+                    count, height, enc->y_r_buffer, enc->u_g_buffer,
+                    enc->v_b_buffer, NULL);
+                break;
+            case RFX_FORMAT_RGBA:
+                rfxcodec_encode_rgba_to_yuva_amd64_ssse3(rgb_data, stride_bytes,
+                    count, height, enc->y_r_buffer, enc->u_g_buffer,
+                    enc->v_b_buffer, NULL);
+                break;
+            case RFX_FORMAT_BGR:
+                rfxcodec_encode_bgr_to_yuv_amd64_ssse3(rgb_data, stride_bytes,
+                    count, height, enc->y_r_buffer, enc->u_g_buffer,
+                    enc->v_b_buffer);
+                break;
+            case RFX_FORMAT_RGB:
+                rfxcodec_encode_rgb_to_yuv_amd64_ssse3(rgb_data, stride_bytes,
+                    count, height, enc->y_r_buffer, enc->u_g_buffer,
+                    enc->v_b_buffer);
+                break;
+            default:
+                count = 0;
+                break;
+        }
+    }
+    else
+    {
+        count = 0;
+    }
+    return rfx_encode_rgb_to_yuv_tail(rgb_data, width, height, stride_bytes,
+                                      enc->format, count, NULL,
+                                      enc->y_r_buffer, enc->u_g_buffer,
+                                      enc->v_b_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_argb_to_yuva_amd64_ssse3(struct rfxencode *enc,
+                                    const char *argb_data, int width,
+                                    int height, int stride_bytes)
+{
+    int count;
+
+    count = get_simd_count(width);
+    if (count > 0)
+    {
+        switch (enc->format)
+        {
+            case RFX_FORMAT_BGRA:
+                rfxcodec_encode_bgra_to_yuva_amd64_ssse3(argb_data, stride_bytes,
+                    count, height, enc->y_r_buffer, enc->u_g_buffer,
+                    enc->v_b_buffer, enc->a_buffer);
+                break;
+            case RFX_FORMAT_RGBA:
+                rfxcodec_encode_rgba_to_yuva_amd64_ssse3(argb_data, stride_bytes,
+                    count, height, enc->y_r_buffer, enc->u_g_buffer,
+                    enc->v_b_buffer, enc->a_buffer);
+                break;
+            case RFX_FORMAT_BGR:
+                rfxcodec_encode_bgr_to_yuv_amd64_ssse3(argb_data, stride_bytes,
+                    count, height, enc->y_r_buffer, enc->u_g_buffer,
+                    enc->v_b_buffer);
+                break;
+            case RFX_FORMAT_RGB:
+                rfxcodec_encode_rgb_to_yuv_amd64_ssse3(argb_data, stride_bytes,
+                    count, height, enc->y_r_buffer, enc->u_g_buffer,
+                    enc->v_b_buffer);
+                break;
+            default:
+                count = 0;
+                break;
+        }
+    }
+    else
+    {
+        count = 0;
+    }
+    return rfx_encode_rgb_to_yuv_tail(argb_data, width, height, stride_bytes,
+                                      enc->format, count, enc->a_buffer,
+                                      enc->y_r_buffer, enc->u_g_buffer,
+                                      enc->v_b_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_rgb_to_yuv_amd64_avx2(struct rfxencode *enc, const char *rgb_data,
+                                 int width, int height, int stride_bytes)
+{
+    int count;
+
+    count = get_simd_count(width);
+    if (count > 0)
+    {
+        switch (enc->format)
+        {
+            case RFX_FORMAT_BGRA:
+                rfxcodec_encode_bgra_to_yuva_amd64_avx2(rgb_data, stride_bytes,
+                    count, height, enc->y_r_buffer, enc->u_g_buffer,
+                    enc->v_b_buffer, NULL);
+                break;
+            case RFX_FORMAT_RGBA:
+                rfxcodec_encode_rgba_to_yuva_amd64_avx2(rgb_data, stride_bytes,
+                    count, height, enc->y_r_buffer, enc->u_g_buffer,
+                    enc->v_b_buffer, NULL);
+                break;
+            case RFX_FORMAT_BGR:
+                rfxcodec_encode_bgr_to_yuv_amd64_avx2(rgb_data, stride_bytes,
+                    count, height, enc->y_r_buffer, enc->u_g_buffer,
+                    enc->v_b_buffer);
+                break;
+            case RFX_FORMAT_RGB:
+                rfxcodec_encode_rgb_to_yuv_amd64_avx2(rgb_data, stride_bytes,
+                    count, height, enc->y_r_buffer, enc->u_g_buffer,
+                    enc->v_b_buffer);
+                break;
+            default:
+                count = 0;
+                break;
+        }
+    }
+    else
+    {
+        count = 0;
+    }
+    return rfx_encode_rgb_to_yuv_tail(rgb_data, width, height, stride_bytes,
+                                      enc->format, count, NULL,
+                                      enc->y_r_buffer, enc->u_g_buffer,
+                                      enc->v_b_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_argb_to_yuva_amd64_avx2(struct rfxencode *enc, const char *argb_data,
+                                   int width, int height, int stride_bytes)
+{
+    int count;
+
+    count = get_simd_count(width);
+    if (count > 0)
+    {
+        switch (enc->format)
+        {
+            case RFX_FORMAT_BGRA:
+                rfxcodec_encode_bgra_to_yuva_amd64_avx2(argb_data, stride_bytes,
+                    count, height, enc->y_r_buffer, enc->u_g_buffer,
+                    enc->v_b_buffer, enc->a_buffer);
+                break;
+            case RFX_FORMAT_RGBA:
+                rfxcodec_encode_rgba_to_yuva_amd64_avx2(argb_data, stride_bytes,
+                    count, height, enc->y_r_buffer, enc->u_g_buffer,
+                    enc->v_b_buffer, enc->a_buffer);
+                break;
+            case RFX_FORMAT_BGR:
+                rfxcodec_encode_bgr_to_yuv_amd64_avx2(argb_data, stride_bytes,
+                    count, height, enc->y_r_buffer, enc->u_g_buffer,
+                    enc->v_b_buffer);
+                break;
+            case RFX_FORMAT_RGB:
+                rfxcodec_encode_rgb_to_yuv_amd64_avx2(argb_data, stride_bytes,
+                    count, height, enc->y_r_buffer, enc->u_g_buffer,
+                    enc->v_b_buffer);
+                break;
+            default:
+                count = 0;
+                break;
+        }
+    }
+    else
+    {
+        count = 0;
+    }
+    return rfx_encode_rgb_to_yuv_tail(argb_data, width, height, stride_bytes,
+                                      enc->format, count, enc->a_buffer,
+                                      enc->y_r_buffer, enc->u_g_buffer,
+                                      enc->v_b_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_rgb_to_yuv_row_amd64_ssse3(const char *rgb_row, int width,
+                                      int pixel_format, uint8 *a_row,
+                                      uint8 *y_row, uint8 *u_row, uint8 *v_row)
+{
+    int count;
+
+    count = get_simd_count(width);
+    if (count > 0)
+    {
+        switch (pixel_format)
+        {
+            case RFX_FORMAT_BGRA:
+                rfxcodec_encode_bgra_to_yuva_amd64_ssse3(rgb_row, 0, count, 1,
+                    y_row, u_row, v_row, a_row);
+                break;
+            case RFX_FORMAT_RGBA:
+                rfxcodec_encode_rgba_to_yuva_amd64_ssse3(rgb_row, 0, count, 1,
+                    y_row, u_row, v_row, a_row);
+                break;
+            case RFX_FORMAT_BGR:
+                rfxcodec_encode_bgr_to_yuv_amd64_ssse3(rgb_row, 0, count, 1,
+                    y_row, u_row, v_row);
+                break;
+            case RFX_FORMAT_RGB:
+                rfxcodec_encode_rgb_to_yuv_amd64_ssse3(rgb_row, 0, count, 1,
+                    y_row, u_row, v_row);
+                break;
+            default:
+                count = 0;
+                break;
+        }
+    }
+    else
+    {
+        count = 0;
+    }
+    return rfx_encode_rgb_to_yuv_row_tail(rgb_row, width, pixel_format, count,
+                                          a_row, y_row, u_row, v_row);
+}
+
+/******************************************************************************/
+int
+rfx_encode_rgb_to_yuv_row_amd64_avx2(const char *rgb_row, int width,
+                                     int pixel_format, uint8 *a_row,
+                                     uint8 *y_row, uint8 *u_row, uint8 *v_row)
+{
+    int count;
+
+    count = get_simd_count(width);
+    if (count > 0)
+    {
+        switch (pixel_format)
+        {
+            case RFX_FORMAT_BGRA:
+                rfxcodec_encode_bgra_to_yuva_amd64_avx2(rgb_row, 0, count, 1,
+                    y_row, u_row, v_row, a_row);
+                break;
+            case RFX_FORMAT_RGBA:
+                rfxcodec_encode_rgba_to_yuva_amd64_avx2(rgb_row, 0, count, 1,
+                    y_row, u_row, v_row, a_row);
+                break;
+            case RFX_FORMAT_BGR:
+                rfxcodec_encode_bgr_to_yuv_amd64_avx2(rgb_row, 0, count, 1,
+                    y_row, u_row, v_row);
+                break;
+            case RFX_FORMAT_RGB:
+                rfxcodec_encode_rgb_to_yuv_amd64_avx2(rgb_row, 0, count, 1,
+                    y_row, u_row, v_row);
+                break;
+            default:
+                count = 0;
+                break;
+        }
+    }
+    else
+    {
+        count = 0;
+    }
+    return rfx_encode_rgb_to_yuv_row_tail(rgb_row, width, pixel_format, count,
+                                          a_row, y_row, u_row, v_row);
+}
@@ -0,0 +1,63 @@
+/*
+Copyright 2026 librfxcodec contributors
+
+Permission to use, copy, modify, distribute, and sell this software and its
+documentation for any purpose is hereby granted without fee, provided that
+the above copyright notice appear in all copies and that both that
+copyright notice and this permission notice appear in supporting
+documentation.
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+OPEN GROUP BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+cpuid and xgetbv for the intrinsics build, see cpuid_amd64.asm
+
+*/
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <cpuid.h>
+
+#include "funcs_intrin.h"
+
+/******************************************************************************/
+int
+cpuid_intrin(int eax_in, int ecx_in, int *eax, int *ebx, int *ecx, int *edx)
+{
+    unsigned int a;
+    unsigned int b;
+    unsigned int c;
+    unsigned int d;
+
+    __cpuid_count(eax_in, ecx_in, a, b, c, d);
+    *eax = a;
+    *ebx = b;
+    *ecx = c;
+    *edx = d;
+    return 0;
+}
+
+/******************************************************************************/
+/* only called when cpuid says OSXSAVE, the opcode is used so no -mxsave is
+   needed */
+int
+xgetbv_intrin(int ecx_in, int *eax, int *edx)
+{
+    unsigned int a;
+    unsigned int d;
+
+    __asm__ __volatile__(".byte 0x0f, 0x01, 0xd0"
+                         : "=a" (a), "=d" (d) : "c" (ecx_in));
+    *eax = a;
+    *edx = d;
+    return 0;
+}
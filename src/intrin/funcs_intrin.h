@@ -0,0 +1,200 @@
+/*
+Copyright 2026 librfxcodec contributors
+
+Permission to use, copy, modify, distribute, and sell this software and its
+documentation for any purpose is hereby granted without fee, provided that
+the above copyright notice appear in all copies and that both that
+copyright notice and this permission notice appear in supporting
+documentation.
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+OPEN GROUP BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+intrinsics kernels, same arguments as the amd64 and x86 asm kernels
+
+*/
+
+#ifndef __FUNCS_INTRIN_H
+#define __FUNCS_INTRIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int
+cpuid_intrin(int eax_in, int ecx_in, int *eax, int *ebx, int *ecx, int *edx);
+int
+xgetbv_intrin(int ecx_in, int *eax, int *edx);
+int
+rfxcodec_encode_dwt_shift_intrin_sse2(const char *qtable,
+                                      const unsigned char *data,
+                                      short *dwt_buffer1, short *dwt_buffer);
+int
+rfxcodec_encode_dwt_h1_shift_intrin_sse2(const char *qtable, short *out_buffer,
+                                         short *v1_buffer);
+int
+rfxcodec_encode_dwt_v1_rows_intrin_sse2(const unsigned char *s0,
+                                        const unsigned char *s1,
+                                        const unsigned char *s2, int n,
+                                        short *y_v1, short *u_v1, short *v_v1);
+int
+rfxcodec_encode_diff_count_intrin_sse2(const short *coefs,
+                                       const short *history, short *diff,
+                                       short *history_out, int *diff_zeros,
+                                       int *coef_zeros);
+int
+rfxcodec_encode_nonzero_mask_intrin_sse2(const short *coefs,
+                                         unsigned int *mask);
+int
+rfxcodec_encode_alpha_delta_intrin_sse2(const unsigned char *plane,
+                                        unsigned char *delta,
+                                        unsigned int *mask);
+int
+rfxcodec_decode_dwt_intrin_sse2(short *buffer, short *dwt_buffer);
+int
+rfxcodec_decode_yuv_to_bgra_intrin_sse2(const short *y_buffer,
+                                        const short *u_buffer,
+                                        const short *v_buffer,
+                                        unsigned char *bgra_buffer);
+int
+rfxcodec_encode_bgra_to_yuva_intrin_sse2(const char *src, int stride_bytes,
+                                         int count, int height,
+                                         unsigned char *y_buf,
+                                         unsigned char *u_buf,
+                                         unsigned char *v_buf,
+                                         unsigned char *a_buf);
+int
+rfxcodec_encode_rgba_to_yuva_intrin_sse2(const char *src, int stride_bytes,
+                                         int count, int height,
+                                         unsigned char *y_buf,
+                                         unsigned char *u_buf,
+                                         unsigned char *v_buf,
+                                         unsigned char *a_buf);
+int
+rfxcodec_encode_dwt_shift_intrin_sse41(const char *qtable,
+                                       const unsigned char *data,
+                                       short *dwt_buffer1, short *dwt_buffer);
+int
+rfxcodec_encode_dwt_h1_shift_intrin_sse41(const char *qtable,
+                                          short *out_buffer, short *v1_buffer);
+int
+rfxcodec_encode_dwt_v1_rows_intrin_sse41(const unsigned char *s0,
+                                         const unsigned char *s1,
+                                         const unsigned char *s2, int n,
+                                         short *y_v1, short *u_v1,
+                                         short *v_v1);
+int
+rfxcodec_encode_diff_count_intrin_sse41(const short *coefs,
+                                        const short *history, short *diff,
+                                        short *history_out, int *diff_zeros,
+                                        int *coef_zeros);
+int
+rfxcodec_encode_nonzero_mask_intrin_sse41(const short *coefs,
+                                          unsigned int *mask);
+int
+rfxcodec_encode_alpha_delta_intrin_sse41(const unsigned char *plane,
+                                         unsigned char *delta,
+                                         unsigned int *mask);
+int
+rfxcodec_decode_dwt_intrin_sse41(short *buffer, short *dwt_buffer);
+int
+rfxcodec_decode_yuv_to_bgra_intrin_sse41(const short *y_buffer,
+                                         const short *u_buffer,
+                                         const short *v_buffer,
+                                         unsigned char *bgra_buffer);
+int
+rfxcodec_encode_bgra_to_yuva_intrin_sse41(const char *src, int stride_bytes,
+                                          int count, int height,
+                                          unsigned char *y_buf,
+                                          unsigned char *u_buf,
+                                          unsigned char *v_buf,
+                                          unsigned char *a_buf);
+int
+rfxcodec_encode_rgba_to_yuva_intrin_sse41(const char *src, int stride_bytes,
+                                          int count, int height,
+                                          unsigned char *y_buf,
+                                          unsigned char *u_buf,
+                                          unsigned char *v_buf,
+                                          unsigned char *a_buf);
+int
+rfxcodec_encode_bgr_to_yuv_intrin_sse41(const char *src, int stride_bytes,
+                                        int count, int height,
+                                        unsigned char *y_buf,
+                                        unsigned char *u_buf,
+                                        unsigned char *v_buf);
+int
+rfxcodec_encode_rgb_to_yuv_intrin_sse41(const char *src, int stride_bytes,
+                                        int count, int height,
+                                        unsigned char *y_buf,
+                                        unsigned char *u_buf,
+                                        unsigned char *v_buf);
+int
+rfxcodec_encode_dwt_shift_intrin_avx2(const char *qtable,
+                                      const unsigned char *data,
+                                      short *dwt_buffer1, short *dwt_buffer);
+int
+rfxcodec_encode_dwt_h1_shift_intrin_avx2(const char *qtable, short *out_buffer,
+                                         short *v1_buffer);
+int
+rfxcodec_encode_dwt_v1_rows_intrin_avx2(const unsigned char *s0,
+                                        const unsigned char *s1,
+                                        const unsigned char *s2, int n,
+                                        short *y_v1, short *u_v1, short *v_v1);
+int
+rfxcodec_encode_diff_count_intrin_avx2(const short *coefs,
+                                       const short *history, short *diff,
+                                       short *history_out, int *diff_zeros,
+                                       int *coef_zeros);
+int
+rfxcodec_encode_nonzero_mask_intrin_avx2(const short *coefs,
+                                         unsigned int *mask);
+int
+rfxcodec_encode_alpha_delta_intrin_avx2(const unsigned char *plane,
+                                        unsigned char *delta,
+                                        unsigned int *mask);
+int
+rfxcodec_decode_dwt_intrin_avx2(short *buffer, short *dwt_buffer);
+int
+rfxcodec_decode_yuv_to_bgra_intrin_avx2(const short *y_buffer,
+                                        const short *u_buffer,
+                                        const short *v_buffer,
+                                        unsigned char *bgra_buffer);
+int
+rfxcodec_encode_bgra_to_yuva_intrin_avx2(const char *src, int stride_bytes,
+                                         int count, int height,
+                                         unsigned char *y_buf,
+                                         unsigned char *u_buf,
+                                         unsigned char *v_buf,
+                                         unsigned char *a_buf);
+int
+rfxcodec_encode_rgba_to_yuva_intrin_avx2(const char *src, int stride_bytes,
+                                         int count, int height,
+                                         unsigned char *y_buf,
+                                         unsigned char *u_buf,
+                                         unsigned char *v_buf,
+                                         unsigned char *a_buf);
+int
+rfxcodec_encode_bgr_to_yuv_intrin_avx2(const char *src, int stride_bytes,
+                                       int count, int height,
+                                       unsigned char *y_buf,
+                                       unsigned char *u_buf,
+                                       unsigned char *v_buf);
+int
+rfxcodec_encode_rgb_to_yuv_intrin_avx2(const char *src, int stride_bytes,
+                                       int count, int height,
+                                       unsigned char *y_buf,
+                                       unsigned char *u_buf,
+                                       unsigned char *v_buf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
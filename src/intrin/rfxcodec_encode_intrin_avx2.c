@@ -0,0 +1,140 @@
+/*
+Copyright 2026 librfxcodec contributors
+
+Permission to use, copy, modify, distribute, and sell this software and its
+documentation for any purpose is hereby granted without fee, provided that
+the above copyright notice appear in all copies and that both that
+copyright notice and this permission notice appear in supporting
+documentation.
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+OPEN GROUP BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+intrinsics kernels, avx2
+
+*/
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <immintrin.h>
+
+#include "rfxcommon.h"
+#include "funcs_intrin.h"
+
+typedef __m256i rv_t;
+
+#define RV_NAME(_name) _name ## _intrin_avx2
+#define RV_LANES 16
+
+#define RV_LOAD(_p) _mm256_loadu_si256((const __m256i *) (_p))
+#define RV_STORE(_p, _v) _mm256_storeu_si256((__m256i *) (_p), _v)
+#define RV_LOAD_U8(_p) \
+    _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (_p)))
+#define RV_ZERO _mm256_setzero_si256()
+#define RV_SET1(_v) _mm256_set1_epi16(_v)
+#define RV_SET1_32(_v) _mm256_set1_epi32(_v)
+#define RV_ADD(_a, _b) _mm256_add_epi16(_a, _b)
+#define RV_SUB(_a, _b) _mm256_sub_epi16(_a, _b)
+#define RV_AND(_a, _b) _mm256_and_si256(_a, _b)
+#define RV_OR(_a, _b) _mm256_or_si256(_a, _b)
+#define RV_XOR(_a, _b) _mm256_xor_si256(_a, _b)
+#define RV_ANDNOT(_a, _b) _mm256_andnot_si256(_a, _b)
+#define RV_CMPEQ(_a, _b) _mm256_cmpeq_epi16(_a, _b)
+#define RV_SLLI(_a, _n) _mm256_slli_epi16(_a, _n)
+#define RV_SRAI(_a, _n) _mm256_srai_epi16(_a, _n)
+#define RV_SRA(_a, _n) _mm256_sra_epi16(_a, _n)
+#define RV_SRL(_a, _n) _mm256_srl_epi16(_a, _n)
+#define RV_ADD32(_a, _b) _mm256_add_epi32(_a, _b)
+#define RV_SLLI32(_a, _n) _mm256_slli_epi32(_a, _n)
+#define RV_SRLI32(_a, _n) _mm256_srli_epi32(_a, _n)
+#define RV_SRAI32(_a, _n) _mm256_srai_epi32(_a, _n)
+#define RV_MADD(_a, _b) _mm256_madd_epi16(_a, _b)
+/* the packs work in 128 bit lanes, 0xD8 puts the quarters back in order */
+#define RV_PACKS32(_a, _b) \
+    _mm256_permute4x64_epi64(_mm256_packs_epi32(_a, _b), 0xD8)
+/* RV_LANES words to bytes with unsigned saturation */
+#define RV_STORE_U8(_p, _w) do { \
+    __m256i lw = _w; \
+    _mm_storeu_si128((__m128i *) (_p), \
+                     _mm_packus_epi16(_mm256_castsi256_si128(lw), \
+                                      _mm256_extracti128_si256(lw, 1))); \
+} while (0)
+/* even and odd words of _a then _b */
+#define RV_DEINTERLEAVE(_a, _b, _e, _o) do { \
+    __m256i la = _a; \
+    __m256i lb = _b; \
+    _e = RV_PACKS32(_mm256_srai_epi32(_mm256_slli_epi32(la, 16), 16), \
+                    _mm256_srai_epi32(_mm256_slli_epi32(lb, 16), 16)); \
+    _o = RV_PACKS32(_mm256_srai_epi32(la, 16), _mm256_srai_epi32(lb, 16)); \
+} while (0)
+/* byte lanes for the alpha plane, RV_NEXT_BYTE is _a one byte on with the
+   first byte of _b shifted in, 0x21 gives the high half of _a and the low
+   half of _b for the alignr across the 128 bit lanes */
+#define RV_ADD8(_a, _b) _mm256_add_epi8(_a, _b)
+#define RV_SUB8(_a, _b) _mm256_sub_epi8(_a, _b)
+#define RV_CMPGT8(_a, _b) _mm256_cmpgt_epi8(_a, _b)
+#define RV_CMPEQ8(_a, _b) _mm256_cmpeq_epi8(_a, _b)
+#define RV_MOVEMASK8(_a) ((uint32) _mm256_movemask_epi8(_a))
+#define RV_NEXT_BYTE(_a, _b) \
+    _mm256_alignr_epi8(_mm256_permute2x128_si256(_a, _b, 0x21), _a, 1)
+/* decoder, the unpacks and RV_PACKS32_LANE work within the 128 bit lanes
+   so a pack of the two unpacks is back in order, RV_INTERLEAVE gives the
+   words of _a and _b alternating, the first RV_LANES in _lo, 0x20 and
+   0x31 put the low then the high halves of the unpacks together */
+#define RV_MIN(_a, _b) _mm256_min_epi16(_a, _b)
+#define RV_MAX(_a, _b) _mm256_max_epi16(_a, _b)
+#define RV_UNPACKLO16(_a, _b) _mm256_unpacklo_epi16(_a, _b)
+#define RV_UNPACKHI16(_a, _b) _mm256_unpackhi_epi16(_a, _b)
+#define RV_PACKS32_LANE(_a, _b) _mm256_packs_epi32(_a, _b)
+#define RV_INTERLEAVE(_a, _b, _lo, _hi) do { \
+    __m256i la = _a; \
+    __m256i lb = _b; \
+    __m256i ul = _mm256_unpacklo_epi16(la, lb); \
+    __m256i uh = _mm256_unpackhi_epi16(la, lb); \
+    _lo = _mm256_permute2x128_si256(ul, uh, 0x20); \
+    _hi = _mm256_permute2x128_si256(ul, uh, 0x31); \
+} while (0)
+/* a bit for each of the 32 words at _p that is not zero */
+#define RV_NONZERO_BITS(_p) \
+    (~(uint32) _mm256_movemask_epi8(_mm256_permute4x64_epi64( \
+        _mm256_packs_epi16( \
+            _mm256_cmpeq_epi16(RV_LOAD(_p), _mm256_setzero_si256()), \
+            _mm256_cmpeq_epi16(RV_LOAD((_p) + 16), _mm256_setzero_si256())), \
+        0xD8)))
+
+/******************************************************************************/
+/* 4 pixels of 3 bytes to 4 of 4 bytes, the 4th byte is 0, only the 12
+   bytes are read */
+static __inline__ __m128i
+load_px3(const char *src)
+{
+    __m128i lo;
+    __m128i hi;
+    int last;
+
+    memcpy(&last, src + 8, 4);
+    lo = _mm_loadl_epi64((const __m128i *) src);
+    hi = _mm_cvtsi32_si128(last);
+    return _mm_shuffle_epi8(_mm_unpacklo_epi64(lo, hi),
+                            _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1,
+                                          6, 7, 8, -1, 9, 10, 11, -1));
+}
+
+#define RV_LOAD_PX3(_p) \
+    _mm256_inserti128_si256(_mm256_castsi128_si256(load_px3(_p)), \
+                            load_px3((_p) + 12), 1)
+
+#include "rfxcodec_encode_intrin_body.h"
@@ -0,0 +1,780 @@
+/*
+Copyright 2026 librfxcodec contributors
+
+Permission to use, copy, modify, distribute, and sell this software and its
+documentation for any purpose is hereby granted without fee, provided that
+the above copyright notice appear in all copies and that both that
+copyright notice and this permission notice appear in supporting
+documentation.
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+OPEN GROUP BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+intrinsics kernels, included once for each instruction set by
+rfxcodec_encode_intrin_sse2.c, rfxcodec_encode_intrin_sse41.c and
+rfxcodec_encode_intrin_avx2.c
+
+the including file defines rv_t, a vector of RV_LANES 16 bit lanes, the
+RV_ operations on it and RV_NAME to give each kernel its suffix
+
+*/
+
+/* floor((_a + _b) / 2), the C does the add in int so it must not wrap */
+#define RV_AVG(_a, _b) \
+    RV_ADD(RV_AND(_a, _b), RV_SRAI(RV_XOR(_a, _b), 1))
+/* floor((_a - _b) / 2), same */
+#define RV_HALF_SUB(_a, _b) \
+    RV_SUB(RV_SUB(RV_SRAI(_a, 1), RV_SRAI(_b, 1)), \
+           RV_AND(RV_ANDNOT(_a, _b), RV_SET1(1)))
+
+/* 16 bit pairs for RV_MADD */
+#define RV_PAIR(_lo, _hi) \
+    RV_SET1_32((int) ((((uint32) (uint16) (_hi)) << 16) | (uint16) (_lo)))
+
+/******************************************************************************/
+/* one row pair of the level 1 vertical pass, see rfx_dwt_2d_encode_block8 */
+static RFX_ALWAYS_INLINE void
+RV_NAME(dwt_v1_row)(const uint8 *s0, const uint8 *s1, const uint8 *s2,
+                    int n, sint16 *l, sint16 *h)
+{
+    rv_t t0;
+    rv_t t1;
+    rv_t t2;
+    rv_t vh;
+    rv_t c128;
+    int x;
+
+    c128 = RV_SET1(128);
+    for (x = 0; x < 64; x += RV_LANES)
+    {
+        t0 = RV_SLLI(RV_SUB(RV_LOAD_U8(s0 + x), c128), DWT_FACTOR);
+        t1 = RV_SLLI(RV_SUB(RV_LOAD_U8(s1 + x), c128), DWT_FACTOR);
+        t2 = RV_SLLI(RV_SUB(RV_LOAD_U8(s2 + x), c128), DWT_FACTOR);
+        vh = RV_HALF_SUB(t1, RV_AVG(t0, t2));
+        RV_STORE(h + x, vh);
+        if (n == 0)
+        {
+            RV_STORE(l + x, RV_ADD(t0, vh));
+        }
+        else
+        {
+            RV_STORE(l + x, RV_ADD(t0, RV_AVG(RV_LOAD(h + x - 64), vh)));
+        }
+    }
+}
+
+/******************************************************************************/
+/* level 1 vertical pass, rfx_dwt_2d_encode_block8 up to
+   rfx_dwt_2d_encode_horz */
+static void
+RV_NAME(dwt_vert8)(const uint8 *in_buffer, sint16 *tmp_buffer)
+{
+    const uint8 *s0;
+    int n;
+
+    for (n = 0; n < 32; n++)
+    {
+        s0 = in_buffer + n * 128;
+        RV_NAME(dwt_v1_row)(s0, s0 + 64, n < 31 ? s0 + 128 : s0, n,
+                            tmp_buffer + n * 64, tmp_buffer + (n + 32) * 64);
+    }
+}
+
+/******************************************************************************/
+/* levels 2 and 3 vertical pass, rfx_dwt_2d_encode_block up to
+   rfx_dwt_2d_encode_horz */
+static void
+RV_NAME(dwt_vert)(const sint16 *in_buffer, sint16 *tmp_buffer,
+                  int subband_width)
+{
+    const sint16 *s0;
+    const sint16 *s2;
+    sint16 *l;
+    sint16 *h;
+    rv_t t0;
+    rv_t vh;
+    int total_width;
+    int x;
+    int n;
+
+    total_width = subband_width << 1;
+    for (n = 0; n < subband_width; n++)
+    {
+        s0 = in_buffer + 2 * n * total_width;
+        s2 = n < subband_width - 1 ? s0 + 2 * total_width : s0;
+        l = tmp_buffer + n * total_width;
+        h = l + subband_width * total_width;
+        for (x = 0; x < total_width; x += RV_LANES)
+        {
+            t0 = RV_LOAD(s0 + x);
+            vh = RV_HALF_SUB(RV_LOAD(s0 + total_width + x),
+                             RV_AVG(t0, RV_LOAD(s2 + x)));
+            RV_STORE(h + x, vh);
+            if (n == 0)
+            {
+                RV_STORE(l + x, RV_ADD(t0, vh));
+            }
+            else
+            {
+                RV_STORE(l + x, RV_ADD(t0, RV_AVG(RV_LOAD(h + x - total_width),
+                                                  vh)));
+            }
+        }
+    }
+}
+
+/******************************************************************************/
+/* one half of rfx_dwt_2d_encode_horz, the subband_width rows of src give
+   the high pass band hi and the low pass band lo
+   the rows are split into even and odd columns first so the filter runs
+   over all the rows as one line, the first and last column of each row are
+   fixed after */
+static void
+RV_NAME(dwt_horz_half)(const sint16 *src, sint16 *hi, sint16 *lo,
+                       int subband_width)
+{
+    sint16 even[1024 + 32];
+    sint16 odd[1024];
+    sint16 high[1 + 1024 + 32];
+    sint16 *hb;
+    rv_t e;
+    rv_t o;
+    int count;
+    int index;
+    int y;
+
+    count = subband_width * subband_width;
+    for (index = 0; index < count; index += RV_LANES)
+    {
+        RV_DEINTERLEAVE(RV_LOAD(src + 2 * index),
+                        RV_LOAD(src + 2 * index + RV_LANES), e, o);
+        RV_STORE(even + index, e);
+        RV_STORE(odd + index, o);
+    }
+    even[count] = 0;
+    hb = high + 1;
+    hb[-1] = 0;
+    for (index = 0; index < count; index += RV_LANES)
+    {
+        e = RV_AVG(RV_LOAD(even + index), RV_LOAD(even + index + 1));
+        RV_STORE(hb + index, RV_HALF_SUB(RV_LOAD(odd + index), e));
+    }
+    /* last column, the next even column is this row's last */
+    for (y = subband_width - 1; y < count; y += subband_width)
+    {
+        hb[y] = (odd[y] - even[y]) >> 1;
+    }
+    for (index = 0; index < count; index += RV_LANES)
+    {
+        o = RV_LOAD(hb + index);
+        RV_STORE(hi + index, o);
+        RV_STORE(lo + index, RV_ADD(RV_LOAD(even + index),
+                                    RV_AVG(RV_LOAD(hb + index - 1), o)));
+    }
+    /* first column, there is no high pass before it */
+    for (y = 0; y < count; y += subband_width)
+    {
+        lo[y] = even[y] + hb[y];
+    }
+}
+
+/******************************************************************************/
+/* rfx_dwt_2d_encode_horz */
+static void
+RV_NAME(dwt_horz)(const sint16 *in_buffer, sint16 *out_buffer,
+                  int subband_width)
+{
+    int count;
+
+    count = subband_width * subband_width;
+    /* L to HL and LL, H to HH and LH */
+    RV_NAME(dwt_horz_half)(in_buffer, out_buffer, out_buffer + count * 3,
+                           subband_width);
+    RV_NAME(dwt_horz_half)(in_buffer + count * 2, out_buffer + count * 2,
+                           out_buffer + count, subband_width);
+}
+
+/******************************************************************************/
+/* rfx_quantization_encode_block */
+static void
+RV_NAME(quant_block)(sint16 *buffer, int buffer_size, int factor)
+{
+    rv_t v;
+    rv_t mask;
+    rv_t half;
+    __m128i shift;
+    int index;
+
+    factor += DWT_FACTOR;
+    if (factor == 0)
+    {
+        return;
+    }
+    /* (v + half) >> factor as (v >> factor) plus the carry out of the low
+       bits, the add does not fit in 16 bits */
+    shift = _mm_cvtsi32_si128(factor);
+    mask = RV_SET1((1 << factor) - 1);
+    half = RV_SET1(1 << (factor - 1));
+    for (index = 0; index < buffer_size; index += RV_LANES)
+    {
+        v = RV_LOAD(buffer + index);
+        v = RV_ADD(RV_SRA(v, shift),
+                   RV_SRL(RV_ADD(RV_AND(v, mask), half), shift));
+        RV_STORE(buffer + index, v);
+    }
+}
+
+/******************************************************************************/
+/* rfx_quantization_encode */
+static void
+RV_NAME(quant)(sint16 *buffer, const char *qtable)
+{
+    RV_NAME(quant_block)(buffer, 1024, ((qtable[4] >> 0) & 0xf) - 6); /* HL1 */
+    RV_NAME(quant_block)(buffer + 1024, 1024, ((qtable[3] >> 4) & 0xf) - 6); /* LH1 */
+    RV_NAME(quant_block)(buffer + 2048, 1024, ((qtable[4] >> 4) & 0xf) - 6); /* HH1 */
+    RV_NAME(quant_block)(buffer + 3072, 256, ((qtable[2] >> 4) & 0xf) - 6); /* HL2 */
+    RV_NAME(quant_block)(buffer + 3328, 256, ((qtable[2] >> 0) & 0xf) - 6); /* LH2 */
+    RV_NAME(quant_block)(buffer + 3584, 256, ((qtable[3] >> 0) & 0xf) - 6); /* HH2 */
+    RV_NAME(quant_block)(buffer + 3840, 64, ((qtable[1] >> 0) & 0xf) - 6); /* HL3 */
+    RV_NAME(quant_block)(buffer + 3904, 64, ((qtable[0] >> 4) & 0xf) - 6); /* LH3 */
+    RV_NAME(quant_block)(buffer + 3968, 64, ((qtable[1] >> 4) & 0xf) - 6); /* HH3 */
+    RV_NAME(quant_block)(buffer + 4032, 64, ((qtable[0] >> 0) & 0xf) - 6); /* LL3 */
+}
+
+/******************************************************************************/
+/* rfx_dwt_2d_encode then rfx_quantization_encode, dwt_buffer1 gets the
+   coefficients */
+int
+RV_NAME(rfxcodec_encode_dwt_shift)(const char *qtable,
+                                   const unsigned char *data,
+                                   short *dwt_buffer1, short *dwt_buffer)
+{
+    RV_NAME(dwt_vert8)(data, dwt_buffer);
+    RV_NAME(dwt_horz)(dwt_buffer, dwt_buffer1, 32);
+    RV_NAME(dwt_vert)(dwt_buffer1 + 3072, dwt_buffer, 16);
+    RV_NAME(dwt_horz)(dwt_buffer, dwt_buffer1 + 3072, 16);
+    RV_NAME(dwt_vert)(dwt_buffer1 + 3840, dwt_buffer, 8);
+    RV_NAME(dwt_horz)(dwt_buffer, dwt_buffer1 + 3840, 8);
+    RV_NAME(quant)(dwt_buffer1, qtable);
+    return 0;
+}
+
+/******************************************************************************/
+/* rfx_dwt_2d_encode_h1 then rfx_quantization_encode */
+int
+RV_NAME(rfxcodec_encode_dwt_h1_shift)(const char *qtable, short *out_buffer,
+                                      short *v1_buffer)
+{
+    RV_NAME(dwt_horz)(v1_buffer, out_buffer, 32);
+    RV_NAME(dwt_vert)(out_buffer + 3072, v1_buffer, 16);
+    RV_NAME(dwt_horz)(v1_buffer, out_buffer + 3072, 16);
+    RV_NAME(dwt_vert)(out_buffer + 3840, v1_buffer, 8);
+    RV_NAME(dwt_horz)(v1_buffer, out_buffer + 3840, 8);
+    RV_NAME(quant)(out_buffer, qtable);
+    return 0;
+}
+
+/******************************************************************************/
+/* rfx_dwt_2d_encode_v1_rows */
+int
+RV_NAME(rfxcodec_encode_dwt_v1_rows)(const unsigned char *s0,
+                                     const unsigned char *s1,
+                                     const unsigned char *s2, int n,
+                                     short *y_v1, short *u_v1, short *v_v1)
+{
+    RV_NAME(dwt_v1_row)(s0, s1, s2, n, y_v1 + n * 64, y_v1 + (n + 32) * 64);
+    RV_NAME(dwt_v1_row)(s0 + 64, s1 + 64, s2 + 64, n,
+                        u_v1 + n * 64, u_v1 + (n + 32) * 64);
+    RV_NAME(dwt_v1_row)(s0 + 128, s1 + 128, s2 + 128, n,
+                        v_v1 + n * 64, v_v1 + (n + 32) * 64);
+    return 0;
+}
+
+/******************************************************************************/
+/* rfx_differential_pro_encode */
+int
+RV_NAME(rfxcodec_encode_diff_count)(const short *coefs, const short *history,
+                                    short *diff, short *history_out,
+                                    int *diff_zeros, int *coef_zeros)
+{
+    sint16 dlanes[RV_LANES];
+    sint16 clanes[RV_LANES];
+    rv_t c;
+    rv_t h;
+    rv_t dz;
+    rv_t cz;
+    rv_t zero;
+    int counted;
+    int dzeros;
+    int czeros;
+    int index;
+
+    /* the last 81 are not counted, whole vectors up to there are */
+    counted = (4096 - 81) & ~(RV_LANES - 1);
+    zero = RV_ZERO;
+    dz = zero;
+    cz = zero;
+    for (index = 0; index < 4096; index += RV_LANES)
+    {
+        c = RV_LOAD(coefs + index);
+        h = RV_LOAD(history + index);
+        RV_STORE(diff + index, RV_SUB(c, h));
+        if (index < counted)
+        {
+            dz = RV_SUB(dz, RV_CMPEQ(c, h));
+            cz = RV_SUB(cz, RV_CMPEQ(c, zero));
+        }
+    }
+    RV_STORE(dlanes, dz);
+    RV_STORE(clanes, cz);
+    dzeros = 0;
+    czeros = 0;
+    for (index = 0; index < RV_LANES; index++)
+    {
+        dzeros += dlanes[index];
+        czeros += clanes[index];
+    }
+    for (index = counted; index < 4096 - 81; index++)
+    {
+        dzeros += coefs[index] == history[index];
+        czeros += coefs[index] == 0;
+    }
+    if (history_out != NULL)
+    {
+        memcpy(history_out, coefs, 4096 * sizeof(sint16));
+    }
+    *diff_zeros = dzeros;
+    *coef_zeros = czeros;
+    return 0;
+}
+
+/******************************************************************************/
+/* rfx_encode_nonzero_mask */
+int
+RV_NAME(rfxcodec_encode_nonzero_mask)(const short *coefs, unsigned int *mask)
+{
+    uint32 bits;
+    int index;
+    int jndex;
+
+    for (index = 0; index < 4096 / 32; index++)
+    {
+        bits = 0;
+        for (jndex = 0; jndex < 32; jndex += 2 * RV_LANES)
+        {
+            bits |= RV_NONZERO_BITS(coefs + jndex) << jndex;
+        }
+        mask[index] = bits;
+        coefs += 32;
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/* rfx_encode_alpha_delta, the delta is (d << 1) ^ (0 > d ? 0xFF : 0) and
+   each byte is compared with the one after it, the last byte of a row has
+   none so bit 63 is cleared */
+int
+RV_NAME(rfxcodec_encode_alpha_delta)(const unsigned char *plane,
+                                     unsigned char *delta,
+                                     unsigned int *mask)
+{
+    rv_t d[64 / (2 * RV_LANES)];
+    rv_t next;
+    uint64 bits;
+    int index;
+    int jndex;
+
+    for (jndex = 0; jndex < 64; jndex++)
+    {
+        for (index = 0; index < 64 / (2 * RV_LANES); index++)
+        {
+            d[index] = RV_LOAD(plane + index * 2 * RV_LANES);
+            if (jndex > 0)
+            {
+                d[index] = RV_SUB8(d[index],
+                                   RV_LOAD(plane + index * 2 * RV_LANES - 64));
+                d[index] = RV_XOR(RV_ADD8(d[index], d[index]),
+                                  RV_CMPGT8(RV_ZERO, d[index]));
+            }
+            RV_STORE(delta + index * 2 * RV_LANES, d[index]);
+        }
+        bits = 0;
+        for (index = 0; index < 64 / (2 * RV_LANES); index++)
+        {
+            next = index + 1 < 64 / (2 * RV_LANES) ? d[index + 1] : RV_ZERO;
+            bits |= ((uint64) RV_MOVEMASK8(RV_CMPEQ8(d[index],
+                     RV_NEXT_BYTE(d[index], next)))) << (index * 2 * RV_LANES);
+        }
+        bits &= ~(((uint64) 1) << 63);
+        mask[0] = (uint32) bits;
+        mask[1] = (uint32) (bits >> 32);
+        plane += 64;
+        delta += 64;
+        mask += 2;
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/* packed pixels to the y, u, v and a planes, see
+   rfx_encode_rgb_to_yuv_row_tail, the multipliers over 32767 are split in
+   a pmaddwd multiplier and the channel in the high 16 bits of a lane
+     y = r *  19595 + g * (38470 - 65536) + b *   7471 + (g << 16)
+     u = r * -11071 + g * -21736 + b * (32807 - 65536) + (b << 16)
+     v = r *  32756 + g * -27429 + b *  -5327 */
+static RFX_ALWAYS_INLINE void
+RV_NAME(to_yuva)(const char *src, int stride_bytes, int count, int height,
+                 uint8 *y_buf, uint8 *u_buf, uint8 *v_buf, uint8 *a_buf,
+                 int bpp, int ro, int go, int bo)
+{
+    const char *s;
+    rv_t px[2];
+    rv_t rg[2];
+    rv_t b[2];
+    rv_t cy[2];
+    rv_t cu[2];
+    rv_t cv[2];
+    rv_t ff;
+    rv_t hi16;
+    rv_t c128;
+    int row;
+    int x;
+    int k;
+
+    ff = RV_SET1_32(0xFF);
+    hi16 = RV_SET1_32((int) 0xFFFF0000);
+    c128 = RV_SET1(128);
+    for (row = 0; row < height; row++)
+    {
+        s = src + row * stride_bytes;
+        for (x = 0; x < count; x += RV_LANES)
+        {
+            /* RV_LANES / 2 pixels in each 32 bit lane vector */
+            if (bpp == 4)
+            {
+                px[0] = RV_LOAD(s);
+                px[1] = RV_LOAD(s + RV_LANES * 2);
+                s += RV_LANES * 4;
+            }
+#if defined(RV_LOAD_PX3)
+            else
+            {
+                px[0] = RV_LOAD_PX3(s);
+                px[1] = RV_LOAD_PX3(s + RV_LANES * 3 / 2);
+                s += RV_LANES * 3;
+            }
+#endif
+            for (k = 0; k < 2; k++)
+            {
+                rg[k] = RV_OR(RV_AND(RV_SRLI32(px[k], ro * 8), ff),
+                              RV_SLLI32(RV_AND(RV_SRLI32(px[k], go * 8), ff),
+                                        16));
+                b[k] = RV_AND(RV_SRLI32(px[k], bo * 8), ff);
+                cy[k] = RV_ADD32(RV_MADD(rg[k], RV_PAIR(19595, 38470 - 65536)),
+                                 RV_MADD(b[k], RV_PAIR(7471, 0)));
+                cy[k] = RV_SRAI32(RV_ADD32(cy[k], RV_AND(rg[k], hi16)), 16);
+                cu[k] = RV_ADD32(RV_MADD(rg[k], RV_PAIR(-11071, -21736)),
+                                 RV_MADD(b[k], RV_PAIR(32807 - 65536, 0)));
+                cu[k] = RV_SRAI32(RV_ADD32(cu[k], RV_SLLI32(b[k], 16)), 16);
+                cv[k] = RV_ADD32(RV_MADD(rg[k], RV_PAIR(32756, -27429)),
+                                 RV_MADD(b[k], RV_PAIR(-5327, 0)));
+                cv[k] = RV_SRAI32(cv[k], 16);
+            }
+            RV_STORE_U8(y_buf + x, RV_PACKS32(cy[0], cy[1]));
+            RV_STORE_U8(u_buf + x, RV_ADD(RV_PACKS32(cu[0], cu[1]), c128));
+            RV_STORE_U8(v_buf + x, RV_ADD(RV_PACKS32(cv[0], cv[1]), c128));
+            if (a_buf != NULL)
+            {
+                RV_STORE_U8(a_buf + x, RV_PACKS32(RV_SRLI32(px[0], 24),
+                                                  RV_SRLI32(px[1], 24)));
+            }
+        }
+        y_buf += 64;
+        u_buf += 64;
+        v_buf += 64;
+        if (a_buf != NULL)
+        {
+            a_buf += 64;
+        }
+    }
+}
+
+/******************************************************************************/
+int
+RV_NAME(rfxcodec_encode_bgra_to_yuva)(const char *src, int stride_bytes,
+                                      int count, int height,
+                                      unsigned char *y_buf,
+                                      unsigned char *u_buf,
+                                      unsigned char *v_buf,
+                                      unsigned char *a_buf)
+{
+    RV_NAME(to_yuva)(src, stride_bytes, count, height,
+                     y_buf, u_buf, v_buf, a_buf, 4, 2, 1, 0);
+    return 0;
+}
+
+/******************************************************************************/
+int
+RV_NAME(rfxcodec_encode_rgba_to_yuva)(const char *src, int stride_bytes,
+                                      int count, int height,
+                                      unsigned char *y_buf,
+                                      unsigned char *u_buf,
+                                      unsigned char *v_buf,
+                                      unsigned char *a_buf)
+{
+    RV_NAME(to_yuva)(src, stride_bytes, count, height,
+                     y_buf, u_buf, v_buf, a_buf, 4, 0, 1, 2);
+    return 0;
+}
+
+#if defined(RV_LOAD_PX3)
+
+/******************************************************************************/
+int
+RV_NAME(rfxcodec_encode_bgr_to_yuv)(const char *src, int stride_bytes,
+                                    int count, int height,
+                                    unsigned char *y_buf,
+                                    unsigned char *u_buf,
+                                    unsigned char *v_buf)
+{
+    RV_NAME(to_yuva)(src, stride_bytes, count, height,
+                     y_buf, u_buf, v_buf, NULL, 3, 2, 1, 0);
+    return 0;
+}
+
+/******************************************************************************/
+int
+RV_NAME(rfxcodec_encode_rgb_to_yuv)(const char *src, int stride_bytes,
+                                    int count, int height,
+                                    unsigned char *y_buf,
+                                    unsigned char *u_buf,
+                                    unsigned char *v_buf)
+{
+    RV_NAME(to_yuva)(src, stride_bytes, count, height,
+                     y_buf, u_buf, v_buf, NULL, 3, 0, 1, 2);
+    return 0;
+}
+
+#endif
+
+/* floor((_a + _b + 1) / 2), see RV_AVG */
+#define RV_AVG_UP(_a, _b) \
+    RV_SUB(RV_OR(_a, _b), RV_SRAI(RV_XOR(_a, _b), 1))
+
+/******************************************************************************/
+/* one row of the inverse horizontal DWT, see rfx_dwt_2d_decode_horz_row,
+   h[n - 1] and e[n + 1] are unaligned loads from copies of the row with
+   h[0] put in front and e[width - 1] put after */
+static void
+RV_NAME(idwt_horz_row)(const sint16 *l, const sint16 *h, sint16 *dst,
+                       int width)
+{
+    sint16 hbuf[32 + 1];
+    sint16 ebuf[32 + 1];
+    rv_t ve;
+    rv_t vo;
+    rv_t vlo;
+    rv_t vhi;
+    int n;
+
+    if (width < RV_LANES)
+    {
+        /* level 3 with avx2, 8 of the 4096 */
+        dst[0] = l[0] - h[0];
+        for (n = 1; n < width; n++)
+        {
+            dst[2 * n] = l[n] - ((h[n - 1] + h[n] + 1) >> 1);
+            dst[2 * n - 1] = (h[n - 1] << 1) +
+                             ((dst[2 * n - 2] + dst[2 * n]) >> 1);
+        }
+        dst[2 * width - 1] = (h[width - 1] << 1) + dst[2 * width - 2];
+        return;
+    }
+    hbuf[0] = h[0];
+    for (n = 0; n < width; n += RV_LANES)
+    {
+        RV_STORE(hbuf + 1 + n, RV_LOAD(h + n));
+    }
+    for (n = 0; n < width; n += RV_LANES)
+    {
+        ve = RV_SUB(RV_LOAD(l + n), RV_AVG_UP(RV_LOAD(hbuf + n),
+                                              RV_LOAD(h + n)));
+        RV_STORE(ebuf + n, ve);
+    }
+    ebuf[width] = ebuf[width - 1];
+    for (n = 0; n < width; n += RV_LANES)
+    {
+        ve = RV_LOAD(ebuf + n);
+        vo = RV_ADD(RV_SLLI(RV_LOAD(h + n), 1),
+                    RV_AVG(ve, RV_LOAD(ebuf + n + 1)));
+        RV_INTERLEAVE(ve, vo, vlo, vhi);
+        RV_STORE(dst + 2 * n, vlo);
+        RV_STORE(dst + 2 * n + RV_LANES, vhi);
+    }
+}
+
+/******************************************************************************/
+/* inverse vertical DWT, see rfx_dwt_2d_decode_vert, a strip of RV_LANES
+   columns at a time from the top down so the H row above and the even row
+   above stay in registers */
+static void
+RV_NAME(idwt_vert)(const sint16 *in_buffer, sint16 *out_buffer,
+                   int subband_width)
+{
+    const sint16 *l;
+    const sint16 *h;
+    sint16 *dst;
+    rv_t vhp;
+    rv_t vh;
+    rv_t vep;
+    rv_t ve;
+    int total_width;
+    int n;
+    int x;
+
+    total_width = subband_width << 1;
+    for (x = 0; x < total_width; x += RV_LANES)
+    {
+        l = in_buffer + x;
+        h = l + subband_width * total_width;
+        dst = out_buffer + x;
+        vhp = RV_LOAD(h);
+        vep = RV_SUB(RV_LOAD(l), vhp);
+        RV_STORE(dst, vep);
+        for (n = 1; n < subband_width; n++)
+        {
+            l += total_width;
+            h += total_width;
+            dst += total_width * 2;
+            vh = RV_LOAD(h);
+            ve = RV_SUB(RV_LOAD(l), RV_AVG_UP(vhp, vh));
+            RV_STORE(dst - total_width,
+                     RV_ADD(RV_SLLI(vhp, 1), RV_AVG(vep, ve)));
+            RV_STORE(dst, ve);
+            vhp = vh;
+            vep = ve;
+        }
+        RV_STORE(dst + total_width, RV_ADD(RV_SLLI(vhp, 1), vep));
+    }
+}
+
+/******************************************************************************/
+static void
+RV_NAME(idwt_block)(sint16 *in_out_buffer, sint16 *tmp_buffer,
+                    int subband_width)
+{
+    const sint16 *hl, *lh, *hh, *ll;
+    sint16 *l_dst, *h_dst;
+    int total_width;
+    int y;
+
+    total_width = subband_width << 1;
+    hl = in_out_buffer;
+    lh = hl + subband_width * subband_width;
+    hh = lh + subband_width * subband_width;
+    ll = hh + subband_width * subband_width;
+    l_dst = tmp_buffer;
+    h_dst = tmp_buffer + subband_width * total_width;
+    for (y = 0; y < subband_width; y++)
+    {
+        RV_NAME(idwt_horz_row)(ll, hl, l_dst, subband_width);
+        RV_NAME(idwt_horz_row)(lh, hh, h_dst, subband_width);
+        ll += subband_width;
+        hl += subband_width;
+        lh += subband_width;
+        hh += subband_width;
+        l_dst += total_width;
+        h_dst += total_width;
+    }
+    RV_NAME(idwt_vert)(tmp_buffer, in_out_buffer, subband_width);
+}
+
+/******************************************************************************/
+/* rfx_dwt_2d_decode */
+int
+RV_NAME(rfxcodec_decode_dwt)(short *buffer, short *dwt_buffer)
+{
+    RV_NAME(idwt_block)(buffer + 3840, dwt_buffer, 8);
+    RV_NAME(idwt_block)(buffer + 3072, dwt_buffer, 16);
+    RV_NAME(idwt_block)(buffer, dwt_buffer, 32);
+    return 0;
+}
+
+/******************************************************************************/
+/* rfx_decode_yuv_to_bgra, pmaddwd on (y, cr) and (y, cb) pairs gives the
+   same 32 bit sums as the C, the pixels are b | g << 8 and r | 0xFF << 8
+   words interleaved */
+int
+RV_NAME(rfxcodec_decode_yuv_to_bgra)(const short *y_buffer,
+                                     const short *u_buffer,
+                                     const short *v_buffer,
+                                     unsigned char *bgra_buffer)
+{
+    rv_t vy;
+    rv_t vu;
+    rv_t vv;
+    rv_t yu_lo;
+    rv_t yu_hi;
+    rv_t yv_lo;
+    rv_t yv_hi;
+    rv_t vr;
+    rv_t vg;
+    rv_t vb;
+    rv_t vlo;
+    rv_t vhi;
+    rv_t r_cr;
+    rv_t g_cb;
+    rv_t g_cr;
+    rv_t b_cb;
+    rv_t add;
+    rv_t c255;
+    rv_t cff00;
+    int index;
+
+    r_cr = RV_PAIR(16384, 22979);
+    g_cb = RV_PAIR(16384, -5632);
+    g_cr = RV_PAIR(0, -11705);
+    b_cb = RV_PAIR(16384, 28998);
+    add = RV_SET1_32(128 << (14 + DWT_FACTOR));
+    c255 = RV_SET1(255);
+    cff00 = RV_SET1((short) 0xFF00);
+    for (index = 0; index < 4096; index += RV_LANES)
+    {
+        vy = RV_LOAD(y_buffer + index);
+        vu = RV_LOAD(u_buffer + index);
+        vv = RV_LOAD(v_buffer + index);
+        yu_lo = RV_UNPACKLO16(vy, vu);
+        yu_hi = RV_UNPACKHI16(vy, vu);
+        yv_lo = RV_UNPACKLO16(vy, vv);
+        yv_hi = RV_UNPACKHI16(vy, vv);
+        vr = RV_PACKS32_LANE(
+            RV_SRAI32(RV_ADD32(RV_MADD(yv_lo, r_cr), add), 14 + DWT_FACTOR),
+            RV_SRAI32(RV_ADD32(RV_MADD(yv_hi, r_cr), add), 14 + DWT_FACTOR));
+        vg = RV_PACKS32_LANE(
+            RV_SRAI32(RV_ADD32(RV_ADD32(RV_MADD(yu_lo, g_cb),
+                                        RV_MADD(yv_lo, g_cr)), add),
+                      14 + DWT_FACTOR),
+            RV_SRAI32(RV_ADD32(RV_ADD32(RV_MADD(yu_hi, g_cb),
+                                        RV_MADD(yv_hi, g_cr)), add),
+                      14 + DWT_FACTOR));
+        vb = RV_PACKS32_LANE(
+            RV_SRAI32(RV_ADD32(RV_MADD(yu_lo, b_cb), add), 14 + DWT_FACTOR),
+            RV_SRAI32(RV_ADD32(RV_MADD(yu_hi, b_cb), add), 14 + DWT_FACTOR));
+        vr = RV_MIN(RV_MAX(vr, RV_ZERO), c255);
+        vg = RV_MIN(RV_MAX(vg, RV_ZERO), c255);
+        vb = RV_MIN(RV_MAX(vb, RV_ZERO), c255);
+        RV_INTERLEAVE(RV_OR(vb, RV_SLLI(vg, 8)), RV_OR(vr, cff00), vlo, vhi);
+        RV_STORE(bgra_buffer, vlo);
+        RV_STORE(bgra_buffer + RV_LANES * 2, vhi);
+        bgra_buffer += RV_LANES * 4;
+    }
+    return 0;
+}
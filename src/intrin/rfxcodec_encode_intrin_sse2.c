@@ -0,0 +1,107 @@
+/*
+Copyright 2026 librfxcodec contributors
+
+Permission to use, copy, modify, distribute, and sell this software and its
+documentation for any purpose is hereby granted without fee, provided that
+the above copyright notice appear in all copies and that both that
+copyright notice and this permission notice appear in supporting
+documentation.
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+OPEN GROUP BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+intrinsics kernels, sse2
+
+*/
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <emmintrin.h>
+
+#include "rfxcommon.h"
+#include "funcs_intrin.h"
+
+typedef __m128i rv_t;
+
+#define RV_NAME(_name) _name ## _intrin_sse2
+#define RV_LANES 8
+
+#define RV_LOAD(_p) _mm_loadu_si128((const __m128i *) (_p))
+#define RV_STORE(_p, _v) _mm_storeu_si128((__m128i *) (_p), _v)
+#define RV_LOAD_U8(_p) \
+    _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (_p)), \
+                      _mm_setzero_si128())
+#define RV_ZERO _mm_setzero_si128()
+#define RV_SET1(_v) _mm_set1_epi16(_v)
+#define RV_SET1_32(_v) _mm_set1_epi32(_v)
+#define RV_ADD(_a, _b) _mm_add_epi16(_a, _b)
+#define RV_SUB(_a, _b) _mm_sub_epi16(_a, _b)
+#define RV_AND(_a, _b) _mm_and_si128(_a, _b)
+#define RV_OR(_a, _b) _mm_or_si128(_a, _b)
+#define RV_XOR(_a, _b) _mm_xor_si128(_a, _b)
+#define RV_ANDNOT(_a, _b) _mm_andnot_si128(_a, _b)
+#define RV_CMPEQ(_a, _b) _mm_cmpeq_epi16(_a, _b)
+#define RV_SLLI(_a, _n) _mm_slli_epi16(_a, _n)
+#define RV_SRAI(_a, _n) _mm_srai_epi16(_a, _n)
+#define RV_SRA(_a, _n) _mm_sra_epi16(_a, _n)
+#define RV_SRL(_a, _n) _mm_srl_epi16(_a, _n)
+#define RV_ADD32(_a, _b) _mm_add_epi32(_a, _b)
+#define RV_SLLI32(_a, _n) _mm_slli_epi32(_a, _n)
+#define RV_SRLI32(_a, _n) _mm_srli_epi32(_a, _n)
+#define RV_SRAI32(_a, _n) _mm_srai_epi32(_a, _n)
+#define RV_MADD(_a, _b) _mm_madd_epi16(_a, _b)
+#define RV_PACKS32(_a, _b) _mm_packs_epi32(_a, _b)
+/* RV_LANES words to bytes with unsigned saturation */
+#define RV_STORE_U8(_p, _w) \
+    _mm_storel_epi64((__m128i *) (_p), _mm_packus_epi16(_w, _w))
+/* even and odd words of _a then _b */
+#define RV_DEINTERLEAVE(_a, _b, _e, _o) do { \
+    __m128i la = _a; \
+    __m128i lb = _b; \
+    _e = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(la, 16), 16), \
+                         _mm_srai_epi32(_mm_slli_epi32(lb, 16), 16)); \
+    _o = _mm_packs_epi32(_mm_srai_epi32(la, 16), _mm_srai_epi32(lb, 16)); \
+} while (0)
+/* byte lanes for the alpha plane, RV_NEXT_BYTE is _a one byte on with the
+   first byte of _b shifted in */
+#define RV_ADD8(_a, _b) _mm_add_epi8(_a, _b)
+#define RV_SUB8(_a, _b) _mm_sub_epi8(_a, _b)
+#define RV_CMPGT8(_a, _b) _mm_cmpgt_epi8(_a, _b)
+#define RV_CMPEQ8(_a, _b) _mm_cmpeq_epi8(_a, _b)
+#define RV_MOVEMASK8(_a) ((uint32) _mm_movemask_epi8(_a))
+#define RV_NEXT_BYTE(_a, _b) \
+    _mm_or_si128(_mm_srli_si128(_a, 1), _mm_slli_si128(_b, 15))
+/* decoder, the unpacks and RV_PACKS32_LANE work within the 128 bit lanes
+   so a pack of the two unpacks is back in order, RV_INTERLEAVE gives the
+   words of _a and _b alternating, the first RV_LANES in _lo */
+#define RV_MIN(_a, _b) _mm_min_epi16(_a, _b)
+#define RV_MAX(_a, _b) _mm_max_epi16(_a, _b)
+#define RV_UNPACKLO16(_a, _b) _mm_unpacklo_epi16(_a, _b)
+#define RV_UNPACKHI16(_a, _b) _mm_unpackhi_epi16(_a, _b)
+#define RV_PACKS32_LANE(_a, _b) _mm_packs_epi32(_a, _b)
+#define RV_INTERLEAVE(_a, _b, _lo, _hi) do { \
+    __m128i la = _a; \
+    __m128i lb = _b; \
+    _lo = _mm_unpacklo_epi16(la, lb); \
+    _hi = _mm_unpackhi_epi16(la, lb); \
+} while (0)
+/* a bit for each of the 16 words at _p that is not zero */
+#define RV_NONZERO_BITS(_p) \
+    ((~(uint32) _mm_movemask_epi8(_mm_packs_epi16( \
+        _mm_cmpeq_epi16(RV_LOAD(_p), _mm_setzero_si128()), \
+        _mm_cmpeq_epi16(RV_LOAD((_p) + 8), _mm_setzero_si128())))) & 0xFFFF)
+
+#include "rfxcodec_encode_intrin_body.h"
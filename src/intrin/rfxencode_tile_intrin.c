@@ -0,0 +1,453 @@
+/**
+ * FreeRDP: A Remote Desktop Protocol client.
+ * RemoteFX Codec Library - Encode
+ *
+ * Copyright 2011 Vic Lee
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rfxcodec_encode.h>
+
+#include "rfxcommon.h"
+#include "rfxencode.h"
+#include "rfxencode_diff_rlgr1.h"
+#include "rfxencode_diff_rlgr3.h"
+#include "rfxencode_tile.h"
+#include "rfxencode_rgb_to_yuv.h"
+
+#include "intrin/funcs_intrin.h"
+
+#define LLOG_LEVEL 1
+#define LLOGLN(_level, _args) \
+    do { if (_level < LLOG_LEVEL) { printf _args ; printf("\n"); } } while (0)
+
+typedef int (*to_yuva_proc)(const char *src, int stride_bytes,
+                            int count, int height,
+                            unsigned char *y_buf, unsigned char *u_buf,
+                            unsigned char *v_buf, unsigned char *a_buf);
+typedef int (*to_yuv_proc)(const char *src, int stride_bytes,
+                           int count, int height,
+                           unsigned char *y_buf, unsigned char *u_buf,
+                           unsigned char *v_buf);
+
+/* fused colour conversion kernels of one instruction set, sse2 has no
+   pshufb for the 24 bit formats */
+struct yuv_kernels
+{
+    to_yuva_proc bgra;
+    to_yuva_proc rgba;
+    to_yuv_proc bgr;
+    to_yuv_proc rgb;
+};
+
+static const struct yuv_kernels g_yuv_sse2 =
+{
+    rfxcodec_encode_bgra_to_yuva_intrin_sse2,
+    rfxcodec_encode_rgba_to_yuva_intrin_sse2,
+    NULL,
+    NULL
+};
+
+static const struct yuv_kernels g_yuv_sse41 =
+{
+    rfxcodec_encode_bgra_to_yuva_intrin_sse41,
+    rfxcodec_encode_rgba_to_yuva_intrin_sse41,
+    rfxcodec_encode_bgr_to_yuv_intrin_sse41,
+    rfxcodec_encode_rgb_to_yuv_intrin_sse41
+};
+
+static const struct yuv_kernels g_yuv_avx2 =
+{
+    rfxcodec_encode_bgra_to_yuva_intrin_avx2,
+    rfxcodec_encode_rgba_to_yuva_intrin_avx2,
+    rfxcodec_encode_bgr_to_yuv_intrin_avx2,
+    rfxcodec_encode_rgb_to_yuv_intrin_avx2
+};
+
+/******************************************************************************/
+/* see get_simd_count in rfxencode_tile_amd64.c */
+static int
+get_simd_count(int width)
+{
+    int count;
+
+    count = width & ~15;
+    if ((count == width) && (width < 64))
+    {
+        count -= 16;
+    }
+    return count;
+}
+
+/******************************************************************************/
+/* convert the columns the kernels can do, returns the column the C tail
+   starts at */
+static int
+rgb_to_yuv_simd(const struct yuv_kernels *kernels, const char *rgb_data,
+                int width, int height, int stride_bytes, int pixel_format,
+                uint8 *a_buf, uint8 *y_buf, uint8 *u_buf, uint8 *v_buf)
+{
+    int count;
+
+    count = get_simd_count(width);
+    if (count < 1)
+    {
+        return 0;
+    }
+    switch (pixel_format)
+    {
+        case RFX_FORMAT_BGRA:
+            kernels->bgra(rgb_data, stride_bytes, count, height,
+                          y_buf, u_buf, v_buf, a_buf);
+            break;
+        case RFX_FORMAT_RGBA:
+            kernels->rgba(rgb_data, stride_bytes, count, height,
+                          y_buf, u_buf, v_buf, a_buf);
+            break;
+        case RFX_FORMAT_BGR:
+            if (kernels->bgr == NULL)
+            {
+                return 0;
+            }
+            kernels->bgr(rgb_data, stride_bytes, count, height,
+                         y_buf, u_buf, v_buf);
+            break;
+        case RFX_FORMAT_RGB:
+            if (kernels->rgb == NULL)
+            {
+                return 0;
+            }
+            kernels->rgb(rgb_data, stride_bytes, count, height,
+                         y_buf, u_buf, v_buf);
+            break;
+        default:
+            return 0;
+    }
+    return count;
+}
+
+/******************************************************************************/
+int
+rfx_encode_component_rlgr1_intrin_sse2(struct rfxencode *enc, const char *qtable,
+                                       const uint8 *data,
+                                       uint8 *buffer, int buffer_size, int *size)
+{
+    LLOGLN(10, ("rfx_encode_component_rlgr1_intrin_sse2:"));
+    if (rfxcodec_encode_dwt_shift_intrin_sse2(qtable, data, enc->dwt_buffer1,
+                                              enc->dwt_buffer) != 0)
+    {
+        return 1;
+    }
+    *size = enc->rfx_encode_diff_rlgr1(enc->dwt_buffer1, buffer,
+                                       buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_encode_component_rlgr3_intrin_sse2(struct rfxencode *enc, const char *qtable,
+                                       const uint8 *data,
+                                       uint8 *buffer, int buffer_size, int *size)
+{
+    LLOGLN(10, ("rfx_encode_component_rlgr3_intrin_sse2:"));
+    if (rfxcodec_encode_dwt_shift_intrin_sse2(qtable, data, enc->dwt_buffer1,
+                                              enc->dwt_buffer) != 0)
+    {
+        return 1;
+    }
+    *size = enc->rfx_encode_diff_rlgr3(enc->dwt_buffer1, buffer,
+                                       buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_encode_dwt_shift_intrin_sse2(struct rfxencode *enc, const char *qtable,
+                                 const uint8 *data, sint16 *coefs)
+{
+    return rfxcodec_encode_dwt_shift_intrin_sse2(qtable, data, coefs,
+                                                 enc->dwt_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_dwt_h1_shift_intrin_sse2(struct rfxencode *enc, const char *qtable,
+                                    sint16 *v1_buffer, sint16 *coefs)
+{
+    return rfxcodec_encode_dwt_h1_shift_intrin_sse2(qtable, coefs, v1_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_component_rlgr1_intrin_sse41(struct rfxencode *enc, const char *qtable,
+                                        const uint8 *data,
+                                        uint8 *buffer, int buffer_size, int *size)
+{
+    LLOGLN(10, ("rfx_encode_component_rlgr1_intrin_sse41:"));
+    if (rfxcodec_encode_dwt_shift_intrin_sse41(qtable, data, enc->dwt_buffer1,
+                                               enc->dwt_buffer) != 0)
+    {
+        return 1;
+    }
+    *size = enc->rfx_encode_diff_rlgr1(enc->dwt_buffer1, buffer,
+                                       buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_encode_component_rlgr3_intrin_sse41(struct rfxencode *enc, const char *qtable,
+                                        const uint8 *data,
+                                        uint8 *buffer, int buffer_size, int *size)
+{
+    LLOGLN(10, ("rfx_encode_component_rlgr3_intrin_sse41:"));
+    if (rfxcodec_encode_dwt_shift_intrin_sse41(qtable, data, enc->dwt_buffer1,
+                                               enc->dwt_buffer) != 0)
+    {
+        return 1;
+    }
+    *size = enc->rfx_encode_diff_rlgr3(enc->dwt_buffer1, buffer,
+                                       buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_encode_dwt_shift_intrin_sse41(struct rfxencode *enc, const char *qtable,
+                                  const uint8 *data, sint16 *coefs)
+{
+    return rfxcodec_encode_dwt_shift_intrin_sse41(qtable, data, coefs,
+                                                  enc->dwt_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_dwt_h1_shift_intrin_sse41(struct rfxencode *enc, const char *qtable,
+                                     sint16 *v1_buffer, sint16 *coefs)
+{
+    return rfxcodec_encode_dwt_h1_shift_intrin_sse41(qtable, coefs, v1_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_component_rlgr1_intrin_avx2(struct rfxencode *enc, const char *qtable,
+                                       const uint8 *data,
+                                       uint8 *buffer, int buffer_size, int *size)
+{
+    LLOGLN(10, ("rfx_encode_component_rlgr1_intrin_avx2:"));
+    if (rfxcodec_encode_dwt_shift_intrin_avx2(qtable, data, enc->dwt_buffer1,
+                                              enc->dwt_buffer) != 0)
+    {
+        return 1;
+    }
+    *size = enc->rfx_encode_diff_rlgr1(enc->dwt_buffer1, buffer,
+                                       buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_encode_component_rlgr3_intrin_avx2(struct rfxencode *enc, const char *qtable,
+                                       const uint8 *data,
+                                       uint8 *buffer, int buffer_size, int *size)
+{
+    LLOGLN(10, ("rfx_encode_component_rlgr3_intrin_avx2:"));
+    if (rfxcodec_encode_dwt_shift_intrin_avx2(qtable, data, enc->dwt_buffer1,
+                                              enc->dwt_buffer) != 0)
+    {
+        return 1;
+    }
+    *size = enc->rfx_encode_diff_rlgr3(enc->dwt_buffer1, buffer,
+                                       buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_encode_dwt_shift_intrin_avx2(struct rfxencode *enc, const char *qtable,
+                                 const uint8 *data, sint16 *coefs)
+{
+    return rfxcodec_encode_dwt_shift_intrin_avx2(qtable, data, coefs,
+                                                 enc->dwt_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_dwt_h1_shift_intrin_avx2(struct rfxencode *enc, const char *qtable,
+                                    sint16 *v1_buffer, sint16 *coefs)
+{
+    return rfxcodec_encode_dwt_h1_shift_intrin_avx2(qtable, coefs, v1_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_rgb_to_yuv_intrin_sse2(struct rfxencode *enc, const char *rgb_data,
+                                  int width, int height, int stride_bytes)
+{
+    int count;
+
+    count = rgb_to_yuv_simd(&g_yuv_sse2, rgb_data, width, height,
+                            stride_bytes, enc->format, NULL,
+                            enc->y_r_buffer, enc->u_g_buffer,
+                            enc->v_b_buffer);
+    return rfx_encode_rgb_to_yuv_tail(rgb_data, width, height, stride_bytes,
+                                      enc->format, count, NULL,
+                                      enc->y_r_buffer, enc->u_g_buffer,
+                                      enc->v_b_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_argb_to_yuva_intrin_sse2(struct rfxencode *enc,
+                                    const char *argb_data, int width,
+                                    int height, int stride_bytes)
+{
+    int count;
+
+    count = rgb_to_yuv_simd(&g_yuv_sse2, argb_data, width, height,
+                            stride_bytes, enc->format, enc->a_buffer,
+                            enc->y_r_buffer, enc->u_g_buffer,
+                            enc->v_b_buffer);
+    return rfx_encode_rgb_to_yuv_tail(argb_data, width, height, stride_bytes,
+                                      enc->format, count, enc->a_buffer,
+                                      enc->y_r_buffer, enc->u_g_buffer,
+                                      enc->v_b_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_rgb_to_yuv_row_intrin_sse2(const char *rgb_row, int width,
+                                      int pixel_format, uint8 *a_row,
+                                      uint8 *y_row, uint8 *u_row, uint8 *v_row)
+{
+    int count;
+
+    count = rgb_to_yuv_simd(&g_yuv_sse2, rgb_row, width, 1, 0,
+                            pixel_format, a_row, y_row, u_row, v_row);
+    return rfx_encode_rgb_to_yuv_row_tail(rgb_row, width, pixel_format, count,
+                                          a_row, y_row, u_row, v_row);
+}
+
+/******************************************************************************/
+int
+rfx_encode_rgb_to_yuv_intrin_sse41(struct rfxencode *enc, const char *rgb_data,
+                                   int width, int height, int stride_bytes)
+{
+    int count;
+
+    count = rgb_to_yuv_simd(&g_yuv_sse41, rgb_data, width, height,
+                            stride_bytes, enc->format, NULL,
+                            enc->y_r_buffer, enc->u_g_buffer,
+                            enc->v_b_buffer);
+    return rfx_encode_rgb_to_yuv_tail(rgb_data, width, height, stride_bytes,
+                                      enc->format, count, NULL,
+                                      enc->y_r_buffer, enc->u_g_buffer,
+                                      enc->v_b_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_argb_to_yuva_intrin_sse41(struct rfxencode *enc,
+                                     const char *argb_data, int width,
+                                     int height, int stride_bytes)
+{
+    int count;
+
+    count = rgb_to_yuv_simd(&g_yuv_sse41, argb_data, width, height,
+                            stride_bytes, enc->format, enc->a_buffer,
+                            enc->y_r_buffer, enc->u_g_buffer,
+                            enc->v_b_buffer);
+    return rfx_encode_rgb_to_yuv_tail(argb_data, width, height, stride_bytes,
+                                      enc->format, count, enc->a_buffer,
+                                      enc->y_r_buffer, enc->u_g_buffer,
+                                      enc->v_b_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_rgb_to_yuv_row_intrin_sse41(const char *rgb_row, int width,
+                                       int pixel_format, uint8 *a_row,
+                                       uint8 *y_row, uint8 *u_row, uint8 *v_row)
+{
+    int count;
+
+    count = rgb_to_yuv_simd(&g_yuv_sse41, rgb_row, width, 1, 0,
+                            pixel_format, a_row, y_row, u_row, v_row);
+    return rfx_encode_rgb_to_yuv_row_tail(rgb_row, width, pixel_format, count,
+                                          a_row, y_row, u_row, v_row);
+}
+
+/******************************************************************************/
+int
+rfx_encode_rgb_to_yuv_intrin_avx2(struct rfxencode *enc, const char *rgb_data,
+                                  int width, int height, int stride_bytes)
+{
+    int count;
+
+    count = rgb_to_yuv_simd(&g_yuv_avx2, rgb_data, width, height,
+                            stride_bytes, enc->format, NULL,
+                            enc->y_r_buffer, enc->u_g_buffer,
+                            enc->v_b_buffer);
+    return rfx_encode_rgb_to_yuv_tail(rgb_data, width, height, stride_bytes,
+                                      enc->format, count, NULL,
+                                      enc->y_r_buffer, enc->u_g_buffer,
+                                      enc->v_b_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_argb_to_yuva_intrin_avx2(struct rfxencode *enc,
+                                    const char *argb_data, int width,
+                                    int height, int stride_bytes)
+{
+    int count;
+
+    count = rgb_to_yuv_simd(&g_yuv_avx2, argb_data, width, height,
+                            stride_bytes, enc->format, enc->a_buffer,
+                            enc->y_r_buffer, enc->u_g_buffer,
+                            enc->v_b_buffer);
+    return rfx_encode_rgb_to_yuv_tail(argb_data, width, height, stride_bytes,
+                                      enc->format, count, enc->a_buffer,
+                                      enc->y_r_buffer, enc->u_g_buffer,
+                                      enc->v_b_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_rgb_to_yuv_row_intrin_avx2(const char *rgb_row, int width,
+                                      int pixel_format, uint8 *a_row,
+                                      uint8 *y_row, uint8 *u_row, uint8 *v_row)
+{
+    int count;
+
+    count = rgb_to_yuv_simd(&g_yuv_avx2, rgb_row, width, 1, 0,
+                            pixel_format, a_row, y_row, u_row, v_row);
+    return rfx_encode_rgb_to_yuv_row_tail(rgb_row, width, pixel_format, count,
+                                          a_row, y_row, u_row, v_row);
+}
@@ -31,6 +31,7 @@ typedef signed short sint16;
 typedef unsigned short uint16;
 typedef signed int sint32;
 typedef unsigned int uint32;
+typedef unsigned long long uint64;
 
 struct _STREAM
 {
@@ -106,17 +107,28 @@ typedef struct _STREAM STREAM;
 
   LZCNT = BSR ^ 31
 
+  GBSF is the forward scan, __builtin_ctz gives BSF or TZCNT, _BitScanForward
+  on Visual C++, _in must not be 0 for either
+
 */
 #if defined(__GNUC__)
 #define GBSR(_in, _r) do { \
     _r = __builtin_clz(_in) ^ 31; \
 } while (0)
+#define GBSF(_in, _r) do { \
+    _r = __builtin_ctz(_in); \
+} while (0)
 #elif defined(_MSC_VER) && (_MSC_VER > 1000)
 #define GBSR(_in, _r) do { \
     unsigned long rv = 0; \
     _BitScanReverse(&rv, _in); \
     _r = rv; \
 } while (0)
+#define GBSF(_in, _r) do { \
+    unsigned long rv = 0; \
+    _BitScanForward(&rv, _in); \
+    _r = rv; \
+} while (0)
 #else
 #define GBSR(_in, _r) do { \
     int rv = -1; \
@@ -128,6 +140,46 @@ typedef struct _STREAM STREAM;
     } \
     _r = rv; \
 } while (0)
+#define GBSF(_in, _r) do { \
+    int rv = 0; \
+    unsigned int x = _in; \
+    while ((x & 1) == 0) \
+    { \
+        rv++; \
+        x = x >> 1; \
+    } \
+    _r = rv; \
+} while (0)
+#endif
+
+/*
+  the RLGR coders are built a second time for CPUs with LZCNT and BMI2,
+  the compiler picks lzcnt, tzcnt, bzhi and shlx for the same C when the
+  function has RFX_TARGET_BMI2, the shared body is RFX_ALWAYS_INLINE so it
+  is compiled once for each
+*/
+#if defined(__GNUC__)
+#define RFX_ALWAYS_INLINE __inline__ __attribute__((always_inline))
+#if defined(RFX_USE_ACCEL_X86) || defined(RFX_USE_ACCEL_AMD64) || \
+    defined(RFX_USE_ACCEL_INTRIN)
+#define RFX_USE_BMI2 1
+#define RFX_TARGET_BMI2 __attribute__((target("lzcnt,bmi,bmi2")))
+#endif
+#else
+#define RFX_ALWAYS_INLINE
+#endif
+
+/*
+  RFX_RESTRICT marks the buffers of a row kernel as not overlapping, without
+  it the compiler has to check for overlap at run time before it can use
+  vector loads and stores for a plain C loop, and at -O2 it does not
+*/
+#if defined(__GNUC__)
+#define RFX_RESTRICT __restrict__
+#elif defined(_MSC_VER) && (_MSC_VER >= 1400)
+#define RFX_RESTRICT __restrict
+#else
+#define RFX_RESTRICT
 #endif
 
 #endif
@@ -0,0 +1,216 @@
+/**
+ * RFX codec decoder
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rfxcodec_decode.h>
+
+#include "rfxcommon.h"
+#include "rfxconstants.h"
+#include "rfxdecode.h"
+#include "rfxdecode_parse.h"
+#include "rfxdecode_dwt.h"
+#include "rfxdecode_yuv_to_rgb.h"
+
+#ifdef RFX_USE_ACCEL_X86
+#include "x86/funcs_x86.h"
+#endif
+
+#ifdef RFX_USE_ACCEL_AMD64
+#include "amd64/funcs_amd64.h"
+#endif
+
+#ifdef RFX_USE_ACCEL_INTRIN
+#include "intrin/funcs_intrin.h"
+#endif
+
+#if defined(SIMD_USE_ACCEL)
+/******************************************************************************/
+/* only the sse2 and avx2 kernels are used, see rfxcodec_encode_create_ex
+   for the rest of the cpuid bits */
+static void
+rfxdecode_get_cpu(struct rfxdecode *dec)
+{
+    int ax;
+    int bx;
+    int cx;
+    int dx;
+    int xcr0;
+
+#if defined(RFX_USE_ACCEL_X86)
+    cpuid_x86(1, 0, &ax, &bx, &cx, &dx);
+#elif defined(RFX_USE_ACCEL_AMD64)
+    cpuid_amd64(1, 0, &ax, &bx, &cx, &dx);
+#elif defined(RFX_USE_ACCEL_INTRIN)
+    cpuid_intrin(1, 0, &ax, &bx, &cx, &dx);
+#endif
+    if (dx & (1 << 26)) /* SSE 2 */
+    {
+        printf("rfxcodec_decode_create: got sse2\n");
+        dec->got_sse2 = 1;
+    }
+    /* ymm state must be enabled by the OS, XCR0 bits 1 and 2 */
+    xcr0 = 0;
+    if ((cx & (1 << 27)) && (cx & (1 << 28))) /* OSXSAVE and AVX */
+    {
+#if defined(RFX_USE_ACCEL_X86)
+        xgetbv_x86(0, &xcr0, &dx);
+#elif defined(RFX_USE_ACCEL_AMD64)
+        xgetbv_amd64(0, &xcr0, &dx);
+#elif defined(RFX_USE_ACCEL_INTRIN)
+        xgetbv_intrin(0, &xcr0, &dx);
+#endif
+        if ((xcr0 & 6) == 6)
+        {
+            printf("rfxcodec_decode_create: got avx\n");
+            dec->got_avx = 1;
+        }
+    }
+    if (dec->got_avx)
+    {
+#if defined(RFX_USE_ACCEL_X86)
+        cpuid_x86(7, 0, &ax, &bx, &cx, &dx);
+#elif defined(RFX_USE_ACCEL_AMD64)
+        cpuid_amd64(7, 0, &ax, &bx, &cx, &dx);
+#elif defined(RFX_USE_ACCEL_INTRIN)
+        cpuid_intrin(7, 0, &ax, &bx, &cx, &dx);
+#endif
+        if (bx & (1 << 5)) /* AVX 2 */
+        {
+            printf("rfxcodec_decode_create: got avx2\n");
+            dec->got_avx2 = 1;
+        }
+    }
+}
+#endif
+
+/******************************************************************************/
+int
+rfxcodec_decode_create(int width, int height, int format, int flags,
+                       void **handle)
+{
+    struct rfxdecode *dec;
+
+    if (flags & RFX_FLAGS_PRO1)
+    {
+        /* progressive is encode only */
+        return 3;
+    }
+    dec = (struct rfxdecode *) calloc(1, sizeof(struct rfxdecode));
+    if (dec == NULL)
+    {
+        return 1;
+    }
+    dec->width = width;
+    dec->height = height;
+    dec->flags = flags;
+    dec->mode = RLGR3;
+    switch (format)
+    {
+        case RFX_FORMAT_BGRA:
+            dec->bits_per_pixel = 32;
+            break;
+        case RFX_FORMAT_RGBA:
+            dec->bits_per_pixel = 32;
+            break;
+        case RFX_FORMAT_BGR:
+            dec->bits_per_pixel = 24;
+            break;
+        case RFX_FORMAT_RGB:
+            dec->bits_per_pixel = 24;
+            break;
+        case RFX_FORMAT_YUV:
+            dec->bits_per_pixel = 32;
+            break;
+        default:
+            free(dec);
+            return 2;
+    }
+    dec->format = format;
+
+#if defined(SIMD_USE_ACCEL)
+    rfxdecode_get_cpu(dec);
+#endif
+
+    dec->rfx_decode_dwt = rfx_dwt_2d_decode;
+    dec->rfx_decode_yuv_to_bgra = rfx_decode_yuv_to_bgra;
+    if (flags & RFX_FLAGS_NOACCEL)
+    {
+        *handle = dec;
+        return 0;
+    }
+#if defined(RFX_USE_ACCEL_INTRIN)
+    if (dec->got_avx2)
+    {
+        printf("rfxcodec_decode_create: rfx_decode_dwt set to rfxcodec_decode_dwt_intrin_avx2\n");
+        dec->rfx_decode_dwt = rfxcodec_decode_dwt_intrin_avx2;
+        printf("rfxcodec_decode_create: rfx_decode_yuv_to_bgra set to rfxcodec_decode_yuv_to_bgra_intrin_avx2\n");
+        dec->rfx_decode_yuv_to_bgra = rfxcodec_decode_yuv_to_bgra_intrin_avx2;
+    }
+    else if (dec->got_sse2)
+    {
+        printf("rfxcodec_decode_create: rfx_decode_dwt set to rfxcodec_decode_dwt_intrin_sse2\n");
+        dec->rfx_decode_dwt = rfxcodec_decode_dwt_intrin_sse2;
+        printf("rfxcodec_decode_create: rfx_decode_yuv_to_bgra set to rfxcodec_decode_yuv_to_bgra_intrin_sse2\n");
+        dec->rfx_decode_yuv_to_bgra = rfxcodec_decode_yuv_to_bgra_intrin_sse2;
+    }
+#endif
+    *handle = dec;
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfxcodec_decode_destroy(void *handle)
+{
+    struct rfxdecode *dec;
+
+    dec = (struct rfxdecode *) handle;
+    if (dec == NULL)
+    {
+        return 0;
+    }
+    free(dec->rects);
+    free(dec);
+    return 0;
+}
+
+/******************************************************************************/
+/* decode a message from rfxcodec_encode, the tiles in it are drawn to data
+   clipped to its region rects and width x height
+   returns 0 on success */
+int
+rfxcodec_decode(void *handle, char *cdata, int cdata_bytes,
+                char *data, int width, int height, int stride_bytes)
+{
+    struct rfxdecode *dec;
+    STREAM s;
+
+    dec = (struct rfxdecode *) handle;
+    s.data = (uint8 *) cdata;
+    s.p = s.data;
+    s.size = cdata_bytes;
+    dec->num_rects = 0;
+    return rfx_parse_message(dec, &s, data, width, height, stride_bytes);
+}
@@ -0,0 +1,71 @@
+/**
+ * RFX codec decoder
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __RFXDECODE_H
+#define __RFXDECODE_H
+
+/* 3 level inverse 5/3 dwt of a 64 x 64 tile, buffer is the subband layout
+   rfx_dwt_2d_encode writes, dwt_buffer is 4096 sint16 of scratch */
+typedef int (*rfx_decode_dwt_proc)(sint16 *buffer, sint16 *dwt_buffer);
+/* 64 x 64 YCbCr, as the dwt leaves it, to B, G, R, 0xFF pixels */
+typedef int (*rfx_decode_yuv_to_bgra_proc)(const sint16 *y_buffer,
+                                           const sint16 *u_buffer,
+                                           const sint16 *v_buffer,
+                                           uint8 *bgra_buffer);
+
+/* a TS_RFX_RECT from the region block */
+struct rfx_drect
+{
+    int x;
+    int y;
+    int cx;
+    int cy;
+};
+
+struct rfxdecode
+{
+    int width;
+    int height;
+    int format;
+    int flags;
+    int bits_per_pixel;
+    int mode; /* RLGR1 or RLGR3, from the tileset properties */
+    int pad0[2];
+
+    /* tile working buffers */
+    sint16 y_buffer[4096];
+    sint16 u_buffer[4096];
+    sint16 v_buffer[4096];
+    sint16 dwt_buffer[4096];
+    uint8 bgra_buffer[64 * 64 * 4];
+    uint8 a_buffer[4096];
+
+    /* clip rects of the current frame, see rfx_parse_message_region */
+    struct rfx_drect *rects;
+    int num_rects;
+    int max_rects;
+
+    rfx_decode_dwt_proc rfx_decode_dwt;
+    rfx_decode_yuv_to_bgra_proc rfx_decode_yuv_to_bgra;
+
+    int got_sse2;
+    int got_avx;
+    int got_avx2;
+};
+
+#endif
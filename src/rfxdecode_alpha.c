@@ -0,0 +1,139 @@
+/**
+ * RFX codec decoder
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rfxcommon.h"
+#include "rfxdecode_alpha.h"
+
+/*****************************************************************************/
+/* one row of the RLE from fpack, a code byte is a count of raw bytes in
+   the high nibble and a count of repeats of the last byte in the low, a
+   low nibble of 1 or 2 is a big run of (low << 4) + high repeats instead
+   returns the bytes used, -1 on error */
+static int
+funpack_row(const uint8 *data, int data_bytes, uint8 *row)
+{
+    const uint8 *src;
+    const uint8 *src_end;
+    uint8 last;
+    int code;
+    int collen;
+    int replen;
+    int index;
+
+    src = data;
+    src_end = data + data_bytes;
+    last = 0;
+    index = 0;
+    while (index < 64)
+    {
+        if (src >= src_end)
+        {
+            return -1;
+        }
+        code = *src++;
+        collen = code >> 4;
+        replen = code & 0xF;
+        if ((replen == 1) || (replen == 2))
+        {
+            replen = (replen << 4) | collen;
+            collen = 0;
+        }
+        if ((collen + replen > 64 - index) || (collen > src_end - src))
+        {
+            return -1;
+        }
+        if (collen > 0)
+        {
+            memcpy(row + index, src, collen);
+            src += collen;
+            index += collen;
+            last = row[index - 1];
+        }
+        memset(row + index, last, replen);
+        index += replen;
+    }
+    return (int) (src - data);
+}
+
+/*****************************************************************************/
+/* undo fdelta, the rows after the first are (d << 1) ^ (d < 0 ? 0xFF : 0)
+   of the difference to the row above */
+static void
+fundelta(uint8 *plane)
+{
+    uint8 *dst8;
+    uint8 d;
+    int index;
+
+    dst8 = plane + 64;
+    for (index = 64; index < 4096; index++)
+    {
+        d = dst8[0];
+        d = (d >> 1) ^ (uint8) (-(d & 1));
+        dst8[0] = dst8[-64] + d;
+        dst8++;
+    }
+}
+
+/*****************************************************************************/
+/* a 64 x 64 plane from rfx_encode_plane, the flags byte then either the
+   RLE of the delta plane or the raw plane and a pad byte
+   returns the bytes used including the flags byte, -1 on error */
+int
+rfx_decode_plane(const uint8 *data, int data_bytes, uint8 *plane)
+{
+    int bytes;
+    int jndex;
+    int used;
+
+    if (data_bytes < 1)
+    {
+        return -1;
+    }
+    if ((data[0] & 0x10) == 0)
+    {
+        /* raw */
+        if (data_bytes < 4096 + 2)
+        {
+            return -1;
+        }
+        memcpy(plane, data + 1, 4096);
+        return 4096 + 2;
+    }
+    bytes = 1;
+    for (jndex = 0; jndex < 64; jndex++)
+    {
+        used = funpack_row(data + bytes, data_bytes - bytes,
+                           plane + jndex * 64);
+        if (used < 0)
+        {
+            return -1;
+        }
+        bytes += used;
+    }
+    fundelta(plane);
+    return bytes;
+}
@@ -0,0 +1,25 @@
+/**
+ * RFX codec decoder
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __RFXDECODE_ALPHA_H
+#define __RFXDECODE_ALPHA_H
+
+int
+rfx_decode_plane(const uint8 *data, int data_bytes, uint8 *plane);
+
+#endif
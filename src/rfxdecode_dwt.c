@@ -0,0 +1,174 @@
+/**
+ * FreeRDP: A Remote Desktop Protocol client.
+ * RemoteFX Codec Library - DWT
+ *
+ * Copyright 2011 Vic Lee
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rfxcommon.h"
+#include "rfxdecode_dwt.h"
+
+/******************************************************************************/
+/* one row of the inverse horizontal DWT, the low and high halves l and h
+   are interleaved to 2 * width values in dst, the even values first as
+   the odd ones are interpolated from them */
+static void
+rfx_dwt_2d_decode_horz_row(const sint16 *RFX_RESTRICT l,
+                           const sint16 *RFX_RESTRICT h,
+                           sint16 *RFX_RESTRICT dst, int width)
+{
+    int n;
+
+    /* pre, h[-1] mirrors to h[0] */
+    dst[0] = l[0] - h[0];
+
+    /* loop */
+    for (n = 1; n < width; n++)
+    {
+        dst[2 * n] = l[n] - ((h[n - 1] + h[n] + 1) >> 1);
+        dst[2 * n - 1] = (h[n - 1] << 1) + ((dst[2 * n - 2] + dst[2 * n]) >> 1);
+    }
+
+    /* post, dst[2 * width] mirrors to dst[2 * width - 2] */
+    n = width - 1;
+    dst[2 * n + 1] = (h[n] << 1) + dst[2 * n];
+}
+
+/******************************************************************************/
+/* inverse DWT in horizontal direction, the LL and HL sub-bands give the
+   L rows and LH and HH give the H rows, in L, H order in out_buffer */
+static int
+rfx_dwt_2d_decode_horz(const sint16 *in_buffer, sint16 *out_buffer,
+                       int subband_width)
+{
+    const sint16 *hl, *lh, *hh, *ll;
+    sint16 *l_dst, *h_dst;
+    int total_width;
+    int y;
+
+    total_width = subband_width << 1;
+    hl = in_buffer;
+    lh = in_buffer + subband_width * subband_width;
+    hh = in_buffer + subband_width * subband_width * 2;
+    ll = in_buffer + subband_width * subband_width * 3;
+    l_dst = out_buffer;
+    h_dst = out_buffer + subband_width * total_width;
+    for (y = 0; y < subband_width; y++)
+    {
+        rfx_dwt_2d_decode_horz_row(ll, hl, l_dst, subband_width);
+        rfx_dwt_2d_decode_horz_row(lh, hh, h_dst, subband_width);
+        ll += subband_width;
+        hl += subband_width;
+        lh += subband_width;
+        hh += subband_width;
+        l_dst += total_width;
+        h_dst += total_width;
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/* one row pair of the inverse vertical DWT, l and h are the rows of pair
+   n, hp is the H row of pair n - 1, ep is output row 2n - 2 and the even
+   row 2n and odd row 2n - 1 are written */
+static void
+rfx_dwt_2d_decode_vert_row(const sint16 *RFX_RESTRICT l,
+                           const sint16 *RFX_RESTRICT h,
+                           const sint16 *RFX_RESTRICT hp,
+                           const sint16 *RFX_RESTRICT ep,
+                           sint16 *RFX_RESTRICT o, sint16 *RFX_RESTRICT e,
+                           int width)
+{
+    int x;
+
+    for (x = 0; x < width; x++)
+    {
+        e[x] = l[x] - ((hp[x] + h[x] + 1) >> 1);
+        o[x] = (hp[x] << 1) + ((ep[x] + e[x]) >> 1);
+    }
+}
+
+/******************************************************************************/
+/* inverse DWT in vertical direction, the L and H rows in in_buffer are
+   interleaved to out_buffer a row pair at a time so the inner loop runs
+   along the rows */
+static int
+rfx_dwt_2d_decode_vert(const sint16 *in_buffer, sint16 *out_buffer,
+                       int subband_width)
+{
+    const sint16 *l, *h;
+    sint16 *e;
+    int total_width;
+    int n;
+    int x;
+
+    total_width = subband_width << 1;
+    l = in_buffer;
+    h = l + subband_width * total_width;
+    e = out_buffer;
+
+    /* pre */
+    for (x = 0; x < total_width; x++)
+    {
+        e[x] = l[x] - h[x];
+    }
+
+    /* loop */
+    for (n = 1; n < subband_width; n++)
+    {
+        l += total_width;
+        h += total_width;
+        e += total_width * 2;
+        rfx_dwt_2d_decode_vert_row(l, h, h - total_width, e - total_width * 2,
+                                   e - total_width, e, total_width);
+    }
+
+    /* post */
+    for (x = 0; x < total_width; x++)
+    {
+        e[total_width + x] = (h[x] << 1) + e[x];
+    }
+    return 0;
+}
+
+/******************************************************************************/
+static int
+rfx_dwt_2d_decode_block(sint16 *in_out_buffer, sint16 *tmp_buffer,
+                        int subband_width)
+{
+    rfx_dwt_2d_decode_horz(in_out_buffer, tmp_buffer, subband_width);
+    return rfx_dwt_2d_decode_vert(tmp_buffer, in_out_buffer, subband_width);
+}
+
+/******************************************************************************/
+/* each level leaves its 2 * subband_width square where the next level up
+   has its LL sub-band */
+int
+rfx_dwt_2d_decode(sint16 *buffer, sint16 *dwt_buffer)
+{
+    rfx_dwt_2d_decode_block(buffer + 3840, dwt_buffer, 8);
+    rfx_dwt_2d_decode_block(buffer + 3072, dwt_buffer, 16);
+    rfx_dwt_2d_decode_block(buffer, dwt_buffer, 32);
+    return 0;
+}
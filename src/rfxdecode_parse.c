@@ -0,0 +1,329 @@
+/**
+ * RFX codec decoder
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rfxcodec_decode.h>
+
+#include "rfxcommon.h"
+#include "rfxconstants.h"
+#include "rfxdecode.h"
+#include "rfxdecode_parse.h"
+#include "rfxdecode_tile.h"
+#include "rfxdecode_alpha.h"
+
+#define LLOG_LEVEL 1
+#define LLOGLN(_level, _args) \
+    do { if (_level < LLOG_LEVEL) { printf _args ; printf("\n"); } } while (0)
+
+/******************************************************************************/
+static int
+rfx_parse_message_sync(struct rfxdecode *dec, STREAM *s)
+{
+    uint32 magic;
+    uint16 version;
+
+    if (stream_get_left(s) < 6)
+    {
+        return 1;
+    }
+    stream_read_uint32(s, magic); /* magic */
+    stream_read_uint16(s, version); /* version */
+    if ((magic != WF_MAGIC) || (version != WF_VERSION_1_0))
+    {
+        LLOGLN(0, ("rfx_parse_message_sync: bad magic 0x%8.8x version "
+               "0x%4.4x", magic, version));
+        return 1;
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/* the rects tiles are clipped to until the next region */
+static int
+rfx_parse_message_region(struct rfxdecode *dec, STREAM *s)
+{
+    struct rfx_drect *rects;
+    uint16 num_rects;
+    uint16 val16;
+    int index;
+
+    if (stream_get_left(s) < 5)
+    {
+        return 1;
+    }
+    stream_seek(s, 3); /* codecId, channelId, regionFlags */
+    stream_read_uint16(s, num_rects); /* numRects */
+    if (stream_get_left(s) < num_rects * 8)
+    {
+        return 1;
+    }
+    if (num_rects > dec->max_rects)
+    {
+        rects = (struct rfx_drect *)
+                realloc(dec->rects, num_rects * sizeof(struct rfx_drect));
+        if (rects == NULL)
+        {
+            return 1;
+        }
+        dec->rects = rects;
+        dec->max_rects = num_rects;
+    }
+    for (index = 0; index < num_rects; index++)
+    {
+        stream_read_uint16(s, val16);
+        dec->rects[index].x = val16;
+        stream_read_uint16(s, val16);
+        dec->rects[index].y = val16;
+        stream_read_uint16(s, val16);
+        dec->rects[index].cx = val16;
+        stream_read_uint16(s, val16);
+        dec->rects[index].cy = val16;
+    }
+    dec->num_rects = num_rects;
+    return 0;
+}
+
+/******************************************************************************/
+/* one TS_RFX_TILE, WBT_EXTENSION_PLUS tiles also have ALen and the alpha
+   plane after the Cr data, their blockLen and ALen do not count all of
+   the header and alpha flags bytes so the next tile is found by decoding
+   the plane instead */
+static int
+rfx_parse_tile(struct rfxdecode *dec, STREAM *s,
+               const uint8 *quants, int num_quants, int have_alpha,
+               char *data, int width, int height, int stride_bytes)
+{
+    uint8 *tile_start;
+    uint16 block_type;
+    uint32 block_len;
+    uint8 quant_idx[3];
+    uint16 x_idx;
+    uint16 y_idx;
+    uint16 lens[3];
+    uint16 a_len;
+    int header_bytes;
+    int bytes;
+    int used;
+    int index;
+    sint16 *buffers[3];
+
+    header_bytes = have_alpha ? 21 : 19;
+    if (stream_get_left(s) < header_bytes)
+    {
+        return 1;
+    }
+    tile_start = s->p;
+    stream_read_uint16(s, block_type); /* BlockT.blockType */
+    stream_read_uint32(s, block_len); /* BlockT.blockLen */
+    stream_read_uint8(s, quant_idx[0]); /* quantIdxY */
+    stream_read_uint8(s, quant_idx[1]); /* quantIdxCb */
+    stream_read_uint8(s, quant_idx[2]); /* quantIdxCr */
+    stream_read_uint16(s, x_idx); /* xIdx */
+    stream_read_uint16(s, y_idx); /* yIdx */
+    stream_read_uint16(s, lens[0]); /* YLen */
+    stream_read_uint16(s, lens[1]); /* CbLen */
+    stream_read_uint16(s, lens[2]); /* CrLen */
+    a_len = 0;
+    if (have_alpha)
+    {
+        stream_read_uint16(s, a_len); /* ALen */
+    }
+    bytes = lens[0] + lens[1] + lens[2];
+    if ((block_type != CBT_TILE) || (stream_get_left(s) < bytes))
+    {
+        return 1;
+    }
+    if (!have_alpha &&
+        ((block_len < (uint32) (19 + bytes)) ||
+         (block_len > (uint32) (s->size - (tile_start - s->data)))))
+    {
+        return 1;
+    }
+    buffers[0] = dec->y_buffer;
+    buffers[1] = dec->u_buffer;
+    buffers[2] = dec->v_buffer;
+    for (index = 0; index < 3; index++)
+    {
+        if (quant_idx[index] >= num_quants)
+        {
+            return 1;
+        }
+        if (rfx_decode_component(dec, quants + quant_idx[index] * 5,
+                                 s->p, lens[index], buffers[index]) != 0)
+        {
+            return 1;
+        }
+        stream_seek(s, lens[index]);
+    }
+    if (have_alpha)
+    {
+        used = rfx_decode_plane(s->p, stream_get_left(s), dec->a_buffer);
+        LLOGLN(10, ("rfx_parse_tile: alpha used %d ALen %d", used, a_len));
+        if (used < 0)
+        {
+            return 1;
+        }
+        stream_seek(s, used);
+    }
+    else
+    {
+        stream_set_pos(s, (int) (tile_start - s->data) + block_len);
+    }
+    if (dec->format == RFX_FORMAT_YUV)
+    {
+        return rfx_decode_yuv(dec, x_idx * 64, y_idx * 64, have_alpha,
+                              data, width, height, stride_bytes);
+    }
+    return rfx_decode_rgb(dec, x_idx * 64, y_idx * 64, have_alpha,
+                          data, width, height, stride_bytes);
+}
+
+/******************************************************************************/
+static int
+rfx_parse_message_tileset(struct rfxdecode *dec, STREAM *s, int have_alpha,
+                          char *data, int width, int height, int stride_bytes)
+{
+    uint16 subtype;
+    uint16 properties;
+    uint8 num_quants;
+    uint16 num_tiles;
+    uint32 tiles_data_size;
+    const uint8 *quants;
+    STREAM tiles;
+    int index;
+
+    if (stream_get_left(s) < 16)
+    {
+        return 1;
+    }
+    stream_seek(s, 2); /* codecId, channelId */
+    stream_read_uint16(s, subtype); /* subtype */
+    if (subtype != CBT_TILESET)
+    {
+        return 0;
+    }
+    stream_seek_uint16(s); /* idx */
+    stream_read_uint16(s, properties); /* properties */
+    stream_read_uint8(s, num_quants); /* numQuants */
+    stream_seek_uint8(s); /* tileSize */
+    stream_read_uint16(s, num_tiles); /* numTiles */
+    stream_read_uint32(s, tiles_data_size); /* tilesDataSize */
+    switch ((properties >> 10) & 0xF) /* et */
+    {
+        case CLW_ENTROPY_RLGR1:
+            dec->mode = RLGR1;
+            break;
+        case CLW_ENTROPY_RLGR3:
+            dec->mode = RLGR3;
+            break;
+        default:
+            return 1;
+    }
+    if (stream_get_left(s) < num_quants * 5)
+    {
+        return 1;
+    }
+    quants = s->p;
+    stream_seek(s, num_quants * 5);
+    if ((uint32) stream_get_left(s) < tiles_data_size)
+    {
+        return 1;
+    }
+    tiles.data = s->p;
+    tiles.p = s->p;
+    tiles.size = tiles_data_size;
+    for (index = 0; index < num_tiles; index++)
+    {
+        if (rfx_parse_tile(dec, &tiles, quants, num_quants, have_alpha,
+                           data, width, height, stride_bytes) != 0)
+        {
+            LLOGLN(0, ("rfx_parse_message_tileset: bad tile %d", index));
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_parse_message(struct rfxdecode *dec, STREAM *s,
+                  char *data, int width, int height, int stride_bytes)
+{
+    STREAM block;
+    uint16 block_type;
+    uint32 block_len;
+    int error;
+
+    while (stream_get_left(s) > 0)
+    {
+        if (stream_get_left(s) < 6)
+        {
+            return 1;
+        }
+        block.data = s->p;
+        stream_read_uint16(s, block_type); /* BlockT.blockType */
+        stream_read_uint32(s, block_len); /* BlockT.blockLen */
+        if ((block_len < 6) ||
+            (block_len > (uint32) stream_get_left(s) + 6))
+        {
+            return 1;
+        }
+        block.p = s->p;
+        block.size = block_len;
+        stream_seek(s, block_len - 6);
+        switch (block_type)
+        {
+            case WBT_SYNC:
+                error = rfx_parse_message_sync(dec, &block);
+                break;
+            case WBT_REGION:
+                error = rfx_parse_message_region(dec, &block);
+                break;
+            case WBT_EXTENSION:
+                error = rfx_parse_message_tileset(dec, &block, 0, data,
+                                                  width, height,
+                                                  stride_bytes);
+                break;
+            case WBT_EXTENSION_PLUS:
+                error = rfx_parse_message_tileset(dec, &block, 1, data,
+                                                  width, height,
+                                                  stride_bytes);
+                break;
+            default:
+                /* WBT_CODEC_VERSIONS, WBT_CHANNELS, WBT_CONTEXT,
+                   WBT_FRAME_BEGIN and WBT_FRAME_END carry nothing the
+                   tiles need, the tileset has its own properties */
+                error = 0;
+                break;
+        }
+        if (error != 0)
+        {
+            LLOGLN(0, ("rfx_parse_message: error in block type 0x%4.4x",
+                   block_type));
+            return error;
+        }
+    }
+    return 0;
+}
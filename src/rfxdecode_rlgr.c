@@ -0,0 +1,318 @@
+/**
+ * FreeRDP: A Remote Desktop Protocol client.
+ * RemoteFX Codec Library - RLGR
+ *
+ * Copyright 2011 Vic Lee
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * This implementation of RLGR refers to
+ * [MS-RDPRFX] 3.1.8.1.7.3 RLGR1/RLGR3 Pseudocode
+ */
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rfxcommon.h"
+#include "rfxconstants.h"
+#include "rfxdecode_rlgr.h"
+
+/* Constants used within the RLGR1/RLGR3 algorithm */
+#define KPMAX   (80)  /* max value for kp or krp */
+#define LSGR    (3)   /* shift count to convert kp to k */
+#define UP_GR   (4)   /* increase in kp after a zero run in RL mode */
+#define DN_GR   (6)   /* decrease in kp after a nonzero symbol in RL mode */
+#define UQ_GR   (3)   /* increase in kp after zero symbol in GR mode */
+#define DQ_GR   (3)   /* decrease in kp after nonzero symbol in GR mode */
+
+/* Returns the least number of bits required to represent a given value */
+#define GetMinBits(_val, _nbits) \
+do { \
+    uint32 _v = _val; \
+    _nbits = 0; \
+    while (_v) \
+    { \
+        _v >>= 1; \
+        _nbits++; \
+    } \
+} while (0)
+
+/*
+ * Update the passed parameter and clamp it to the range [0, KPMAX]
+ * Return the value of parameter right-shifted by LSGR
+ */
+#define UpdateParam(_param, _deltaP, _k) \
+do { \
+    _param += _deltaP; \
+    if (_param > KPMAX) \
+    { \
+        _param = KPMAX; \
+    } \
+    if (_param < 0) \
+    { \
+        _param = 0; \
+    } \
+    _k = (_param >> LSGR); \
+} while (0)
+
+/* Converts (2 * abs(input) - sign(input)) back to the signed input */
+#define GetIntFrom2MagSign(_twoMs) \
+    ((_twoMs) & 1 ? -(int) (((_twoMs) + 1) >> 1) : (int) ((_twoMs) >> 1))
+
+/*
+  the bit reader keeps the next bits MSB first in a 64 bit word, it is
+  topped up a byte at a time to at least 57 bits so any read of up to 32
+  bits needs no check, past the end of the data it reads zeros and counts
+  them in pad_bytes
+*/
+#define FillBits() \
+do { \
+    while (bits_left <= 56) \
+    { \
+        if (src < src_end) \
+        { \
+            acc |= ((uint64) (*src++)) << (56 - bits_left); \
+        } \
+        else \
+        { \
+            pad_bytes++; \
+        } \
+        bits_left += 8; \
+    } \
+} while (0)
+
+/* read _numBits, 0 to 32, MSB first */
+#define InputBits(_numBits, _bits) \
+do { \
+    int _n = _numBits; \
+    FillBits(); \
+    if (_n > 0) \
+    { \
+        _bits = ((uint32) (acc >> 32)) >> (32 - _n); \
+        acc <<= _n; \
+        bits_left -= _n; \
+    } \
+    else \
+    { \
+        _bits = 0; \
+    } \
+} while (0)
+
+/* count and skip the 1 bits up to and including the next 0 bit */
+#define InputOnes(_count) \
+do { \
+    uint32 _hi; \
+    int _ones; \
+    _count = 0; \
+    for (;;) \
+    { \
+        FillBits(); \
+        _hi = ~((uint32) (acc >> 32)); \
+        if (_hi == 0) \
+        { \
+            _count += 32; \
+            acc <<= 32; \
+            bits_left -= 32; \
+            continue; \
+        } \
+        GBSR(_hi, _ones); \
+        _ones = 31 - _ones; \
+        _count += _ones; \
+        acc <<= _ones + 1; \
+        bits_left -= _ones + 1; \
+        break; \
+    } \
+} while (0)
+
+/* Reads the Golomb/Rice encoding of a non-negative integer */
+#define DecodeGR(_krp, _val) \
+do { \
+    int lkr = (_krp) >> LSGR; \
+    uint32 lvk; \
+    uint32 lrem; \
+    /* unary part of GR code */ \
+    InputOnes(lvk); \
+    /* remainder part of GR code, if needed */ \
+    InputBits(lkr, lrem); \
+    _val = (lvk << lkr) | lrem; \
+    /* update krp, only if it is not equal to 1 */ \
+    if (lvk == 0) \
+    { \
+        UpdateParam(_krp, -2, lkr); \
+    } \
+    else if (lvk > 1) \
+    { \
+        UpdateParam(_krp, (int) lvk, lkr); \
+    } \
+} while (0)
+
+/* Writes a decoded coefficient, drops anything past the end of the
+   buffer, RLGR3 can code one value more than there is room for */
+#define OutputValue(_val) \
+do { \
+    if (dst < dst_end) \
+    { \
+        *dst++ = (sint16) (_val); \
+    } \
+} while (0)
+
+/******************************************************************************/
+/* returns 0 when buffer_size coefficients were decoded from no more than
+   data_size bytes */
+int
+rfx_rlgr_decode(int mode, const uint8 *data, int data_size,
+                sint16 *buffer, int buffer_size)
+{
+    int k;
+    int kp;
+    int krp;
+
+    int run;
+    int room;
+    uint32 bit;
+    uint32 lrun;
+    uint32 mag;
+    uint32 twoMs;
+    uint32 twoMs1;
+    uint32 twoMs2;
+    uint32 sum2Ms;
+    uint32 nIdx;
+
+    const uint8 *src;
+    const uint8 *src_end;
+    uint64 acc;
+    int bits_left;
+    int pad_bytes;
+    sint16 *dst;
+    sint16 *dst_end;
+
+    src = data;
+    src_end = data + data_size;
+    acc = 0;
+    bits_left = 0;
+    pad_bytes = 0;
+    dst = buffer;
+    dst_end = buffer + buffer_size;
+
+    /* initialize the parameters */
+    k = 1;
+    kp = 1 << LSGR;
+    krp = 1 << LSGR;
+
+    while (dst < dst_end)
+    {
+        if (k)
+        {
+            /* RUN-LENGTH MODE */
+
+            /* each 0 bit is a full run of 1 << k zeros, a 1 bit ends it,
+               a stream that keeps reading 0 bits stops when the buffer is
+               full */
+            room = (int) (dst_end - dst);
+            run = 0;
+            for (;;)
+            {
+                InputBits(1, bit);
+                if (bit)
+                {
+                    /* the remaining run length is in k bits */
+                    InputBits(k, lrun);
+                    run += (int) lrun;
+                    break;
+                }
+                run += 1 << k;
+                UpdateParam(kp, UP_GR, k); /* update kp, k */
+                if (run >= room)
+                {
+                    break;
+                }
+            }
+            if (run >= room)
+            {
+                memset(dst, 0, room * sizeof(sint16));
+                dst = dst_end;
+                break;
+            }
+            memset(dst, 0, run * sizeof(sint16));
+            dst += run;
+
+            /* the nonzero value after the run, sign then GR code of
+               (mag - 1) */
+            InputBits(1, bit);
+            DecodeGR(krp, mag);
+            mag++;
+            OutputValue(bit ? -(int) mag : (int) mag);
+
+            UpdateParam(kp, -DN_GR, k);
+        }
+        else if (mode == RLGR1)
+        {
+            /* GOLOMB-RICE MODE */
+
+            /* RLGR1 variant */
+
+            DecodeGR(krp, twoMs);
+            OutputValue(GetIntFrom2MagSign(twoMs));
+
+            /* update k, kp, reversed from the spec like the encoder */
+            if (twoMs)
+            {
+                UpdateParam(kp, -DQ_GR, k);
+            }
+            else
+            {
+                UpdateParam(kp, UQ_GR, k);
+            }
+        }
+        else
+        {
+            /* GOLOMB-RICE MODE */
+
+            /* RLGR3 variant */
+
+            /* the sum of two (2*magnitude - sign) values is GR coded, the
+               first of them follows in as many bits as the sum needs */
+            DecodeGR(krp, sum2Ms);
+            GetMinBits(sum2Ms, nIdx);
+            InputBits((int) nIdx, twoMs1);
+            twoMs2 = sum2Ms - twoMs1;
+            OutputValue(GetIntFrom2MagSign(twoMs1));
+            OutputValue(GetIntFrom2MagSign(twoMs2));
+
+            /* update k,kp for the two input values */
+            if (twoMs1 && twoMs2)
+            {
+                UpdateParam(kp, -2 * DQ_GR, k);
+            }
+            else if (!twoMs1 && !twoMs2)
+            {
+                UpdateParam(kp, 2 * UQ_GR, k);
+            }
+        }
+    }
+
+    /* bits taken past the end of the data means it was cut short */
+    if ((int) (src - data + pad_bytes) * 8 - bits_left > data_size * 8)
+    {
+        return 1;
+    }
+    return 0;
+}
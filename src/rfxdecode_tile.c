@@ -0,0 +1,200 @@
+/**
+ * RFX codec decoder
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rfxcodec_decode.h>
+
+#include "rfxcommon.h"
+#include "rfxdecode.h"
+#include "rfxdecode_tile.h"
+#include "rfxdecode_rlgr.h"
+#include "rfxdecode_quantization.h"
+
+/******************************************************************************/
+/* entropy decode, dequantise and inverse transform one component, buffer
+   is left with the 64 x 64 values in the scale the dwt encoder takes */
+int
+rfx_decode_component(struct rfxdecode *dec, const uint8 *qtable,
+                     const uint8 *data, int data_bytes, sint16 *buffer)
+{
+    if (rfx_rlgr_decode(dec->mode, data, data_bytes, buffer, 4096) != 0)
+    {
+        return 1;
+    }
+    rfx_differential_decode(buffer + 4032, 64);
+    rfx_quantization_decode(buffer, qtable);
+    return dec->rfx_decode_dwt(buffer, dec->dwt_buffer);
+}
+
+/******************************************************************************/
+/* copy the clip part of the bgra_buffer tile at x, y to data in the
+   decoder format */
+static void
+rfx_decode_copy_rect(struct rfxdecode *dec, int x, int y,
+                     const struct rfx_drect *clip,
+                     char *data, int stride_bytes)
+{
+    const uint8 *src;
+    uint8 *dst;
+    int cx;
+    int index;
+    int jndex;
+
+    cx = clip->cx;
+    src = dec->bgra_buffer + ((clip->y - y) * 64 + (clip->x - x)) * 4;
+    dst = (uint8 *) (data + clip->y * stride_bytes +
+                     clip->x * (dec->bits_per_pixel / 8));
+    for (jndex = 0; jndex < clip->cy; jndex++)
+    {
+        switch (dec->format)
+        {
+            case RFX_FORMAT_BGRA:
+                memcpy(dst, src, cx * 4);
+                break;
+            case RFX_FORMAT_RGBA:
+                for (index = 0; index < cx; index++)
+                {
+                    dst[index * 4 + 0] = src[index * 4 + 2];
+                    dst[index * 4 + 1] = src[index * 4 + 1];
+                    dst[index * 4 + 2] = src[index * 4 + 0];
+                    dst[index * 4 + 3] = src[index * 4 + 3];
+                }
+                break;
+            case RFX_FORMAT_BGR:
+                for (index = 0; index < cx; index++)
+                {
+                    dst[index * 3 + 0] = src[index * 4 + 0];
+                    dst[index * 3 + 1] = src[index * 4 + 1];
+                    dst[index * 3 + 2] = src[index * 4 + 2];
+                }
+                break;
+            case RFX_FORMAT_RGB:
+                for (index = 0; index < cx; index++)
+                {
+                    dst[index * 3 + 0] = src[index * 4 + 2];
+                    dst[index * 3 + 1] = src[index * 4 + 1];
+                    dst[index * 3 + 2] = src[index * 4 + 0];
+                }
+                break;
+        }
+        src += 64 * 4;
+        dst += stride_bytes;
+    }
+}
+
+/******************************************************************************/
+/* the tile at x, y from the y, u and v buffers to data, only the part
+   inside the region rects and the width x height surface is written,
+   with no rects the whole surface is the region */
+int
+rfx_decode_rgb(struct rfxdecode *dec, int x, int y, int have_alpha,
+               char *data, int width, int height, int stride_bytes)
+{
+    struct rfx_drect whole;
+    struct rfx_drect clip;
+    const struct rfx_drect *rect;
+    int num_rects;
+    int index;
+    int r;
+    int b;
+
+    dec->rfx_decode_yuv_to_bgra(dec->y_buffer, dec->u_buffer, dec->v_buffer,
+                                dec->bgra_buffer);
+    if (have_alpha)
+    {
+        for (index = 0; index < 4096; index++)
+        {
+            dec->bgra_buffer[index * 4 + 3] = dec->a_buffer[index];
+        }
+    }
+    rect = dec->rects;
+    num_rects = dec->num_rects;
+    if (num_rects < 1)
+    {
+        whole.x = 0;
+        whole.y = 0;
+        whole.cx = width;
+        whole.cy = height;
+        rect = &whole;
+        num_rects = 1;
+    }
+    for (index = 0; index < num_rects; index++)
+    {
+        clip.x = MAX(x, rect->x);
+        clip.y = MAX(y, rect->y);
+        r = MIN(x + 64, rect->x + rect->cx);
+        r = MIN(r, width);
+        b = MIN(y + 64, rect->y + rect->cy);
+        b = MIN(b, height);
+        clip.x = MAX(clip.x, 0);
+        clip.y = MAX(clip.y, 0);
+        clip.cx = r - clip.x;
+        clip.cy = b - clip.y;
+        if ((clip.cx > 0) && (clip.cy > 0))
+        {
+            rfx_decode_copy_rect(dec, x, y, &clip, data, stride_bytes);
+        }
+        rect++;
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/* the tile at x, y from the y, u and v buffers to the RFX_FORMAT_YUV
+   planes rfx_encode_yuv takes, all of the tile is written, the A plane
+   only when the tile has alpha */
+int
+rfx_decode_yuv(struct rfxdecode *dec, int x, int y, int have_alpha,
+               char *data, int width, int height, int stride_bytes)
+{
+    const sint16 *src[3];
+    uint8 *dst;
+    int val;
+    int index;
+    int jndex;
+
+    if ((x >= width) || (y >= height))
+    {
+        return 1;
+    }
+    src[0] = dec->y_buffer;
+    src[1] = dec->u_buffer;
+    src[2] = dec->v_buffer;
+    dst = (uint8 *) (data + (y << 8) * (stride_bytes >> 8) + (x << 8));
+    for (jndex = 0; jndex < 3; jndex++)
+    {
+        for (index = 0; index < 4096; index++)
+        {
+            val = (src[jndex][index] + (128 << DWT_FACTOR)) >> DWT_FACTOR;
+            dst[index] = MINMAX(val, 0, 255);
+        }
+        dst += 4096;
+    }
+    if (have_alpha)
+    {
+        memcpy(dst, dec->a_buffer, 4096);
+    }
+    return 0;
+}
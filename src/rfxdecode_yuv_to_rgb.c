@@ -0,0 +1,78 @@
+/**
+ * FreeRDP: A Remote Desktop Protocol client.
+ * RemoteFX Codec Library - Decode
+ *
+ * Copyright 2011 Vic Lee
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rfxcommon.h"
+#include "rfxdecode_yuv_to_rgb.h"
+
+/*
+  ICT inverse, the same matrix FreeRDP uses, in 14 bit fixed point
+    R = Y + 1.402525 Cr
+    G = Y - 0.343730 Cb - 0.714401 Cr
+    B = Y + 1.769905 Cb
+  the dwt leaves Y - 128, Cb and Cr scaled by 1 << DWT_FACTOR so the
+  14 + 5 bits are shifted out together and 128 << 19 rounds Y back up,
+  every product fits in 32 bits for any sint16 input so the SIMD
+  kernels get the same pixels from pmaddwd
+*/
+#define YUV_Y_MUL 16384
+#define YUV_R_CR 22979
+#define YUV_G_CB 5632
+#define YUV_G_CR 11705
+#define YUV_B_CB 28998
+#define YUV_SHIFT (14 + DWT_FACTOR)
+#define YUV_ADD (128 << YUV_SHIFT)
+
+/******************************************************************************/
+int
+rfx_decode_yuv_to_bgra(const sint16 *y_buffer, const sint16 *u_buffer,
+                       const sint16 *v_buffer, uint8 *bgra_buffer)
+{
+    int index;
+    int y;
+    int u;
+    int v;
+    int r;
+    int g;
+    int b;
+
+    for (index = 0; index < 4096; index++)
+    {
+        y = y_buffer[index] * YUV_Y_MUL + YUV_ADD;
+        u = u_buffer[index];
+        v = v_buffer[index];
+        r = (y + v * YUV_R_CR) >> YUV_SHIFT;
+        g = (y - u * YUV_G_CB - v * YUV_G_CR) >> YUV_SHIFT;
+        b = (y + u * YUV_B_CB) >> YUV_SHIFT;
+        bgra_buffer[0] = MINMAX(b, 0, 255);
+        bgra_buffer[1] = MINMAX(g, 0, 255);
+        bgra_buffer[2] = MINMAX(r, 0, 255);
+        bgra_buffer[3] = 0xFF;
+        bgra_buffer += 4;
+    }
+    return 0;
+}
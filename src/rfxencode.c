@@ -36,9 +36,14 @@
 #include "rfxencode_differential.h"
 #include "rfxencode_quantization.h"
 #include "rfxencode_dwt.h"
+#include "rfxencode_dwt_shift_rem.h"
 #include "rfxencode_diff_rlgr1.h"
 #include "rfxencode_diff_rlgr3.h"
 #include "rfxencode_rgb_to_yuv.h"
+#include "rfxencode_pool.h"
+#include "rfxencode_pipe.h"
+#include "rfxencode_async.h"
+#include "rfxencode_alpha.h"
 
 #ifdef RFX_USE_ACCEL_X86
 #include "x86/funcs_x86.h"
@@ -48,6 +53,17 @@
 #include "amd64/funcs_amd64.h"
 #endif
 
+#ifdef RFX_USE_ACCEL_INTRIN
+#include "intrin/funcs_intrin.h"
+#endif
+
+/* see rfxcodec_encode_deadline */
+struct rfx_tile_order
+{
+    int priority;
+    int index;
+};
+
 static void
 clear_encoder_rbs(struct rfxencode *enc)
 {
@@ -63,6 +79,18 @@ clear_encoder_rbs(struct rfxencode *enc)
     }
 }
 
+static void
+set_dwt_buffers(struct rfxencode *enc)
+{
+    enc->dwt_buffer = (sint16 *) (((size_t) (enc->dwt_buffer_a)) & ~15);
+    enc->dwt_buffer1 = (sint16 *) (((size_t) (enc->dwt_buffer1_a)) & ~15);
+    enc->dwt_buffer2 = (sint16 *) (((size_t) (enc->dwt_buffer2_a)) & ~15);
+    enc->dwt_buffer3 = (sint16 *) (((size_t) (enc->dwt_buffer3_a)) & ~15);
+    enc->dwt_buffer4 = (sint16 *) (((size_t) (enc->dwt_buffer4_a)) & ~15);
+    enc->dwt_buffer5 = (sint16 *) (((size_t) (enc->dwt_buffer5_a)) & ~15);
+    enc->dwt_buffer6 = (sint16 *) (((size_t) (enc->dwt_buffer6_a)) & ~15);
+}
+
 static int
 rfxencode_reset_encoder(void *handle)
 {
@@ -112,6 +140,7 @@ rfxcodec_encode_create_ex(int width, int height, int format, int flags,
     int bx;
     int cx;
     int dx;
+    int xcr0;
 
     enc = (struct rfxencode *) calloc(1, sizeof(struct rfxencode));
     if (enc == NULL)
@@ -119,18 +148,14 @@ rfxcodec_encode_create_ex(int width, int height, int format, int flags,
         return 1;
     }
 
-    enc->dwt_buffer = (sint16 *) (((size_t) (enc->dwt_buffer_a)) & ~15);
-    enc->dwt_buffer1 = (sint16 *) (((size_t) (enc->dwt_buffer1_a)) & ~15);
-    enc->dwt_buffer2 = (sint16 *) (((size_t) (enc->dwt_buffer2_a)) & ~15);
-    enc->dwt_buffer3 = (sint16 *) (((size_t) (enc->dwt_buffer3_a)) & ~15);
-    enc->dwt_buffer4 = (sint16 *) (((size_t) (enc->dwt_buffer4_a)) & ~15);
-    enc->dwt_buffer5 = (sint16 *) (((size_t) (enc->dwt_buffer5_a)) & ~15);
-    enc->dwt_buffer6 = (sint16 *) (((size_t) (enc->dwt_buffer6_a)) & ~15);
+    set_dwt_buffers(enc);
 
 #if defined(RFX_USE_ACCEL_X86)
     cpuid_x86(1, 0, &ax, &bx, &cx, &dx);
 #elif defined(RFX_USE_ACCEL_AMD64)
     cpuid_amd64(1, 0, &ax, &bx, &cx, &dx);
+#elif defined(RFX_USE_ACCEL_INTRIN)
+    cpuid_intrin(1, 0, &ax, &bx, &cx, &dx);
 #else
     ax = 0;
     bx = 0;
@@ -147,6 +172,11 @@ rfxcodec_encode_create_ex(int width, int height, int format, int flags,
         printf("rfxcodec_encode_create: got sse3\n");
         enc->got_sse3 = 1;
     }
+    if (cx & (1 << 9)) /* SSSE 3 */
+    {
+        printf("rfxcodec_encode_create: got ssse3\n");
+        enc->got_ssse3 = 1;
+    }
     if (cx & (1 << 19)) /* SSE 4.1 */
     {
         printf("rfxcodec_encode_create: got sse4.1\n");
@@ -162,10 +192,59 @@ rfxcodec_encode_create_ex(int width, int height, int format, int flags,
         printf("rfxcodec_encode_create: got popcnt\n");
         enc->got_popcnt = 1;
     }
+    /* ymm state must be enabled by the OS, XCR0 bits 1 and 2 */
+    xcr0 = 0;
+    if ((cx & (1 << 27)) && (cx & (1 << 28))) /* OSXSAVE and AVX */
+    {
+#if defined(RFX_USE_ACCEL_X86)
+        xgetbv_x86(0, &xcr0, &dx);
+#elif defined(RFX_USE_ACCEL_AMD64)
+        xgetbv_amd64(0, &xcr0, &dx);
+#elif defined(RFX_USE_ACCEL_INTRIN)
+        xgetbv_intrin(0, &xcr0, &dx);
+#endif
+        if ((xcr0 & 6) == 6)
+        {
+            printf("rfxcodec_encode_create: got avx\n");
+            enc->got_avx = 1;
+        }
+    }
+    if (enc->got_avx)
+    {
+#if defined(RFX_USE_ACCEL_X86)
+        cpuid_x86(7, 0, &ax, &bx, &cx, &dx);
+#elif defined(RFX_USE_ACCEL_AMD64)
+        cpuid_amd64(7, 0, &ax, &bx, &cx, &dx);
+#elif defined(RFX_USE_ACCEL_INTRIN)
+        cpuid_intrin(7, 0, &ax, &bx, &cx, &dx);
+#else
+        bx = 0;
+#endif
+        if (bx & (1 << 5)) /* AVX 2 */
+        {
+            printf("rfxcodec_encode_create: got avx2\n");
+            enc->got_avx2 = 1;
+        }
+        /* bmi2 is vex encoded, every cpu with it also has avx */
+        if (bx & (1 << 8)) /* BMI 2 */
+        {
+            printf("rfxcodec_encode_create: got bmi2\n");
+            enc->got_bmi2 = 1;
+        }
+        /* opmask and zmm state, XCR0 bits 5, 6 and 7 */
+        if (((xcr0 & 0xE0) == 0xE0) &&
+            (bx & (1 << 16)) && (bx & (1 << 30))) /* AVX-512 F and BW */
+        {
+            printf("rfxcodec_encode_create: got avx512bw\n");
+            enc->got_avx512bw = 1;
+        }
+    }
 #if defined(RFX_USE_ACCEL_X86)
     cpuid_x86(0x80000001, 0, &ax, &bx, &cx, &dx);
 #elif defined(RFX_USE_ACCEL_AMD64)
     cpuid_amd64(0x80000001, 0, &ax, &bx, &cx, &dx);
+#elif defined(RFX_USE_ACCEL_INTRIN)
+    cpuid_intrin(0x80000001, 0, &ax, &bx, &cx, &dx);
 #else
     ax = 0;
     bx = 0;
@@ -185,6 +264,7 @@ rfxcodec_encode_create_ex(int width, int height, int format, int flags,
 
     enc->width = width;
     enc->height = height;
+    enc->pool_weight = 1;
     enc->mode = RLGR3;
     if (flags & RFX_FLAGS_RLGR1)
     {
@@ -214,6 +294,166 @@ rfxcodec_encode_create_ex(int width, int height, int format, int flags,
     enc->format = format;
     enc->rfx_encode_rgb_to_yuv = rfx_encode_rgb_to_yuv;
     enc->rfx_encode_argb_to_yuva = rfx_encode_argb_to_yuva;
+    enc->rfx_encode_format_rgb = rfx_encode_format_rgb;
+    enc->rfx_encode_format_argb = rfx_encode_format_argb;
+    enc->rfx_encode_rgb_to_yuv_row = rfx_encode_rgb_to_yuv_row;
+    enc->rfx_encode_dwt_v1_rows = rfx_dwt_2d_encode_v1_rows;
+    enc->rfx_rem_dwt_shift_encode = rfx_rem_dwt_shift_encode;
+    enc->rfx_differential_pro_encode = rfx_differential_pro_encode;
+    enc->rfx_encode_nonzero_mask = rfx_encode_nonzero_mask;
+    enc->rfx_encode_alpha_delta = rfx_encode_alpha_delta;
+    enc->rfx_encode_diff_rlgr1 = rfx_encode_diff_rlgr1_ex;
+    enc->rfx_encode_diff_rlgr3 = rfx_encode_diff_rlgr3_ex;
+    if ((flags & RFX_FLAGS_NOACCEL) == 0)
+    {
+#if defined(RFX_USE_BMI2)
+        if (enc->got_lzcnt && enc->got_bmi2)
+        {
+            printf("rfxcodec_encode_create: rfx_encode_diff_rlgr1 set to rfx_encode_diff_rlgr1_bmi2\n");
+            enc->rfx_encode_diff_rlgr1 = rfx_encode_diff_rlgr1_bmi2;
+            printf("rfxcodec_encode_create: rfx_encode_diff_rlgr3 set to rfx_encode_diff_rlgr3_bmi2\n");
+            enc->rfx_encode_diff_rlgr3 = rfx_encode_diff_rlgr3_bmi2;
+        }
+#endif
+#if defined(RFX_USE_ACCEL_X86)
+        if (enc->got_sse2)
+        {
+            printf("rfxcodec_encode_create: rfx_encode_rgb_to_yuv set to rfx_encode_rgb_to_yuv_x86_sse2\n");
+            enc->rfx_encode_rgb_to_yuv = rfx_encode_rgb_to_yuv_x86_sse2;
+            enc->rfx_encode_argb_to_yuva = rfx_encode_argb_to_yuva_x86_sse2;
+        }
+#elif defined(RFX_USE_ACCEL_AMD64)
+        if (enc->got_avx2)
+        {
+            printf("rfxcodec_encode_create: rfx_encode_rgb_to_yuv set to rfx_encode_rgb_to_yuv_amd64_avx2\n");
+            enc->rfx_encode_rgb_to_yuv = rfx_encode_rgb_to_yuv_amd64_avx2;
+            enc->rfx_encode_argb_to_yuva = rfx_encode_argb_to_yuva_amd64_avx2;
+            enc->rfx_encode_rgb_to_yuv_row = rfx_encode_rgb_to_yuv_row_amd64_avx2;
+        }
+        else if (enc->got_ssse3)
+        {
+            printf("rfxcodec_encode_create: rfx_encode_rgb_to_yuv set to rfx_encode_rgb_to_yuv_amd64_ssse3\n");
+            enc->rfx_encode_rgb_to_yuv = rfx_encode_rgb_to_yuv_amd64_ssse3;
+            enc->rfx_encode_argb_to_yuva = rfx_encode_argb_to_yuva_amd64_ssse3;
+            enc->rfx_encode_rgb_to_yuv_row = rfx_encode_rgb_to_yuv_row_amd64_ssse3;
+        }
+        else if (enc->got_sse2)
+        {
+            printf("rfxcodec_encode_create: rfx_encode_rgb_to_yuv set to rfx_encode_rgb_to_yuv_amd64_sse2\n");
+            enc->rfx_encode_rgb_to_yuv = rfx_encode_rgb_to_yuv_amd64_sse2;
+            enc->rfx_encode_argb_to_yuva = rfx_encode_argb_to_yuva_amd64_sse2;
+        }
+        if (enc->got_avx2)
+        {
+            printf("rfxcodec_encode_create: rfx_encode_format_rgb set to rfx_encode_format_rgb_amd64_avx2\n");
+            enc->rfx_encode_format_rgb = rfx_encode_format_rgb_amd64_avx2;
+            enc->rfx_encode_format_argb = rfx_encode_format_argb_amd64_avx2;
+        }
+        else if (enc->got_ssse3)
+        {
+            printf("rfxcodec_encode_create: rfx_encode_format_rgb set to rfx_encode_format_rgb_amd64_ssse3\n");
+            enc->rfx_encode_format_rgb = rfx_encode_format_rgb_amd64_ssse3;
+            enc->rfx_encode_format_argb = rfx_encode_format_argb_amd64_ssse3;
+        }
+        if (enc->got_avx2)
+        {
+            printf("rfxcodec_encode_create: rfx_encode_dwt_v1_rows set to rfxcodec_encode_dwt_v1_rows_amd64_avx2\n");
+            enc->rfx_encode_dwt_v1_rows = rfxcodec_encode_dwt_v1_rows_amd64_avx2;
+        }
+        else if (enc->got_sse2)
+        {
+            printf("rfxcodec_encode_create: rfx_encode_dwt_v1_rows set to rfxcodec_encode_dwt_v1_rows_amd64_sse2\n");
+            enc->rfx_encode_dwt_v1_rows = rfxcodec_encode_dwt_v1_rows_amd64_sse2;
+        }
+        if (enc->got_avx2)
+        {
+            printf("rfxcodec_encode_create: rfx_rem_dwt_shift_encode set to rfxcodec_encode_dwt_shift_rem_amd64_avx2\n");
+            enc->rfx_rem_dwt_shift_encode = rfxcodec_encode_dwt_shift_rem_amd64_avx2;
+        }
+        else if (enc->got_sse41)
+        {
+            printf("rfxcodec_encode_create: rfx_rem_dwt_shift_encode set to rfxcodec_encode_dwt_shift_rem_amd64_sse41\n");
+            enc->rfx_rem_dwt_shift_encode = rfxcodec_encode_dwt_shift_rem_amd64_sse41;
+        }
+        if (enc->got_avx2)
+        {
+            printf("rfxcodec_encode_create: rfx_differential_pro_encode set to rfxcodec_encode_diff_count_amd64_avx2\n");
+            enc->rfx_differential_pro_encode = rfxcodec_encode_diff_count_amd64_avx2;
+        }
+        else if (enc->got_sse2)
+        {
+            printf("rfxcodec_encode_create: rfx_differential_pro_encode set to rfxcodec_encode_diff_count_amd64_sse2\n");
+            enc->rfx_differential_pro_encode = rfxcodec_encode_diff_count_amd64_sse2;
+        }
+#elif defined(RFX_USE_ACCEL_INTRIN)
+        if (enc->got_avx2)
+        {
+            printf("rfxcodec_encode_create: rfx_encode_rgb_to_yuv set to rfx_encode_rgb_to_yuv_intrin_avx2\n");
+            enc->rfx_encode_rgb_to_yuv = rfx_encode_rgb_to_yuv_intrin_avx2;
+            enc->rfx_encode_argb_to_yuva = rfx_encode_argb_to_yuva_intrin_avx2;
+            enc->rfx_encode_rgb_to_yuv_row = rfx_encode_rgb_to_yuv_row_intrin_avx2;
+        }
+        else if (enc->got_sse41)
+        {
+            printf("rfxcodec_encode_create: rfx_encode_rgb_to_yuv set to rfx_encode_rgb_to_yuv_intrin_sse41\n");
+            enc->rfx_encode_rgb_to_yuv = rfx_encode_rgb_to_yuv_intrin_sse41;
+            enc->rfx_encode_argb_to_yuva = rfx_encode_argb_to_yuva_intrin_sse41;
+            enc->rfx_encode_rgb_to_yuv_row = rfx_encode_rgb_to_yuv_row_intrin_sse41;
+        }
+        else if (enc->got_sse2)
+        {
+            printf("rfxcodec_encode_create: rfx_encode_rgb_to_yuv set to rfx_encode_rgb_to_yuv_intrin_sse2\n");
+            enc->rfx_encode_rgb_to_yuv = rfx_encode_rgb_to_yuv_intrin_sse2;
+            enc->rfx_encode_argb_to_yuva = rfx_encode_argb_to_yuva_intrin_sse2;
+            enc->rfx_encode_rgb_to_yuv_row = rfx_encode_rgb_to_yuv_row_intrin_sse2;
+        }
+        if (enc->got_avx2)
+        {
+            printf("rfxcodec_encode_create: rfx_encode_dwt_v1_rows set to rfxcodec_encode_dwt_v1_rows_intrin_avx2\n");
+            enc->rfx_encode_dwt_v1_rows = rfxcodec_encode_dwt_v1_rows_intrin_avx2;
+        }
+        else if (enc->got_sse41)
+        {
+            printf("rfxcodec_encode_create: rfx_encode_dwt_v1_rows set to rfxcodec_encode_dwt_v1_rows_intrin_sse41\n");
+            enc->rfx_encode_dwt_v1_rows = rfxcodec_encode_dwt_v1_rows_intrin_sse41;
+        }
+        else if (enc->got_sse2)
+        {
+            printf("rfxcodec_encode_create: rfx_encode_dwt_v1_rows set to rfxcodec_encode_dwt_v1_rows_intrin_sse2\n");
+            enc->rfx_encode_dwt_v1_rows = rfxcodec_encode_dwt_v1_rows_intrin_sse2;
+        }
+        if (enc->got_avx2)
+        {
+            printf("rfxcodec_encode_create: rfx_differential_pro_encode set to rfxcodec_encode_diff_count_intrin_avx2\n");
+            enc->rfx_differential_pro_encode = rfxcodec_encode_diff_count_intrin_avx2;
+        }
+        else if (enc->got_sse2)
+        {
+            printf("rfxcodec_encode_create: rfx_differential_pro_encode set to rfxcodec_encode_diff_count_intrin_sse2\n");
+            enc->rfx_differential_pro_encode = rfxcodec_encode_diff_count_intrin_sse2;
+        }
+        if (enc->got_avx2)
+        {
+            printf("rfxcodec_encode_create: rfx_encode_nonzero_mask set to rfxcodec_encode_nonzero_mask_intrin_avx2\n");
+            enc->rfx_encode_nonzero_mask = rfxcodec_encode_nonzero_mask_intrin_avx2;
+        }
+        else if (enc->got_sse2)
+        {
+            printf("rfxcodec_encode_create: rfx_encode_nonzero_mask set to rfxcodec_encode_nonzero_mask_intrin_sse2\n");
+            enc->rfx_encode_nonzero_mask = rfxcodec_encode_nonzero_mask_intrin_sse2;
+        }
+        if (enc->got_avx2)
+        {
+            printf("rfxcodec_encode_create: rfx_encode_alpha_delta set to rfxcodec_encode_alpha_delta_intrin_avx2\n");
+            enc->rfx_encode_alpha_delta = rfxcodec_encode_alpha_delta_intrin_avx2;
+        }
+        else if (enc->got_sse2)
+        {
+            printf("rfxcodec_encode_create: rfx_encode_alpha_delta set to rfxcodec_encode_alpha_delta_intrin_sse2\n");
+            enc->rfx_encode_alpha_delta = rfxcodec_encode_alpha_delta_intrin_sse2;
+        }
+#endif
+    }
     /* assign encoding functions */
     if (flags & RFX_FLAGS_PRO1)
     {
@@ -225,27 +465,38 @@ rfxcodec_encode_create_ex(int width, int height, int format, int flags,
         {
             printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr3\n");
             enc->rfx_encode = rfx_encode_component_rlgr3; /* rfxencode_tile.c */
+            enc->rfx_encode_dwt = rfx_encode_dwt_quant;
+            enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_quant;
+            enc->rfx_encode_entropy = rfx_encode_entropy_rlgr3;
         }
         else
         {
             printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr1\n");
             enc->rfx_encode = rfx_encode_component_rlgr1; /* rfxencode_tile.c */
+            enc->rfx_encode_dwt = rfx_encode_dwt_quant;
+            enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_quant;
+            enc->rfx_encode_entropy = rfx_encode_entropy_rlgr1;
         }
     }
     else
     {
 #if defined(RFX_USE_ACCEL_X86)
+        /* no rfx_encode_dwt_h1, x86 takes the plane route */
         if (enc->got_sse41)
         {
             if (enc->mode == RLGR3)
             {
                 printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr3_x86_sse41\n");
                 enc->rfx_encode = rfx_encode_component_rlgr3_x86_sse41; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_shift_x86_sse41;
+                enc->rfx_encode_entropy = rfx_encode_entropy_diff_rlgr3;
             }
             else
             {
                 printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr1_x86_sse41\n");
                 enc->rfx_encode = rfx_encode_component_rlgr1_x86_sse41; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_shift_x86_sse41;
+                enc->rfx_encode_entropy = rfx_encode_entropy_diff_rlgr1;
             }
         }
         else if (enc->got_sse2)
@@ -254,11 +505,15 @@ rfxcodec_encode_create_ex(int width, int height, int format, int flags,
             {
                 printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr3_x86_sse2\n");
                 enc->rfx_encode = rfx_encode_component_rlgr3_x86_sse2; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_shift_x86_sse2;
+                enc->rfx_encode_entropy = rfx_encode_entropy_diff_rlgr3;
             }
             else
             {
                 printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr1_x86_sse2\n");
                 enc->rfx_encode = rfx_encode_component_rlgr1_x86_sse2; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_shift_x86_sse2;
+                enc->rfx_encode_entropy = rfx_encode_entropy_diff_rlgr1;
             }
         }
         else
@@ -267,25 +522,75 @@ rfxcodec_encode_create_ex(int width, int height, int format, int flags,
             {
                 printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr3\n");
                 enc->rfx_encode = rfx_encode_component_rlgr3; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_quant;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_quant;
+                enc->rfx_encode_entropy = rfx_encode_entropy_rlgr3;
             }
             else
             {
                 printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr1\n");
                 enc->rfx_encode = rfx_encode_component_rlgr1; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_quant;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_quant;
+                enc->rfx_encode_entropy = rfx_encode_entropy_rlgr1;
             }
         }
 #elif defined(RFX_USE_ACCEL_AMD64)
-        if (enc->got_sse41)
+        if (enc->got_avx512bw)
+        {
+            if (enc->mode == RLGR3)
+            {
+                printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr3_amd64_avx512\n");
+                enc->rfx_encode = rfx_encode_component_rlgr3_amd64_avx512; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_shift_amd64_avx512;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_shift_amd64_avx512;
+                enc->rfx_encode_entropy = rfx_encode_entropy_diff_rlgr3;
+            }
+            else
+            {
+                printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr1_amd64_avx512\n");
+                enc->rfx_encode = rfx_encode_component_rlgr1_amd64_avx512; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_shift_amd64_avx512;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_shift_amd64_avx512;
+                enc->rfx_encode_entropy = rfx_encode_entropy_diff_rlgr1;
+            }
+        }
+        else if (enc->got_avx2)
+        {
+            if (enc->mode == RLGR3)
+            {
+                printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr3_amd64_avx2\n");
+                enc->rfx_encode = rfx_encode_component_rlgr3_amd64_avx2; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_shift_amd64_avx2;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_shift_amd64_avx2;
+                enc->rfx_encode_entropy = rfx_encode_entropy_diff_rlgr3;
+            }
+            else
+            {
+                printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr1_amd64_avx2\n");
+                enc->rfx_encode = rfx_encode_component_rlgr1_amd64_avx2; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_shift_amd64_avx2;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_shift_amd64_avx2;
+                enc->rfx_encode_entropy = rfx_encode_entropy_diff_rlgr1;
+            }
+        }
+        else if (enc->got_sse41)
         {
             if (enc->mode == RLGR3)
             {
                 printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr3_amd64_sse41\n");
                 enc->rfx_encode = rfx_encode_component_rlgr3_amd64_sse41; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_shift_amd64_sse41;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_shift_amd64_sse41;
+                enc->rfx_encode_entropy = rfx_encode_entropy_diff_rlgr3;
             }
             else
             {
                 printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr1_amd64_sse41\n");
                 enc->rfx_encode = rfx_encode_component_rlgr1_amd64_sse41; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_shift_amd64_sse41;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_shift_amd64_sse41;
+                enc->rfx_encode_entropy = rfx_encode_entropy_diff_rlgr1;
             }
         }
         else if (enc->got_sse2)
@@ -294,11 +599,94 @@ rfxcodec_encode_create_ex(int width, int height, int format, int flags,
             {
                 printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr3_amd64_sse2\n");
                 enc->rfx_encode = rfx_encode_component_rlgr3_amd64_sse2; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_shift_amd64_sse2;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_shift_amd64_sse2;
+                enc->rfx_encode_entropy = rfx_encode_entropy_diff_rlgr3;
             }
             else
             {
                 printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr1_amd64_sse2\n");
                 enc->rfx_encode = rfx_encode_component_rlgr1_amd64_sse2; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_shift_amd64_sse2;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_shift_amd64_sse2;
+                enc->rfx_encode_entropy = rfx_encode_entropy_diff_rlgr1;
+            }
+        }
+        else
+        {
+            if (enc->mode == RLGR3)
+            {
+                printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr3\n");
+                enc->rfx_encode = rfx_encode_component_rlgr3; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_quant;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_quant;
+                enc->rfx_encode_entropy = rfx_encode_entropy_rlgr3;
+            }
+            else
+            {
+                printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr1\n");
+                enc->rfx_encode = rfx_encode_component_rlgr1; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_quant;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_quant;
+                enc->rfx_encode_entropy = rfx_encode_entropy_rlgr1;
+            }
+        }
+#elif defined(RFX_USE_ACCEL_INTRIN)
+        if (enc->got_avx2)
+        {
+            if (enc->mode == RLGR3)
+            {
+                printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr3_intrin_avx2\n");
+                enc->rfx_encode = rfx_encode_component_rlgr3_intrin_avx2; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_shift_intrin_avx2;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_shift_intrin_avx2;
+                enc->rfx_encode_entropy = rfx_encode_entropy_diff_rlgr3;
+            }
+            else
+            {
+                printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr1_intrin_avx2\n");
+                enc->rfx_encode = rfx_encode_component_rlgr1_intrin_avx2; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_shift_intrin_avx2;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_shift_intrin_avx2;
+                enc->rfx_encode_entropy = rfx_encode_entropy_diff_rlgr1;
+            }
+        }
+        else if (enc->got_sse41)
+        {
+            if (enc->mode == RLGR3)
+            {
+                printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr3_intrin_sse41\n");
+                enc->rfx_encode = rfx_encode_component_rlgr3_intrin_sse41; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_shift_intrin_sse41;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_shift_intrin_sse41;
+                enc->rfx_encode_entropy = rfx_encode_entropy_diff_rlgr3;
+            }
+            else
+            {
+                printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr1_intrin_sse41\n");
+                enc->rfx_encode = rfx_encode_component_rlgr1_intrin_sse41; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_shift_intrin_sse41;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_shift_intrin_sse41;
+                enc->rfx_encode_entropy = rfx_encode_entropy_diff_rlgr1;
+            }
+        }
+        else if (enc->got_sse2)
+        {
+            if (enc->mode == RLGR3)
+            {
+                printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr3_intrin_sse2\n");
+                enc->rfx_encode = rfx_encode_component_rlgr3_intrin_sse2; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_shift_intrin_sse2;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_shift_intrin_sse2;
+                enc->rfx_encode_entropy = rfx_encode_entropy_diff_rlgr3;
+            }
+            else
+            {
+                printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr1_intrin_sse2\n");
+                enc->rfx_encode = rfx_encode_component_rlgr1_intrin_sse2; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_shift_intrin_sse2;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_shift_intrin_sse2;
+                enc->rfx_encode_entropy = rfx_encode_entropy_diff_rlgr1;
             }
         }
         else
@@ -307,11 +695,17 @@ rfxcodec_encode_create_ex(int width, int height, int format, int flags,
             {
                 printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr3\n");
                 enc->rfx_encode = rfx_encode_component_rlgr3; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_quant;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_quant;
+                enc->rfx_encode_entropy = rfx_encode_entropy_rlgr3;
             }
             else
             {
                 printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr1\n");
                 enc->rfx_encode = rfx_encode_component_rlgr1; /* rfxencode_tile.c */
+                enc->rfx_encode_dwt = rfx_encode_dwt_quant;
+                enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_quant;
+                enc->rfx_encode_entropy = rfx_encode_entropy_rlgr1;
             }
         }
 #else
@@ -319,11 +713,17 @@ rfxcodec_encode_create_ex(int width, int height, int format, int flags,
         {
             printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr3\n");
             enc->rfx_encode = rfx_encode_component_rlgr3; /* rfxencode_tile.c */
+            enc->rfx_encode_dwt = rfx_encode_dwt_quant;
+            enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_quant;
+            enc->rfx_encode_entropy = rfx_encode_entropy_rlgr3;
         }
         else
         {
             printf("rfxcodec_encode_create: rfx_encode set to rfx_encode_component_rlgr1\n");
             enc->rfx_encode = rfx_encode_component_rlgr1; /* rfxencode_tile.c */
+            enc->rfx_encode_dwt = rfx_encode_dwt_quant;
+            enc->rfx_encode_dwt_h1 = rfx_encode_dwt_h1_quant;
+            enc->rfx_encode_entropy = rfx_encode_entropy_rlgr1;
         }
 #endif
     }
@@ -352,6 +752,39 @@ rfxcodec_encode_create(int width, int height, int format, int flags)
     return 0;
 }
 
+/******************************************************************************/
+/* detach from the current pool, destroying it if owned, and attach to
+   pool with a new session */
+static int
+rfxencode_attach_pool(struct rfxencode *enc, struct rfx_pool *pool,
+                      int owned)
+{
+    rfx_pool_session_destroy(enc->pool_session);
+    enc->pool_session = NULL;
+    if (enc->pool_owned)
+    {
+        rfx_pool_destroy(enc->pool);
+    }
+    enc->pool = NULL;
+    enc->pool_owned = 0;
+    if (pool == NULL)
+    {
+        return 0;
+    }
+    if (rfx_pool_session_create(pool, enc->pool_weight, enc->pool_latency_ms,
+                                &(enc->pool_session)) != 0)
+    {
+        if (owned)
+        {
+            rfx_pool_destroy(pool);
+        }
+        return 1;
+    }
+    enc->pool = pool;
+    enc->pool_owned = owned;
+    return 0;
+}
+
 /******************************************************************************/
 int
 rfxcodec_encode_destroy(void *handle)
@@ -363,11 +796,308 @@ rfxcodec_encode_destroy(void *handle)
     {
         return 0;
     }
+    rfx_async_destroy(enc->async);
     clear_encoder_rbs(enc);
+    rfxencode_attach_pool(enc, NULL, 0);
+    rfx_pipe_destroy(enc->pipe);
+    rfx_compose_free_slots(enc);
+    free(enc->order_tiles);
+    free(enc->order_keys);
     free(enc);
     return 0;
 }
 
+/******************************************************************************/
+int
+rfxcodec_encode_set_threads(void *handle, int num_threads)
+{
+    struct rfxencode *enc;
+
+    struct rfx_pool *pool;
+
+    enc = (struct rfxencode *) handle;
+    rfxencode_attach_pool(enc, NULL, 0);
+    /* more threads than cpus only adds switching, as for
+       rfxcodec_encode_pool_create */
+    num_threads = MIN(num_threads, rfx_pool_get_num_cpus());
+    if (num_threads < 2)
+    {
+        return 0;
+    }
+    if (rfx_pool_create(num_threads, &pool) != 0)
+    {
+        return 1;
+    }
+    return rfxencode_attach_pool(enc, pool, 1);
+}
+
+/******************************************************************************/
+int
+rfxcodec_encode_pool_create(int num_threads, void **pool)
+{
+    struct rfx_pool *self;
+
+    if (num_threads > rfx_pool_get_num_cpus())
+    {
+        num_threads = 0;
+    }
+    if (rfx_pool_create(num_threads, &self) != 0)
+    {
+        return 1;
+    }
+    *pool = self;
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfxcodec_encode_pool_destroy(void *pool)
+{
+    return rfx_pool_destroy((struct rfx_pool *) pool);
+}
+
+/******************************************************************************/
+int
+rfxcodec_encode_set_pool(void *handle, void *pool)
+{
+    struct rfxencode *enc;
+
+    enc = (struct rfxencode *) handle;
+    return rfxencode_attach_pool(enc, (struct rfx_pool *) pool, 0);
+}
+
+/******************************************************************************/
+int
+rfxcodec_encode_set_share(void *handle, int weight, int latency_ms)
+{
+    struct rfxencode *enc;
+
+    enc = (struct rfxencode *) handle;
+    enc->pool_weight = weight;
+    enc->pool_latency_ms = latency_ms;
+    if (enc->pool_session != NULL)
+    {
+        return rfx_pool_session_set_share(enc->pool_session,
+                                          weight, latency_ms);
+    }
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfxcodec_encode_get_stats(void *handle, struct rfxcodec_encode_stats *stats)
+{
+    struct rfxencode *enc;
+
+    enc = (struct rfxencode *) handle;
+    memset(stats, 0, sizeof(struct rfxcodec_encode_stats));
+    if (enc->pool_session != NULL)
+    {
+        return rfx_pool_session_get_stats(enc->pool_session,
+                                          &(stats->queue_depth),
+                                          &(stats->tiles_done),
+                                          &(stats->wait_us_avg),
+                                          &(stats->wait_us_max));
+    }
+    return 0;
+}
+
+/******************************************************************************/
+static int
+rfxencode_get_async(struct rfxencode *enc)
+{
+    if (enc->async == NULL)
+    {
+        if (rfx_async_create(enc, &(enc->async)) != 0)
+        {
+            enc->async = NULL;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfxcodec_encode_submit(void *handle, char *cdata, int cdata_bytes,
+                       const char *buf, int width, int height,
+                       int stride_bytes,
+                       const struct rfx_rect *region, int num_region,
+                       const struct rfx_tile *tiles, int num_tiles,
+                       const char *quants, int num_quants, int flags,
+                       rfxcodec_encode_done_proc done, void *user)
+{
+    struct rfxencode *enc;
+    struct rfx_async_call call;
+
+    enc = (struct rfxencode *) handle;
+    if (rfxencode_get_async(enc) != 0)
+    {
+        return 1;
+    }
+    memset(&call, 0, sizeof(call));
+    call.cdata = cdata;
+    call.cdata_bytes = cdata_bytes;
+    call.buf = buf;
+    call.width = width;
+    call.height = height;
+    call.stride_bytes = stride_bytes;
+    call.regions = region;
+    call.num_regions = num_region;
+    call.tiles = tiles;
+    call.num_tiles = num_tiles;
+    call.quants = quants;
+    call.num_quants = num_quants;
+    call.flags = flags;
+    call.done = done;
+    call.user = user;
+    return rfx_async_submit(enc->async, &call);
+}
+
+/******************************************************************************/
+int
+rfxcodec_encode_get_fd(void *handle)
+{
+    struct rfxencode *enc;
+
+    enc = (struct rfxencode *) handle;
+    if (rfxencode_get_async(enc) != 0)
+    {
+        return -1;
+    }
+    return rfx_async_get_fd(enc->async);
+}
+
+/******************************************************************************/
+int
+rfxcodec_encode_get_result(void *handle, void **user, int *tiles_written,
+                           int *cdata_bytes)
+{
+    struct rfxencode *enc;
+
+    enc = (struct rfxencode *) handle;
+    if (enc->async == NULL)
+    {
+        return 1;
+    }
+    return rfx_async_get_result(enc->async, user, tiles_written,
+                                cdata_bytes);
+}
+
+/******************************************************************************/
+int
+rfxcodec_encode_set_pipeline(void *handle, int pipeline)
+{
+    struct rfxencode *enc;
+
+    enc = (struct rfxencode *) handle;
+    rfx_pipe_destroy(enc->pipe);
+    enc->pipe = NULL;
+    if (!pipeline)
+    {
+        return 0;
+    }
+    if (rfx_pipe_create(&(enc->pipe)) != 0)
+    {
+        enc->pipe = NULL;
+        return 1;
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/* worker context, only the scratch buffers get used */
+int
+rfxencode_scratch_create(struct rfxencode **scratch)
+{
+    struct rfxencode *enc;
+
+    enc = (struct rfxencode *) calloc(1, sizeof(struct rfxencode));
+    if (enc == NULL)
+    {
+        return 1;
+    }
+    set_dwt_buffers(enc);
+    *scratch = enc;
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfxencode_scratch_destroy(struct rfxencode *scratch)
+{
+    if (scratch == NULL)
+    {
+        return 0;
+    }
+    free(scratch->tile_stage);
+    free(scratch);
+    return 0;
+}
+
+/******************************************************************************/
+/* copy what selects the encoding functions from the handle */
+int
+rfxencode_scratch_setup(struct rfxencode *scratch,
+                        const struct rfxencode *enc)
+{
+    scratch->width = enc->width;
+    scratch->height = enc->height;
+    scratch->mode = enc->mode;
+    scratch->properties = enc->properties;
+    scratch->flags = enc->flags;
+    scratch->bits_per_pixel = enc->bits_per_pixel;
+    scratch->format = enc->format;
+    scratch->pro_ver = enc->pro_ver;
+    scratch->rfx_encode = enc->rfx_encode;
+    scratch->rfx_encode_rgb_to_yuv = enc->rfx_encode_rgb_to_yuv;
+    scratch->rfx_encode_argb_to_yuva = enc->rfx_encode_argb_to_yuva;
+    scratch->rfx_encode_format_rgb = enc->rfx_encode_format_rgb;
+    scratch->rfx_encode_format_argb = enc->rfx_encode_format_argb;
+    scratch->rfx_encode_rgb_to_yuv_row = enc->rfx_encode_rgb_to_yuv_row;
+    scratch->rfx_encode_dwt_v1_rows = enc->rfx_encode_dwt_v1_rows;
+    scratch->rfx_rem_encode = enc->rfx_rem_encode;
+    scratch->rfx_rem_dwt_shift_encode = enc->rfx_rem_dwt_shift_encode;
+    scratch->rfx_differential_pro_encode = enc->rfx_differential_pro_encode;
+    scratch->rfx_encode_nonzero_mask = enc->rfx_encode_nonzero_mask;
+    scratch->rfx_encode_alpha_delta = enc->rfx_encode_alpha_delta;
+    scratch->rfx_encode_diff_rlgr1 = enc->rfx_encode_diff_rlgr1;
+    scratch->rfx_encode_diff_rlgr3 = enc->rfx_encode_diff_rlgr3;
+    scratch->rfx_encode_dwt = enc->rfx_encode_dwt;
+    scratch->rfx_encode_dwt_h1 = enc->rfx_encode_dwt_h1;
+    scratch->rfx_encode_entropy = enc->rfx_encode_entropy;
+    scratch->got_sse2 = enc->got_sse2;
+    scratch->got_sse3 = enc->got_sse3;
+    scratch->got_ssse3 = enc->got_ssse3;
+    scratch->got_sse41 = enc->got_sse41;
+    scratch->got_sse42 = enc->got_sse42;
+    scratch->got_sse4a = enc->got_sse4a;
+    scratch->got_avx = enc->got_avx;
+    scratch->got_avx2 = enc->got_avx2;
+    scratch->got_avx512bw = enc->got_avx512bw;
+    scratch->got_popcnt = enc->got_popcnt;
+    scratch->got_lzcnt = enc->got_lzcnt;
+    scratch->got_bmi2 = enc->got_bmi2;
+    scratch->got_neon = enc->got_neon;
+    if ((enc->format == RFX_FORMAT_BGR) || (enc->format == RFX_FORMAT_RGB))
+    {
+        /* nothing writes the alpha plane for these, it stays as the
+           handle has it so it is only copied when the scratch last ran
+           a job of another handle */
+        if (scratch->a_buffer_from != enc)
+        {
+            memcpy(scratch->a_buffer, enc->a_buffer, sizeof(enc->a_buffer));
+            scratch->a_buffer_from = enc;
+        }
+    }
+    else
+    {
+        /* jobs of this handle write the alpha plane */
+        scratch->a_buffer_from = NULL;
+    }
+    return 0;
+}
+
 /******************************************************************************/
 int
 rfxcodec_encode_ex(void *handle, char *cdata, int *cdata_bytes,
@@ -428,6 +1158,101 @@ rfxcodec_encode_ex(void *handle, char *cdata, int *cdata_bytes,
     return tiles_written;
 }
 
+/******************************************************************************/
+static int
+rfxencode_order_compare(const void *a, const void *b)
+{
+    const struct rfx_tile_order *order_a;
+    const struct rfx_tile_order *order_b;
+
+    order_a = (const struct rfx_tile_order *) a;
+    order_b = (const struct rfx_tile_order *) b;
+    if (order_a->priority != order_b->priority)
+    {
+        return (order_a->priority > order_b->priority) ? -1 : 1;
+    }
+    return order_a->index - order_b->index;
+}
+
+/******************************************************************************/
+int
+rfxcodec_encode_deadline(void *handle, char *cdata, int *cdata_bytes,
+                         const char *buf, int width, int height,
+                         int stride_bytes,
+                         const struct rfx_rect *regions, int num_regions,
+                         const struct rfx_tile *tiles, int num_tiles,
+                         const char *quants, int num_quants, int flags,
+                         const int *priorities, int deadline_us,
+                         int *order)
+{
+    struct rfxencode *enc;
+    struct rfx_tile *order_tiles;
+    struct rfx_tile_order *order_keys;
+    int tiles_written;
+    int index;
+
+    enc = (struct rfxencode *) handle;
+    if ((priorities != NULL) && (num_tiles > 1))
+    {
+        if (num_tiles > enc->num_order_tiles)
+        {
+            order_tiles = (struct rfx_tile *)
+                          malloc(num_tiles * sizeof(struct rfx_tile));
+            order_keys = (struct rfx_tile_order *)
+                         malloc(num_tiles * sizeof(struct rfx_tile_order));
+            if ((order_tiles == NULL) || (order_keys == NULL))
+            {
+                free(order_tiles);
+                free(order_keys);
+                return -1;
+            }
+            free(enc->order_tiles);
+            free(enc->order_keys);
+            enc->order_tiles = order_tiles;
+            enc->order_keys = order_keys;
+            enc->num_order_tiles = num_tiles;
+        }
+        for (index = 0; index < num_tiles; index++)
+        {
+            enc->order_keys[index].priority = priorities[index];
+            enc->order_keys[index].index = index;
+        }
+        qsort(enc->order_keys, num_tiles, sizeof(struct rfx_tile_order),
+              rfxencode_order_compare);
+        for (index = 0; index < num_tiles; index++)
+        {
+            enc->order_tiles[index] = tiles[enc->order_keys[index].index];
+        }
+        tiles = enc->order_tiles;
+    }
+    if (deadline_us > 0)
+    {
+        enc->deadline_set = 1;
+        enc->deadline_us = rfx_pool_get_us() + (uint32) deadline_us;
+    }
+    tiles_written = rfxcodec_encode_ex(handle, cdata, cdata_bytes, buf,
+                                       width, height, stride_bytes,
+                                       regions, num_regions,
+                                       tiles, num_tiles,
+                                       quants, num_quants, flags);
+    enc->deadline_set = 0;
+    if (order != NULL)
+    {
+        for (index = 0; index < num_tiles; index++)
+        {
+            if (tiles == enc->order_tiles)
+            {
+                order[index] = enc->order_keys[index].index;
+            }
+            else
+            {
+                order[index] = index;
+            }
+        }
+    }
+    return tiles_written;
+}
+
 /******************************************************************************/
 int
 rfxcodec_encode(void *handle, char *cdata, int *cdata_bytes,
@@ -446,6 +1271,7 @@ int
 rfxcodec_encode_get_internals(struct rfxcodec_encode_internals *internals)
 {
     memset(internals, 0, sizeof(struct rfxcodec_encode_internals));
+    /* the encoder itself uses rfx_encode_diff_rlgr1/3 */
     internals->rfxencode_rlgr1 = rfx_rlgr1_encode;
     internals->rfxencode_rlgr3 = rfx_rlgr3_encode;
     internals->rfxencode_differential = rfx_differential_encode;
@@ -453,6 +1279,8 @@ rfxcodec_encode_get_internals(struct rfxcodec_encode_internals *internals)
     internals->rfxencode_dwt_2d = rfx_dwt_2d_encode;
     internals->rfxencode_diff_rlgr1 = rfx_encode_diff_rlgr1;
     internals->rfxencode_diff_rlgr3 = rfx_encode_diff_rlgr3;
+    internals->rfxencode_rem_dwt_shift = rfx_rem_dwt_shift_encode;
+    internals->rfxencode_differential_pro = rfx_differential_pro_encode;
 #if defined(RFX_USE_ACCEL_X86)
     internals->rfxencode_dwt_shift_x86_sse2 = rfxcodec_encode_dwt_shift_x86_sse2;
     internals->rfxencode_dwt_shift_x86_sse41 = rfxcodec_encode_dwt_shift_x86_sse41;
@@ -460,6 +1288,20 @@ rfxcodec_encode_get_internals(struct rfxcodec_encode_internals *internals)
 #if defined(RFX_USE_ACCEL_AMD64)
     internals->rfxencode_dwt_shift_amd64_sse2 = rfxcodec_encode_dwt_shift_amd64_sse2;
     internals->rfxencode_dwt_shift_amd64_sse41 = rfxcodec_encode_dwt_shift_amd64_sse41;
+    internals->rfxencode_dwt_shift_amd64_avx2 = rfxcodec_encode_dwt_shift_amd64_avx2;
+    internals->rfxencode_dwt_shift_amd64_avx512 = rfxcodec_encode_dwt_shift_amd64_avx512;
+    internals->rfxencode_rem_dwt_shift_amd64_sse41 = rfxcodec_encode_dwt_shift_rem_amd64_sse41;
+    internals->rfxencode_rem_dwt_shift_amd64_avx2 = rfxcodec_encode_dwt_shift_rem_amd64_avx2;
+    internals->rfxencode_differential_pro_amd64_sse2 = rfxcodec_encode_diff_count_amd64_sse2;
+    internals->rfxencode_differential_pro_amd64_avx2 = rfxcodec_encode_diff_count_amd64_avx2;
+#endif
+#if defined(RFX_USE_ACCEL_INTRIN)
+    internals->rfxencode_dwt_shift_intrin_sse2 = rfxcodec_encode_dwt_shift_intrin_sse2;
+    internals->rfxencode_dwt_shift_intrin_sse41 = rfxcodec_encode_dwt_shift_intrin_sse41;
+    internals->rfxencode_dwt_shift_intrin_avx2 = rfxcodec_encode_dwt_shift_intrin_avx2;
+    internals->rfxencode_differential_pro_intrin_sse2 = rfxcodec_encode_diff_count_intrin_sse2;
+    internals->rfxencode_differential_pro_intrin_sse41 = rfxcodec_encode_diff_count_intrin_sse41;
+    internals->rfxencode_differential_pro_intrin_avx2 = rfxcodec_encode_diff_count_intrin_avx2;
 #endif
     return 0;
 }
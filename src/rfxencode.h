@@ -29,9 +29,65 @@ typedef int (*rfx_encode_argb_to_yuva_proc)(struct rfxencode *enc,
                                             const char *argb_data,
                                             int width, int height,
                                        int stride_bytes);
+/* split packed pixels into 64 x 64 planes, see rfx_encode_format_rgb */
+typedef int (*rfx_encode_format_rgb_proc)(const char *rgb_data,
+                                          int width, int height,
+                                          int stride_bytes, int pixel_format,
+                                          uint8 *r_buf, uint8 *g_buf,
+                                          uint8 *b_buf);
+typedef int (*rfx_encode_format_argb_proc)(const char *argb_data,
+                                           int width, int height,
+                                           int stride_bytes, int pixel_format,
+                                           uint8 *a_buf, uint8 *r_buf,
+                                           uint8 *g_buf, uint8 *b_buf);
+/* one row of rfx_encode_rgb_to_yuv, padded to 64 */
+typedef int (*rfx_encode_rgb_to_yuv_row_proc)(const char *rgb_row, int width,
+                                              int pixel_format, uint8 *a_row,
+                                              uint8 *y_row, uint8 *u_row,
+                                              uint8 *v_row);
+/* rfx_dwt_2d_encode_v1_rows */
+typedef int (*rfx_encode_dwt_v1_rows_proc)(const uint8 *s0, const uint8 *s1,
+                                           const uint8 *s2, int n,
+                                           sint16 *y_v1, sint16 *u_v1,
+                                           sint16 *v_v1);
+/* rfx_rem_dwt_shift_encode, progressive */
+typedef int (*rfx_rem_dwt_shift_encode_proc)(const uint8 *in_buffer,
+                                             sint16 *out_buffer,
+                                             sint16 *tmp_buffer,
+                                             const char *quants);
+/* rfx_differential_pro_encode */
+typedef int (*rfx_differential_pro_encode_proc)(const sint16 *coefs,
+                                                const sint16 *history,
+                                                sint16 *diff,
+                                                sint16 *history_out,
+                                                int *diff_zeros,
+                                                int *coef_zeros);
+/* rfx_encode_nonzero_mask, 4096 coefficients to 128 mask words */
+typedef int (*rfx_encode_nonzero_mask_proc)(const sint16 *coefs,
+                                            uint32 *mask);
+/* rfx_encode_alpha_delta, 64 x 64 alpha plane to its delta plane and 128
+   mask words of delta bytes equal to the next one */
+typedef int (*rfx_encode_alpha_delta_proc)(const uint8 *plane, uint8 *delta,
+                                           uint32 *mask);
+/* rfx_encode_diff_rlgr1_ex, rfx_encode_diff_rlgr3_ex */
+typedef int (*rfx_encode_diff_rlgr_proc)(sint16 *coef, uint8 *cdata,
+                                         int cdata_size, int diff_bytes,
+                                         rfx_encode_nonzero_mask_proc nonzero_mask);
 typedef int (*rfx_encode_proc)(struct rfxencode *enc, const char *qtable,
                                const uint8 *data,
                                uint8 *buffer, int buffer_size, int *size);
+/* rfx_encode split in two for the pipeline, DWT and quantisation into
+   coefs then entropy coding of coefs */
+typedef int (*rfx_encode_dwt_proc)(struct rfxencode *enc, const char *qtable,
+                                   const uint8 *data, sint16 *coefs);
+/* rfx_encode_dwt_proc after the level 1 vertical pass, see
+   rfx_dwt_2d_encode_h1 */
+typedef int (*rfx_encode_dwt_h1_proc)(struct rfxencode *enc,
+                                      const char *qtable,
+                                      sint16 *v1_buffer, sint16 *coefs);
+typedef int (*rfx_encode_entropy_proc)(struct rfxencode *enc, sint16 *coefs,
+                                       uint8 *buffer, int buffer_size,
+                                       int *size);
 
 struct rfx_rb
 {
@@ -44,6 +100,13 @@ struct rfx_rb
 #define RFX_MAX_RB_X 64
 #define RFX_MAX_RB_Y 64
 
+struct rfx_pool;
+struct rfx_pool_session;
+struct rfx_pipe;
+struct rfx_async;
+struct rfx_tile_order;
+struct rfx_tile_slot;
+
 struct rfxencode
 {
     int width;
@@ -81,20 +144,67 @@ struct rfxencode
     rfx_encode_proc rfx_encode;
     rfx_encode_rgb_to_yuv_proc rfx_encode_rgb_to_yuv;
     rfx_encode_argb_to_yuva_proc rfx_encode_argb_to_yuva;
+    rfx_encode_format_rgb_proc rfx_encode_format_rgb;
+    rfx_encode_format_argb_proc rfx_encode_format_argb;
+    rfx_encode_rgb_to_yuv_row_proc rfx_encode_rgb_to_yuv_row;
+    rfx_encode_dwt_v1_rows_proc rfx_encode_dwt_v1_rows;
     rfx_encode_proc rfx_rem_encode;
+    rfx_rem_dwt_shift_encode_proc rfx_rem_dwt_shift_encode;
+    rfx_differential_pro_encode_proc rfx_differential_pro_encode;
+    rfx_encode_nonzero_mask_proc rfx_encode_nonzero_mask;
+    rfx_encode_alpha_delta_proc rfx_encode_alpha_delta;
+    rfx_encode_diff_rlgr_proc rfx_encode_diff_rlgr1;
+    rfx_encode_diff_rlgr_proc rfx_encode_diff_rlgr3;
+    rfx_encode_dwt_proc rfx_encode_dwt;
+    rfx_encode_dwt_h1_proc rfx_encode_dwt_h1;
+    rfx_encode_entropy_proc rfx_encode_entropy;
 
     struct rfx_rb * rbs[RFX_MAX_RB_X][RFX_MAX_RB_Y];
 
     int got_sse2;
     int got_sse3;
+    int got_ssse3;
     int got_sse41;
     int got_sse42;
     int got_sse4a;
+    int got_avx;
+    int got_avx2;
+    int got_avx512bw;
     int got_popcnt;
     int got_lzcnt;
+    int got_bmi2;
     int got_neon;
+
+    /* tile parallel encoding, see rfxcodec_encode_set_threads and
+       rfxcodec_encode_set_pool */
+    struct rfx_pool *pool;
+    int pool_owned;
+    struct rfx_pool_session *pool_session;
+    int pool_weight; /* see rfxcodec_encode_set_share */
+    int pool_latency_ms;
+    struct rfx_pipe *pipe; /* see rfxcodec_encode_set_pipeline */
+    struct rfx_async *async; /* see rfxcodec_encode_submit */
+    int deadline_set; /* see rfxcodec_encode_deadline */
+    uint32 deadline_us;
+    struct rfx_tile *order_tiles;
+    struct rfx_tile_order *order_keys;
+    int num_order_tiles;
+    struct rfx_tile_slot *tile_slots;
+    void **tile_slot_args;
+    int *tile_slot_nodes; /* numa node of each tile's source */
+    int num_tile_slots;
+    uint8 *tile_stage; /* worker staging buffer, RFX_TILE_STAGE_BYTES */
+    /* scratch only, handle whose untouched a_buffer this one holds */
+    const struct rfxencode *a_buffer_from;
 };
 
+int
+rfxencode_scratch_create(struct rfxencode **scratch);
+int
+rfxencode_scratch_destroy(struct rfxencode *scratch);
+int
+rfxencode_scratch_setup(struct rfxencode *scratch,
+                        const struct rfxencode *enc);
 void
 rfxcodec_hexdump(const void *p, int len);
 
@@ -37,7 +37,6 @@
 #define LLOGLN(_level, _args) \
     do { if (_level < LLOG_LEVEL) { printf _args ; printf("\n"); } } while (0)
 
-#if 1
 /*****************************************************************************/
 static int
 fdelta(const char *in_plane, char *out_plane, int cx, int cy)
@@ -71,51 +70,68 @@ fdelta(const char *in_plane, char *out_plane, int cx, int cy)
     }
     return 0;
 }
-#endif
 
-#if 0
 /*****************************************************************************/
-#define DELTA_ONE \
-do { \
-    delta = src8[cx] - src8[0]; \
-    is_neg = (delta >> 7) & 1; \
-    dst8[cx] = (((delta ^ -is_neg) + is_neg) << 1) - is_neg; \
-    src8++; \
-    dst8++; \
-} while (0)
+/* 8 bytes of 0 or 1 to 8 bits, the multiply moves byte k to bit 56 + k
+   without any carries */
+static uint32
+fbits8(const uint8 *eq)
+{
+    uint64 x;
+
+    x = ((uint64) eq[0]) | (((uint64) eq[1]) << 8) |
+        (((uint64) eq[2]) << 16) | (((uint64) eq[3]) << 24) |
+        (((uint64) eq[4]) << 32) | (((uint64) eq[5]) << 40) |
+        (((uint64) eq[6]) << 48) | (((uint64) eq[7]) << 56);
+    return (uint32) ((x * 0x0102040810204080ULL) >> 56);
+}
 
 /*****************************************************************************/
-static int
-fdelta(char *in_plane, char *out_plane, int cx, int cy)
+/* 64 x 64 only, same delta plane as fdelta, the branch is folded into
+   (d << 1) ^ (d < 0 ? 0xFF : 0), bit i of the row's mask word pair is set
+   when delta[i] == delta[i + 1], bit 63 is never set */
+int
+rfx_encode_alpha_delta(const uint8 *plane, uint8 *delta, uint32 *mask)
 {
-    char delta;
-    char is_neg;
-    char *src8;
-    char *dst8;
-    char *src8_end;
+    const uint8 *src8;
+    uint8 *dst8;
+    uint8 d;
+    uint8 row[72];
+    uint8 eq[64];
+    int index;
+    int jndex;
 
-    memcpy(out_plane, in_plane, cx);
-    src8 = in_plane;
-    dst8 = out_plane;
-    src8_end = src8 + (cx * cy - cx);
-    while (src8 + 8 <= src8_end)
-    {
-        DELTA_ONE;
-        DELTA_ONE;
-        DELTA_ONE;
-        DELTA_ONE;
-        DELTA_ONE;
-        DELTA_ONE;
-        DELTA_ONE;
-        DELTA_ONE;
-    }
-    while (src8 < src8_end)
+    memset(row + 64, 0, 8);
+    for (jndex = 0; jndex < 64; jndex++)
     {
-        DELTA_ONE;
+        src8 = plane + jndex * 64;
+        dst8 = delta + jndex * 64;
+        if (jndex == 0)
+        {
+            memcpy(row, src8, 64);
+        }
+        else
+        {
+            for (index = 0; index < 64; index++)
+            {
+                d = src8[index] - src8[index - 64];
+                row[index] = (d << 1) ^ (((sint8) d) >> 7);
+            }
+        }
+        memcpy(dst8, row, 64);
+        for (index = 0; index < 64; index++)
+        {
+            eq[index] = row[index] == row[index + 1];
+        }
+        eq[63] = 0;
+        mask[0] = fbits8(eq) | (fbits8(eq + 8) << 8) |
+                  (fbits8(eq + 16) << 16) | (fbits8(eq + 24) << 24);
+        mask[1] = fbits8(eq + 32) | (fbits8(eq + 40) << 8) |
+                  (fbits8(eq + 48) << 16) | (fbits8(eq + 56) << 24);
+        mask += 2;
     }
     return 0;
 }
-#endif
 
 /*****************************************************************************/
 static int
@@ -250,6 +266,160 @@ fpack(char *plane, int cx, int cy, STREAM *s)
     return (int) (s->p - holdp);
 }
 
+/*****************************************************************************/
+/* first bit at or after pos that differs from flip, end if none */
+static int
+fpack_run_end(const uint32 *mask, int pos, int end, uint32 flip)
+{
+    uint32 lmask;
+    int lword;
+    int lbit;
+
+    lword = pos >> 5;
+    lmask = (mask[lword] ^ flip) & (0xFFFFFFFF << (pos & 31));
+    while (lmask == 0)
+    {
+        lword++;
+        if ((lword << 5) >= end)
+        {
+            return end;
+        }
+        lmask = mask[lword] ^ flip;
+    }
+    GBSF(lmask, lbit);
+    pos = (lword << 5) + lbit;
+    return pos < end ? pos : end;
+}
+
+/*****************************************************************************/
+/* fpack for a 64 x 64 plane with the equal neighbour masks from
+   rfx_encode_alpha_delta, a run of set or clear bits is taken in one step
+   where fpack looks at each byte */
+static int
+fpack_mask(char *plane, const uint32 *mask, STREAM *s)
+{
+    char *colptr;
+    const uint32 *lmask;
+    uint8 *holdp;
+    int index;
+    int jndex;
+    int next;
+    int collen;
+    int replen;
+
+    holdp = s->p;
+    for (jndex = 0; jndex < 64; jndex++)
+    {
+        colptr = plane + jndex * 64;
+        lmask = mask + jndex * 2;
+        if (colptr[0] == 0)
+        {
+            collen = 0;
+            replen = 1;
+        }
+        else
+        {
+            collen = 1;
+            replen = 0;
+        }
+        index = 0;
+        while (index < 63)
+        {
+            if ((lmask[index >> 5] >> (index & 31)) & 1)
+            {
+                next = fpack_run_end(lmask, index, 63, 0xFFFFFFFF);
+                replen += next - index;
+                index = next;
+            }
+            else if (replen > 0)
+            {
+                if (replen < 3)
+                {
+                    collen += replen + 1;
+                    replen = 0;
+                }
+                else
+                {
+                    fout(collen, replen, colptr, s);
+                    colptr = plane + jndex * 64 + index + 1;
+                    replen = 0;
+                    collen = 1;
+                }
+                index++;
+            }
+            else
+            {
+                next = fpack_run_end(lmask, index, 63, 0);
+                collen += next - index;
+                index = next;
+            }
+        }
+        /* end of line */
+        fout(collen, replen, colptr, s);
+    }
+    return (int) (s->p - holdp);
+}
+
+/*****************************************************************************/
+/* 1 if every byte of the 64 x 64 plane is the same, 16 rows at a time so a
+   plane that is not stops early, the inner loop is vectorised */
+static int
+fconst(const uint8 *plane)
+{
+    uint8 v;
+    uint8 diff;
+    int index;
+    int jndex;
+
+    v = plane[0];
+    for (jndex = 0; jndex < 4; jndex++)
+    {
+        diff = 0;
+        for (index = 0; index < 64 * 16; index++)
+        {
+            diff |= plane[index] ^ v;
+        }
+        if (diff != 0)
+        {
+            return 0;
+        }
+        plane += 64 * 16;
+    }
+    return 1;
+}
+
+/*****************************************************************************/
+/* what fdelta and fpack give for a 64 x 64 plane of v, the first row is v
+   and a run of 63, or a run of 64 when v is 0, every delta row after it is
+   zero, a big run of 47 then a run of 17 */
+static int
+fpack_const(uint8 v, STREAM *s)
+{
+    uint8 *holdp;
+    int jndex;
+
+    holdp = s->p;
+    if (v == 0)
+    {
+        stream_write_uint8(s, 0xF2);
+        stream_write_uint8(s, 0x11);
+    }
+    else
+    {
+        stream_write_uint8(s, 0x1F);
+        stream_write_uint8(s, v);
+        stream_write_uint8(s, 0xF2);
+        stream_write_uint8(s, 0x10);
+        stream_write_uint8(s, v);
+    }
+    for (jndex = 1; jndex < 64; jndex++)
+    {
+        stream_write_uint8(s, 0xF2);
+        stream_write_uint8(s, 0x11);
+    }
+    return (int) (s->p - holdp);
+}
+
 /*****************************************************************************/
 int
 rfx_encode_plane(struct rfxencode *enc, const uint8 *plane, int cx, int cy,
@@ -259,13 +429,29 @@ rfx_encode_plane(struct rfxencode *enc, const uint8 *plane, int cx, int cy,
     char *delta_plane;
     int bytes;
     uint8 *holdp;
+    uint32 mask[128];
 
     org_plane = (const char *) plane;
     delta_plane = (char *) (enc->dwt_buffer1);
-    fdelta(org_plane, delta_plane, cx, cy);
     holdp = s->p;
-    stream_write_uint8(s, 0x10); /* flags, RLE */
-    bytes = fpack(delta_plane, cx, cy, s);
+    if ((cx == 64) && (cy == 64) && fconst(plane))
+    {
+        /* opaque or fully transparent, nothing to delta or search */
+        stream_write_uint8(s, 0x10); /* flags, RLE */
+        return fpack_const(plane[0], s);
+    }
+    if ((cx == 64) && (cy == 64))
+    {
+        enc->rfx_encode_alpha_delta(plane, (uint8 *) delta_plane, mask);
+        stream_write_uint8(s, 0x10); /* flags, RLE */
+        bytes = fpack_mask(delta_plane, mask, s);
+    }
+    else
+    {
+        fdelta(org_plane, delta_plane, cx, cy);
+        stream_write_uint8(s, 0x10); /* flags, RLE */
+        bytes = fpack(delta_plane, cx, cy, s);
+    }
     if (bytes > cx * cy)
     {
         LLOGLN(10, ("rfx_encode_plane: too big bytes %d", bytes));
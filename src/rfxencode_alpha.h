@@ -20,6 +20,8 @@
 #ifndef __RFXCODEC_ENCODE_ALPHA_H
 #define __RFXCODEC_ENCODE_ALPHA_H
 
+int
+rfx_encode_alpha_delta(const uint8 *plane, uint8 *delta, uint32 *mask);
 int
 rfx_encode_plane(struct rfxencode *enc, const uint8 *plane, int cx, int cy,
                  STREAM *s);
@@ -0,0 +1,274 @@
+/**
+ * RFX codec encoder
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * rfxcodec_encode_submit, one thread per handle runs the submitted
+ * rfxcodec_encode_ex calls
+ * a pipe is used for the fd, not eventfd, so it works on the BSDs too
+ */
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <pthread.h>
+
+#include <rfxcodec_encode.h>
+
+#include "rfxcommon.h"
+#include "rfxencode_async.h"
+
+#define LLOG_LEVEL 1
+#define LLOGLN(_level, _args) \
+    do { if (_level < LLOG_LEVEL) { printf _args ; printf("\n"); } } while (0)
+
+struct rfx_async
+{
+    void *handle;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    struct rfx_async_call *calls_head; /* waiting to run */
+    struct rfx_async_call *calls_tail;
+    struct rfx_async_call *results_head; /* done, for get_result */
+    struct rfx_async_call *results_tail;
+    int fds[2]; /* one byte in the pipe per result */
+    pthread_t thread;
+    int started;
+    int shutdown;
+};
+
+/******************************************************************************/
+static void
+rfx_async_append(struct rfx_async_call **head, struct rfx_async_call **tail,
+                 struct rfx_async_call *call)
+{
+    call->next = NULL;
+    if (*tail == NULL)
+    {
+        *head = call;
+    }
+    else
+    {
+        (*tail)->next = call;
+    }
+    *tail = call;
+}
+
+/******************************************************************************/
+static struct rfx_async_call *
+rfx_async_remove(struct rfx_async_call **head, struct rfx_async_call **tail)
+{
+    struct rfx_async_call *call;
+
+    call = *head;
+    if (call != NULL)
+    {
+        *head = call->next;
+        if (*head == NULL)
+        {
+            *tail = NULL;
+        }
+    }
+    return call;
+}
+
+/******************************************************************************/
+static void *
+rfx_async_thread_loop(void *arg)
+{
+    struct rfx_async *async;
+    struct rfx_async_call *call;
+    char byte;
+
+    async = (struct rfx_async *) arg;
+    pthread_mutex_lock(&async->mutex);
+    for (;;)
+    {
+        call = rfx_async_remove(&(async->calls_head), &(async->calls_tail));
+        if (call == NULL)
+        {
+            if (async->shutdown)
+            {
+                break;
+            }
+            pthread_cond_wait(&async->cond, &async->mutex);
+            continue;
+        }
+        pthread_mutex_unlock(&async->mutex);
+        call->tiles_written =
+            rfxcodec_encode_ex(async->handle, call->cdata,
+                               &(call->cdata_bytes), call->buf,
+                               call->width, call->height, call->stride_bytes,
+                               call->regions, call->num_regions,
+                               call->tiles, call->num_tiles,
+                               call->quants, call->num_quants, call->flags);
+        if (call->done != NULL)
+        {
+            call->done(async->handle, call->user, call->tiles_written,
+                       call->cdata_bytes);
+            free(call);
+            pthread_mutex_lock(&async->mutex);
+            continue;
+        }
+        pthread_mutex_lock(&async->mutex);
+        rfx_async_append(&(async->results_head), &(async->results_tail),
+                         call);
+        byte = 0;
+        if (write(async->fds[1], &byte, 1) != 1)
+        {
+            LLOGLN(0, ("rfx_async_thread_loop: write failed"));
+        }
+    }
+    pthread_mutex_unlock(&async->mutex);
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_async_create(void *handle, struct rfx_async **async)
+{
+    struct rfx_async *self;
+    int index;
+
+    self = xnew(struct rfx_async);
+    if (self == NULL)
+    {
+        return 1;
+    }
+    self->handle = handle;
+    pthread_mutex_init(&self->mutex, NULL);
+    pthread_cond_init(&self->cond, NULL);
+    self->fds[0] = -1;
+    self->fds[1] = -1;
+    if (pipe(self->fds) != 0)
+    {
+        self->fds[0] = -1;
+        self->fds[1] = -1;
+        rfx_async_destroy(self);
+        return 1;
+    }
+    for (index = 0; index < 2; index++)
+    {
+        fcntl(self->fds[index], F_SETFL,
+              fcntl(self->fds[index], F_GETFL) | O_NONBLOCK);
+        fcntl(self->fds[index], F_SETFD, FD_CLOEXEC);
+    }
+    if (pthread_create(&(self->thread), NULL,
+                       rfx_async_thread_loop, self) != 0)
+    {
+        rfx_async_destroy(self);
+        return 1;
+    }
+    self->started = 1;
+    *async = self;
+    return 0;
+}
+
+/******************************************************************************/
+/* runs the calls still queued first */
+int
+rfx_async_destroy(struct rfx_async *async)
+{
+    struct rfx_async_call *call;
+
+    if (async == NULL)
+    {
+        return 0;
+    }
+    pthread_mutex_lock(&async->mutex);
+    async->shutdown = 1;
+    pthread_cond_signal(&async->cond);
+    pthread_mutex_unlock(&async->mutex);
+    if (async->started)
+    {
+        pthread_join(async->thread, NULL);
+    }
+    while ((call = rfx_async_remove(&(async->results_head),
+                                    &(async->results_tail))) != NULL)
+    {
+        free(call);
+    }
+    if (async->fds[0] != -1)
+    {
+        close(async->fds[0]);
+        close(async->fds[1]);
+    }
+    pthread_cond_destroy(&async->cond);
+    pthread_mutex_destroy(&async->mutex);
+    free(async);
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_async_submit(struct rfx_async *async, const struct rfx_async_call *call)
+{
+    struct rfx_async_call *self;
+
+    self = xnew(struct rfx_async_call);
+    if (self == NULL)
+    {
+        return 1;
+    }
+    *self = *call;
+    pthread_mutex_lock(&async->mutex);
+    rfx_async_append(&(async->calls_head), &(async->calls_tail), self);
+    pthread_cond_signal(&async->cond);
+    pthread_mutex_unlock(&async->mutex);
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_async_get_fd(struct rfx_async *async)
+{
+    return async->fds[0];
+}
+
+/******************************************************************************/
+int
+rfx_async_get_result(struct rfx_async *async, void **user,
+                     int *tiles_written, int *cdata_bytes)
+{
+    struct rfx_async_call *call;
+    char byte;
+
+    pthread_mutex_lock(&async->mutex);
+    call = rfx_async_remove(&(async->results_head), &(async->results_tail));
+    if (call != NULL)
+    {
+        if (read(async->fds[0], &byte, 1) != 1)
+        {
+            LLOGLN(0, ("rfx_async_get_result: read failed"));
+        }
+    }
+    pthread_mutex_unlock(&async->mutex);
+    if (call == NULL)
+    {
+        return 1;
+    }
+    *user = call->user;
+    *tiles_written = call->tiles_written;
+    *cdata_bytes = call->cdata_bytes;
+    free(call);
+    return 0;
+}
@@ -0,0 +1,58 @@
+/**
+ * RFX codec encoder
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __RFXENCODE_ASYNC_H
+#define __RFXENCODE_ASYNC_H
+
+struct rfx_async;
+
+/* one rfxcodec_encode_submit */
+struct rfx_async_call
+{
+    char *cdata;
+    int cdata_bytes;
+    const char *buf;
+    int width;
+    int height;
+    int stride_bytes;
+    const struct rfx_rect *regions;
+    int num_regions;
+    const struct rfx_tile *tiles;
+    int num_tiles;
+    const char *quants;
+    int num_quants;
+    int flags;
+    rfxcodec_encode_done_proc done;
+    void *user;
+    int tiles_written;
+    struct rfx_async_call *next;
+};
+
+int
+rfx_async_create(void *handle, struct rfx_async **async);
+int
+rfx_async_destroy(struct rfx_async *async);
+int
+rfx_async_submit(struct rfx_async *async, const struct rfx_async_call *call);
+int
+rfx_async_get_fd(struct rfx_async *async);
+int
+rfx_async_get_result(struct rfx_async *async, void **user,
+                     int *tiles_written, int *cdata_bytes);
+
+#endif
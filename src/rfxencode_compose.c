@@ -35,11 +35,13 @@
 
 #include "rfxencode_quantization.h"
 #include "rfxencode_dwt_rem.h"
-#include "rfxencode_dwt_shift_rem.h"
 #include "rfxencode_diff_rlgr1.h"
 #include "rfxencode_rlgr1.h"
 #include "rfxencode_differential.h"
 #include "rfxencode_compose.h"
+#include "rfxencode_pool.h"
+#include "rfxencode_topo.h"
+#include "rfxencode_pipe.h"
 
 #define LLOG_LEVEL 1
 #define LLOGLN(_level, _args) \
@@ -397,6 +399,383 @@ rfx_compose_message_tile_argb(struct rfxencode *enc, STREAM *s,
     return 0;
 }
 
+/******************************************************************************/
+static int
+rfx_compose_message_tile(struct rfxencode *enc, STREAM *s,
+                         const char *buf, int stride_bytes,
+                         const struct rfx_tile *tile,
+                         const char *quantVals, int flags)
+{
+    const char *tile_data;
+    int x;
+    int y;
+
+    x = tile->x;
+    y = tile->y;
+    if (enc->format == RFX_FORMAT_YUV)
+    {
+        tile_data = buf + (y << 8) * (stride_bytes >> 8) + (x << 8);
+        if (flags & RFX_FLAGS_ALPHAV1)
+        {
+            return rfx_compose_message_tile_yuva(enc, s,
+                                                 tile_data, tile->cx, tile->cy,
+                                                 stride_bytes, quantVals,
+                                                 tile->quant_y, tile->quant_cb,
+                                                 tile->quant_cr, x / 64, y / 64);
+        }
+        return rfx_compose_message_tile_yuv(enc, s,
+                                            tile_data, tile->cx, tile->cy,
+                                            stride_bytes, quantVals,
+                                            tile->quant_y, tile->quant_cb,
+                                            tile->quant_cr, x / 64, y / 64);
+    }
+    tile_data = buf + y * stride_bytes + x * (enc->bits_per_pixel / 8);
+    if (flags & RFX_FLAGS_ALPHAV1)
+    {
+        return rfx_compose_message_tile_argb(enc, s,
+                                             tile_data, tile->cx, tile->cy,
+                                             stride_bytes, quantVals,
+                                             tile->quant_y, tile->quant_cb,
+                                             tile->quant_cr, x / 64, y / 64);
+    }
+    return rfx_compose_message_tile_rgb(enc, s,
+                                        tile_data, tile->cx, tile->cy,
+                                        stride_bytes, quantVals,
+                                        tile->quant_y, tile->quant_cb,
+                                        tile->quant_cr, x / 64, y / 64);
+}
+
+static int
+rfx_pro_compose_message_tile(struct rfxencode *enc, STREAM *s,
+                             const char *buf, int stride_bytes,
+                             const struct rfx_tile *tile, const char *quants,
+                             const struct rfx_rb *rb, struct rfx_rb *rb_new);
+
+/******************************************************************************/
+/* see rfxcodec_encode_deadline */
+int
+rfx_compose_past_deadline(const struct rfxencode *enc)
+{
+    if (!enc->deadline_set)
+    {
+        return 0;
+    }
+    return ((sint32) (rfx_pool_get_us() - enc->deadline_us)) >= 0;
+}
+
+/******************************************************************************/
+void
+rfx_compose_free_slots(struct rfxencode *enc)
+{
+    int index;
+
+    for (index = 0; index < enc->num_tile_slots; index++)
+    {
+        free(enc->tile_slots[index].data);
+        free(enc->tile_slots[index].rb_new);
+    }
+    free(enc->tile_slots);
+    free(enc->tile_slot_args);
+    free(enc->tile_slot_nodes);
+    enc->tile_slots = NULL;
+    enc->tile_slot_args = NULL;
+    enc->tile_slot_nodes = NULL;
+    enc->num_tile_slots = 0;
+    free(enc->tile_stage);
+    enc->tile_stage = NULL;
+}
+
+/******************************************************************************/
+/* keep the tile encoded in s from its start */
+void
+rfx_compose_store_slot(struct rfx_tile_slot *slot, STREAM *s)
+{
+    int bytes;
+
+    bytes = stream_get_pos(s);
+    if (slot->data_alloc < bytes)
+    {
+        free(slot->data);
+        slot->data_alloc = bytes + 1024;
+        slot->data = (uint8 *) malloc(slot->data_alloc);
+        if (slot->data == NULL)
+        {
+            slot->data_alloc = 0;
+            return;
+        }
+    }
+    memcpy(slot->data, s->data, bytes);
+    slot->bytes = bytes;
+}
+
+/******************************************************************************/
+static void
+rfx_compose_encode_slot(struct rfxencode *scratch, void *arg)
+{
+    struct rfx_tile_slot *slot;
+    const struct rfx_tile *tile;
+    STREAM s;
+    int rv;
+
+    slot = (struct rfx_tile_slot *) arg;
+    slot->bytes = -1;
+    if (slot->can_skip && rfx_compose_past_deadline(slot->enc))
+    {
+        slot->bytes = RFX_TILE_SLOT_LATE;
+        return;
+    }
+    if (scratch->tile_stage == NULL)
+    {
+        scratch->tile_stage = (uint8 *) malloc(RFX_TILE_STAGE_BYTES);
+        if (scratch->tile_stage == NULL)
+        {
+            return;
+        }
+    }
+    s.data = scratch->tile_stage;
+    s.p = s.data;
+    s.size = RFX_TILE_STAGE_BYTES;
+    tile = slot->tile;
+    if (slot->pro)
+    {
+        rv = rfx_pro_compose_message_tile(scratch, &s, slot->buf,
+                                          slot->stride_bytes, tile,
+                                          slot->quantVals,
+                                          slot->enc->rbs[tile->x / 64]
+                                                        [tile->y / 64],
+                                          slot->rb_new);
+    }
+    else
+    {
+        rv = rfx_compose_message_tile(scratch, &s, slot->buf,
+                                      slot->stride_bytes, tile,
+                                      slot->quantVals, slot->flags);
+    }
+    if (rv != 0)
+    {
+        return;
+    }
+    rfx_compose_store_slot(slot, &s);
+}
+
+/******************************************************************************/
+/* numa node of the first line of each tile's source into
+   enc->tile_slot_nodes */
+static void
+rfx_compose_get_tile_nodes(struct rfxencode *enc,
+                           const char *buf, int stride_bytes,
+                           const struct rfx_tile *tiles, int num_tiles)
+{
+    const void *addrs[64];
+    int count;
+    int index;
+    int x;
+    int y;
+
+    for (index = 0; index < num_tiles; index += count)
+    {
+        count = MIN(num_tiles - index, 64);
+        for (x = 0; x < count; x++)
+        {
+            y = tiles[index + x].y;
+            if (enc->format == RFX_FORMAT_YUV)
+            {
+                addrs[x] = buf + (y << 8) * (stride_bytes >> 8) +
+                           (tiles[index + x].x << 8);
+            }
+            else
+            {
+                addrs[x] = buf + y * stride_bytes +
+                           tiles[index + x].x * (enc->bits_per_pixel / 8);
+            }
+        }
+        rfx_topo_get_mem_nodes(addrs, enc->tile_slot_nodes + index, count);
+    }
+}
+
+/******************************************************************************/
+/* phase one, in enc->pipe or enc->pool when there is one
+   the gather pass encodes the tiles that failed here again */
+static int
+rfx_compose_encode_slots(struct rfxencode *enc,
+                         const char *buf, int stride_bytes,
+                         const struct rfx_tile *tiles, int num_tiles,
+                         const char *quantVals, int flags, int pro)
+{
+    struct rfx_tile_slot *slots;
+    struct rfx_tile_slot *slot;
+    void **args;
+    int *nodes;
+    int index;
+
+    if (num_tiles > enc->num_tile_slots)
+    {
+        args = (void **) realloc(enc->tile_slot_args,
+                                 num_tiles * sizeof(void *));
+        if (args == NULL)
+        {
+            return 1;
+        }
+        enc->tile_slot_args = args;
+        nodes = (int *) realloc(enc->tile_slot_nodes,
+                                num_tiles * sizeof(int));
+        if (nodes == NULL)
+        {
+            return 1;
+        }
+        enc->tile_slot_nodes = nodes;
+        slots = (struct rfx_tile_slot *)
+                realloc(enc->tile_slots,
+                        num_tiles * sizeof(struct rfx_tile_slot));
+        if (slots == NULL)
+        {
+            return 1;
+        }
+        memset(slots + enc->num_tile_slots, 0,
+               (num_tiles - enc->num_tile_slots) *
+               sizeof(struct rfx_tile_slot));
+        enc->tile_slots = slots;
+        enc->num_tile_slots = num_tiles;
+    }
+    for (index = 0; index < num_tiles; index++)
+    {
+        slot = enc->tile_slots + index;
+        if (pro && (slot->rb_new == NULL))
+        {
+            slot->rb_new = xnew(struct rfx_rb);
+            if (slot->rb_new == NULL)
+            {
+                return 1;
+            }
+        }
+        slot->enc = enc;
+        slot->buf = buf;
+        slot->stride_bytes = stride_bytes;
+        slot->tile = tiles + index;
+        slot->quantVals = quantVals;
+        slot->flags = flags;
+        slot->pro = pro;
+        slot->can_skip = index > 0;
+        enc->tile_slot_args[index] = slot;
+    }
+    if ((enc->pipe != NULL) && !pro)
+    {
+        return rfx_pipe_run(enc->pipe, enc, enc->tile_slots, num_tiles);
+    }
+    if (enc->pool != NULL)
+    {
+        nodes = NULL;
+        if (rfx_pool_get_num_nodes(enc->pool) > 1)
+        {
+            rfx_compose_get_tile_nodes(enc, buf, stride_bytes,
+                                       tiles, num_tiles);
+            nodes = enc->tile_slot_nodes;
+        }
+        return rfx_pool_run(enc->pool_session, enc, rfx_compose_encode_slot,
+                            enc->tile_slot_args, nodes, num_tiles);
+    }
+    for (index = 0; index < num_tiles; index++)
+    {
+        rfx_compose_encode_slot(enc, enc->tile_slot_args[index]);
+    }
+    return 0;
+}
+
+/******************************************************************************/
+static void
+rfx_compose_message_tileset_header(struct rfxencode *enc, STREAM *s,
+                                   int block_len, int num_quants,
+                                   const char *quant_vals,
+                                   int num_tiles, int tiles_data_size,
+                                   int flags)
+{
+    if (flags & RFX_FLAGS_ALPHAV1)
+    {
+        LLOGLN(10, ("rfx_compose_message_tileset: RFX_FLAGS_ALPHAV1 set"));
+        stream_write_uint16(s, WBT_EXTENSION_PLUS); /* CodecChannelT.blockType */
+    }
+    else
+    {
+        stream_write_uint16(s, WBT_EXTENSION); /* CodecChannelT.blockType */
+    }
+    stream_write_uint32(s, block_len); /* CodecChannelT.blockLen */
+    stream_write_uint8(s, 1); /* CodecChannelT.codecId */
+    stream_write_uint8(s, 0); /* CodecChannelT.channelId */
+    stream_write_uint16(s, CBT_TILESET); /* subtype */
+    stream_write_uint16(s, 0); /* idx */
+    stream_write_uint16(s, enc->properties); /* properties */
+    stream_write_uint8(s, num_quants); /* numQuants */
+    stream_write_uint8(s, 0x40); /* tileSize */
+    stream_write_uint16(s, num_tiles); /* numTiles */
+    stream_write_uint32(s, tiles_data_size); /* tilesDataSize */
+    memcpy(s->p, quant_vals, num_quants * 5);
+    s->p += num_quants * 5;
+}
+
+/******************************************************************************/
+/* phase two, stops at the first tile that would not have fit when
+   encoding straight into s */
+static int
+rfx_compose_gather_tileset(struct rfxencode *enc, STREAM *s,
+                           const char *buf, int stride_bytes,
+                           const struct rfx_tile *tiles, int num_tiles,
+                           const char *quantVals, int numQuants, int flags)
+{
+    struct rfx_tile_slot *slot;
+    int header_bytes;
+    int tile_header_bytes;
+    int start_pos;
+    int end_pos;
+    int pos;
+    int tiles_written;
+    int index;
+
+    header_bytes = 22 + numQuants * 5;
+    tile_header_bytes = (flags & RFX_FLAGS_ALPHAV1) ? 21 : 19;
+    start_pos = stream_get_pos(s);
+    stream_seek(s, header_bytes);
+    tiles_written = 0;
+    for (index = 0; index < num_tiles; index++)
+    {
+        slot = enc->tile_slots + index;
+        if (slot->bytes == RFX_TILE_SLOT_LATE)
+        {
+            break;
+        }
+        if (slot->bytes < 0)
+        {
+            pos = stream_get_pos(s);
+            if (rfx_compose_message_tile(enc, s, buf, stride_bytes,
+                                         tiles + index, quantVals,
+                                         flags) != 0)
+            {
+                stream_set_pos(s, pos);
+                break;
+            }
+            tiles_written++;
+            continue;
+        }
+        /* same check check_and_rfx_encode does before the Cr
+           component, YLen and CbLen are at offset 13 */
+        if (stream_get_left(s) - tile_header_bytes -
+            (slot->data[13] | (slot->data[14] << 8)) -
+            (slot->data[15] | (slot->data[16] << 8)) < TILE_SIZE_UPPER_LIMIT)
+        {
+            break;
+        }
+        stream_write(s, slot->data, slot->bytes);
+        tiles_written++;
+    }
+    end_pos = stream_get_pos(s);
+    stream_set_pos(s, start_pos);
+    rfx_compose_message_tileset_header(enc, s, end_pos - start_pos,
+                                       numQuants, quantVals, tiles_written,
+                                       end_pos - start_pos - header_bytes,
+                                       flags);
+    stream_set_pos(s, end_pos);
+    return tiles_written;
+}
+
 /******************************************************************************/
 static int
 rfx_compose_message_tileset(struct rfxencode *enc, STREAM *s,
@@ -437,29 +816,19 @@ rfx_compose_message_tileset(struct rfxencode *enc, STREAM *s,
         quantVals = quants;
     }
     numTiles = num_tiles;
-    size = 22 + numQuants * 5;
-    start_pos = stream_get_pos(s);
-    if (flags & RFX_FLAGS_ALPHAV1)
+    if (((enc->pool != NULL) || (enc->pipe != NULL)) && (numTiles > 1) &&
+        (rfx_compose_encode_slots(enc, buf, stride_bytes, tiles, numTiles,
+                                  quantVals, flags, 0) == 0))
     {
-        LLOGLN(10, ("rfx_compose_message_tileset: RFX_FLAGS_ALPHAV1 set"));
-        stream_write_uint16(s, WBT_EXTENSION_PLUS); /* CodecChannelT.blockType */
+        return rfx_compose_gather_tileset(enc, s, buf, stride_bytes,
+                                          tiles, numTiles, quantVals,
+                                          numQuants, flags);
     }
-    else
-    {
-        stream_write_uint16(s, WBT_EXTENSION); /* CodecChannelT.blockType */
-    }
-    stream_seek_uint32(s); /* set CodecChannelT.blockLen later */
-    stream_write_uint8(s, 1); /* CodecChannelT.codecId */
-    stream_write_uint8(s, 0); /* CodecChannelT.channelId */
-    stream_write_uint16(s, CBT_TILESET); /* subtype */
-    stream_write_uint16(s, 0); /* idx */
-    stream_write_uint16(s, enc->properties); /* properties */
-    stream_write_uint8(s, numQuants); /* numQuants */
-    stream_write_uint8(s, 0x40); /* tileSize */
-    stream_write_uint16(s, numTiles); /* numTiles */
-    stream_seek_uint32(s); /* set tilesDataSize later */
-    memcpy(s->p, quantVals, numQuants * 5);
-    s->p += numQuants * 5;
+    size = 22 + numQuants * 5;
+    start_pos = stream_get_pos(s);
+    /* blockLen and tilesDataSize set later */
+    rfx_compose_message_tileset_header(enc, s, 0, numQuants, quantVals,
+                                       numTiles, 0, flags);
     end_pos = stream_get_pos(s);
     tiles_written = 0;
     tiles_end_checkpoint = stream_get_pos(s);
@@ -470,6 +839,10 @@ rfx_compose_message_tileset(struct rfxencode *enc, STREAM *s,
         {
             for (index = 0; index < numTiles; index++)
             {
+                if ((index > 0) && rfx_compose_past_deadline(enc))
+                {
+                    break;
+                }
                 x = tiles[index].x;
                 y = tiles[index].y;
                 cx = tiles[index].cx;
@@ -494,6 +867,10 @@ rfx_compose_message_tileset(struct rfxencode *enc, STREAM *s,
         {
             for (index = 0; index < numTiles; index++)
             {
+                if ((index > 0) && rfx_compose_past_deadline(enc))
+                {
+                    break;
+                }
                 x = tiles[index].x;
                 y = tiles[index].y;
                 cx = tiles[index].cx;
@@ -521,6 +898,10 @@ rfx_compose_message_tileset(struct rfxencode *enc, STREAM *s,
         {
             for (index = 0; index < numTiles; index++)
             {
+                if ((index > 0) && rfx_compose_past_deadline(enc))
+                {
+                    break;
+                }
                 x = tiles[index].x;
                 y = tiles[index].y;
                 cx = tiles[index].cx;
@@ -545,6 +926,10 @@ rfx_compose_message_tileset(struct rfxencode *enc, STREAM *s,
         {
             for (index = 0; index < numTiles; index++)
             {
+                if ((index > 0) && rfx_compose_past_deadline(enc))
+                {
+                    break;
+                }
                 x = tiles[index].x;
                 y = tiles[index].y;
                 cx = tiles[index].cx;
@@ -685,19 +1070,6 @@ do { _count1 = 0; _count2 = 0; \
         _coef3[_loop] = _coef2[_loop]; _loop++; } \
 } while (0)
 
-/******************************************************************************/
-/* coef1 = coef2 - coef3 (QCdt = QCot - QCrb)
-   count zeros in coef1, coef2 */
-#define COEF_DIFF_COUNT(_coef1, _coef2, _coef3, _loop, _count1, _count2) \
-do { _count1 = 0; _count2 = 0; \
-    for (_loop = 0; _loop < 4096 - 81; _loop++) { \
-        _coef1[_loop] = _coef2[_loop] - _coef3[_loop]; \
-        if (_coef1[_loop] == 0) { _count1++; } \
-        if (_coef2[_loop] == 0) { _count2++; } } \
-    while (_loop < 4096) { \
-        _coef1[_loop] = _coef2[_loop] - _coef3[_loop]; _loop++; } \
-} while (0)
-
 /******************************************************************************/
 /* coef1 = coef2 - coef3 (QCdt = QCot - QCrb)
    coef3 = coef2 */
@@ -717,22 +1089,16 @@ do { \
 } while (0)
 
 /******************************************************************************/
-/* return tiles written or -1 on error */
+/* encode one tile at the end of s against its history rb, the new
+   history goes in rb_new, which can be rb, then only when the tile fits
+   returns 0 ok, 1 if the tile does not fit */
 static int
-rfx_pro_compose_message_region(struct rfxencode *enc, STREAM *s,
-                               const struct rfx_rect *regions, int num_regions,
-                               const char *buf, int width, int height,
-                               int stride_bytes,
-                               const struct rfx_tile *tiles, int num_tiles,
-                               const char *quants, int num_quants,
-                               int flags)
+rfx_pro_compose_message_tile(struct rfxencode *enc, STREAM *s,
+                             const char *buf, int stride_bytes,
+                             const struct rfx_tile *tile, const char *quants,
+                             const struct rfx_rb *rb, struct rfx_rb *rb_new)
 {
-    int index;
     int jndex;
-    int start_pos;
-    int tiles_start_pos;
-    int end_pos;
-    int tiles_written;
     int x;
     int y;
     uint8 quantIdxY;
@@ -755,7 +1121,6 @@ rfx_pro_compose_message_region(struct rfxencode *enc, STREAM *s,
     const char *u_quants;
     const char *v_quants;
 
-    struct rfx_rb *rb;
     int dt_y_zeros;
     int dt_u_zeros;
     int dt_v_zeros;
@@ -766,26 +1131,197 @@ rfx_pro_compose_message_region(struct rfxencode *enc, STREAM *s,
     sint16 *dwt_buffer_y;
     sint16 *dwt_buffer_u;
     sint16 *dwt_buffer_v;
+    int early;
 
-    if (stream_get_left(s) < 18 + num_regions * 8 + num_quants * 5)
+    x = tile->x;
+    y = tile->y;
+    quantIdxY = tile->quant_y;
+    quantIdxCb = tile->quant_cb;
+    quantIdxCr = tile->quant_cr;
+    tile_data = buf + (y << 8) * (stride_bytes >> 8) + (x << 8);
+    xIdx = x / 64;
+    yIdx = y / 64;
+    tile_start_pos = stream_get_pos(s);
+    stream_write_uint16(s, PRO_WBT_TILE_SIMPLE);
+    stream_seek_uint32(s); /* set later */
+    stream_write_uint8(s, quantIdxY);
+    stream_write_uint8(s, quantIdxCb);
+    stream_write_uint8(s, quantIdxCr);
+    stream_write_uint16(s, xIdx);
+    stream_write_uint16(s, yIdx);
+    stream_seek(s, 1); /* flags, set later */
+    stream_seek(s, 8); /* yLen, cbLen, crLen, tailLen, set later */
+    y_buffer = (const uint8 *) tile_data;
+    u_buffer = (const uint8 *) (tile_data + RFX_YUV_BTES);
+    v_buffer = (const uint8 *) (tile_data + RFX_YUV_BTES * 2);
+    y_quants = quants + quantIdxY * 5;
+    u_quants = quants + quantIdxCb * 5;
+    v_quants = quants + quantIdxCr * 5;
+    enc->rfx_rem_dwt_shift_encode(y_buffer, enc->dwt_buffer1,
+                                  enc->dwt_buffer, y_quants);
+    enc->rfx_rem_dwt_shift_encode(u_buffer, enc->dwt_buffer2,
+                                  enc->dwt_buffer, u_quants);
+    enc->rfx_rem_dwt_shift_encode(v_buffer, enc->dwt_buffer3,
+                                  enc->dwt_buffer, v_quants);
+    /* a separate rb_new takes the new history in the same pass, it is
+       only swapped in once the tile is sent */
+    early = rb_new != rb;
+    enc->rfx_differential_pro_encode(enc->dwt_buffer1, rb->y,
+                                     enc->dwt_buffer4,
+                                     early ? rb_new->y : NULL,
+                                     &dt_y_zeros, &ot_y_zeros);
+    enc->rfx_differential_pro_encode(enc->dwt_buffer2, rb->u,
+                                     enc->dwt_buffer5,
+                                     early ? rb_new->u : NULL,
+                                     &dt_u_zeros, &ot_u_zeros);
+    enc->rfx_differential_pro_encode(enc->dwt_buffer3, rb->v,
+                                     enc->dwt_buffer6,
+                                     early ? rb_new->v : NULL,
+                                     &dt_v_zeros, &ot_v_zeros);
+    if (ot_y_zeros + ot_u_zeros + ot_v_zeros <
+        dt_y_zeros + dt_u_zeros + dt_v_zeros)
     {
-        return -1;
+        LLOGLN(10, ("rfx_pro_compose_message_tile: diff"));
+        tile_flags = RFX_TILE_DIFFERENCE;
+        dwt_buffer_y = enc->dwt_buffer4;
+        dwt_buffer_u = enc->dwt_buffer5;
+        dwt_buffer_v = enc->dwt_buffer6;
     }
-    if (quants == NULL)
+    else
     {
-        num_quants = 1;
-        quants = (const char *) g_rfx_default_quantization_values;
+        LLOGLN(10, ("rfx_pro_compose_message_tile: orig"));
+        tile_flags = 0;
+        dwt_buffer_y = enc->dwt_buffer1;
+        dwt_buffer_u = enc->dwt_buffer2;
+        dwt_buffer_v = enc->dwt_buffer3;
     }
-    start_pos = stream_get_pos(s);
+    y_bytes = enc->rfx_encode_diff_rlgr1(dwt_buffer_y,
+                                         stream_get_tail(s),
+                                         stream_get_left(s), 81,
+                                         enc->rfx_encode_nonzero_mask);
+    if (y_bytes < 0)
+    {
+        return 1;
+    }
+    stream_seek(s, y_bytes);
+    u_bytes = enc->rfx_encode_diff_rlgr1(dwt_buffer_u,
+                                         stream_get_tail(s),
+                                         stream_get_left(s), 81,
+                                         enc->rfx_encode_nonzero_mask);
+    if (u_bytes < 0)
+    {
+        return 1;
+    }
+    stream_seek(s, u_bytes);
+    v_bytes = enc->rfx_encode_diff_rlgr1(dwt_buffer_v,
+                                         stream_get_tail(s),
+                                         stream_get_left(s), 81,
+                                         enc->rfx_encode_nonzero_mask);
+    if (v_bytes < 0)
+    {
+        return 1;
+    }
+    stream_seek(s, v_bytes);
+    LLOGLN(10, ("rfx_pro_compose_message_tile: y_bytes %d "
+           "u_bytes %d v_bytes %d", y_bytes, u_bytes, v_bytes));
+    tile_end_pos = stream_get_pos(s);
+    stream_set_pos(s, tile_start_pos + 2);
+    stream_write_uint32(s, tile_end_pos - tile_start_pos); /* blockLen */
+    stream_set_pos(s, tile_start_pos + 13);
+    stream_write_uint8(s, tile_flags); /* flags */
+    stream_write_uint16(s, y_bytes); /* yLen */
+    stream_write_uint16(s, u_bytes); /* cbLen */
+    stream_write_uint16(s, v_bytes); /* crLen */
+    stream_write_uint16(s, 0); /* tailLen */
+    stream_set_pos(s, tile_end_pos);
+    if (early)
+    {
+        return 0;
+    }
+    /* update the history only after you know there is space
+       for this tile in the compressed buffer */
+    if (tile_flags == 0)
+    {
+        /* undo the diff from rfx_encode_diff_rlgr */
+        for (jndex = 4096 - 80; jndex < 4096; jndex++)
+        {
+            enc->dwt_buffer1[jndex] += enc->dwt_buffer1[jndex - 1];
+            enc->dwt_buffer2[jndex] += enc->dwt_buffer2[jndex - 1];
+            enc->dwt_buffer3[jndex] += enc->dwt_buffer3[jndex - 1];
+        }
+    }
+    memcpy(rb_new->y, enc->dwt_buffer1, 64 * 64 * 2);
+    memcpy(rb_new->u, enc->dwt_buffer2, 64 * 64 * 2);
+    memcpy(rb_new->v, enc->dwt_buffer3, 64 * 64 * 2);
+    return 0;
+}
+
+/******************************************************************************/
+/* each tile only reads and writes its own history so the tiles can be
+   encoded in any order, each against its current history with the new
+   history going in its slot, swapped in when the gather pass sends the
+   tile
+   returns non zero for tile lists the serial loop would fail on and tile
+   lists with the same tile more than once */
+static int
+rfx_pro_check_tiles(struct rfxencode *enc,
+                    const struct rfx_tile *tiles, int num_tiles,
+                    int num_quants)
+{
+    uint8 tile_used[RFX_MAX_RB_X * RFX_MAX_RB_Y];
+    int index;
+    uint16 xIdx;
+    uint16 yIdx;
+
+    memset(tile_used, 0, sizeof(tile_used));
+    for (index = 0; index < num_tiles; index++)
+    {
+        if (((uint8) (tiles[index].quant_y) >= num_quants) ||
+            ((uint8) (tiles[index].quant_cb) >= num_quants) ||
+            ((uint8) (tiles[index].quant_cr) >= num_quants))
+        {
+            return 1;
+        }
+        xIdx = tiles[index].x / 64;
+        yIdx = tiles[index].y / 64;
+        if ((xIdx >= RFX_MAX_RB_X) || (yIdx >= RFX_MAX_RB_Y) ||
+            tile_used[yIdx * RFX_MAX_RB_X + xIdx])
+        {
+            return 1;
+        }
+        tile_used[yIdx * RFX_MAX_RB_X + xIdx] = 1;
+        if (enc->rbs[xIdx][yIdx] == NULL)
+        {
+            enc->rbs[xIdx][yIdx] = xnew(struct rfx_rb);
+            if (enc->rbs[xIdx][yIdx] == NULL)
+            {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/******************************************************************************/
+static void
+rfx_pro_compose_message_region_header(struct rfxencode *enc, STREAM *s,
+                                      const struct rfx_rect *regions,
+                                      int num_regions,
+                                      const char *quants, int num_quants,
+                                      int block_len, int num_tiles,
+                                      int tile_data_size)
+{
+    int index;
+
     stream_write_uint16(s, PRO_WBT_REGION);
-    stream_seek_uint32(s); /* blockLen, set later */
+    stream_write_uint32(s, block_len); /* blockLen */
     stream_write_uint8(s, CT_TILE_64x64);
     stream_write_uint16(s, num_regions);
     stream_write_uint8(s, num_quants);
     stream_write_uint8(s, 0); /* numProgQuant */
     stream_write_uint8(s, RFX_DWT_REDUCE_EXTRAPOLATE); /* flags */
-    stream_seek_uint16(s); /* num_tiles, set later */
-    stream_seek_uint32(s); /* tileDataSize, set later */
+    stream_write_uint16(s, num_tiles); /* num_tiles */
+    stream_write_uint32(s, tile_data_size); /* tileDataSize */
     for (index = 0; index < num_regions; index++)
     {
         stream_write_uint16(s, regions[index].x);
@@ -794,6 +1330,131 @@ rfx_pro_compose_message_region(struct rfxencode *enc, STREAM *s,
         stream_write_uint16(s, regions[index].cy);
     }
     stream_write(s, quants, num_quants * 5);
+}
+
+/******************************************************************************/
+/* phase two, the history of a tile is only replaced once the tile is
+   known to fit, rfx_encode_diff_rlgr1 output does not depend on the
+   room it gets so a tile fits straight into s if it fits here
+   return tiles written or -1 on error */
+static int
+rfx_pro_gather_region(struct rfxencode *enc, STREAM *s,
+                      const struct rfx_rect *regions, int num_regions,
+                      const char *buf, int stride_bytes,
+                      const struct rfx_tile *tiles, int num_tiles,
+                      const char *quants, int num_quants)
+{
+    struct rfx_tile_slot *slot;
+    struct rfx_rb *rb;
+    int header_bytes;
+    int start_pos;
+    int end_pos;
+    int pos;
+    int tiles_written;
+    int index;
+    uint16 xIdx;
+    uint16 yIdx;
+
+    header_bytes = 18 + num_regions * 8 + num_quants * 5;
+    start_pos = stream_get_pos(s);
+    stream_seek(s, header_bytes);
+    tiles_written = 0;
+    for (index = 0; index < num_tiles; index++)
+    {
+        slot = enc->tile_slots + index;
+        xIdx = tiles[index].x / 64;
+        yIdx = tiles[index].y / 64;
+        rb = enc->rbs[xIdx][yIdx];
+        if (slot->bytes == RFX_TILE_SLOT_LATE)
+        {
+            break;
+        }
+        if (slot->bytes < 0)
+        {
+            if (stream_get_left(s) < 22)
+            {
+                break;
+            }
+            pos = stream_get_pos(s);
+            if (rfx_pro_compose_message_tile(enc, s, buf, stride_bytes,
+                                             tiles + index, quants,
+                                             rb, rb) != 0)
+            {
+                stream_set_pos(s, pos);
+                break;
+            }
+            tiles_written++;
+            continue;
+        }
+        if (stream_get_left(s) < slot->bytes)
+        {
+            break;
+        }
+        stream_write(s, slot->data, slot->bytes);
+        enc->rbs[xIdx][yIdx] = slot->rb_new;
+        slot->rb_new = rb;
+        tiles_written++;
+    }
+    if (tiles_written < 1)
+    {
+        return -1;
+    }
+    end_pos = stream_get_pos(s);
+    stream_set_pos(s, start_pos);
+    rfx_pro_compose_message_region_header(enc, s, regions, num_regions,
+                                          quants, num_quants,
+                                          end_pos - start_pos, tiles_written,
+                                          end_pos - start_pos - header_bytes);
+    stream_set_pos(s, end_pos);
+    return tiles_written;
+}
+
+/******************************************************************************/
+/* return tiles written or -1 on error */
+static int
+rfx_pro_compose_message_region(struct rfxencode *enc, STREAM *s,
+                               const struct rfx_rect *regions, int num_regions,
+                               const char *buf, int width, int height,
+                               int stride_bytes,
+                               const struct rfx_tile *tiles, int num_tiles,
+                               const char *quants, int num_quants,
+                               int flags)
+{
+    int index;
+    int start_pos;
+    int tiles_start_pos;
+    int end_pos;
+    int tiles_written;
+    uint8 quantIdxY;
+    uint8 quantIdxCb;
+    uint8 quantIdxCr;
+    int tile_end_pos;
+    uint16 xIdx;
+    uint16 yIdx;
+    struct rfx_rb *rb;
+
+    if (stream_get_left(s) < 18 + num_regions * 8 + num_quants * 5)
+    {
+        return -1;
+    }
+    if (quants == NULL)
+    {
+        num_quants = 1;
+        quants = (const char *) g_rfx_default_quantization_values;
+    }
+    if ((enc->pool != NULL) && (num_tiles > 1) &&
+        (rfx_pro_check_tiles(enc, tiles, num_tiles, num_quants) == 0) &&
+        (rfx_compose_encode_slots(enc, buf, stride_bytes, tiles, num_tiles,
+                                  quants, flags, 1) == 0))
+    {
+        return rfx_pro_gather_region(enc, s, regions, num_regions,
+                                     buf, stride_bytes, tiles, num_tiles,
+                                     quants, num_quants);
+    }
+    start_pos = stream_get_pos(s);
+    /* blockLen, num_tiles and tileDataSize set later */
+    rfx_pro_compose_message_region_header(enc, s, regions, num_regions,
+                                          quants, num_quants, 0, 0, 0);
     tiles_start_pos = stream_get_pos(s);
     tile_end_pos = -1;
     tiles_written = 0;
@@ -803,8 +1464,10 @@ rfx_pro_compose_message_region(struct rfxencode *enc, STREAM *s,
         {
             break;
         }
-        x = tiles[index].x;
-        y = tiles[index].y;
+        if ((index > 0) && rfx_compose_past_deadline(enc))
+        {
+            break;
+        }
         quantIdxY = tiles[index].quant_y;
         quantIdxCb = tiles[index].quant_cb;
         quantIdxCr = tiles[index].quant_cr;
@@ -813,29 +1476,12 @@ rfx_pro_compose_message_region(struct rfxencode *enc, STREAM *s,
         {
             return -1;
         }
-        tile_data = buf + (y << 8) * (stride_bytes >> 8) + (x << 8);
-        xIdx = x / 64;
-        yIdx = y / 64;
+        xIdx = tiles[index].x / 64;
+        yIdx = tiles[index].y / 64;
         if ((xIdx >= RFX_MAX_RB_X) || (yIdx >= RFX_MAX_RB_Y))
         {
             return -1;
         }
-        tile_start_pos = stream_get_pos(s);
-        stream_write_uint16(s, PRO_WBT_TILE_SIMPLE);
-        stream_seek_uint32(s); /* set later */
-        stream_write_uint8(s, quantIdxY);
-        stream_write_uint8(s, quantIdxCb);
-        stream_write_uint8(s, quantIdxCr);
-        stream_write_uint16(s, xIdx);
-        stream_write_uint16(s, yIdx);
-        stream_seek(s, 1); /* flags, set later */
-        stream_seek(s, 8); /* yLen, cbLen, crLen, tailLen, set later */
-        y_buffer = (const uint8 *) tile_data;
-        u_buffer = (const uint8 *) (tile_data + RFX_YUV_BTES);
-        v_buffer = (const uint8 *) (tile_data + RFX_YUV_BTES * 2);
-        y_quants = quants + quantIdxY * 5;
-        u_quants = quants + quantIdxCb * 5;
-        v_quants = quants + quantIdxCr * 5;
         rb = enc->rbs[xIdx][yIdx];
         if (rb == NULL)
         {
@@ -846,87 +1492,14 @@ rfx_pro_compose_message_region(struct rfxencode *enc, STREAM *s,
             }
             enc->rbs[xIdx][yIdx] = rb;
         }
-        rfx_rem_dwt_shift_encode(y_buffer, enc->dwt_buffer1,
-                                 enc->dwt_buffer, y_quants);
-        rfx_rem_dwt_shift_encode(u_buffer, enc->dwt_buffer2,
-                                 enc->dwt_buffer, u_quants);
-        rfx_rem_dwt_shift_encode(v_buffer, enc->dwt_buffer3,
-                                 enc->dwt_buffer, v_quants);
-        COEF_DIFF_COUNT(enc->dwt_buffer4, enc->dwt_buffer1, rb->y,
-                        jndex, dt_y_zeros, ot_y_zeros);
-        COEF_DIFF_COUNT(enc->dwt_buffer5, enc->dwt_buffer2, rb->u,
-                        jndex, dt_u_zeros, ot_u_zeros);
-        COEF_DIFF_COUNT(enc->dwt_buffer6, enc->dwt_buffer3, rb->v,
-                        jndex, dt_v_zeros, ot_v_zeros);
-        if (ot_y_zeros + ot_u_zeros + ot_v_zeros <
-            dt_y_zeros + dt_u_zeros + dt_v_zeros)
-        {
-            LLOGLN(10, ("rfx_pro_compose_message_region: diff"));
-            tile_flags = RFX_TILE_DIFFERENCE;
-            dwt_buffer_y = enc->dwt_buffer4;
-            dwt_buffer_u = enc->dwt_buffer5;
-            dwt_buffer_v = enc->dwt_buffer6;
-        }
-        else
-        {
-            LLOGLN(10, ("rfx_pro_compose_message_region: orig"));
-            tile_flags = 0;
-            dwt_buffer_y = enc->dwt_buffer1;
-            dwt_buffer_u = enc->dwt_buffer2;
-            dwt_buffer_v = enc->dwt_buffer3;
-        }
-        y_bytes = rfx_encode_diff_rlgr1(dwt_buffer_y,
-                                        stream_get_tail(s),
-                                        stream_get_left(s), 81);
-        if (y_bytes < 0)
-        {
-            break;
-        }
-        stream_seek(s, y_bytes);
-        u_bytes = rfx_encode_diff_rlgr1(dwt_buffer_u,
-                                        stream_get_tail(s),
-                                        stream_get_left(s), 81);
-        if (u_bytes < 0)
+        if (rfx_pro_compose_message_tile(enc, s, buf, stride_bytes,
+                                         tiles + index, quants,
+                                         rb, rb) != 0)
         {
             break;
         }
-        stream_seek(s, u_bytes);
-        v_bytes = rfx_encode_diff_rlgr1(dwt_buffer_v,
-                                        stream_get_tail(s),
-                                        stream_get_left(s), 81);
-        if (v_bytes < 0)
-        {
-            break;
-        }
-        stream_seek(s, v_bytes);
-        LLOGLN(10, ("rfx_pro_compose_message_region: y_bytes %d "
-               "u_bytes %d v_bytes %d", y_bytes, u_bytes, v_bytes));
         tile_end_pos = stream_get_pos(s);
-        stream_set_pos(s, tile_start_pos + 2);
-        stream_write_uint32(s, tile_end_pos - tile_start_pos); /* blockLen */
-        stream_set_pos(s, tile_start_pos + 13);
-        stream_write_uint8(s, tile_flags); /* flags */
-        stream_write_uint16(s, y_bytes); /* yLen */
-        stream_write_uint16(s, u_bytes); /* cbLen */
-        stream_write_uint16(s, v_bytes); /* crLen */
-        stream_write_uint16(s, 0); /* tailLen */
-        stream_set_pos(s, tile_end_pos);
         ++tiles_written;
-        /* update the history only after you know there is space
-           for this tile in the compressed buffer */
-        if (tile_flags == 0)
-        {
-            /* undo the diff from rfx_encode_diff_rlgr */
-            for (jndex = 4096 - 80; jndex < 4096; jndex++)
-            {
-                enc->dwt_buffer1[jndex] += enc->dwt_buffer1[jndex - 1];
-                enc->dwt_buffer2[jndex] += enc->dwt_buffer2[jndex - 1];
-                enc->dwt_buffer3[jndex] += enc->dwt_buffer3[jndex - 1];
-            }
-        }
-        memcpy(rb->y, enc->dwt_buffer1, 64 * 64 * 2);
-        memcpy(rb->u, enc->dwt_buffer2, 64 * 64 * 2);
-        memcpy(rb->v, enc->dwt_buffer3, 64 * 64 * 2);
     }
     if (tile_end_pos == -1)
     {
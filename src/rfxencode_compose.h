@@ -21,6 +21,28 @@
 
 #include "rfxcommon.h"
 
+/* two phase encoding, every tile is first encoded into its own slot, in
+   any order and on any thread, then a gather pass writes the tileset or
+   region with its final lengths and copies the tiles in order */
+#define RFX_TILE_SLOT_LATE -2
+
+struct rfx_tile_slot
+{
+    const struct rfxencode *enc;
+    const char *buf;
+    int stride_bytes;
+    const struct rfx_tile *tile;
+    const char *quantVals;
+    int flags;
+    int pro;
+    int can_skip; /* not the first tile, the deadline can skip it */
+    uint8 *data;
+    int data_alloc;
+    int bytes; /* -1 if the tile did not fit in the staging buffer,
+                  RFX_TILE_SLOT_LATE if the deadline skipped it */
+    struct rfx_rb *rb_new; /* progressive, the tile's history if sent */
+};
+
 int
 rfx_compose_message_header(struct rfxencode *enc, STREAM *s);
 int
@@ -40,5 +62,11 @@ rfx_pro_compose_message_data(struct rfxencode *enc, STREAM *s,
                              int stride_bytes,
                              const struct rfx_tile *tiles, int num_tiles,
                              const char *quants, int num_quants, int flags);
+int
+rfx_compose_past_deadline(const struct rfxencode *enc);
+void
+rfx_compose_free_slots(struct rfxencode *enc);
+void
+rfx_compose_store_slot(struct rfx_tile_slot *slot, STREAM *s);
 
 #endif
@@ -32,6 +32,8 @@
 #include <string.h>
 
 #include "rfxcommon.h"
+#include "rfxencode.h"
+#include "rfxencode_differential.h"
 #include "rfxencode_diff_rlgr1.h"
 
 #define PIXELS_IN_TILE 4096
@@ -50,6 +52,35 @@
     coef_size--; \
 } while (0)
 
+/* collect the run of zeros in the input stream, the run ends at the next
+   set bit in nz_mask, input is 0 when it goes to the end of the tile */
+#define GetZeroRun do { \
+    int lpos = PIXELS_IN_TILE - coef_size; \
+    int lword = lpos >> 5; \
+    uint32 lmask = nz_mask[lword] & (0xFFFFFFFF << (lpos & 31)); \
+    while (lmask == 0 && lword < PIXELS_IN_TILE / 32 - 1) \
+    { \
+        lword++; \
+        lmask = nz_mask[lword]; \
+    } \
+    if (lmask == 0) \
+    { \
+        numZeros = coef_size; \
+        coef += coef_size; \
+        coef_size = 0; \
+        input = 0; \
+    } \
+    else \
+    { \
+        GBSF(lmask, numZeros); \
+        numZeros += (lword << 5) - lpos; \
+        coef += numZeros; \
+        input = *coef; \
+        coef++; \
+        coef_size -= numZeros + 1; \
+    } \
+} while (0)
+
 #define CheckWrite do { \
     while (bit_count >= 8) \
     { \
@@ -109,9 +140,11 @@
     } \
 } while (0)
 
-int
-rfx_encode_diff_rlgr1(sint16 *coef, uint8 *cdata, int cdata_size,
-                      int diff_bytes)
+/* nonzero_mask is one of the rfx_encode_nonzero_mask_proc kernels */
+static RFX_ALWAYS_INLINE int
+rfx_encode_diff_rlgr1_body(sint16 *coef, uint8 *cdata, int cdata_size,
+                           int diff_bytes,
+                           rfx_encode_nonzero_mask_proc nonzero_mask)
 {
     int k;
     int kp;
@@ -130,6 +163,7 @@ rfx_encode_diff_rlgr1(sint16 *coef, uint8 *cdata, int cdata_size,
     int bit_count;
     unsigned int bits;
     uint8 *cdata_org;
+    uint32 nz_mask[PIXELS_IN_TILE / 32];
 
     uint32 twoMs;
 
@@ -138,6 +172,7 @@ rfx_encode_diff_rlgr1(sint16 *coef, uint8 *cdata, int cdata_size,
     {
         coef[k] -= coef[k - 1];
     }
+    nonzero_mask(coef, nz_mask);
 
     /* initialize the parameters */
     k = 1;
@@ -158,18 +193,7 @@ rfx_encode_diff_rlgr1(sint16 *coef, uint8 *cdata, int cdata_size,
             /* RUN-LENGTH MODE */
 
             /* collect the run of zeros in the input stream */
-            numZeros = 0;
-
-            GetNextInput;
-            while (input == 0)
-            {
-                numZeros++;
-                if (coef_size < 1)
-                {
-                    break;
-                }
-                GetNextInput;
-            }
+            GetZeroRun;
 
             /* emit output zeros */
             runmax = 1 << k;
@@ -275,3 +299,35 @@ rfx_encode_diff_rlgr1(sint16 *coef, uint8 *cdata, int cdata_size,
 
     return processed_size;
 }
+
+/*****************************************************************************/
+int
+rfx_encode_diff_rlgr1_ex(sint16 *coef, uint8 *cdata, int cdata_size,
+                         int diff_bytes,
+                         rfx_encode_nonzero_mask_proc nonzero_mask)
+{
+    return rfx_encode_diff_rlgr1_body(coef, cdata, cdata_size, diff_bytes,
+                                      nonzero_mask);
+}
+
+#if defined(RFX_USE_BMI2)
+/*****************************************************************************/
+/* rfx_encode_diff_rlgr1_ex for CPUs with LZCNT and BMI2 */
+RFX_TARGET_BMI2 int
+rfx_encode_diff_rlgr1_bmi2(sint16 *coef, uint8 *cdata, int cdata_size,
+                           int diff_bytes,
+                           rfx_encode_nonzero_mask_proc nonzero_mask)
+{
+    return rfx_encode_diff_rlgr1_body(coef, cdata, cdata_size, diff_bytes,
+                                      nonzero_mask);
+}
+#endif
+
+/*****************************************************************************/
+int
+rfx_encode_diff_rlgr1(sint16 *coef, uint8 *cdata, int cdata_size,
+                      int diff_bytes)
+{
+    return rfx_encode_diff_rlgr1_ex(coef, cdata, cdata_size, diff_bytes,
+                                    rfx_encode_nonzero_mask);
+}
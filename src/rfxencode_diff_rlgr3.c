@@ -32,6 +32,8 @@
 #include <string.h>
 
 #include "rfxcommon.h"
+#include "rfxencode.h"
+#include "rfxencode_differential.h"
 #include "rfxencode_diff_rlgr3.h"
 
 #define PIXELS_IN_TILE 4096
@@ -45,9 +47,45 @@
 #define DQ_GR   (3)   /* decrease in kp after zero symbol in GR mode */
 
 #define GetNextInput do { \
-    input = *coef; \
-    coef++; \
-    coef_size--; \
+    if (coef_size > 0) \
+    { \
+        input = *coef; \
+        coef++; \
+        coef_size--; \
+    } \
+    else \
+    { \
+        input = 0; \
+    } \
+} while (0)
+
+/* collect the run of zeros in the input stream, the run ends at the next
+   set bit in nz_mask, input is 0 when it goes to the end of the tile */
+#define GetZeroRun do { \
+    int lpos = PIXELS_IN_TILE - coef_size; \
+    int lword = lpos >> 5; \
+    uint32 lmask = nz_mask[lword] & (0xFFFFFFFF << (lpos & 31)); \
+    while (lmask == 0 && lword < PIXELS_IN_TILE / 32 - 1) \
+    { \
+        lword++; \
+        lmask = nz_mask[lword]; \
+    } \
+    if (lmask == 0) \
+    { \
+        numZeros = coef_size; \
+        coef += coef_size; \
+        coef_size = 0; \
+        input = 0; \
+    } \
+    else \
+    { \
+        GBSF(lmask, numZeros); \
+        numZeros += (lword << 5) - lpos; \
+        coef += numZeros; \
+        input = *coef; \
+        coef++; \
+        coef_size -= numZeros + 1; \
+    } \
 } while (0)
 
 #define CheckWrite do { \
@@ -109,9 +147,11 @@
     } \
 } while (0)
 
-int
-rfx_encode_diff_rlgr3(sint16 *coef, uint8 *cdata, int cdata_size,
-                      int diff_bytes)
+/* nonzero_mask is one of the rfx_encode_nonzero_mask_proc kernels */
+static RFX_ALWAYS_INLINE int
+rfx_encode_diff_rlgr3_body(sint16 *coef, uint8 *cdata, int cdata_size,
+                           int diff_bytes,
+                           rfx_encode_nonzero_mask_proc nonzero_mask)
 {
     int k;
     int kp;
@@ -130,6 +170,7 @@ rfx_encode_diff_rlgr3(sint16 *coef, uint8 *cdata, int cdata_size,
     int bit_count;
     unsigned int bits;
     uint8 *cdata_org;
+    uint32 nz_mask[PIXELS_IN_TILE / 32];
 
     uint32 twoMs1;
     uint32 twoMs2;
@@ -141,6 +182,7 @@ rfx_encode_diff_rlgr3(sint16 *coef, uint8 *cdata, int cdata_size,
     {
         coef[k] -= coef[k - 1];
     }
+    nonzero_mask(coef, nz_mask);
 
     /* initialize the parameters */
     k = 1;
@@ -161,18 +203,7 @@ rfx_encode_diff_rlgr3(sint16 *coef, uint8 *cdata, int cdata_size,
             /* RUN-LENGTH MODE */
 
             /* collect the run of zeros in the input stream */
-            numZeros = 0;
-
-            GetNextInput;
-            while (input == 0)
-            {
-                numZeros++;
-                if (coef_size < 1)
-                {
-                    break;
-                }
-                GetNextInput;
-            }
+            GetZeroRun;
 
             /* emit output zeros */
             runmax = 1 << k;
@@ -261,15 +292,8 @@ rfx_encode_diff_rlgr3(sint16 *coef, uint8 *cdata, int cdata_size,
             CheckWrite;
 
             /* encode binary representation of the first input (twoMs1). */
-            if (sum2Ms != 0)
-            {
-                GBSR(sum2Ms, nIdx);
-                nIdx++;
-            }
-            else
-            {
-                nIdx = 0;
-            }
+            /* bit count of sum2Ms, 0 for 0, lzcnt with RFX_TARGET_BMI2 */
+            GBSR((sum2Ms << 1) | 1, nIdx);
 
             bits <<= nIdx;
             bits |= twoMs1;
@@ -312,3 +336,35 @@ rfx_encode_diff_rlgr3(sint16 *coef, uint8 *cdata, int cdata_size,
 
     return processed_size;
 }
+
+/*****************************************************************************/
+int
+rfx_encode_diff_rlgr3_ex(sint16 *coef, uint8 *cdata, int cdata_size,
+                         int diff_bytes,
+                         rfx_encode_nonzero_mask_proc nonzero_mask)
+{
+    return rfx_encode_diff_rlgr3_body(coef, cdata, cdata_size, diff_bytes,
+                                      nonzero_mask);
+}
+
+#if defined(RFX_USE_BMI2)
+/*****************************************************************************/
+/* rfx_encode_diff_rlgr3_ex for CPUs with LZCNT and BMI2 */
+RFX_TARGET_BMI2 int
+rfx_encode_diff_rlgr3_bmi2(sint16 *coef, uint8 *cdata, int cdata_size,
+                           int diff_bytes,
+                           rfx_encode_nonzero_mask_proc nonzero_mask)
+{
+    return rfx_encode_diff_rlgr3_body(coef, cdata, cdata_size, diff_bytes,
+                                      nonzero_mask);
+}
+#endif
+
+/*****************************************************************************/
+int
+rfx_encode_diff_rlgr3(sint16 *coef, uint8 *cdata, int cdata_size,
+                      int diff_bytes)
+{
+    return rfx_encode_diff_rlgr3_ex(coef, cdata, cdata_size, diff_bytes,
+                                    rfx_encode_nonzero_mask);
+}
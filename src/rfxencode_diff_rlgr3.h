@@ -21,10 +21,21 @@
 #define __RFX_DIFF_RLGR3_H
 
 #include "rfxcommon.h"
+#include "rfxencode.h"
 
 int
 rfx_encode_diff_rlgr3(sint16 *coef, uint8 *cdata, int cdata_size,
                       int diff_bytes);
+int
+rfx_encode_diff_rlgr3_ex(sint16 *coef, uint8 *cdata, int cdata_size,
+                         int diff_bytes,
+                         rfx_encode_nonzero_mask_proc nonzero_mask);
+#if defined(RFX_USE_BMI2)
+int
+rfx_encode_diff_rlgr3_bmi2(sint16 *coef, uint8 *cdata, int cdata_size,
+                           int diff_bytes,
+                           rfx_encode_nonzero_mask_proc nonzero_mask);
+#endif
 
 #endif /* __RFX_DIFF_RLGR3_H */
 
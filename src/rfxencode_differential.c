@@ -47,3 +47,71 @@ rfx_differential_encode(sint16 *buffer, int buffer_size)
     }
     return 0;
 }
+
+/******************************************************************************/
+/* progressive, diff = coefs - history (QCdt = QCot - QCrb) over the 4096
+   coefficients, history_out = coefs when not NULL
+   the zeros in diff and coefs are counted over the first 4096 - 81, the
+   LL3 band is left out */
+int
+rfx_differential_pro_encode(const sint16 *coefs, const sint16 *history,
+                            sint16 *diff, sint16 *history_out,
+                            int *diff_zeros, int *coef_zeros)
+{
+    int index;
+    int dzeros;
+    int czeros;
+    sint16 coef;
+    sint16 delta;
+
+    dzeros = 0;
+    czeros = 0;
+    for (index = 0; index < 4096 - 81; index++)
+    {
+        coef = coefs[index];
+        delta = coef - history[index];
+        diff[index] = delta;
+        if (delta == 0)
+        {
+            dzeros++;
+        }
+        if (coef == 0)
+        {
+            czeros++;
+        }
+    }
+    for (; index < 4096; index++)
+    {
+        diff[index] = coefs[index] - history[index];
+    }
+    if (history_out != NULL)
+    {
+        memcpy(history_out, coefs, 4096 * sizeof(sint16));
+    }
+    *diff_zeros = dzeros;
+    *coef_zeros = czeros;
+    return 0;
+}
+
+/******************************************************************************/
+/* mask bit (index & 31) of word (index >> 5) is set when coefs[index] is not
+   zero, used by the RLGR coders to find the end of a zero run */
+int
+rfx_encode_nonzero_mask(const sint16 *coefs, uint32 *mask)
+{
+    int index;
+    int jndex;
+    uint32 bits;
+
+    for (index = 0; index < 4096 / 32; index++)
+    {
+        bits = 0;
+        for (jndex = 0; jndex < 32; jndex++)
+        {
+            bits |= (uint32) (coefs[jndex] != 0) << jndex;
+        }
+        mask[index] = bits;
+        coefs += 32;
+    }
+    return 0;
+}
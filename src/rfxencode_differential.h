@@ -24,5 +24,11 @@
 
 int
 rfx_differential_encode(sint16 *buffer, int buffer_size);
+int
+rfx_differential_pro_encode(const sint16 *coefs, const sint16 *history,
+                            sint16 *diff, sint16 *history_out,
+                            int *diff_zeros, int *coef_zeros);
+int
+rfx_encode_nonzero_mask(const sint16 *coefs, uint32 *mask);
 
 #endif /* __RFXENCODE_DIFFERENTIAL_H */
@@ -30,20 +30,63 @@
 #include "rfxencode_dwt.h"
 
 /******************************************************************************/
+/* rfx_quantization_encode_block on one value, _h is 0 when _f is 0 */
+#define QUANT(_v, _f, _h) ((sint16) ((((sint16) (_v)) + (_h)) >> (_f)))
+
+/******************************************************************************/
+/* one row of the horizontal DWT, src is 2 * width wide, the H half goes to
+   hi and the L half to lo, each quantised by its shift and half as it is
+   made, hn1 and hn hold the whole high values the low pass uses */
+static void
+rfx_dwt_2d_encode_horz_row(const sint16 *RFX_RESTRICT src,
+                           sint16 *RFX_RESTRICT lo, sint16 *RFX_RESTRICT hi,
+                           int width, int lshift, int lhalf,
+                           int hshift, int hhalf)
+{
+    sint16 hn1, hn;
+    int x;
+    int n;
+
+    /* pre */
+    hn = (src[1] - ((src[0] + src[2]) >> 1)) >> 1;
+    hi[0] = QUANT(hn, hshift, hhalf);
+    lo[0] = QUANT(src[0] + hn, lshift, lhalf);
+
+    /* loop */
+    for (n = 1; n < width - 1; n++)
+    {
+        x = n << 1;
+        hn1 = hn;
+        hn = (src[x + 1] - ((src[x] + src[x + 2]) >> 1)) >> 1;
+        hi[n] = QUANT(hn, hshift, hhalf);
+        lo[n] = QUANT(src[x] + ((hn1 + hn) >> 1), lshift, lhalf);
+    }
+
+    /* post */
+    n = width - 1;
+    x = n << 1;
+    hn1 = hn;
+    hn = (src[x + 1] - ((src[x] + src[x]) >> 1)) >> 1;
+    hi[n] = QUANT(hn, hshift, hhalf);
+    lo[n] = QUANT(src[x] + ((hn1 + hn) >> 1), lshift, lhalf);
+}
+
+/******************************************************************************/
+/* DWT in horizontal direction, results in 4 sub-bands in HL(0), LH(1),
+   HH(2), LL(3) order, the lower part L generates LL and HL, the higher part
+   H generates LH and HH, shift and half quantise each sub-band in that
+   order, ll_diff does the rfx_differential_encode of LL a row at a time */
 static int
-rfx_dwt_2d_encode_horz(const sint16 *in_buffer, sint16 *out_buffer,
-                       int subband_width)
+rfx_dwt_2d_encode_horz_quant(const sint16 *in_buffer, sint16 *out_buffer,
+                             int subband_width, const int *shift,
+                             const int *half, int ll_diff)
 {
     const sint16 *l_src, *h_src;
     sint16 *hl, *lh, *hh, *ll;
-    int x, y;
+    sint16 prev, val;
+    int y;
     int n;
 
-    /* DWT in horizontal direction, results in 4 sub-bands in
-     * HL(0), LH(1), HH(2), LL(3) order, stored in original buffer. */
-    /* The lower part L generates LL(3) and HL(0). */
-    /* The higher part H generates LH(1) and HH(2). */
-
     ll = out_buffer + subband_width * subband_width * 3;
     hl = out_buffer;
     l_src = in_buffer;
@@ -52,45 +95,23 @@ rfx_dwt_2d_encode_horz(const sint16 *in_buffer, sint16 *out_buffer,
     hh = out_buffer + subband_width * subband_width * 2;
     h_src = in_buffer + subband_width * subband_width * 2;
 
+    prev = 0;
     for (y = 0; y < subband_width; y++)
     {
-
-        /* pre */
-        hl[0] = (l_src[1] - ((l_src[0] + l_src[2]) >> 1)) >> 1;
-        ll[0] = l_src[0] + hl[0];
-
-        /* loop */
-        for (n = 1; n < subband_width - 1; n++)
-        {
-            x = n << 1;
-            hl[n] = (l_src[x + 1] - ((l_src[x] + l_src[x + 2]) >> 1)) >> 1;
-            ll[n] = l_src[x] + ((hl[n - 1] + hl[n]) >> 1);
-        }
-
-        /* post */
-        n = subband_width - 1;
-        x = n << 1;
-        hl[n] = (l_src[x + 1] - ((l_src[x] + l_src[x]) >> 1)) >> 1;
-        ll[n] = l_src[x] + ((hl[n - 1] + hl[n]) >> 1);
-
-        /* pre */
-        hh[0] = (h_src[1] - ((h_src[0] + h_src[2]) >> 1)) >> 1;
-        lh[0] = h_src[0] + hh[0];
-
-        /* loop */
-        for (n = 1; n < subband_width - 1; n++)
+        rfx_dwt_2d_encode_horz_row(l_src, ll, hl, subband_width,
+                                   shift[3], half[3], shift[0], half[0]);
+        rfx_dwt_2d_encode_horz_row(h_src, lh, hh, subband_width,
+                                   shift[1], half[1], shift[2], half[2]);
+        if (ll_diff)
         {
-            x = n << 1;
-            hh[n] = (h_src[x + 1] - ((h_src[x] + h_src[x + 2]) >> 1)) >> 1;
-            lh[n] = h_src[x] + ((hh[n - 1] + hh[n]) >> 1);
+            for (n = 0; n < subband_width; n++)
+            {
+                val = ll[n];
+                ll[n] = val - prev;
+                prev = val;
+            }
         }
 
-        /* post */
-        n = subband_width - 1;
-        x = n << 1;
-        hh[n] = (h_src[x + 1] - ((h_src[x] + h_src[x]) >> 1)) >> 1;
-        lh[n] = h_src[x] + ((hh[n - 1] + hh[n]) >> 1);
-
         ll += subband_width;
         hl += subband_width;
         l_src += subband_width << 1;
@@ -104,114 +125,170 @@ rfx_dwt_2d_encode_horz(const sint16 *in_buffer, sint16 *out_buffer,
 
 /******************************************************************************/
 static int
-rfx_dwt_2d_encode_block(sint16 *in_out_buffer, sint16 *tmp_buffer,
-                        int subband_width)
+rfx_dwt_2d_encode_horz(const sint16 *in_buffer, sint16 *out_buffer,
+                       int subband_width)
 {
-    sint16 *src, *l, *h;
+    static const int zero[4] = { 0, 0, 0, 0 };
+
+    return rfx_dwt_2d_encode_horz_quant(in_buffer, out_buffer, subband_width,
+                                        zero, zero, 0);
+}
+
+/******************************************************************************/
+/* one row pair of the vertical DWT, s0, s1 and s2 are rows 2n, 2n + 1 and
+   2n + 2, hp is the H row of pair n - 1 or NULL for the first pair */
+static void
+rfx_dwt_2d_encode_vert_row(const sint16 *RFX_RESTRICT s0,
+                           const sint16 *RFX_RESTRICT s1,
+                           const sint16 *RFX_RESTRICT s2,
+                           const sint16 *RFX_RESTRICT hp,
+                           sint16 *RFX_RESTRICT l, sint16 *RFX_RESTRICT h,
+                           int width)
+{
+    sint16 hx;
+    int x;
+
+    if (hp == NULL)
+    {
+        for (x = 0; x < width; x++)
+        {
+            hx = (s1[x] - ((s0[x] + s2[x]) >> 1)) >> 1;
+            h[x] = hx;
+            l[x] = s0[x] + hx;
+        }
+    }
+    else
+    {
+        for (x = 0; x < width; x++)
+        {
+            hx = (s1[x] - ((s0[x] + s2[x]) >> 1)) >> 1;
+            h[x] = hx;
+            l[x] = s0[x] + ((hp[x] + hx) >> 1);
+        }
+    }
+}
+
+/******************************************************************************/
+static int
+rfx_dwt_2d_encode_vert(const sint16 *in_buffer, sint16 *tmp_buffer,
+                       int subband_width)
+{
+    const sint16 *s0;
+    sint16 *l, *h;
     int total_width;
-    int x, y;
     int n;
 
     total_width = subband_width << 1;
 
     /* DWT in vertical direction, results in 2 sub-bands in L, H order in
-     * tmp buffer. */
-    for (x = 0; x < total_width; x++)
+     * tmp buffer, a row pair at a time so the inner loop runs along the
+     * rows */
+    l = tmp_buffer;
+    h = l + subband_width * total_width;
+    s0 = in_buffer;
+    rfx_dwt_2d_encode_vert_row(s0, s0 + total_width, s0 + 2 * total_width,
+                               NULL, l, h, total_width);
+    for (n = 1; n < subband_width; n++)
     {
+        l += total_width;
+        h += total_width;
+        s0 += 2 * total_width;
+        rfx_dwt_2d_encode_vert_row(s0, s0 + total_width,
+                                   n < subband_width - 1 ?
+                                   s0 + 2 * total_width : s0, /* mirror */
+                                   h - total_width, l, h, total_width);
+    }
+    return 0;
+}
+
+/******************************************************************************/
+static int
+rfx_dwt_2d_encode_block(sint16 *in_out_buffer, sint16 *tmp_buffer,
+                        int subband_width)
+{
+    rfx_dwt_2d_encode_vert(in_out_buffer, tmp_buffer, subband_width);
+    return rfx_dwt_2d_encode_horz(tmp_buffer, in_out_buffer, subband_width);
+}
 
-        /* pre */
-        l = tmp_buffer + x;
-        h = l + subband_width * total_width;
-        src = in_out_buffer + x;
-        *h = (src[total_width] - ((src[0] + src[2 * total_width]) >> 1)) >> 1;
-        *l = src[0] + (*h);
+/******************************************************************************/
+/* rfx_dwt_2d_encode_vert_row for the 8 bit level 1 input */
+static void
+rfx_dwt_2d_encode_vert8_row(const uint8 *RFX_RESTRICT s0,
+                            const uint8 *RFX_RESTRICT s1,
+                            const uint8 *RFX_RESTRICT s2,
+                            const sint16 *RFX_RESTRICT hp,
+                            sint16 *RFX_RESTRICT l, sint16 *RFX_RESTRICT h,
+                            int width)
+{
+    sint16 t0, t1, t2;
+    sint16 hx;
+    int x;
 
-        /* loop */
-        for (n = 1; n < subband_width - 1; n++)
+    if (hp == NULL)
+    {
+        for (x = 0; x < width; x++)
         {
-            y = n << 1;
-            l = tmp_buffer + n * total_width + x;
-            h = l + subband_width * total_width;
-            src = in_out_buffer + y * total_width + x;
-            *h = (src[total_width] - ((src[0] + src[2 * total_width]) >> 1)) >> 1;
-            *l = src[0] + ((*(h - total_width) + *h) >> 1);
+            t0 = (s0[x] - 128) << DWT_FACTOR;
+            t1 = (s1[x] - 128) << DWT_FACTOR;
+            t2 = (s2[x] - 128) << DWT_FACTOR;
+            hx = (t1 - ((t0 + t2) >> 1)) >> 1;
+            h[x] = hx;
+            l[x] = t0 + hx;
+        }
+    }
+    else
+    {
+        for (x = 0; x < width; x++)
+        {
+            t0 = (s0[x] - 128) << DWT_FACTOR;
+            t1 = (s1[x] - 128) << DWT_FACTOR;
+            t2 = (s2[x] - 128) << DWT_FACTOR;
+            hx = (t1 - ((t0 + t2) >> 1)) >> 1;
+            h[x] = hx;
+            l[x] = t0 + ((hp[x] + hx) >> 1);
         }
-
-        /* post */
-        n = subband_width - 1;
-        y = n << 1;
-        l = tmp_buffer + n * total_width + x;
-        h = l + subband_width * total_width;
-        src = in_out_buffer + y * total_width + x;
-        *h = (src[total_width] - ((src[0] + src[0]) >> 1)) >> 1;
-        *l = src[0] + ((*(h - total_width) + *h) >> 1);
-
     }
-
-    return rfx_dwt_2d_encode_horz(tmp_buffer, in_out_buffer, subband_width);
 }
 
 /******************************************************************************/
 static int
-rfx_dwt_2d_encode_block8(const uint8 *in_buffer,
-                         sint16 *out_buffer, sint16 *tmp_buffer,
-                         int subband_width)
+rfx_dwt_2d_encode_vert8(const uint8 *in_buffer, sint16 *tmp_buffer,
+                        int subband_width)
 {
-    const uint8 *src;
+    const uint8 *s0;
     sint16 *l, *h;
-    sint16 s1, s2, s3;
     int total_width;
-    int x, y;
     int n;
 
     total_width = subband_width << 1;
 
     /* DWT in vertical direction, results in 2 sub-bands in L, H order in
-     * tmp buffer. */
-    for (x = 0; x < total_width; x++)
+     * tmp buffer, see rfx_dwt_2d_encode_vert */
+    l = tmp_buffer;
+    h = l + subband_width * total_width;
+    s0 = in_buffer;
+    rfx_dwt_2d_encode_vert8_row(s0, s0 + total_width, s0 + 2 * total_width,
+                                NULL, l, h, total_width);
+    for (n = 1; n < subband_width; n++)
     {
-
-        /* pre */
-        l = tmp_buffer + x;
-        h = l + subband_width * total_width;
-        src = in_buffer + x;
-        s1 = (src[total_width] - 128) << DWT_FACTOR;
-        s2 = (src[0] - 128) << DWT_FACTOR;
-        s3 = (src[2 * total_width] - 128) << DWT_FACTOR;
-        *h = (s1 - ((s2 + s3) >> 1)) >> 1;
-        s1 = (src[0] - 128) << DWT_FACTOR;
-        *l = s1 + *h;
-
-        /* loop */
-        for (n = 1; n < subband_width - 1; n++)
-        {
-            y = n << 1;
-            l = tmp_buffer + n * total_width + x;
-            h = l + subband_width * total_width;
-            src = in_buffer + y * total_width + x;
-            s1 = (src[total_width] - 128) << DWT_FACTOR;
-            s2 = (src[0] - 128) << DWT_FACTOR;
-            s3 = (src[2 * total_width] - 128) << DWT_FACTOR;
-            *h = (s1 - ((s2 + s3) >> 1)) >> 1;
-            s1 = (src[0] - 128) << DWT_FACTOR;
-            *l = s1 + ((*(h - total_width) + *h) >> 1);
-        }
-
-        /* post */
-        n = subband_width - 1;
-        y = n << 1;
-        l = tmp_buffer + n * total_width + x;
-        h = l + subband_width * total_width;
-        src = in_buffer + y * total_width + x;
-        s1 = (src[total_width] - 128) << DWT_FACTOR;
-        s2 = (src[0] - 128) << DWT_FACTOR;
-        s3 = (src[0] - 128) << DWT_FACTOR;
-        *h = (s1 - ((s2 + s3) >> 1)) >> 1;
-        s1 = (src[0] - 128) << DWT_FACTOR;
-        *l = s1 + ((*(h - total_width) + *h) >> 1);
-
+        l += total_width;
+        h += total_width;
+        s0 += 2 * total_width;
+        rfx_dwt_2d_encode_vert8_row(s0, s0 + total_width,
+                                    n < subband_width - 1 ?
+                                    s0 + 2 * total_width : s0, /* mirror */
+                                    h - total_width, l, h, total_width);
     }
+    return 0;
+}
 
+/******************************************************************************/
+static int
+rfx_dwt_2d_encode_block8(const uint8 *in_buffer,
+                         sint16 *out_buffer, sint16 *tmp_buffer,
+                         int subband_width)
+{
+    rfx_dwt_2d_encode_vert8(in_buffer, tmp_buffer, subband_width);
     return rfx_dwt_2d_encode_horz(tmp_buffer, out_buffer, subband_width);
 }
 
@@ -225,3 +302,106 @@ rfx_dwt_2d_encode(const uint8 *in_buffer, sint16 *out_buffer,
     rfx_dwt_2d_encode_block(out_buffer + 3840, tmp_buffer, 8);
     return 0;
 }
+
+/******************************************************************************/
+/* row pair n of the level 1 vertical pass of rfx_dwt_2d_encode_block8 for
+   the three components, s0, s1 and s2 are source rows 2n, 2n + 1 and
+   2n + 2, each the y, u then v 64 bytes, for the last pair s2 is s0
+   the L and H rows go where rfx_dwt_2d_encode_block8 puts them in its
+   tmp_buffer */
+int
+rfx_dwt_2d_encode_v1_rows(const uint8 *s0, const uint8 *s1, const uint8 *s2,
+                          int n, sint16 *y_v1, sint16 *u_v1, sint16 *v_v1)
+{
+    sint16 *v1[3];
+    sint16 *l, *h;
+    int c;
+
+    v1[0] = y_v1;
+    v1[1] = u_v1;
+    v1[2] = v_v1;
+    for (c = 0; c < 3; c++)
+    {
+        l = v1[c] + n * 64;
+        h = l + 32 * 64;
+        rfx_dwt_2d_encode_vert8_row(s0, s1, s2, n == 0 ? NULL : h - 64,
+                                    l, h, 64);
+        s0 += 64;
+        s1 += 64;
+        s2 += 64;
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/* rest of rfx_dwt_2d_encode after the level 1 vertical pass, v1_buffer holds
+   the L and H rows as rfx_dwt_2d_encode_block8 leaves them in tmp_buffer and
+   is used as tmp_buffer for levels 2 and 3 */
+int
+rfx_dwt_2d_encode_h1(sint16 *v1_buffer, sint16 *out_buffer)
+{
+    rfx_dwt_2d_encode_horz(v1_buffer, out_buffer, 32);
+    rfx_dwt_2d_encode_block(out_buffer + 3072, v1_buffer, 16);
+    rfx_dwt_2d_encode_block(out_buffer + 3840, v1_buffer, 8);
+    return 0;
+}
+
+/******************************************************************************/
+/* shift and rounding add rfx_quantization_encode_block uses for the 4 bit
+   quant value q */
+static void
+rfx_dwt_quant_factor(int q, int *shift, int *half)
+{
+    uint32 factor;
+
+    factor = (q & 0xf) - 6 + DWT_FACTOR;
+    *shift = factor;
+    *half = factor == 0 ? 0 : 1 << (factor - 1);
+}
+
+/******************************************************************************/
+/* rfx_dwt_2d_encode_h1, rfx_quantization_encode and the LL3
+   rfx_differential_encode in one pass, each high sub-band is quantised as
+   the horizontal pass makes it and LL3 is quantised and differenced by the
+   level 3 pass, out_buffer is ready for the RLGR coder */
+int
+rfx_dwt_2d_encode_h1_quant(sint16 *v1_buffer, sint16 *out_buffer,
+                           const char *qtable)
+{
+    int shift[4];
+    int half[4];
+
+    rfx_dwt_quant_factor(qtable[4], shift + 0, half + 0); /* HL1 */
+    rfx_dwt_quant_factor(qtable[3] >> 4, shift + 1, half + 1); /* LH1 */
+    rfx_dwt_quant_factor(qtable[4] >> 4, shift + 2, half + 2); /* HH1 */
+    shift[3] = 0;
+    half[3] = 0;
+    rfx_dwt_2d_encode_horz_quant(v1_buffer, out_buffer, 32, shift, half, 0);
+
+    rfx_dwt_quant_factor(qtable[2] >> 4, shift + 0, half + 0); /* HL2 */
+    rfx_dwt_quant_factor(qtable[2], shift + 1, half + 1); /* LH2 */
+    rfx_dwt_quant_factor(qtable[3], shift + 2, half + 2); /* HH2 */
+    rfx_dwt_2d_encode_vert(out_buffer + 3072, v1_buffer, 16);
+    rfx_dwt_2d_encode_horz_quant(v1_buffer, out_buffer + 3072, 16,
+                                 shift, half, 0);
+
+    rfx_dwt_quant_factor(qtable[1], shift + 0, half + 0); /* HL3 */
+    rfx_dwt_quant_factor(qtable[0] >> 4, shift + 1, half + 1); /* LH3 */
+    rfx_dwt_quant_factor(qtable[1] >> 4, shift + 2, half + 2); /* HH3 */
+    rfx_dwt_quant_factor(qtable[0], shift + 3, half + 3); /* LL3 */
+    rfx_dwt_2d_encode_vert(out_buffer + 3840, v1_buffer, 8);
+    rfx_dwt_2d_encode_horz_quant(v1_buffer, out_buffer + 3840, 8,
+                                 shift, half, 1);
+    return 0;
+}
+
+/******************************************************************************/
+/* rfx_dwt_2d_encode, rfx_quantization_encode and the LL3
+   rfx_differential_encode in one pass, see rfx_dwt_2d_encode_h1_quant */
+int
+rfx_dwt_2d_encode_quant(const uint8 *in_buffer, sint16 *out_buffer,
+                        sint16 *tmp_buffer, const char *qtable)
+{
+    rfx_dwt_2d_encode_vert8(in_buffer, tmp_buffer, 32);
+    return rfx_dwt_2d_encode_h1_quant(tmp_buffer, out_buffer, qtable);
+}
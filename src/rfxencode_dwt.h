@@ -22,5 +22,16 @@
 int
 rfx_dwt_2d_encode(const uint8 *in_buffer, sint16 *out_buffer,
                   sint16 *tmp_buffer);
+int
+rfx_dwt_2d_encode_v1_rows(const uint8 *s0, const uint8 *s1, const uint8 *s2,
+                          int n, sint16 *y_v1, sint16 *u_v1, sint16 *v_v1);
+int
+rfx_dwt_2d_encode_h1(sint16 *v1_buffer, sint16 *out_buffer);
+int
+rfx_dwt_2d_encode_h1_quant(sint16 *v1_buffer, sint16 *out_buffer,
+                           const char *qtable);
+int
+rfx_dwt_2d_encode_quant(const uint8 *in_buffer, sint16 *out_buffer,
+                        sint16 *tmp_buffer, const char *qtable);
 
 #endif
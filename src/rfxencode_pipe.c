@@ -0,0 +1,556 @@
+/**
+ * RFX codec encoder
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * three stage tile pipeline
+ * stage 1, calling thread, colour conversion into planes
+ * stage 2, own thread, DWT and quantisation into coefficients
+ * stage 3, own thread, entropy coding into the tile's slot
+ */
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <pthread.h>
+
+#include <rfxcodec_encode.h>
+
+#include "rfxcommon.h"
+#include "rfxencode.h"
+#include "rfxconstants.h"
+#include "rfxencode_tile.h"
+#include "rfxencode_alpha.h"
+#include "rfxencode_compose.h"
+#include "rfxencode_pipe.h"
+
+#define LLOG_LEVEL 1
+#define LLOGLN(_level, _args) \
+    do { if (_level < LLOG_LEVEL) { printf _args ; printf("\n"); } } while (0)
+
+#define RFX_PIPE_RING_SIZE 8
+
+#define RFX_PIPE_TILE 0
+#define RFX_PIPE_SKIP 1 /* tile failed in an earlier stage */
+#define RFX_PIPE_SYNC 2 /* end of rfx_pipe_run's tiles */
+#define RFX_PIPE_EXIT 3
+
+/* colour converted tile, stage 1 to 2 */
+struct rfx_pipe_planes
+{
+    int cmd;
+    struct rfx_tile_slot *slot;
+    const uint8 *y;
+    const uint8 *u;
+    const uint8 *v;
+    const uint8 *a;
+    uint8 y_buffer[4096];
+    uint8 u_buffer[4096];
+    uint8 v_buffer[4096];
+    uint8 a_buffer[4096];
+};
+
+/* quantised coefficients, stage 2 to 3 */
+struct rfx_pipe_coefs
+{
+    int cmd;
+    struct rfx_tile_slot *slot;
+    sint16 *y; /* 16 byte aligned in coefs_a */
+    sint16 *u;
+    sint16 *v;
+    const uint8 *a;
+    uint8 a_buffer[4096];
+    sint16 coefs_a[4096 * 3 + 8];
+};
+
+/* bounded single producer single consumer ring, the entries are filled
+   and read in place, full and empty can not both be waited on so one
+   cond is enough */
+struct rfx_pipe_ring
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    void *entries[RFX_PIPE_RING_SIZE];
+    int head;
+    int count;
+};
+
+struct rfx_pipe
+{
+    struct rfx_pipe_ring planes_ring;
+    struct rfx_pipe_ring coefs_ring;
+    struct rfx_pipe_planes planes[RFX_PIPE_RING_SIZE];
+    struct rfx_pipe_coefs coefs[RFX_PIPE_RING_SIZE];
+    struct rfxencode *dwt_scratch;
+    struct rfxencode *entropy_scratch;
+    pthread_t dwt_thread;
+    pthread_t entropy_thread;
+    int dwt_started;
+    int entropy_started;
+    pthread_mutex_t mutex;
+    pthread_cond_t done_cond;
+    int done;
+};
+
+/******************************************************************************/
+static void
+rfx_pipe_ring_init(struct rfx_pipe_ring *ring, void *entries,
+                   int entry_bytes)
+{
+    int index;
+
+    pthread_mutex_init(&ring->mutex, NULL);
+    pthread_cond_init(&ring->cond, NULL);
+    for (index = 0; index < RFX_PIPE_RING_SIZE; index++)
+    {
+        ring->entries[index] = ((char *) entries) + index * entry_bytes;
+    }
+}
+
+/******************************************************************************/
+static void
+rfx_pipe_ring_deinit(struct rfx_pipe_ring *ring)
+{
+    pthread_cond_destroy(&ring->cond);
+    pthread_mutex_destroy(&ring->mutex);
+}
+
+/******************************************************************************/
+/* producer, wait for a free entry */
+static void *
+rfx_pipe_ring_get_free(struct rfx_pipe_ring *ring)
+{
+    void *entry;
+
+    pthread_mutex_lock(&ring->mutex);
+    while (ring->count >= RFX_PIPE_RING_SIZE)
+    {
+        pthread_cond_wait(&ring->cond, &ring->mutex);
+    }
+    entry = ring->entries[(ring->head + ring->count) % RFX_PIPE_RING_SIZE];
+    pthread_mutex_unlock(&ring->mutex);
+    return entry;
+}
+
+/******************************************************************************/
+/* producer, hand the entry from rfx_pipe_ring_get_free to the consumer */
+static void
+rfx_pipe_ring_push(struct rfx_pipe_ring *ring)
+{
+    pthread_mutex_lock(&ring->mutex);
+    ring->count++;
+    pthread_cond_signal(&ring->cond);
+    pthread_mutex_unlock(&ring->mutex);
+}
+
+/******************************************************************************/
+/* consumer, wait for the oldest entry */
+static void *
+rfx_pipe_ring_get_used(struct rfx_pipe_ring *ring)
+{
+    void *entry;
+
+    pthread_mutex_lock(&ring->mutex);
+    while (ring->count < 1)
+    {
+        pthread_cond_wait(&ring->cond, &ring->mutex);
+    }
+    entry = ring->entries[ring->head];
+    pthread_mutex_unlock(&ring->mutex);
+    return entry;
+}
+
+/******************************************************************************/
+/* consumer, give the entry from rfx_pipe_ring_get_used back */
+static void
+rfx_pipe_ring_pop(struct rfx_pipe_ring *ring)
+{
+    pthread_mutex_lock(&ring->mutex);
+    ring->head = (ring->head + 1) % RFX_PIPE_RING_SIZE;
+    ring->count--;
+    pthread_cond_signal(&ring->cond);
+    pthread_mutex_unlock(&ring->mutex);
+}
+
+/******************************************************************************/
+/* stage 1 */
+static int
+rfx_pipe_convert(struct rfxencode *enc, struct rfx_tile_slot *slot,
+                 struct rfx_pipe_planes *planes)
+{
+    const struct rfx_tile *tile;
+    const char *tile_data;
+
+    tile = slot->tile;
+    if (enc->format == RFX_FORMAT_YUV)
+    {
+        tile_data = slot->buf + (tile->y << 8) * (slot->stride_bytes >> 8) +
+                    (tile->x << 8);
+        planes->y = (const uint8 *) tile_data;
+        planes->u = (const uint8 *) (tile_data + RFX_YUV_BTES);
+        planes->v = (const uint8 *) (tile_data + RFX_YUV_BTES * 2);
+        planes->a = (const uint8 *) (tile_data + RFX_YUV_BTES * 3);
+        return 0;
+    }
+    tile_data = slot->buf + tile->y * slot->stride_bytes +
+                tile->x * (enc->bits_per_pixel / 8);
+    if (slot->flags & RFX_FLAGS_ALPHAV1)
+    {
+        if (enc->rfx_encode_argb_to_yuva(enc, tile_data, tile->cx, tile->cy,
+                                         slot->stride_bytes) != 0)
+        {
+            return 1;
+        }
+        memcpy(planes->a_buffer, enc->a_buffer, 4096);
+    }
+    else
+    {
+        if (enc->rfx_encode_rgb_to_yuv(enc, tile_data, tile->cx, tile->cy,
+                                       slot->stride_bytes) != 0)
+        {
+            return 1;
+        }
+    }
+    memcpy(planes->y_buffer, enc->y_r_buffer, 4096);
+    memcpy(planes->u_buffer, enc->u_g_buffer, 4096);
+    memcpy(planes->v_buffer, enc->v_b_buffer, 4096);
+    planes->y = planes->y_buffer;
+    planes->u = planes->u_buffer;
+    planes->v = planes->v_buffer;
+    planes->a = planes->a_buffer;
+    return 0;
+}
+
+/******************************************************************************/
+/* stage 2 */
+static int
+rfx_pipe_dwt(struct rfxencode *scratch, const struct rfx_pipe_planes *planes,
+             struct rfx_pipe_coefs *coefs)
+{
+    const struct rfx_tile *tile;
+    const char *quantVals;
+
+    tile = planes->slot->tile;
+    quantVals = planes->slot->quantVals;
+    if (scratch->rfx_encode_dwt(scratch, quantVals + tile->quant_y * 5,
+                                planes->y, coefs->y) != 0)
+    {
+        return 1;
+    }
+    if (scratch->rfx_encode_dwt(scratch, quantVals + tile->quant_cb * 5,
+                                planes->u, coefs->u) != 0)
+    {
+        return 1;
+    }
+    if (scratch->rfx_encode_dwt(scratch, quantVals + tile->quant_cr * 5,
+                                planes->v, coefs->v) != 0)
+    {
+        return 1;
+    }
+    if (planes->slot->flags & RFX_FLAGS_ALPHAV1)
+    {
+        coefs->a = planes->a;
+        if (planes->a == planes->a_buffer)
+        {
+            /* the planes entry gets reused */
+            memcpy(coefs->a_buffer, planes->a_buffer, 4096);
+            coefs->a = coefs->a_buffer;
+        }
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/* stage 3, same tile layout as rfx_compose_message_tile_rgb and
+   rfx_compose_message_tile_argb */
+static void
+rfx_pipe_entropy(struct rfxencode *scratch, struct rfx_pipe_coefs *coefs)
+{
+    struct rfx_tile_slot *slot;
+    const struct rfx_tile *tile;
+    sint16 *comps[3];
+    int lens[3];
+    int alpha;
+    int a_len;
+    int index;
+    STREAM s;
+
+    slot = coefs->slot;
+    tile = slot->tile;
+    if (scratch->tile_stage == NULL)
+    {
+        scratch->tile_stage = (uint8 *) malloc(RFX_TILE_STAGE_BYTES);
+        if (scratch->tile_stage == NULL)
+        {
+            return;
+        }
+    }
+    s.data = scratch->tile_stage;
+    s.p = s.data;
+    s.size = RFX_TILE_STAGE_BYTES;
+    alpha = slot->flags & RFX_FLAGS_ALPHAV1;
+    stream_seek(&s, alpha ? 21 : 19);
+    comps[0] = coefs->y;
+    comps[1] = coefs->u;
+    comps[2] = coefs->v;
+    for (index = 0; index < 3; index++)
+    {
+        if (stream_get_left(&s) < TILE_SIZE_UPPER_LIMIT)
+        {
+            return;
+        }
+        if (scratch->rfx_encode_entropy(scratch, comps[index],
+                                        stream_get_tail(&s),
+                                        stream_get_left(&s),
+                                        lens + index) != 0)
+        {
+            return;
+        }
+        stream_seek(&s, lens[index]);
+    }
+    a_len = 0;
+    if (alpha)
+    {
+        a_len = rfx_encode_plane(scratch, coefs->a, 64, 64, &s);
+    }
+    index = stream_get_pos(&s);
+    stream_set_pos(&s, 0);
+    stream_write_uint16(&s, CBT_TILE); /* BlockT.blockType */
+    stream_write_uint32(&s, 19 + lens[0] + lens[1] + lens[2] + a_len);
+    stream_write_uint8(&s, tile->quant_y);
+    stream_write_uint8(&s, tile->quant_cb);
+    stream_write_uint8(&s, tile->quant_cr);
+    stream_write_uint16(&s, tile->x / 64);
+    stream_write_uint16(&s, tile->y / 64);
+    stream_write_uint16(&s, lens[0]);
+    stream_write_uint16(&s, lens[1]);
+    stream_write_uint16(&s, lens[2]);
+    if (alpha)
+    {
+        stream_write_uint16(&s, a_len);
+    }
+    stream_set_pos(&s, index);
+    rfx_compose_store_slot(slot, &s);
+}
+
+/******************************************************************************/
+static void *
+rfx_pipe_dwt_loop(void *arg)
+{
+    struct rfx_pipe *pipe;
+    struct rfx_pipe_planes *planes;
+    struct rfx_pipe_coefs *coefs;
+    int cmd;
+
+    pipe = (struct rfx_pipe *) arg;
+    do
+    {
+        planes = (struct rfx_pipe_planes *)
+                 rfx_pipe_ring_get_used(&(pipe->planes_ring));
+        coefs = (struct rfx_pipe_coefs *)
+                rfx_pipe_ring_get_free(&(pipe->coefs_ring));
+        cmd = planes->cmd;
+        if (cmd == RFX_PIPE_TILE)
+        {
+            rfxencode_scratch_setup(pipe->dwt_scratch, planes->slot->enc);
+            if (rfx_pipe_dwt(pipe->dwt_scratch, planes, coefs) != 0)
+            {
+                cmd = RFX_PIPE_SKIP;
+            }
+        }
+        coefs->cmd = cmd;
+        coefs->slot = planes->slot;
+        rfx_pipe_ring_push(&(pipe->coefs_ring));
+        rfx_pipe_ring_pop(&(pipe->planes_ring));
+    } while (cmd != RFX_PIPE_EXIT);
+    return 0;
+}
+
+/******************************************************************************/
+static void *
+rfx_pipe_entropy_loop(void *arg)
+{
+    struct rfx_pipe *pipe;
+    struct rfx_pipe_coefs *coefs;
+    int cmd;
+
+    pipe = (struct rfx_pipe *) arg;
+    do
+    {
+        coefs = (struct rfx_pipe_coefs *)
+                rfx_pipe_ring_get_used(&(pipe->coefs_ring));
+        cmd = coefs->cmd;
+        if (cmd == RFX_PIPE_TILE)
+        {
+            rfxencode_scratch_setup(pipe->entropy_scratch, coefs->slot->enc);
+            rfx_pipe_entropy(pipe->entropy_scratch, coefs);
+        }
+        else if (cmd == RFX_PIPE_SYNC)
+        {
+            pthread_mutex_lock(&pipe->mutex);
+            pipe->done = 1;
+            pthread_cond_signal(&pipe->done_cond);
+            pthread_mutex_unlock(&pipe->mutex);
+        }
+        rfx_pipe_ring_pop(&(pipe->coefs_ring));
+    } while (cmd != RFX_PIPE_EXIT);
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_pipe_create(struct rfx_pipe **pipe)
+{
+    struct rfx_pipe *self;
+    int index;
+
+    self = xnew(struct rfx_pipe);
+    if (self == NULL)
+    {
+        return 1;
+    }
+    rfx_pipe_ring_init(&(self->planes_ring), self->planes,
+                       sizeof(struct rfx_pipe_planes));
+    rfx_pipe_ring_init(&(self->coefs_ring), self->coefs,
+                       sizeof(struct rfx_pipe_coefs));
+    for (index = 0; index < RFX_PIPE_RING_SIZE; index++)
+    {
+        self->coefs[index].y = (sint16 *)
+                               ((((size_t) (self->coefs[index].coefs_a)) +
+                                 15) & ~15);
+        self->coefs[index].u = self->coefs[index].y + 4096;
+        self->coefs[index].v = self->coefs[index].u + 4096;
+    }
+    pthread_mutex_init(&self->mutex, NULL);
+    pthread_cond_init(&self->done_cond, NULL);
+    if ((rfxencode_scratch_create(&(self->dwt_scratch)) != 0) ||
+        (rfxencode_scratch_create(&(self->entropy_scratch)) != 0))
+    {
+        rfx_pipe_destroy(self);
+        return 1;
+    }
+    if (pthread_create(&(self->dwt_thread), NULL,
+                       rfx_pipe_dwt_loop, self) != 0)
+    {
+        rfx_pipe_destroy(self);
+        return 1;
+    }
+    self->dwt_started = 1;
+    if (pthread_create(&(self->entropy_thread), NULL,
+                       rfx_pipe_entropy_loop, self) != 0)
+    {
+        rfx_pipe_destroy(self);
+        return 1;
+    }
+    self->entropy_started = 1;
+    LLOGLN(10, ("rfx_pipe_create: ok"));
+    *pipe = self;
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_pipe_destroy(struct rfx_pipe *pipe)
+{
+    struct rfx_pipe_planes *planes;
+    struct rfx_pipe_coefs *coefs;
+
+    if (pipe == NULL)
+    {
+        return 0;
+    }
+    if (pipe->dwt_started)
+    {
+        planes = (struct rfx_pipe_planes *)
+                 rfx_pipe_ring_get_free(&(pipe->planes_ring));
+        planes->cmd = RFX_PIPE_EXIT;
+        planes->slot = NULL;
+        rfx_pipe_ring_push(&(pipe->planes_ring));
+        pthread_join(pipe->dwt_thread, NULL);
+    }
+    else if (pipe->entropy_started)
+    {
+        coefs = (struct rfx_pipe_coefs *)
+                rfx_pipe_ring_get_free(&(pipe->coefs_ring));
+        coefs->cmd = RFX_PIPE_EXIT;
+        coefs->slot = NULL;
+        rfx_pipe_ring_push(&(pipe->coefs_ring));
+    }
+    if (pipe->entropy_started)
+    {
+        pthread_join(pipe->entropy_thread, NULL);
+    }
+    rfxencode_scratch_destroy(pipe->dwt_scratch);
+    rfxencode_scratch_destroy(pipe->entropy_scratch);
+    pthread_cond_destroy(&pipe->done_cond);
+    pthread_mutex_destroy(&pipe->mutex);
+    rfx_pipe_ring_deinit(&(pipe->planes_ring));
+    rfx_pipe_ring_deinit(&(pipe->coefs_ring));
+    free(pipe);
+    return 0;
+}
+
+/******************************************************************************/
+/* encode the tiles of slots into the slots, colour conversion happens
+   here on enc, the calling thread only gets ahead of stage 2 by the
+   ring size */
+int
+rfx_pipe_run(struct rfx_pipe *pipe, struct rfxencode *enc,
+             struct rfx_tile_slot *slots, int num_slots)
+{
+    struct rfx_pipe_planes *planes;
+    int index;
+
+    for (index = 0; index < num_slots; index++)
+    {
+        if (slots[index].can_skip && rfx_compose_past_deadline(enc))
+        {
+            while (index < num_slots)
+            {
+                slots[index].bytes = RFX_TILE_SLOT_LATE;
+                index++;
+            }
+            break;
+        }
+        slots[index].bytes = -1;
+        planes = (struct rfx_pipe_planes *)
+                 rfx_pipe_ring_get_free(&(pipe->planes_ring));
+        planes->cmd = RFX_PIPE_TILE;
+        planes->slot = slots + index;
+        if (rfx_pipe_convert(enc, slots + index, planes) != 0)
+        {
+            planes->cmd = RFX_PIPE_SKIP;
+        }
+        rfx_pipe_ring_push(&(pipe->planes_ring));
+    }
+    planes = (struct rfx_pipe_planes *)
+             rfx_pipe_ring_get_free(&(pipe->planes_ring));
+    planes->cmd = RFX_PIPE_SYNC;
+    planes->slot = NULL;
+    rfx_pipe_ring_push(&(pipe->planes_ring));
+    pthread_mutex_lock(&pipe->mutex);
+    while (!pipe->done)
+    {
+        pthread_cond_wait(&pipe->done_cond, &pipe->mutex);
+    }
+    pipe->done = 0;
+    pthread_mutex_unlock(&pipe->mutex);
+    return 0;
+}
@@ -0,0 +1,34 @@
+/**
+ * RFX codec encoder
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __RFXENCODE_PIPE_H
+#define __RFXENCODE_PIPE_H
+
+struct rfxencode;
+struct rfx_pipe;
+struct rfx_tile_slot;
+
+int
+rfx_pipe_create(struct rfx_pipe **pipe);
+int
+rfx_pipe_destroy(struct rfx_pipe *pipe);
+int
+rfx_pipe_run(struct rfx_pipe *pipe, struct rfxencode *enc,
+             struct rfx_tile_slot *slots, int num_slots);
+
+#endif
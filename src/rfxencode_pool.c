@@ -0,0 +1,779 @@
+/**
+ * RFX codec encoder
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * worker threads, each with its own scratch encoder context
+ *
+ * every handle using the pool has a session with its own job queue, a
+ * thread whose own deque is empty refills it with a few jobs of the
+ * session picked by weighted fair queuing, a session whose oldest job is
+ * past its latency target goes first, only the refill takes the pool
+ * mutex, a thread that finds nothing there steals from the back of the
+ * other threads' deques
+ *
+ * on numa hosts each thread is kept on the cpus of one node, creates its
+ * scratch context there and looks a few jobs past the head of the queue
+ * for a tile whose source is in that node's memory
+ */
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include <pthread.h>
+
+#include <rfxcodec_encode.h>
+
+#include "rfxcommon.h"
+#include "rfxencode.h"
+#include "rfxencode_pool.h"
+#include "rfxencode_topo.h"
+
+#define LLOG_LEVEL 1
+#define LLOGLN(_level, _args) \
+    do { if (_level < LLOG_LEVEL) { printf _args ; printf("\n"); } } while (0)
+
+/* virtual time a job of a weight 1 session costs */
+#define RFX_POOL_VTIME_JOB 65536
+/* jobs past the head a thread looks at for one on its own node */
+#define RFX_POOL_NODE_SCAN 8
+/* most jobs a refill moves to a thread's deque, a late session waits for
+   at most this many jobs of each thread */
+#define RFX_POOL_REFILL 4
+
+/* the caller of rfx_pool_run waits on its own batch, threads only lock
+   it once per job they finish */
+struct rfx_pool_batch
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t done_cond;
+    int jobs_left;
+};
+
+struct rfx_pool_job
+{
+    rfx_pool_job_proc proc;
+    void *arg;
+    struct rfxencode *enc;
+    struct rfx_pool_session *session;
+    struct rfx_pool_batch *batch;
+    uint32 queued_us;
+    int node; /* of the tile's source, -1 if not known */
+};
+
+struct rfx_pool_session
+{
+    struct rfx_pool *pool;
+    struct rfx_pool_job *jobs; /* ring */
+    int jobs_alloc;
+    int jobs_head;
+    int jobs_count;
+    int weight;
+    int latency_us; /* 0 for none */
+    /* virtual finish time of the next job, wraps, compare with
+       RFX_POOL_VTIME_BEFORE */
+    uint32 vtime;
+    struct rfx_pool_session *next_active;
+    int active;
+    int jobs_done;
+    int wait_us_avg;
+    int wait_us_max; /* since the last rfx_pool_session_get_stats */
+};
+
+/* the owner takes from the front, others steal from the back, only the
+   owner refills it and only when it is empty */
+struct rfx_pool_deque
+{
+    pthread_mutex_t mutex;
+    struct rfx_pool_job jobs[RFX_POOL_REFILL];
+    int jobs_head;
+    int jobs_count;
+};
+
+struct rfx_pool_thread
+{
+    struct rfx_pool *pool;
+    struct rfxencode *scratch;
+    struct rfx_pool_deque deque;
+    int index;
+    pthread_t thread;
+    int started;
+    int node; /* -1 if not pinned */
+};
+
+struct rfx_pool
+{
+    pthread_mutex_t mutex; /* sessions, vclock and shutdown */
+    pthread_cond_t work_cond;
+    pthread_cond_t ready_cond;
+    int threads_ready;
+    int threads_failed;
+    struct rfx_pool_session *active; /* sessions with jobs queued */
+    uint32 vclock; /* vtime of the last job taken */
+    int shutdown;
+    int num_threads;
+    int threads_alloc;
+    struct rfx_pool_thread *threads;
+    int num_nodes; /* with cpus, 1 if not numa */
+    int cpu_nodes[RFX_TOPO_MAX_CPUS];
+};
+
+#define RFX_POOL_VTIME_BEFORE(_a, _b) (((sint32) ((_a) - (_b))) < 0)
+
+/******************************************************************************/
+uint32
+rfx_pool_get_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint32) ts.tv_sec) * 1000000 + (uint32) (ts.tv_nsec / 1000);
+}
+
+/******************************************************************************/
+/* pool->mutex must be held */
+static int
+rfx_pool_session_push(struct rfx_pool_session *session,
+                      rfx_pool_job_proc proc, void *arg,
+                      struct rfxencode *enc, struct rfx_pool_batch *batch,
+                      uint32 now, int node)
+{
+    struct rfx_pool_job *jobs;
+    struct rfx_pool_job *job;
+    int jobs_alloc;
+    int index;
+
+    if (session->jobs_count >= session->jobs_alloc)
+    {
+        /* grow and unwrap the ring */
+        jobs_alloc = session->jobs_alloc + 64;
+        jobs = (struct rfx_pool_job *)
+               malloc(jobs_alloc * sizeof(struct rfx_pool_job));
+        if (jobs == NULL)
+        {
+            return 1;
+        }
+        for (index = 0; index < session->jobs_count; index++)
+        {
+            jobs[index] = session->jobs[(session->jobs_head + index) %
+                                        session->jobs_alloc];
+        }
+        free(session->jobs);
+        session->jobs = jobs;
+        session->jobs_alloc = jobs_alloc;
+        session->jobs_head = 0;
+    }
+    job = session->jobs + (session->jobs_head + session->jobs_count) %
+          session->jobs_alloc;
+    job->proc = proc;
+    job->arg = arg;
+    job->enc = enc;
+    job->session = session;
+    job->batch = batch;
+    job->queued_us = now;
+    job->node = node;
+    session->jobs_count++;
+    return 0;
+}
+
+/******************************************************************************/
+/* pool->mutex must be held
+   a session that was idle starts at the current virtual time so it can
+   not save up a share while it has nothing queued */
+static void
+rfx_pool_session_activate(struct rfx_pool_session *session)
+{
+    struct rfx_pool *pool;
+
+    pool = session->pool;
+    if (session->active || (session->jobs_count < 1))
+    {
+        return;
+    }
+    if (RFX_POOL_VTIME_BEFORE(session->vtime, pool->vclock))
+    {
+        session->vtime = pool->vclock;
+    }
+    session->next_active = pool->active;
+    pool->active = session;
+    session->active = 1;
+}
+
+/******************************************************************************/
+/* pool->mutex must be held
+   a job of session on node moves to the head if there is one close to it
+   so it is the one taken */
+static void
+rfx_pool_session_prefer_node(struct rfx_pool_session *session, int node)
+{
+    struct rfx_pool_job job;
+    int index;
+    int jndex;
+
+    for (index = 0; (index < session->jobs_count) &&
+            (index < RFX_POOL_NODE_SCAN); index++)
+    {
+        jndex = (session->jobs_head + index) % session->jobs_alloc;
+        if (session->jobs[jndex].node == node)
+        {
+            if (index > 0)
+            {
+                job = session->jobs[jndex];
+                session->jobs[jndex] = session->jobs[session->jobs_head];
+                session->jobs[session->jobs_head] = job;
+            }
+            return;
+        }
+    }
+}
+
+/******************************************************************************/
+/* pool->mutex must be held
+   the session past its latency target by the most, else the one with
+   the earliest virtual finish time, NULL if nothing is queued */
+static struct rfx_pool_session *
+rfx_pool_pick_session(struct rfx_pool *pool, uint32 now)
+{
+    struct rfx_pool_session *session;
+    struct rfx_pool_session *pick;
+    int late_us;
+    int pick_late_us;
+    int wait_us;
+
+    if (pool->active == NULL)
+    {
+        return NULL;
+    }
+    pick = NULL;
+    pick_late_us = 0;
+    for (session = pool->active; session != NULL;
+            session = session->next_active)
+    {
+        if (session->latency_us > 0)
+        {
+            wait_us = (int) (now -
+                             session->jobs[session->jobs_head].queued_us);
+            late_us = wait_us - session->latency_us;
+            if (late_us > pick_late_us)
+            {
+                pick = session;
+                pick_late_us = late_us;
+            }
+        }
+    }
+    if (pick == NULL)
+    {
+        pick = pool->active;
+        for (session = pick->next_active; session != NULL;
+                session = session->next_active)
+        {
+            if (RFX_POOL_VTIME_BEFORE(session->vtime, pick->vtime))
+            {
+                pick = session;
+            }
+        }
+    }
+    return pick;
+}
+
+/******************************************************************************/
+/* pool->mutex must be held
+   take the head job of session, which must have one, and charge it
+   node is the calling thread's, -1 for any */
+static void
+rfx_pool_session_take(struct rfx_pool_session *session, int node,
+                      uint32 now, struct rfx_pool_job *job)
+{
+    struct rfx_pool *pool;
+    struct rfx_pool_session **link;
+    int wait_us;
+
+    pool = session->pool;
+    if (node >= 0)
+    {
+        rfx_pool_session_prefer_node(session, node);
+    }
+    *job = session->jobs[session->jobs_head];
+    session->jobs_head = (session->jobs_head + 1) % session->jobs_alloc;
+    session->jobs_count--;
+    pool->vclock = session->vtime;
+    session->vtime += RFX_POOL_VTIME_JOB / session->weight;
+    wait_us = (int) (now - job->queued_us);
+    session->wait_us_avg += (wait_us - session->wait_us_avg) / 16;
+    session->wait_us_max = MAX(session->wait_us_max, wait_us);
+    if (session->jobs_count < 1)
+    {
+        for (link = &(pool->active); *link != session;
+                link = &((*link)->next_active))
+        {
+        }
+        *link = session->next_active;
+        session->next_active = NULL;
+        session->active = 0;
+    }
+}
+
+/******************************************************************************/
+/* pool->mutex must be held, thread's deque must be empty
+   a thread takes about its share of the picked session's jobs so the
+   others find some left, each is charged on its own so the weights hold
+   returns the number of jobs moved */
+static int
+rfx_pool_refill(struct rfx_pool_thread *thread)
+{
+    struct rfx_pool *pool;
+    struct rfx_pool_session *session;
+    struct rfx_pool_job jobs[RFX_POOL_REFILL];
+    uint32 now;
+    int count;
+    int index;
+
+    pool = thread->pool;
+    if (pool->active == NULL)
+    {
+        return 0;
+    }
+    now = rfx_pool_get_us();
+    session = rfx_pool_pick_session(pool, now);
+    count = session->jobs_count / pool->num_threads;
+    count = MAX(count, 1);
+    count = MIN(count, RFX_POOL_REFILL);
+    for (index = 0; index < count; index++)
+    {
+        rfx_pool_session_take(session, thread->node, now, jobs + index);
+    }
+    pthread_mutex_lock(&(thread->deque.mutex));
+    memcpy(thread->deque.jobs, jobs, count * sizeof(struct rfx_pool_job));
+    thread->deque.jobs_head = 0;
+    thread->deque.jobs_count = count;
+    pthread_mutex_unlock(&(thread->deque.mutex));
+    return count;
+}
+
+/******************************************************************************/
+/* the owner takes from the front, a thief from the back
+   returns 1 if the deque is empty */
+static int
+rfx_pool_deque_pop(struct rfx_pool_deque *deque, int own,
+                   struct rfx_pool_job *job)
+{
+    int rv;
+
+    rv = 1;
+    pthread_mutex_lock(&(deque->mutex));
+    if (deque->jobs_count > 0)
+    {
+        if (own)
+        {
+            *job = deque->jobs[deque->jobs_head];
+            deque->jobs_head++;
+        }
+        else
+        {
+            *job = deque->jobs[deque->jobs_head + deque->jobs_count - 1];
+        }
+        deque->jobs_count--;
+        rv = 0;
+    }
+    pthread_mutex_unlock(&(deque->mutex));
+    return rv;
+}
+
+/******************************************************************************/
+/* own deque, then a refill from the sessions, then steal
+   returns 1 if there is nothing to do */
+static int
+rfx_pool_get_job(struct rfx_pool_thread *thread, struct rfx_pool_job *job)
+{
+    struct rfx_pool *pool;
+    int count;
+    int index;
+
+    pool = thread->pool;
+    if (rfx_pool_deque_pop(&(thread->deque), 1, job) == 0)
+    {
+        return 0;
+    }
+    pthread_mutex_lock(&(pool->mutex));
+    count = rfx_pool_refill(thread);
+    pthread_mutex_unlock(&(pool->mutex));
+    if ((count > 0) && (rfx_pool_deque_pop(&(thread->deque), 1, job) == 0))
+    {
+        return 0;
+    }
+    for (index = 1; index < pool->num_threads; index++)
+    {
+        if (rfx_pool_deque_pop(&(pool->threads[(thread->index + index) %
+                                               pool->num_threads].deque),
+                               0, job) == 0)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/******************************************************************************/
+static void *
+rfx_pool_thread_loop(void *arg)
+{
+    struct rfx_pool_thread *thread;
+    struct rfx_pool *pool;
+    struct rfx_pool_batch *batch;
+    struct rfx_pool_job job;
+
+    thread = (struct rfx_pool_thread *) arg;
+    pool = thread->pool;
+    if ((thread->node >= 0) &&
+            (rfx_topo_pin_thread(pool->cpu_nodes, RFX_TOPO_MAX_CPUS,
+                                 thread->node) != 0))
+    {
+        thread->node = -1;
+    }
+    /* created here so it is in this node's memory */
+    if (rfxencode_scratch_create(&(thread->scratch)) != 0)
+    {
+        thread->scratch = NULL;
+    }
+    pthread_mutex_lock(&pool->mutex);
+    pool->threads_ready++;
+    if (thread->scratch == NULL)
+    {
+        pool->threads_failed++;
+    }
+    pthread_cond_broadcast(&pool->ready_cond);
+    while ((pool->threads_ready < pool->num_threads) && !pool->shutdown)
+    {
+        pthread_cond_wait(&pool->ready_cond, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    for (;;)
+    {
+        if (thread->scratch == NULL)
+        {
+            break;
+        }
+        if (rfx_pool_get_job(thread, &job) == 0)
+        {
+            rfxencode_scratch_setup(thread->scratch, job.enc);
+            job.proc(thread->scratch, job.arg);
+            batch = job.batch;
+            pthread_mutex_lock(&(batch->mutex));
+            batch->jobs_left--;
+            if (batch->jobs_left == 0)
+            {
+                pthread_cond_signal(&(batch->done_cond));
+            }
+            pthread_mutex_unlock(&(batch->mutex));
+            continue;
+        }
+        /* jobs left in other deques are run by their owners */
+        pthread_mutex_lock(&pool->mutex);
+        while ((pool->active == NULL) && !pool->shutdown)
+        {
+            pthread_cond_wait(&pool->work_cond, &pool->mutex);
+        }
+        if ((pool->active == NULL) && pool->shutdown)
+        {
+            pthread_mutex_unlock(&pool->mutex);
+            break;
+        }
+        pthread_mutex_unlock(&pool->mutex);
+    }
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_pool_get_num_cpus(void)
+{
+    int num_cpus;
+
+    num_cpus = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    return MAX(num_cpus, 1);
+}
+
+/******************************************************************************/
+/* num_threads 0 means one per online cpu */
+int
+rfx_pool_create(int num_threads, struct rfx_pool **pool)
+{
+    struct rfx_pool *self;
+    struct rfx_pool_thread *thread;
+    int nodes[RFX_TOPO_MAX_NODES];
+    int index;
+    int rv;
+
+    if (num_threads < 1)
+    {
+        num_threads = rfx_pool_get_num_cpus();
+    }
+    self = xnew(struct rfx_pool);
+    if (self == NULL)
+    {
+        return 1;
+    }
+    pthread_mutex_init(&self->mutex, NULL);
+    pthread_cond_init(&self->work_cond, NULL);
+    pthread_cond_init(&self->ready_cond, NULL);
+    /* the nodes with cpus, in order, the threads go round them */
+    rfx_topo_get_cpu_nodes(self->cpu_nodes, RFX_TOPO_MAX_CPUS);
+    memset(nodes, 0, sizeof(nodes));
+    for (index = 0; index < RFX_TOPO_MAX_CPUS; index++)
+    {
+        if (self->cpu_nodes[index] >= 0)
+        {
+            nodes[self->cpu_nodes[index]] = 1;
+        }
+    }
+    self->num_nodes = 0;
+    for (index = 0; index < RFX_TOPO_MAX_NODES; index++)
+    {
+        if (nodes[index])
+        {
+            nodes[self->num_nodes++] = index;
+        }
+    }
+    self->threads = (struct rfx_pool_thread *)
+                    calloc(num_threads, sizeof(struct rfx_pool_thread));
+    if (self->threads == NULL)
+    {
+        rfx_pool_destroy(self);
+        return 1;
+    }
+    self->threads_alloc = num_threads;
+    for (index = 0; index < num_threads; index++)
+    {
+        pthread_mutex_init(&(self->threads[index].deque.mutex), NULL);
+    }
+    /* threads steal from each other so all deques must exist first */
+    self->num_threads = num_threads;
+    for (index = 0; index < num_threads; index++)
+    {
+        thread = self->threads + index;
+        thread->pool = self;
+        thread->index = index;
+        thread->node = -1;
+        if (self->num_nodes > 1)
+        {
+            thread->node = nodes[index % self->num_nodes];
+        }
+        if (pthread_create(&(thread->thread), NULL,
+                           rfx_pool_thread_loop, thread) != 0)
+        {
+            rfx_pool_destroy(self);
+            return 1;
+        }
+        thread->started = 1;
+    }
+    pthread_mutex_lock(&self->mutex);
+    while (self->threads_ready < num_threads)
+    {
+        pthread_cond_wait(&self->ready_cond, &self->mutex);
+    }
+    rv = self->threads_failed;
+    pthread_mutex_unlock(&self->mutex);
+    if (rv != 0)
+    {
+        rfx_pool_destroy(self);
+        return 1;
+    }
+    LLOGLN(10, ("rfx_pool_create: started %d threads on %d nodes",
+                num_threads, self->num_nodes));
+    *pool = self;
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_pool_destroy(struct rfx_pool *pool)
+{
+    struct rfx_pool_thread *thread;
+    int index;
+
+    if (pool == NULL)
+    {
+        return 0;
+    }
+    pthread_mutex_lock(&pool->mutex);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_cond_broadcast(&pool->ready_cond);
+    pthread_mutex_unlock(&pool->mutex);
+    if (pool->threads != NULL)
+    {
+        for (index = 0; index < pool->threads_alloc; index++)
+        {
+            thread = pool->threads + index;
+            if (thread->started)
+            {
+                pthread_join(thread->thread, NULL);
+            }
+            rfxencode_scratch_destroy(thread->scratch);
+            pthread_mutex_destroy(&(thread->deque.mutex));
+        }
+        free(pool->threads);
+    }
+    pthread_cond_destroy(&pool->ready_cond);
+    pthread_cond_destroy(&pool->work_cond);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool);
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_pool_get_num_threads(struct rfx_pool *pool)
+{
+    return pool->num_threads;
+}
+
+/******************************************************************************/
+/* numa nodes the threads are spread over, 1 if not numa */
+int
+rfx_pool_get_num_nodes(struct rfx_pool *pool)
+{
+    return MAX(pool->num_nodes, 1);
+}
+
+/******************************************************************************/
+int
+rfx_pool_session_create(struct rfx_pool *pool, int weight, int latency_ms,
+                        struct rfx_pool_session **session)
+{
+    struct rfx_pool_session *self;
+
+    self = xnew(struct rfx_pool_session);
+    if (self == NULL)
+    {
+        return 1;
+    }
+    self->pool = pool;
+    *session = self;
+    rfx_pool_session_set_share(self, weight, latency_ms);
+    return 0;
+}
+
+/******************************************************************************/
+/* no rfx_pool_run can be in progress on session */
+int
+rfx_pool_session_destroy(struct rfx_pool_session *session)
+{
+    if (session == NULL)
+    {
+        return 0;
+    }
+    free(session->jobs);
+    free(session);
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_pool_session_set_share(struct rfx_pool_session *session,
+                           int weight, int latency_ms)
+{
+    weight = MAX(weight, 1);
+    latency_ms = MAX(latency_ms, 0);
+    pthread_mutex_lock(&(session->pool->mutex));
+    session->weight = weight;
+    session->latency_us = latency_ms * 1000;
+    pthread_mutex_unlock(&(session->pool->mutex));
+    return 0;
+}
+
+/******************************************************************************/
+int
+rfx_pool_session_get_stats(struct rfx_pool_session *session,
+                           int *queue_depth, int *jobs_done,
+                           int *wait_us_avg, int *wait_us_max)
+{
+    pthread_mutex_lock(&(session->pool->mutex));
+    *queue_depth = session->jobs_count;
+    *jobs_done = session->jobs_done;
+    *wait_us_avg = session->wait_us_avg;
+    *wait_us_max = session->wait_us_max;
+    session->wait_us_max = 0;
+    pthread_mutex_unlock(&(session->pool->mutex));
+    return 0;
+}
+
+/******************************************************************************/
+/* queue the jobs on session and wait for all of them, any number of
+   threads can call this on the same pool at the same time, each with
+   its own session
+   nodes is the numa node of each job's source memory, can be NULL */
+int
+rfx_pool_run(struct rfx_pool_session *session, struct rfxencode *enc,
+             rfx_pool_job_proc proc, void **args, const int *nodes,
+             int num_jobs)
+{
+    struct rfx_pool *pool;
+    struct rfx_pool_batch batch;
+    uint32 now;
+    int jobs_queued;
+    int index;
+
+    if (num_jobs < 1)
+    {
+        return 0;
+    }
+    pool = session->pool;
+    pthread_mutex_init(&(batch.mutex), NULL);
+    pthread_cond_init(&(batch.done_cond), NULL);
+    jobs_queued = 0;
+    now = rfx_pool_get_us();
+    pthread_mutex_lock(&pool->mutex);
+    for (index = 0; index < num_jobs; index++)
+    {
+        if (rfx_pool_session_push(session, proc, args[index], enc,
+                                  &batch, now,
+                                  (nodes == NULL) ? -1 : nodes[index]) != 0)
+        {
+            break;
+        }
+        jobs_queued++;
+    }
+    /* no thread can take one before the pool mutex is let go */
+    batch.jobs_left = jobs_queued;
+    rfx_pool_session_activate(session);
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->mutex);
+    /* the jobs that did not make it are run here */
+    for (index = jobs_queued; index < num_jobs; index++)
+    {
+        proc(enc, args[index]);
+    }
+    pthread_mutex_lock(&(batch.mutex));
+    while (batch.jobs_left > 0)
+    {
+        pthread_cond_wait(&(batch.done_cond), &(batch.mutex));
+    }
+    pthread_mutex_unlock(&(batch.mutex));
+    pthread_cond_destroy(&(batch.done_cond));
+    pthread_mutex_destroy(&(batch.mutex));
+    /* counted here, once per run, not by the threads */
+    pthread_mutex_lock(&pool->mutex);
+    session->jobs_done += jobs_queued;
+    pthread_mutex_unlock(&pool->mutex);
+    return 0;
+}
@@ -0,0 +1,60 @@
+/**
+ * RFX codec encoder
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __RFXENCODE_POOL_H
+#define __RFXENCODE_POOL_H
+
+struct rfxencode;
+struct rfx_pool;
+struct rfx_pool_session;
+
+/* scratch is the worker's own context, set up to encode like the handle
+   the job came from */
+typedef void (*rfx_pool_job_proc)(struct rfxencode *scratch, void *arg);
+
+/* monotonic clock in microseconds, wraps, compare differences */
+uint32
+rfx_pool_get_us(void);
+int
+rfx_pool_get_num_cpus(void);
+int
+rfx_pool_create(int num_threads, struct rfx_pool **pool);
+int
+rfx_pool_destroy(struct rfx_pool *pool);
+int
+rfx_pool_get_num_threads(struct rfx_pool *pool);
+int
+rfx_pool_get_num_nodes(struct rfx_pool *pool);
+int
+rfx_pool_session_create(struct rfx_pool *pool, int weight, int latency_ms,
+                        struct rfx_pool_session **session);
+int
+rfx_pool_session_destroy(struct rfx_pool_session *session);
+int
+rfx_pool_session_set_share(struct rfx_pool_session *session,
+                           int weight, int latency_ms);
+int
+rfx_pool_session_get_stats(struct rfx_pool_session *session,
+                           int *queue_depth, int *jobs_done,
+                           int *wait_us_avg, int *wait_us_max);
+int
+rfx_pool_run(struct rfx_pool_session *session, struct rfxencode *enc,
+             rfx_pool_job_proc proc, void **args, const int *nodes,
+             int num_jobs);
+
+#endif
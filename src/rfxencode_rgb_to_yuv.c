@@ -45,10 +45,12 @@
     do { if (_level < LLOG_LEVEL) { printf _args ; printf("\n"); } } while (0)
 
 /******************************************************************************/
-static int
-rfx_encode_format_rgb(const char *rgb_data, int width, int height,
-                      int stride_bytes, int pixel_format,
-                      uint8 *r_buf, uint8 *g_buf, uint8 *b_buf)
+/* split the pixels from start_x to width into planes and pad the planes to
+   64 x 64, the SIMD deinterleave does the columns before start_x */
+int
+rfx_encode_format_rgb_tail(const char *rgb_data, int width, int height,
+                           int stride_bytes, int pixel_format, int start_x,
+                           uint8 *r_buf, uint8 *g_buf, uint8 *b_buf)
 {
     int x;
     int y;
@@ -60,7 +62,8 @@ rfx_encode_format_rgb(const char *rgb_data, int width, int height,
     uint8 *lg_buf;
     uint8 *lb_buf;
 
-    LLOGLN(10, ("rfx_encode_format_rgb: pixel_format %d", pixel_format));
+    LLOGLN(10, ("rfx_encode_format_rgb_tail: pixel_format %d start_x %d",
+            pixel_format, start_x));
     b = 0;
     g = 0;
     r = 0;
@@ -69,11 +72,11 @@ rfx_encode_format_rgb(const char *rgb_data, int width, int height,
         case RFX_FORMAT_BGRA:
             for (y = 0; y < height; y++)
             {
-                src = (uint8 *) (rgb_data + y * stride_bytes);
-                lr_buf = r_buf + y * 64;
-                lg_buf = g_buf + y * 64;
-                lb_buf = b_buf + y * 64;
-                for (x = 0; x < width; x++)
+                src = (uint8 *) (rgb_data + y * stride_bytes + start_x * 4);
+                lr_buf = r_buf + y * 64 + start_x;
+                lg_buf = g_buf + y * 64 + start_x;
+                lb_buf = b_buf + y * 64 + start_x;
+                for (x = start_x; x < width; x++)
                 {
                     b = *src++;
                     *lb_buf++ = b;
@@ -105,11 +108,11 @@ rfx_encode_format_rgb(const char *rgb_data, int width, int height,
         case RFX_FORMAT_RGBA:
             for (y = 0; y < height; y++)
             {
-                src = (uint8 *) (rgb_data + y * stride_bytes);
-                lr_buf = r_buf + y * 64;
-                lg_buf = g_buf + y * 64;
-                lb_buf = b_buf + y * 64;
-                for (x = 0; x < width; x++)
+                src = (uint8 *) (rgb_data + y * stride_bytes + start_x * 4);
+                lr_buf = r_buf + y * 64 + start_x;
+                lg_buf = g_buf + y * 64 + start_x;
+                lb_buf = b_buf + y * 64 + start_x;
+                for (x = start_x; x < width; x++)
                 {
                     r = *src++;
                     *lr_buf++ = r;
@@ -141,11 +144,11 @@ rfx_encode_format_rgb(const char *rgb_data, int width, int height,
         case RFX_FORMAT_BGR:
             for (y = 0; y < height; y++)
             {
-                src = (uint8 *) (rgb_data + y * stride_bytes);
-                lr_buf = r_buf + y * 64;
-                lg_buf = g_buf + y * 64;
-                lb_buf = b_buf + y * 64;
-                for (x = 0; x < width; x++)
+                src = (uint8 *) (rgb_data + y * stride_bytes + start_x * 3);
+                lr_buf = r_buf + y * 64 + start_x;
+                lg_buf = g_buf + y * 64 + start_x;
+                lb_buf = b_buf + y * 64 + start_x;
+                for (x = start_x; x < width; x++)
                 {
                     b = *src++;
                     *lb_buf++ = b;
@@ -176,11 +179,11 @@ rfx_encode_format_rgb(const char *rgb_data, int width, int height,
         case RFX_FORMAT_RGB:
             for (y = 0; y < height; y++)
             {
-                src = (uint8 *) (rgb_data + y * stride_bytes);
-                lr_buf = r_buf + y * 64;
-                lg_buf = g_buf + y * 64;
-                lb_buf = b_buf + y * 64;
-                for (x = 0; x < width; x++)
+                src = (uint8 *) (rgb_data + y * stride_bytes + start_x * 3);
+                lr_buf = r_buf + y * 64 + start_x;
+                lg_buf = g_buf + y * 64 + start_x;
+                lb_buf = b_buf + y * 64 + start_x;
+                for (x = start_x; x < width; x++)
                 {
                     r = *src++;
                     *lr_buf++ = r;
@@ -213,10 +216,21 @@ rfx_encode_format_rgb(const char *rgb_data, int width, int height,
 }
 
 /******************************************************************************/
-static int
-rfx_encode_format_argb(const char *argb_data, int width, int height,
-                       int stride_bytes, int pixel_format,
-                       uint8 *a_buf, uint8 *r_buf, uint8 *g_buf, uint8 *b_buf)
+int
+rfx_encode_format_rgb(const char *rgb_data, int width, int height,
+                      int stride_bytes, int pixel_format,
+                      uint8 *r_buf, uint8 *g_buf, uint8 *b_buf)
+{
+    return rfx_encode_format_rgb_tail(rgb_data, width, height, stride_bytes,
+                                      pixel_format, 0, r_buf, g_buf, b_buf);
+}
+
+/******************************************************************************/
+int
+rfx_encode_format_argb_tail(const char *argb_data, int width, int height,
+                            int stride_bytes, int pixel_format, int start_x,
+                            uint8 *a_buf, uint8 *r_buf, uint8 *g_buf,
+                            uint8 *b_buf)
 {
     int x;
     int y;
@@ -230,7 +244,8 @@ rfx_encode_format_argb(const char *argb_data, int width, int height,
     uint8 *lg_buf;
     uint8 *lb_buf;
 
-    LLOGLN(10, ("rfx_encode_format_argb: pixel_format %d", pixel_format));
+    LLOGLN(10, ("rfx_encode_format_argb_tail: pixel_format %d start_x %d",
+            pixel_format, start_x));
     b = 0;
     g = 0;
     r = 0;
@@ -240,12 +255,12 @@ rfx_encode_format_argb(const char *argb_data, int width, int height,
         case RFX_FORMAT_BGRA:
             for (y = 0; y < height; y++)
             {
-                src = (uint8 *) (argb_data + y * stride_bytes);
-                la_buf = a_buf + y * 64;
-                lr_buf = r_buf + y * 64;
-                lg_buf = g_buf + y * 64;
-                lb_buf = b_buf + y * 64;
-                for (x = 0; x < width; x++)
+                src = (uint8 *) (argb_data + y * stride_bytes + start_x * 4);
+                la_buf = a_buf + y * 64 + start_x;
+                lr_buf = r_buf + y * 64 + start_x;
+                lg_buf = g_buf + y * 64 + start_x;
+                lb_buf = b_buf + y * 64 + start_x;
+                for (x = start_x; x < width; x++)
                 {
                     b = *src++;
                     *lb_buf++ = b;
@@ -281,12 +296,12 @@ rfx_encode_format_argb(const char *argb_data, int width, int height,
         case RFX_FORMAT_RGBA:
             for (y = 0; y < height; y++)
             {
-                src = (uint8 *) (argb_data + y * stride_bytes);
-                la_buf = a_buf + y * 64;
-                lr_buf = r_buf + y * 64;
-                lg_buf = g_buf + y * 64;
-                lb_buf = b_buf + y * 64;
-                for (x = 0; x < width; x++)
+                src = (uint8 *) (argb_data + y * stride_bytes + start_x * 4);
+                la_buf = a_buf + y * 64 + start_x;
+                lr_buf = r_buf + y * 64 + start_x;
+                lg_buf = g_buf + y * 64 + start_x;
+                lb_buf = b_buf + y * 64 + start_x;
+                for (x = start_x; x < width; x++)
                 {
                     r = *src++;
                     *lr_buf++ = r;
@@ -322,11 +337,11 @@ rfx_encode_format_argb(const char *argb_data, int width, int height,
         case RFX_FORMAT_BGR:
             for (y = 0; y < height; y++)
             {
-                src = (uint8 *) (argb_data + y * stride_bytes);
-                lr_buf = r_buf + y * 64;
-                lg_buf = g_buf + y * 64;
-                lb_buf = b_buf + y * 64;
-                for (x = 0; x < width; x++)
+                src = (uint8 *) (argb_data + y * stride_bytes + start_x * 3);
+                lr_buf = r_buf + y * 64 + start_x;
+                lg_buf = g_buf + y * 64 + start_x;
+                lb_buf = b_buf + y * 64 + start_x;
+                for (x = start_x; x < width; x++)
                 {
                     b = *src++;
                     *lb_buf++ = b;
@@ -357,11 +372,11 @@ rfx_encode_format_argb(const char *argb_data, int width, int height,
         case RFX_FORMAT_RGB:
             for (y = 0; y < height; y++)
             {
-                src = (uint8 *) (argb_data + y * stride_bytes);
-                lr_buf = r_buf + y * 64;
-                lg_buf = g_buf + y * 64;
-                lb_buf = b_buf + y * 64;
-                for (x = 0; x < width; x++)
+                src = (uint8 *) (argb_data + y * stride_bytes + start_x * 3);
+                lr_buf = r_buf + y * 64 + start_x;
+                lg_buf = g_buf + y * 64 + start_x;
+                lb_buf = b_buf + y * 64 + start_x;
+                for (x = start_x; x < width; x++)
                 {
                     r = *src++;
                     *lr_buf++ = r;
@@ -393,10 +408,22 @@ rfx_encode_format_argb(const char *argb_data, int width, int height,
     return 0;
 }
 
+/******************************************************************************/
+int
+rfx_encode_format_argb(const char *argb_data, int width, int height,
+                       int stride_bytes, int pixel_format,
+                       uint8 *a_buf, uint8 *r_buf, uint8 *g_buf, uint8 *b_buf)
+{
+    return rfx_encode_format_argb_tail(argb_data, width, height, stride_bytes,
+                                       pixel_format, 0, a_buf, r_buf, g_buf,
+                                       b_buf);
+}
+
 /******************************************************************************/
 /* http://msdn.microsoft.com/en-us/library/ff635643.aspx
  * 0.299   -0.168935    0.499813
  * 0.587   -0.331665   -0.418531
+ * 0.114    0.50059    -0.081282
  * 0.114    0.50059    -0.081282
    y = r *  0.299000 + g *  0.587000 + b *  0.114000;
    u = r * -0.168935 + g * -0.331665 + b *  0.500590;
@@ -404,81 +431,253 @@ rfx_encode_format_argb(const char *argb_data, int width, int height,
 /* 19595  38470   7471
   -11071 -21736  32807
    32756 -27429  -5327 */
-static int
-rfx_encode_rgb_to_yuv_tile(uint8 *y_r_buf, uint8 *u_g_buf, uint8 *v_b_buf)
+/* one row of rfx_encode_rgb_to_yuv_tail, from start_x to width then padded
+   to 64 */
+int
+rfx_encode_rgb_to_yuv_row_tail(const char *rgb_row, int width,
+                               int pixel_format, int start_x,
+                               uint8 *a_row, uint8 *y_row, uint8 *u_row,
+                               uint8 *v_row)
 {
-    int i;
-    sint32 r, g, b;
-    sint32 y, u, v;
+    int x;
+    int bpp;
+    int ro;
+    int go;
+    int bo;
+    int ao;
+    const uint8 *src;
+    sint32 r;
+    sint32 g;
+    sint32 b;
+    sint32 cy;
+    sint32 cu;
+    sint32 cv;
+    uint8 a;
 
-    for (i = 0; i < 4096; i++)
+    switch (pixel_format)
     {
-        r = y_r_buf[i];
-        g = u_g_buf[i];
-        b = v_b_buf[i];
-
-        y = (r *  19595 + g *  38470 + b *   7471) >> 16;
-        u = (r * -11071 + g * -21736 + b *  32807) >> 16;
-        v = (r *  32756 + g * -27429 + b *  -5327) >> 16;
-
-        y_r_buf[i] = MINMAX(y, 0, 255);
-        u_g_buf[i] = MINMAX(u + 128, 0, 255);
-        v_b_buf[i] = MINMAX(v + 128, 0, 255);
-
+        case RFX_FORMAT_BGRA:
+            bpp = 4;
+            bo = 0;
+            go = 1;
+            ro = 2;
+            ao = 3;
+            break;
+        case RFX_FORMAT_RGBA:
+            bpp = 4;
+            ro = 0;
+            go = 1;
+            bo = 2;
+            ao = 3;
+            break;
+        case RFX_FORMAT_BGR:
+            bpp = 3;
+            bo = 0;
+            go = 1;
+            ro = 2;
+            ao = -1;
+            break;
+        case RFX_FORMAT_RGB:
+            bpp = 3;
+            ro = 0;
+            go = 1;
+            bo = 2;
+            ao = -1;
+            break;
+        default:
+            return 1;
+    }
+    if (ao < 0)
+    {
+        a_row = NULL;
+    }
+    /* black, in case width is 0 */
+    cy = 0;
+    cu = 128;
+    cv = 128;
+    a = 0;
+    src = (const uint8 *) (rgb_row + start_x * bpp);
+    for (x = start_x; x < width; x++)
+    {
+        r = src[ro];
+        g = src[go];
+        b = src[bo];
+        cy = (r *  19595 + g *  38470 + b *   7471) >> 16;
+        cu = (r * -11071 + g * -21736 + b *  32807) >> 16;
+        cv = (r *  32756 + g * -27429 + b *  -5327) >> 16;
+        cy = MINMAX(cy, 0, 255);
+        cu = MINMAX(cu + 128, 0, 255);
+        cv = MINMAX(cv + 128, 0, 255);
+        y_row[x] = cy;
+        u_row[x] = cu;
+        v_row[x] = cv;
+        if (a_row != NULL)
+        {
+            a = src[ao];
+            a_row[x] = a;
+        }
+        src += bpp;
+    }
+    while (x < 64)
+    {
+        y_row[x] = cy;
+        u_row[x] = cu;
+        v_row[x] = cv;
+        if (a_row != NULL)
+        {
+            a_row[x] = a;
+        }
+        x++;
     }
     return 0;
 }
 
 /******************************************************************************/
 int
-rfx_encode_rgb_to_yuv(struct rfxencode *enc, const char *rgb_data,
-                      int width, int height, int stride_bytes)
+rfx_encode_rgb_to_yuv_row(const char *rgb_row, int width, int pixel_format,
+                          uint8 *a_row, uint8 *y_row, uint8 *u_row,
+                          uint8 *v_row)
 {
-    uint8 *y_r_buffer;
-    uint8 *u_g_buffer;
-    uint8 *v_b_buffer;
+    return rfx_encode_rgb_to_yuv_row_tail(rgb_row, width, pixel_format, 0,
+                                          a_row, y_row, u_row, v_row);
+}
 
-    y_r_buffer = enc->y_r_buffer;
-    u_g_buffer = enc->u_g_buffer;
-    v_b_buffer = enc->v_b_buffer;
+/******************************************************************************/
+/* read packed pixels from start_x to width and write the final y, u, v and
+   a planes in one pass, padded to 64 x 64, the SIMD versions do the columns
+   before start_x
+   a_buf can be NULL, formats without alpha leave it alone */
+int
+rfx_encode_rgb_to_yuv_tail(const char *rgb_data, int width, int height,
+                           int stride_bytes, int pixel_format, int start_x,
+                           uint8 *a_buf, uint8 *y_buf, uint8 *u_buf,
+                           uint8 *v_buf)
+{
+    int y;
+    int has_alpha;
+    uint8 *la_buf;
 
-    if (rfx_encode_format_rgb(rgb_data, width, height, stride_bytes,
-                              enc->format,
-                              y_r_buffer, u_g_buffer, v_b_buffer) != 0)
+    LLOGLN(10, ("rfx_encode_rgb_to_yuv_tail: pixel_format %d start_x %d",
+            pixel_format, start_x));
+    has_alpha = (a_buf != NULL) &&
+                ((pixel_format == RFX_FORMAT_BGRA) ||
+                 (pixel_format == RFX_FORMAT_RGBA));
+    la_buf = NULL;
+    for (y = 0; y < height; y++)
     {
-        return 1;
+        if (has_alpha)
+        {
+            la_buf = a_buf + y * 64;
+        }
+        if (rfx_encode_rgb_to_yuv_row_tail(rgb_data + y * stride_bytes,
+                                           width, pixel_format, start_x,
+                                           la_buf, y_buf + y * 64,
+                                           u_buf + y * 64,
+                                           v_buf + y * 64) != 0)
+        {
+            return 1;
+        }
     }
-    if (rfx_encode_rgb_to_yuv_tile(y_r_buffer, u_g_buffer, v_b_buffer) != 0)
+    while (y < 64)
     {
-        return 1;
+        if (has_alpha)
+        {
+            la_buf = a_buf + y * 64;
+            memcpy(la_buf, la_buf - 64, 64);
+        }
+        memcpy(y_buf + y * 64, y_buf + (y - 1) * 64, 64);
+        memcpy(u_buf + y * 64, u_buf + (y - 1) * 64, 64);
+        memcpy(v_buf + y * 64, v_buf + (y - 1) * 64, 64);
+        y++;
     }
     return 0;
 }
 
+/******************************************************************************/
+int
+rfx_encode_rgb_to_yuv(struct rfxencode *enc, const char *rgb_data,
+                      int width, int height, int stride_bytes)
+{
+    return rfx_encode_rgb_to_yuv_tail(rgb_data, width, height, stride_bytes,
+                                      enc->format, 0, NULL, enc->y_r_buffer,
+                                      enc->u_g_buffer, enc->v_b_buffer);
+}
+
 /******************************************************************************/
 int
 rfx_encode_argb_to_yuva(struct rfxencode *enc, const char *argb_data,
                         int width, int height, int stride_bytes)
 {
-    uint8 *a_buffer;
-    uint8 *y_r_buffer;
-    uint8 *u_g_buffer;
-    uint8 *v_b_buffer;
+    return rfx_encode_rgb_to_yuv_tail(argb_data, width, height, stride_bytes,
+                                      enc->format, 0, enc->a_buffer,
+                                      enc->y_r_buffer, enc->u_g_buffer,
+                                      enc->v_b_buffer);
+}
 
-    a_buffer = enc->a_buffer;
-    y_r_buffer = enc->y_r_buffer;
-    u_g_buffer = enc->u_g_buffer;
-    v_b_buffer = enc->v_b_buffer;
+/******************************************************************************/
+/* convert packed pixels a row at a time and feed the rows straight into the
+   level 1 vertical DWT, the y, u and v planes are never written, only three
+   rows of each are kept, y_v1, u_v1 and v_v1 get the L and H rows for
+   enc->rfx_encode_dwt_h1
+   a_buf can be NULL, it gets the full alpha plane otherwise */
+int
+rfx_encode_rgb_to_dwt_v1(struct rfxencode *enc, const char *rgb_data,
+                         int width, int height, int stride_bytes,
+                         uint8 *a_buf, sint16 *y_v1, sint16 *u_v1,
+                         sint16 *v_v1)
+{
+    uint8 rows[3][3][64]; /* slot, component, column */
+    uint8 *a_row;
+    int done;
+    int n;
+    int r0;
+    int r1;
+    int r2;
 
-    if (rfx_encode_format_argb(argb_data, width, height, stride_bytes,
-                               enc->format, a_buffer,
-                               y_r_buffer, u_g_buffer, v_b_buffer) != 0)
+    LLOGLN(10, ("rfx_encode_rgb_to_dwt_v1: width %d height %d",
+            width, height));
+    if ((height < 1) || (height > 64))
     {
         return 1;
     }
-    if (rfx_encode_rgb_to_yuv_tile(y_r_buffer, u_g_buffer, v_b_buffer) != 0)
+    /* row r lives in slot r % 3 until row r + 3 is converted, rows from
+       height on are the last row, they are not converted so its slot stays
+       put */
+    done = 0;
+    a_row = NULL;
+    for (n = 0; n < 32; n++)
     {
-        return 1;
+        r0 = 2 * n;
+        r1 = r0 + 1;
+        r2 = n < 31 ? r0 + 2 : r0;
+        while ((done <= r0 + 2) && (done < height))
+        {
+            if (a_buf != NULL)
+            {
+                a_row = a_buf + done * 64;
+            }
+            if (enc->rfx_encode_rgb_to_yuv_row(rgb_data + done * stride_bytes,
+                                               width, enc->format, a_row,
+                                               rows[done % 3][0],
+                                               rows[done % 3][1],
+                                               rows[done % 3][2]) != 0)
+            {
+                return 1;
+            }
+            done++;
+        }
+        r0 = (r0 < height ? r0 : height - 1) % 3;
+        r1 = (r1 < height ? r1 : height - 1) % 3;
+        r2 = (r2 < height ? r2 : height - 1) % 3;
+        enc->rfx_encode_dwt_v1_rows(rows[r0][0], rows[r1][0], rows[r2][0], n,
+                                    y_v1, u_v1, v_v1);
+    }
+    if (a_buf != NULL)
+    {
+        for (n = height; n < 64; n++)
+        {
+            memcpy(a_buf + n * 64, a_buf + (n - 1) * 64, 64);
+        }
     }
     return 0;
 }
@@ -29,5 +29,127 @@ rfx_encode_rgb_to_yuv(struct rfxencode *enc, const char *rgb_data,
 int
 rfx_encode_argb_to_yuva(struct rfxencode *enc, const char *argb_data,
                         int width, int height, int stride_bytes);
+int
+rfx_encode_format_rgb(const char *rgb_data, int width, int height,
+                      int stride_bytes, int pixel_format,
+                      uint8 *r_buf, uint8 *g_buf, uint8 *b_buf);
+int
+rfx_encode_format_argb(const char *argb_data, int width, int height,
+                       int stride_bytes, int pixel_format,
+                       uint8 *a_buf, uint8 *r_buf, uint8 *g_buf, uint8 *b_buf);
+int
+rfx_encode_format_rgb_tail(const char *rgb_data, int width, int height,
+                           int stride_bytes, int pixel_format, int start_x,
+                           uint8 *r_buf, uint8 *g_buf, uint8 *b_buf);
+int
+rfx_encode_format_argb_tail(const char *argb_data, int width, int height,
+                            int stride_bytes, int pixel_format, int start_x,
+                            uint8 *a_buf, uint8 *r_buf, uint8 *g_buf,
+                            uint8 *b_buf);
+int
+rfx_encode_rgb_to_yuv_tail(const char *rgb_data, int width, int height,
+                           int stride_bytes, int pixel_format, int start_x,
+                           uint8 *a_buf, uint8 *y_buf, uint8 *u_buf,
+                           uint8 *v_buf);
+int
+rfx_encode_rgb_to_yuv_row_tail(const char *rgb_row, int width,
+                               int pixel_format, int start_x,
+                               uint8 *a_row, uint8 *y_row, uint8 *u_row,
+                               uint8 *v_row);
+int
+rfx_encode_rgb_to_yuv_row(const char *rgb_row, int width, int pixel_format,
+                          uint8 *a_row, uint8 *y_row, uint8 *u_row,
+                          uint8 *v_row);
+int
+rfx_encode_rgb_to_dwt_v1(struct rfxencode *enc, const char *rgb_data,
+                         int width, int height, int stride_bytes,
+                         uint8 *a_buf, sint16 *y_v1, sint16 *u_v1,
+                         sint16 *v_v1);
+int
+rfx_encode_rgb_to_yuv_x86_sse2(struct rfxencode *enc, const char *rgb_data,
+                               int width, int height, int stride_bytes);
+int
+rfx_encode_argb_to_yuva_x86_sse2(struct rfxencode *enc, const char *argb_data,
+                                 int width, int height, int stride_bytes);
+int
+rfx_encode_rgb_to_yuv_amd64_sse2(struct rfxencode *enc, const char *rgb_data,
+                                 int width, int height, int stride_bytes);
+int
+rfx_encode_argb_to_yuva_amd64_sse2(struct rfxencode *enc,
+                                   const char *argb_data, int width,
+                                   int height, int stride_bytes);
+int
+rfx_encode_rgb_to_yuv_amd64_ssse3(struct rfxencode *enc, const char *rgb_data,
+                                  int width, int height, int stride_bytes);
+int
+rfx_encode_argb_to_yuva_amd64_ssse3(struct rfxencode *enc,
+                                    const char *argb_data, int width,
+                                    int height, int stride_bytes);
+int
+rfx_encode_rgb_to_yuv_amd64_avx2(struct rfxencode *enc, const char *rgb_data,
+                                 int width, int height, int stride_bytes);
+int
+rfx_encode_argb_to_yuva_amd64_avx2(struct rfxencode *enc,
+                                   const char *argb_data, int width,
+                                   int height, int stride_bytes);
+int
+rfx_encode_format_rgb_amd64_ssse3(const char *rgb_data, int width, int height,
+                                  int stride_bytes, int pixel_format,
+                                  uint8 *r_buf, uint8 *g_buf, uint8 *b_buf);
+int
+rfx_encode_format_argb_amd64_ssse3(const char *argb_data, int width, int height,
+                                   int stride_bytes, int pixel_format,
+                                   uint8 *a_buf, uint8 *r_buf, uint8 *g_buf,
+                                   uint8 *b_buf);
+int
+rfx_encode_format_rgb_amd64_avx2(const char *rgb_data, int width, int height,
+                                 int stride_bytes, int pixel_format,
+                                 uint8 *r_buf, uint8 *g_buf, uint8 *b_buf);
+int
+rfx_encode_format_argb_amd64_avx2(const char *argb_data, int width, int height,
+                                  int stride_bytes, int pixel_format,
+                                  uint8 *a_buf, uint8 *r_buf, uint8 *g_buf,
+                                  uint8 *b_buf);
+int
+rfx_encode_rgb_to_yuv_row_amd64_ssse3(const char *rgb_row, int width,
+                                      int pixel_format, uint8 *a_row,
+                                      uint8 *y_row, uint8 *u_row, uint8 *v_row);
+int
+rfx_encode_rgb_to_yuv_row_amd64_avx2(const char *rgb_row, int width,
+                                     int pixel_format, uint8 *a_row,
+                                     uint8 *y_row, uint8 *u_row, uint8 *v_row);
+int
+rfx_encode_rgb_to_yuv_intrin_sse2(struct rfxencode *enc, const char *rgb_data,
+                                  int width, int height, int stride_bytes);
+int
+rfx_encode_argb_to_yuva_intrin_sse2(struct rfxencode *enc,
+                                    const char *argb_data, int width,
+                                    int height, int stride_bytes);
+int
+rfx_encode_rgb_to_yuv_row_intrin_sse2(const char *rgb_row, int width,
+                                      int pixel_format, uint8 *a_row,
+                                      uint8 *y_row, uint8 *u_row, uint8 *v_row);
+int
+rfx_encode_rgb_to_yuv_intrin_sse41(struct rfxencode *enc, const char *rgb_data,
+                                   int width, int height, int stride_bytes);
+int
+rfx_encode_argb_to_yuva_intrin_sse41(struct rfxencode *enc,
+                                     const char *argb_data, int width,
+                                     int height, int stride_bytes);
+int
+rfx_encode_rgb_to_yuv_row_intrin_sse41(const char *rgb_row, int width,
+                                       int pixel_format, uint8 *a_row,
+                                       uint8 *y_row, uint8 *u_row, uint8 *v_row);
+int
+rfx_encode_rgb_to_yuv_intrin_avx2(struct rfxencode *enc, const char *rgb_data,
+                                  int width, int height, int stride_bytes);
+int
+rfx_encode_argb_to_yuva_intrin_avx2(struct rfxencode *enc,
+                                    const char *argb_data, int width,
+                                    int height, int stride_bytes);
+int
+rfx_encode_rgb_to_yuv_row_intrin_avx2(const char *rgb_row, int width,
+                                      int pixel_format, uint8 *a_row,
+                                      uint8 *y_row, uint8 *u_row, uint8 *v_row);
 
 #endif
@@ -34,13 +34,11 @@
 #include "rfxencode_tile.h"
 #include "rfxencode_dwt.h"
 #include "rfxencode_dwt_rem.h"
-#include "rfxencode_quantization.h"
 #include "rfxencode_differential.h"
-#include "rfxencode_rlgr1.h"
-#include "rfxencode_rlgr3.h"
 #include "rfxencode_diff_rlgr1.h"
 #include "rfxencode_diff_rlgr3.h"
 #include "rfxencode_alpha.h"
+#include "rfxencode_rgb_to_yuv.h"
 
 #ifdef RFX_USE_ACCEL_X86
 #include "x86/funcs_x86.h"
@@ -54,43 +52,24 @@
 #define LLOGLN(_level, _args) \
     do { if (_level < LLOG_LEVEL) { printf _args ; printf("\n"); } } while (0)
 
-/**
- * In order not to overflow the output buffer, we need to have an
- * upper limit on the size of a tile which could possibly be written to
- * the buffer.
- *
- * The tile data structure (TS_RFX_TILE) is defined in [MS-RDPRFX]
- * 2.2.2.3.4.1
- *
- * We make the conservative assumption that the RLGR1/RLGL3 algorithm
- * worst case results in a doubling of the YCbCr data for each pixel.
- * This is likely to be far higher than necessary.
- */
-#define RLGR_WORST_CASE_SIZE_FACTOR 2
-#define TILE_SIZE_UPPER_LIMIT (6 + 1 + 1 + 1 + 2 + 2 + 2 + 2 + 2 + \
-                                (64 * 64) * 3 * RLGR_WORST_CASE_SIZE_FACTOR)
-
-
 /******************************************************************************/
+/* the C path ends in the same diff RLGR coders as the SIMD paths,
+   rfx_rlgr1_encode and rfx_rlgr3_encode are only left for
+   rfxcodec_encode_get_internals */
 int
 rfx_encode_component_rlgr1(struct rfxencode *enc, const char *qtable,
                            const uint8 *data,
                            uint8 *buffer, int buffer_size, int *size)
 {
     LLOGLN(10, ("rfx_encode_component_rlgr1:"));
-    if (rfx_dwt_2d_encode(data, enc->dwt_buffer1, enc->dwt_buffer) != 0)
-    {
-        return 1;
-    }
-    if (rfx_quantization_encode(enc->dwt_buffer1, qtable) != 0)
-    {
-        return 1;
-    }
-    if (rfx_differential_encode(enc->dwt_buffer1 + 4032, 64) != 0)
+    if (rfx_dwt_2d_encode_quant(data, enc->dwt_buffer1, enc->dwt_buffer,
+                                qtable) != 0)
     {
         return 1;
     }
-    *size = rfx_rlgr1_encode(enc->dwt_buffer1, buffer, buffer_size);
+    /* LL3 is already differenced */
+    *size = enc->rfx_encode_diff_rlgr1(enc->dwt_buffer1, buffer, buffer_size,
+                                       0, enc->rfx_encode_nonzero_mask);
     return 0;
 }
 
@@ -101,33 +80,158 @@ rfx_encode_component_rlgr3(struct rfxencode *enc, const char *qtable,
                            uint8 *buffer, int buffer_size, int *size)
 {
     LLOGLN(10, ("rfx_encode_component_rlgr3:"));
-    if (rfx_dwt_2d_encode(data, enc->dwt_buffer1, enc->dwt_buffer) != 0)
+    if (rfx_dwt_2d_encode_quant(data, enc->dwt_buffer1, enc->dwt_buffer,
+                                qtable) != 0)
     {
         return 1;
     }
-    if (rfx_quantization_encode(enc->dwt_buffer1, qtable) != 0)
+    /* LL3 is already differenced */
+    *size = enc->rfx_encode_diff_rlgr3(enc->dwt_buffer1, buffer, buffer_size,
+                                       0, enc->rfx_encode_nonzero_mask);
+    return 0;
+}
+
+/******************************************************************************/
+/* first half of rfx_encode_component_rlgr1 and rfx_encode_component_rlgr3,
+   coefs must be 16 byte aligned, LL3 is differenced */
+int
+rfx_encode_dwt_quant(struct rfxencode *enc, const char *qtable,
+                     const uint8 *data, sint16 *coefs)
+{
+    return rfx_dwt_2d_encode_quant(data, coefs, enc->dwt_buffer, qtable);
+}
+
+/******************************************************************************/
+/* rfx_encode_dwt_quant for rfx_encode_rgb_to_dwt_v1 output, v1_buffer is
+   used as work space */
+int
+rfx_encode_dwt_h1_quant(struct rfxencode *enc, const char *qtable,
+                        sint16 *v1_buffer, sint16 *coefs)
+{
+    return rfx_dwt_2d_encode_h1_quant(v1_buffer, coefs, qtable);
+}
+
+/******************************************************************************/
+/* second half of rfx_encode_component_rlgr1, rfx_encode_dwt_quant and
+   rfx_encode_dwt_h1_quant already differenced LL3 */
+int
+rfx_encode_entropy_rlgr1(struct rfxencode *enc, sint16 *coefs,
+                         uint8 *buffer, int buffer_size, int *size)
+{
+    *size = enc->rfx_encode_diff_rlgr1(coefs, buffer, buffer_size, 0,
+                                       enc->rfx_encode_nonzero_mask);
+    return 0;
+}
+
+/******************************************************************************/
+/* second half of rfx_encode_component_rlgr3, rfx_encode_dwt_quant and
+   rfx_encode_dwt_h1_quant already differenced LL3 */
+int
+rfx_encode_entropy_rlgr3(struct rfxencode *enc, sint16 *coefs,
+                         uint8 *buffer, int buffer_size, int *size)
+{
+    *size = enc->rfx_encode_diff_rlgr3(coefs, buffer, buffer_size, 0,
+                                       enc->rfx_encode_nonzero_mask);
+    return 0;
+}
+
+/******************************************************************************/
+/* second half of the SIMD rfx_encode_component_rlgr1_* */
+int
+rfx_encode_entropy_diff_rlgr1(struct rfxencode *enc, sint16 *coefs,
+                              uint8 *buffer, int buffer_size, int *size)
+{
+    *size = enc->rfx_encode_diff_rlgr1(coefs, buffer, buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
+    return 0;
+}
+
+/******************************************************************************/
+/* second half of the SIMD rfx_encode_component_rlgr3_* */
+int
+rfx_encode_entropy_diff_rlgr3(struct rfxencode *enc, sint16 *coefs,
+                              uint8 *buffer, int buffer_size, int *size)
+{
+    *size = enc->rfx_encode_diff_rlgr3(coefs, buffer, buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
+    return 0;
+}
+
+/******************************************************************************/
+static int
+check_and_rfx_encode(struct rfxencode *enc, const char *qtable,
+                     const uint8 *data,
+                     uint8 *buffer, int buffer_size, int *size)
+{
+    if (buffer_size < TILE_SIZE_UPPER_LIMIT)
     {
         return 1;
     }
-    if (rfx_differential_encode(enc->dwt_buffer1 + 4032, 64) != 0)
+    return enc->rfx_encode(enc, qtable, data, buffer, buffer_size, size);
+}
+
+/******************************************************************************/
+/* check_and_rfx_encode for a component rfx_encode_rgb_to_dwt_v1 did the
+   level 1 vertical DWT of, data_out is moved past it */
+static int
+check_and_rfx_encode_v1(struct rfxencode *enc, const char *qtable,
+                        sint16 *v1_buffer, STREAM *data_out, int *size)
+{
+    if (stream_get_left(data_out) < TILE_SIZE_UPPER_LIMIT)
     {
         return 1;
     }
-    *size = rfx_rlgr3_encode(enc->dwt_buffer1, buffer, buffer_size);
+    if (enc->rfx_encode_dwt_h1(enc, qtable, v1_buffer,
+                               enc->dwt_buffer1) != 0)
+    {
+        return 1;
+    }
+    if (enc->rfx_encode_entropy(enc, enc->dwt_buffer1,
+                                stream_get_tail(data_out),
+                                stream_get_left(data_out), size) != 0)
+    {
+        return 1;
+    }
+    stream_seek(data_out, *size);
     return 0;
 }
 
 /******************************************************************************/
+/* colour conversion fused with the level 1 vertical DWT, the rows of each
+   component go to dwt_buffer2, 3 and 4, the rest of the tile path only
+   uses dwt_buffer and dwt_buffer1 */
 static int
-check_and_rfx_encode(struct rfxencode *enc, const char *qtable,
-                     const uint8 *data,
-                     uint8 *buffer, int buffer_size, int *size)
+rfx_encode_rgb_v1(struct rfxencode *enc, const char *rgb_data,
+                  int width, int height, int stride_bytes, uint8 *a_buf,
+                  const char *y_quants, const char *u_quants,
+                  const char *v_quants,
+                  STREAM *data_out, int *y_size, int *u_size, int *v_size)
 {
-    if (buffer_size < TILE_SIZE_UPPER_LIMIT)
+    if (rfx_encode_rgb_to_dwt_v1(enc, rgb_data, width, height, stride_bytes,
+                                 a_buf, enc->dwt_buffer2, enc->dwt_buffer3,
+                                 enc->dwt_buffer4) != 0)
     {
         return 1;
     }
-    return enc->rfx_encode(enc, qtable, data, buffer, buffer_size, size);
+    if (check_and_rfx_encode_v1(enc, y_quants, enc->dwt_buffer2,
+                                data_out, y_size) != 0)
+    {
+        return 1;
+    }
+    LLOGLN(10, ("rfx_encode_rgb_v1: y_size %d", *y_size));
+    if (check_and_rfx_encode_v1(enc, u_quants, enc->dwt_buffer3,
+                                data_out, u_size) != 0)
+    {
+        return 1;
+    }
+    LLOGLN(10, ("rfx_encode_rgb_v1: u_size %d", *u_size));
+    if (check_and_rfx_encode_v1(enc, v_quants, enc->dwt_buffer4,
+                                data_out, v_size) != 0)
+    {
+        return 1;
+    }
+    LLOGLN(10, ("rfx_encode_rgb_v1: v_size %d", *v_size));
+    return 0;
 }
 
 /******************************************************************************/
@@ -143,6 +247,12 @@ rfx_encode_rgb(struct rfxencode *enc, const char *rgb_data,
     uint8 *v_b_buffer;
 
     LLOGLN(10, ("rfx_encode_rgb:"));
+    if (enc->rfx_encode_dwt_h1 != NULL)
+    {
+        return rfx_encode_rgb_v1(enc, rgb_data, width, height, stride_bytes,
+                                 NULL, y_quants, u_quants, v_quants,
+                                 data_out, y_size, u_size, v_size);
+    }
     if (enc->rfx_encode_rgb_to_yuv(enc, rgb_data, width, height,
                                    stride_bytes) != 0)
     {
@@ -196,6 +306,17 @@ rfx_encode_argb(struct rfxencode *enc, const char *argb_data,
     uint8 *v_b_buffer;
 
     LLOGLN(10, ("rfx_encode_argb:"));
+    if (enc->rfx_encode_dwt_h1 != NULL)
+    {
+        if (rfx_encode_rgb_v1(enc, argb_data, width, height, stride_bytes,
+                              enc->a_buffer, y_quants, u_quants, v_quants,
+                              data_out, y_size, u_size, v_size) != 0)
+        {
+            return 1;
+        }
+        *a_size = rfx_encode_plane(enc, enc->a_buffer, 64, 64, data_out);
+        return 0;
+    }
     if (enc->rfx_encode_argb_to_yuva(enc, argb_data, width, height,
                                      stride_bytes) != 0)
     {
@@ -26,6 +26,25 @@
 
 #define RFX_YUV_BTES (64 * 64)
 
+/**
+ * In order not to overflow the output buffer, we need to have an
+ * upper limit on the size of a tile which could possibly be written to
+ * the buffer.
+ *
+ * The tile data structure (TS_RFX_TILE) is defined in [MS-RDPRFX]
+ * 2.2.2.3.4.1
+ *
+ * We make the conservative assumption that the RLGR1/RLGL3 algorithm
+ * worst case results in a doubling of the YCbCr data for each pixel.
+ * This is likely to be far higher than necessary.
+ */
+#define RLGR_WORST_CASE_SIZE_FACTOR 2
+#define TILE_SIZE_UPPER_LIMIT (6 + 1 + 1 + 1 + 2 + 2 + 2 + 2 + 2 + \
+                                (64 * 64) * 3 * RLGR_WORST_CASE_SIZE_FACTOR)
+/* room a tile is encoded in before it is copied to its slot, a tile that
+ * does not fit is encoded again straight into the output */
+#define RFX_TILE_STAGE_BYTES (TILE_SIZE_UPPER_LIMIT * 3)
+
 int
 rfx_encode_component_rlgr1(struct rfxencode *enc, const char *qtable,
                            const uint8 *data,
@@ -35,6 +54,24 @@ rfx_encode_component_rlgr3(struct rfxencode *enc, const char *qtable,
                            const uint8 *data,
                            uint8 *buffer, int buffer_size, int *size);
 int
+rfx_encode_dwt_quant(struct rfxencode *enc, const char *qtable,
+                     const uint8 *data, sint16 *coefs);
+int
+rfx_encode_dwt_h1_quant(struct rfxencode *enc, const char *qtable,
+                        sint16 *v1_buffer, sint16 *coefs);
+int
+rfx_encode_entropy_rlgr1(struct rfxencode *enc, sint16 *coefs,
+                         uint8 *buffer, int buffer_size, int *size);
+int
+rfx_encode_entropy_rlgr3(struct rfxencode *enc, sint16 *coefs,
+                         uint8 *buffer, int buffer_size, int *size);
+int
+rfx_encode_entropy_diff_rlgr1(struct rfxencode *enc, sint16 *coefs,
+                              uint8 *buffer, int buffer_size, int *size);
+int
+rfx_encode_entropy_diff_rlgr3(struct rfxencode *enc, sint16 *coefs,
+                              uint8 *buffer, int buffer_size, int *size);
+int
 rfx_encode_rgb(struct rfxencode *enc, const char *rgb_data,
                int width, int height, int stride_bytes,
                const char *y_quants, const char *u_quants,
@@ -78,6 +115,12 @@ rfx_encode_component_rlgr3_x86_sse41(struct rfxencode *enc, const char *qtable,
                                      const uint8 *data,
                                      uint8 *buffer, int buffer_size, int *size);
 int
+rfx_encode_dwt_shift_x86_sse2(struct rfxencode *enc, const char *qtable,
+                              const uint8 *data, sint16 *coefs);
+int
+rfx_encode_dwt_shift_x86_sse41(struct rfxencode *enc, const char *qtable,
+                               const uint8 *data, sint16 *coefs);
+int
 rfx_encode_component_rlgr1_amd64_sse2(struct rfxencode *enc, const char *qtable,
                                       const uint8 *data,
                                       uint8 *buffer, int buffer_size, int *size);
@@ -93,5 +136,87 @@ int
 rfx_encode_component_rlgr3_amd64_sse41(struct rfxencode *enc, const char *qtable,
                                        const uint8 *data,
                                        uint8 *buffer, int buffer_size, int *size);
+int
+rfx_encode_dwt_shift_amd64_sse2(struct rfxencode *enc, const char *qtable,
+                                const uint8 *data, sint16 *coefs);
+int
+rfx_encode_dwt_h1_shift_amd64_sse2(struct rfxencode *enc, const char *qtable,
+                                   sint16 *v1_buffer, sint16 *coefs);
+int
+rfx_encode_dwt_shift_amd64_sse41(struct rfxencode *enc, const char *qtable,
+                                 const uint8 *data, sint16 *coefs);
+int
+rfx_encode_dwt_h1_shift_amd64_sse41(struct rfxencode *enc, const char *qtable,
+                                    sint16 *v1_buffer, sint16 *coefs);
+int
+rfx_encode_component_rlgr1_amd64_avx2(struct rfxencode *enc, const char *qtable,
+                                      const uint8 *data,
+                                      uint8 *buffer, int buffer_size, int *size);
+int
+rfx_encode_component_rlgr3_amd64_avx2(struct rfxencode *enc, const char *qtable,
+                                      const uint8 *data,
+                                      uint8 *buffer, int buffer_size, int *size);
+int
+rfx_encode_dwt_shift_amd64_avx2(struct rfxencode *enc, const char *qtable,
+                                const uint8 *data, sint16 *coefs);
+int
+rfx_encode_dwt_h1_shift_amd64_avx2(struct rfxencode *enc, const char *qtable,
+                                   sint16 *v1_buffer, sint16 *coefs);
+int
+rfx_encode_component_rlgr1_amd64_avx512(struct rfxencode *enc, const char *qtable,
+                                        const uint8 *data,
+                                        uint8 *buffer, int buffer_size, int *size);
+int
+rfx_encode_component_rlgr3_amd64_avx512(struct rfxencode *enc, const char *qtable,
+                                        const uint8 *data,
+                                        uint8 *buffer, int buffer_size, int *size);
+int
+rfx_encode_dwt_shift_amd64_avx512(struct rfxencode *enc, const char *qtable,
+                                  const uint8 *data, sint16 *coefs);
+int
+rfx_encode_dwt_h1_shift_amd64_avx512(struct rfxencode *enc, const char *qtable,
+                                     sint16 *v1_buffer, sint16 *coefs);
+int
+rfx_encode_component_rlgr1_intrin_sse2(struct rfxencode *enc, const char *qtable,
+                                       const uint8 *data,
+                                       uint8 *buffer, int buffer_size, int *size);
+int
+rfx_encode_component_rlgr3_intrin_sse2(struct rfxencode *enc, const char *qtable,
+                                       const uint8 *data,
+                                       uint8 *buffer, int buffer_size, int *size);
+int
+rfx_encode_dwt_shift_intrin_sse2(struct rfxencode *enc, const char *qtable,
+                                 const uint8 *data, sint16 *coefs);
+int
+rfx_encode_dwt_h1_shift_intrin_sse2(struct rfxencode *enc, const char *qtable,
+                                    sint16 *v1_buffer, sint16 *coefs);
+int
+rfx_encode_component_rlgr1_intrin_sse41(struct rfxencode *enc, const char *qtable,
+                                        const uint8 *data,
+                                        uint8 *buffer, int buffer_size, int *size);
+int
+rfx_encode_component_rlgr3_intrin_sse41(struct rfxencode *enc, const char *qtable,
+                                        const uint8 *data,
+                                        uint8 *buffer, int buffer_size, int *size);
+int
+rfx_encode_dwt_shift_intrin_sse41(struct rfxencode *enc, const char *qtable,
+                                  const uint8 *data, sint16 *coefs);
+int
+rfx_encode_dwt_h1_shift_intrin_sse41(struct rfxencode *enc, const char *qtable,
+                                     sint16 *v1_buffer, sint16 *coefs);
+int
+rfx_encode_component_rlgr1_intrin_avx2(struct rfxencode *enc, const char *qtable,
+                                       const uint8 *data,
+                                       uint8 *buffer, int buffer_size, int *size);
+int
+rfx_encode_component_rlgr3_intrin_avx2(struct rfxencode *enc, const char *qtable,
+                                       const uint8 *data,
+                                       uint8 *buffer, int buffer_size, int *size);
+int
+rfx_encode_dwt_shift_intrin_avx2(struct rfxencode *enc, const char *qtable,
+                                 const uint8 *data, sint16 *coefs);
+int
+rfx_encode_dwt_h1_shift_intrin_avx2(struct rfxencode *enc, const char *qtable,
+                                    sint16 *v1_buffer, sint16 *coefs);
 
 #endif
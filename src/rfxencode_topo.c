@@ -0,0 +1,189 @@
+/**
+ * RFX codec encoder
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * numa topology for the worker pool, from Linux sysfs
+ * without it everything is node 0 and nothing gets pinned
+ */
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+#include <pthread.h>
+
+#include "rfxcommon.h"
+#include "rfxencode_topo.h"
+
+#define LLOG_LEVEL 1
+#define LLOGLN(_level, _args) \
+    do { if (_level < LLOG_LEVEL) { printf _args ; printf("\n"); } } while (0)
+
+/******************************************************************************/
+/* cpulist is like "0-7,16-23" */
+static void
+rfx_topo_parse_cpulist(const char *cpulist, int node,
+                       int *cpu_nodes, int num_cpus)
+{
+    char *end;
+    long first;
+    long last;
+
+    while (*cpulist != 0)
+    {
+        first = strtol(cpulist, &end, 10);
+        if (end == cpulist)
+        {
+            return;
+        }
+        last = first;
+        cpulist = end;
+        if (*cpulist == '-')
+        {
+            cpulist++;
+            last = strtol(cpulist, &end, 10);
+            if (end == cpulist)
+            {
+                return;
+            }
+            cpulist = end;
+        }
+        for (; (first <= last) && (first < num_cpus); first++)
+        {
+            if (first >= 0)
+            {
+                cpu_nodes[first] = node;
+            }
+        }
+        if (*cpulist != ',')
+        {
+            return;
+        }
+        cpulist++;
+    }
+}
+
+/******************************************************************************/
+/* fills in the node of each cpu, -1 if not known
+   returns the number of nodes with cpus */
+int
+rfx_topo_get_cpu_nodes(int *cpu_nodes, int num_cpus)
+{
+    char filename[64];
+    char cpulist[1024];
+    FILE *file;
+    int node;
+    int num_nodes;
+    int index;
+
+    for (index = 0; index < num_cpus; index++)
+    {
+        cpu_nodes[index] = -1;
+    }
+    num_nodes = 0;
+    for (node = 0; node < RFX_TOPO_MAX_NODES; node++)
+    {
+        snprintf(filename, sizeof(filename),
+                 "/sys/devices/system/node/node%d/cpulist", node);
+        file = fopen(filename, "r");
+        if (file == NULL)
+        {
+            continue;
+        }
+        if ((fgets(cpulist, sizeof(cpulist), file) != NULL) &&
+                (cpulist[0] >= '0') && (cpulist[0] <= '9'))
+        {
+            rfx_topo_parse_cpulist(cpulist, node, cpu_nodes, num_cpus);
+            num_nodes++;
+        }
+        fclose(file);
+    }
+    LLOGLN(10, ("rfx_topo_get_cpu_nodes: %d nodes", num_nodes));
+    return num_nodes;
+}
+
+/******************************************************************************/
+/* keep the calling thread on the cpus of node */
+int
+rfx_topo_pin_thread(const int *cpu_nodes, int num_cpus, int node)
+{
+#if defined(HAVE_PTHREAD_SETAFFINITY_NP)
+    cpu_set_t cpus;
+    int index;
+
+    CPU_ZERO(&cpus);
+    for (index = 0; (index < num_cpus) && (index < CPU_SETSIZE); index++)
+    {
+        if (cpu_nodes[index] == node)
+        {
+            CPU_SET(index, &cpus);
+        }
+    }
+    if (CPU_COUNT(&cpus) < 1)
+    {
+        return 1;
+    }
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0)
+    {
+        LLOGLN(0, ("rfx_topo_pin_thread: pthread_setaffinity_np failed"));
+        return 1;
+    }
+    return 0;
+#else
+    return 1;
+#endif
+}
+
+/******************************************************************************/
+/* node of the page each address is in, -1 if not known, pages that have
+   not been touched yet are not on any node */
+int
+rfx_topo_get_mem_nodes(const void **addrs, int *nodes, int count)
+{
+    int index;
+
+#if defined(__linux__) && defined(SYS_move_pages)
+    /* with no target nodes move_pages only reports where the pages are */
+    if (syscall(SYS_move_pages, 0, (unsigned long) count, addrs,
+                NULL, nodes, 0) == 0)
+    {
+        for (index = 0; index < count; index++)
+        {
+            nodes[index] = MAX(nodes[index], -1);
+        }
+        return 0;
+    }
+#endif
+    for (index = 0; index < count; index++)
+    {
+        nodes[index] = -1;
+    }
+    return 1;
+}
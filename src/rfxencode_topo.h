@@ -0,0 +1,32 @@
+/**
+ * RFX codec encoder
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __RFXENCODE_TOPO_H
+#define __RFXENCODE_TOPO_H
+
+#define RFX_TOPO_MAX_CPUS 1024
+#define RFX_TOPO_MAX_NODES 64
+
+int
+rfx_topo_get_cpu_nodes(int *cpu_nodes, int num_cpus);
+int
+rfx_topo_pin_thread(const int *cpu_nodes, int num_cpus, int node);
+int
+rfx_topo_get_mem_nodes(const void **addrs, int *nodes, int count);
+
+#endif
@@ -28,4 +28,26 @@ PROC cpuid_x86
     pop ecx
     pop ebx
     ret
+
+;int
+;xgetbv_x86(int ecx_in, int *eax, int *edx)
+
+PROC xgetbv_x86
+    ; save registers
+    push ecx
+    push edx
+    push edi
+    ; xgetbv
+    mov ecx, [esp + 16]
+    xgetbv
+    mov edi, [esp + 20]
+    mov [edi], eax
+    mov edi, [esp + 24]
+    mov [edi], edx
+    mov eax, 0
+    ; restore registers
+    pop edi
+    pop edx
+    pop ecx
+    ret
 END_OF_FILE
@@ -30,6 +30,8 @@ extern "C" {
 
 int
 cpuid_x86(int eax_in, int ecx_in, int *eax, int *ebx, int *ecx, int *edx);
+int
+xgetbv_x86(int ecx_in, int *eax, int *edx);
 
 int
 rfxcodec_encode_dwt_shift_x86_sse2(const char *qtable,
@@ -42,6 +44,11 @@ rfxcodec_encode_dwt_shift_x86_sse41(const char *qtable,
                                     short *dwt_buffer1,
                                     short *dwt_buffer);
 
+int
+rfxcodec_encode_rgb_to_yuv_tile_x86_sse2(unsigned char *y_r_buf,
+                                         unsigned char *u_g_buf,
+                                         unsigned char *v_b_buf);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,137 @@
+;
+;Copyright 2026 librfxcodec contributors
+;
+;Permission to use, copy, modify, distribute, and sell this software and its
+;documentation for any purpose is hereby granted without fee, provided that
+;the above copyright notice appear in all copies and that both that
+;copyright notice and this permission notice appear in supporting
+;documentation.
+;
+;The above copyright notice and this permission notice shall be included in
+;all copies or substantial portions of the Software.
+;
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+;IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+;FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+;OPEN GROUP BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+;AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+;CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+;
+;x86 asm rgb to yuv, sse2, 8 pixels per loop
+
+%include "common.asm"
+
+PREPARE_RODATA
+    cw128    times 8 dw 128
+    ; dword = r + (g << 16) is added to y, so r is 19595 - 1 and g is
+    ; 38470 - 65536 split over the two pairs
+    cwy_rg   times 4 dw 19594, -13533
+    cwy_gb   times 4 dw -13533, 7471
+    ; dword = g + (b << 16) is added to u, so g is -21736 - 1 and b is
+    ; 32807 - 65536
+    cwu_rg   times 4 dw -11071, -21737
+    cwu_gb   times 4 dw 0, -32729
+    cwv_rg   times 4 dw 32756, -27429
+    cwv_gb   times 4 dw 0, -5327
+
+;int
+;rfxcodec_encode_rgb_to_yuv_tile_x86_sse2(unsigned char *y_r_buf,
+;                                         unsigned char *u_g_buf,
+;                                         unsigned char *v_b_buf);
+
+;******************************************************************************
+PROC rfxcodec_encode_rgb_to_yuv_tile_x86_sse2
+    ; save registers
+    push ebx
+    RETRIEVE_RODATA
+    push esi
+    push edi
+    mov edi, [esp + 16]                 ; y_r_buf
+    mov esi, [esp + 20]                 ; u_g_buf
+    mov edx, [esp + 24]                 ; v_b_buf
+    pxor xmm0, xmm0
+    mov ecx, 4096 / 8
+loop1a:
+    movq xmm1, [edi]                    ; r
+    movq xmm2, [esi]                    ; g
+    movq xmm3, [edx]                    ; b
+    punpcklbw xmm1, xmm0
+    punpcklbw xmm2, xmm0
+    punpcklbw xmm3, xmm0
+    movdqa xmm4, xmm1                   ; r, g
+    punpcklwd xmm4, xmm2
+    punpckhwd xmm1, xmm2
+    movdqa xmm5, xmm2                   ; g, b
+    punpcklwd xmm5, xmm3
+    punpckhwd xmm2, xmm3
+
+    ; y = (r *  19595 + g *  38470 + b *   7471) >> 16
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwy_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwy_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm4
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwy_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwy_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm1
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [edi], xmm3
+
+    ; u = ((r * -11071 + g * -21736 + b *  32807) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwu_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwu_gb)]
+    paddd xmm3, xmm6
+    paddd xmm3, xmm5
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwu_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwu_gb)]
+    paddd xmm6, xmm7
+    paddd xmm6, xmm2
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [esi], xmm3
+
+    ; v = ((r *  32756 + g * -27429 + b *  -5327) >> 16) + 128
+    movdqa xmm3, xmm4
+    pmaddwd xmm3, [lsym(cwv_rg)]
+    movdqa xmm6, xmm5
+    pmaddwd xmm6, [lsym(cwv_gb)]
+    paddd xmm3, xmm6
+    psrad xmm3, 16
+    movdqa xmm6, xmm1
+    pmaddwd xmm6, [lsym(cwv_rg)]
+    movdqa xmm7, xmm2
+    pmaddwd xmm7, [lsym(cwv_gb)]
+    paddd xmm6, xmm7
+    psrad xmm6, 16
+    packssdw xmm3, xmm6
+    paddw xmm3, [lsym(cw128)]
+    packuswb xmm3, xmm3                 ; clamp 0 to 255
+    movq [edx], xmm3
+
+    lea edi, [edi + 8]
+    lea esi, [esi + 8]
+    lea edx, [edx + 8]
+    dec ecx
+    jnz loop1a
+
+    ; restore registers
+    pop edi
+    pop esi
+    pop ebx
+    mov eax, 0                          ; return value
+    ret
+END_OF_FILE
@@ -26,6 +26,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <rfxcodec_encode.h>
+
 #include "rfxcommon.h"
 #include "rfxencode.h"
 #include "rfxencode_differential.h"
@@ -34,6 +36,7 @@
 #include "rfxencode_alpha.h"
 #include "rfxencode_diff_rlgr1.h"
 #include "rfxencode_diff_rlgr3.h"
+#include "rfxencode_rgb_to_yuv.h"
 
 #include "x86/funcs_x86.h"
 
@@ -53,7 +56,9 @@ rfx_encode_component_rlgr1_x86_sse2(struct rfxencode *enc, const char *qtable,
     {
         return 1;
     }
-    *size = rfx_encode_diff_rlgr1(enc->dwt_buffer1, buffer, buffer_size, 64);
+    *size = enc->rfx_encode_diff_rlgr1(enc->dwt_buffer1, buffer,
+                                       buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
     return 0;
 }
 
@@ -69,7 +74,9 @@ rfx_encode_component_rlgr3_x86_sse2(struct rfxencode *enc, const char *qtable,
     {
         return 1;
     }
-    *size = rfx_encode_diff_rlgr3(enc->dwt_buffer1, buffer, buffer_size, 64);
+    *size = enc->rfx_encode_diff_rlgr3(enc->dwt_buffer1, buffer,
+                                       buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
     return 0;
 }
 
@@ -85,7 +92,9 @@ rfx_encode_component_rlgr1_x86_sse41(struct rfxencode *enc, const char *qtable,
     {
         return 1;
     }
-    *size = rfx_encode_diff_rlgr1(enc->dwt_buffer1, buffer, buffer_size, 64);
+    *size = enc->rfx_encode_diff_rlgr1(enc->dwt_buffer1, buffer,
+                                       buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
     return 0;
 }
 
@@ -101,6 +110,59 @@ rfx_encode_component_rlgr3_x86_sse41(struct rfxencode *enc, const char *qtable,
     {
         return 1;
     }
-    *size = rfx_encode_diff_rlgr3(enc->dwt_buffer1, buffer, buffer_size, 64);
+    *size = enc->rfx_encode_diff_rlgr3(enc->dwt_buffer1, buffer,
+                                       buffer_size, 64,
+                                       enc->rfx_encode_nonzero_mask);
     return 0;
 }
+
+/******************************************************************************/
+int
+rfx_encode_dwt_shift_x86_sse2(struct rfxencode *enc, const char *qtable,
+                              const uint8 *data, sint16 *coefs)
+{
+    return rfxcodec_encode_dwt_shift_x86_sse2(qtable, data, coefs,
+                                              enc->dwt_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_dwt_shift_x86_sse41(struct rfxencode *enc, const char *qtable,
+                               const uint8 *data, sint16 *coefs)
+{
+    return rfxcodec_encode_dwt_shift_x86_sse41(qtable, data, coefs,
+                                               enc->dwt_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_rgb_to_yuv_x86_sse2(struct rfxencode *enc, const char *rgb_data,
+                               int width, int height, int stride_bytes)
+{
+    if (enc->rfx_encode_format_rgb(rgb_data, width, height, stride_bytes,
+                                   enc->format, enc->y_r_buffer,
+                                   enc->u_g_buffer, enc->v_b_buffer) != 0)
+    {
+        return 1;
+    }
+    return rfxcodec_encode_rgb_to_yuv_tile_x86_sse2(enc->y_r_buffer,
+                                                    enc->u_g_buffer,
+                                                    enc->v_b_buffer);
+}
+
+/******************************************************************************/
+int
+rfx_encode_argb_to_yuva_x86_sse2(struct rfxencode *enc, const char *argb_data,
+                                 int width, int height, int stride_bytes)
+{
+    if (enc->rfx_encode_format_argb(argb_data, width, height, stride_bytes,
+                                    enc->format, enc->a_buffer,
+                                    enc->y_r_buffer, enc->u_g_buffer,
+                                    enc->v_b_buffer) != 0)
+    {
+        return 1;
+    }
+    return rfxcodec_encode_rgb_to_yuv_tile_x86_sse2(enc->y_r_buffer,
+                                                    enc->u_g_buffer,
+                                                    enc->v_b_buffer);
+}
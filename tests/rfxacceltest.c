@@ -0,0 +1,264 @@
+/**
+ * RFX codec encoder SIMD test
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * the output of a handle using whatever SIMD kernels the build and cpu
+ * give must be byte for byte what a RFX_FLAGS_NOACCEL handle gives, for
+ * every pixel format, RLGR1 and RLGR3, alpha and progressive
+ */
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rfxcodec_encode.h>
+
+#define TEST_WIDTH 200 /* not a multiple of 64 so there are partial tiles */
+#define TEST_HEIGHT 136
+/* RFX_FORMAT_YUV is whole tiles, PRO1 takes only that */
+#define TEST_YUV_WIDTH 192
+#define TEST_YUV_HEIGHT 128
+#define TEST_FRAMES 3
+#define TEST_MAX_TILES 16
+#define TEST_CDATA_BYTES (1024 * 1024)
+
+static const char g_quants[10] =
+{
+    0x66, 0x66, 0x77, 0x88, 0x98,
+    0x99, 0x99, 0xaa, 0xcc, 0xdc
+};
+
+static unsigned int g_seed = 1;
+
+/*****************************************************************************/
+static int
+test_rand(void)
+{
+    g_seed = g_seed * 1103515245 + 12345;
+    return (g_seed >> 8) & 0xffff;
+}
+
+/*****************************************************************************/
+static int
+get_bpp(int format)
+{
+    if ((format == RFX_FORMAT_BGR) || (format == RFX_FORMAT_RGB))
+    {
+        return 3;
+    }
+    return 4;
+}
+
+/*****************************************************************************/
+/* gradients with noise, a flat alpha block and an alpha ramp so the
+   alpha plane has both runs and deltas, moved each frame */
+static void
+make_frame(char *buf, int width, int height, int stride_bytes, int format,
+           int frame)
+{
+    unsigned char *line;
+    unsigned char *tile;
+    int bpp;
+    int x;
+    int y;
+    int index;
+
+    if (format == RFX_FORMAT_YUV)
+    {
+        /* each 64x64 tile is 4 planes of 4096 bytes, Y U V A */
+        for (y = 0; y < height; y += 64)
+        {
+            for (x = 0; x < width; x += 64)
+            {
+                tile = (unsigned char *) buf + y * stride_bytes + (x << 8);
+                for (index = 0; index < 4096; index++)
+                {
+                    tile[index] = (index & 63) * 3 + y + frame * 8 +
+                                  test_rand() % 9;
+                    tile[4096 + index] = 128 + (index >> 6) + x;
+                    tile[8192 + index] = 100 + (index & 7) + frame;
+                    tile[12288 + index] = (index * 7) & 0xff;
+                }
+            }
+        }
+        return;
+    }
+    bpp = get_bpp(format);
+    for (y = 0; y < height; y++)
+    {
+        line = (unsigned char *) (buf + y * stride_bytes);
+        for (x = 0; x < width; x++)
+        {
+            line[0] = (x * 255 / width + frame * 8) + test_rand() % 9;
+            line[1] = y * 255 / height;
+            line[2] = ((x ^ y) * 3 + frame) & 0xff;
+            if (bpp == 4)
+            {
+                line[3] = x < 64 ? 0xff : (x + y + frame) & 0xff;
+            }
+            line += bpp;
+        }
+    }
+}
+
+/*****************************************************************************/
+static int
+make_tiles(struct rfx_tile *tiles, int width, int height)
+{
+    struct rfx_tile *tile;
+    int num_tiles;
+    int x;
+    int y;
+
+    num_tiles = 0;
+    for (y = 0; y < height; y += 64)
+    {
+        for (x = 0; x < width; x += 64)
+        {
+            tile = tiles + num_tiles;
+            tile->x = x;
+            tile->y = y;
+            tile->cx = width - x < 64 ? width - x : 64;
+            tile->cy = height - y < 64 ? height - y : 64;
+            tile->quant_y = 0;
+            tile->quant_cb = 0;
+            tile->quant_cr = 0;
+            num_tiles++;
+        }
+    }
+    return num_tiles;
+}
+
+/*****************************************************************************/
+/* encodes TEST_FRAMES frames on a default handle and on a
+   RFX_FLAGS_NOACCEL one and compares them
+   returns the number of frames that differ */
+static int
+check_accel(int format, int flags, int encode_flags)
+{
+    struct rfx_tile tiles[TEST_MAX_TILES];
+    struct rfx_rect region;
+    void *accel;
+    void *plain;
+    char *buf;
+    char *cdata1;
+    char *cdata2;
+    int width;
+    int height;
+    int stride_bytes;
+    int num_tiles;
+    int bytes1;
+    int bytes2;
+    int written1;
+    int written2;
+    int frame;
+    int bad;
+
+    width = TEST_WIDTH;
+    height = TEST_HEIGHT;
+    stride_bytes = width * get_bpp(format) + 4;
+    if (format == RFX_FORMAT_YUV)
+    {
+        width = TEST_YUV_WIDTH;
+        height = TEST_YUV_HEIGHT;
+        stride_bytes = width * 4;
+    }
+    buf = (char *) malloc(stride_bytes * height);
+    cdata1 = (char *) malloc(TEST_CDATA_BYTES);
+    cdata2 = (char *) malloc(TEST_CDATA_BYTES);
+    if ((buf == NULL) || (cdata1 == NULL) || (cdata2 == NULL) ||
+            (rfxcodec_encode_create_ex(width, height, format, flags,
+                                       &accel) != 0) ||
+            (rfxcodec_encode_create_ex(width, height, format,
+                                       flags | RFX_FLAGS_NOACCEL,
+                                       &plain) != 0))
+    {
+        printf("check_accel: setup failed\n");
+        exit(1);
+    }
+    num_tiles = make_tiles(tiles, width, height);
+    region.x = 0;
+    region.y = 0;
+    region.cx = width;
+    region.cy = height;
+    bad = 0;
+    for (frame = 0; frame < TEST_FRAMES; frame++)
+    {
+        make_frame(buf, width, height, stride_bytes, format, frame);
+        bytes1 = TEST_CDATA_BYTES;
+        bytes2 = TEST_CDATA_BYTES;
+        written1 = rfxcodec_encode_ex(plain, cdata1, &bytes1, buf,
+                                      width, height, stride_bytes,
+                                      &region, 1, tiles, num_tiles,
+                                      g_quants, 1, encode_flags);
+        written2 = rfxcodec_encode_ex(accel, cdata2, &bytes2, buf,
+                                      width, height, stride_bytes,
+                                      &region, 1, tiles, num_tiles,
+                                      g_quants, 1, encode_flags);
+        if ((written1 != num_tiles) || (written2 != written1) ||
+                (bytes2 != bytes1) || (memcmp(cdata1, cdata2, bytes1) != 0))
+        {
+            printf("check_accel: format %d flags 0x%x encode_flags 0x%x "
+                   "frame %d differs, tiles %d %d bytes %d %d\n",
+                   format, flags, encode_flags, frame,
+                   written1, written2, bytes1, bytes2);
+            bad++;
+        }
+    }
+    rfxcodec_encode_destroy(accel);
+    rfxcodec_encode_destroy(plain);
+    free(buf);
+    free(cdata1);
+    free(cdata2);
+    return bad;
+}
+
+/*****************************************************************************/
+int
+main(int argc, char **argv)
+{
+    static const int formats[4] =
+    {
+        RFX_FORMAT_BGRA, RFX_FORMAT_RGBA, RFX_FORMAT_BGR, RFX_FORMAT_RGB
+    };
+    int index;
+    int bad;
+
+    bad = 0;
+    for (index = 0; index < 4; index++)
+    {
+        bad += check_accel(formats[index], RFX_FLAGS_RLGR3, 0);
+        bad += check_accel(formats[index], RFX_FLAGS_RLGR1, 0);
+        bad += check_accel(formats[index], RFX_FLAGS_RLGR3,
+                           RFX_FLAGS_ALPHAV1);
+        bad += check_accel(formats[index], RFX_FLAGS_RLGR1,
+                           RFX_FLAGS_ALPHAV1);
+    }
+    bad += check_accel(RFX_FORMAT_YUV, RFX_FLAGS_RLGR3, 0);
+    bad += check_accel(RFX_FORMAT_YUV, RFX_FLAGS_RLGR1, RFX_FLAGS_ALPHAV1);
+    bad += check_accel(RFX_FORMAT_YUV, RFX_FLAGS_PRO1, 0);
+    bad += check_accel(RFX_FORMAT_YUV, RFX_FLAGS_PRO1 | RFX_FLAGS_PRO_KEY, 0);
+    if (bad != 0)
+    {
+        printf("rfxacceltest: %d failed\n", bad);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,406 @@
+/**
+ * RFX codec encoder submit test
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * every call given to rfxcodec_encode_submit must complete exactly once,
+ * through get_fd and get_result or through the done callback, with the
+ * output rfxcodec_encode_ex gives for the same calls
+ */
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <poll.h>
+
+#include <pthread.h>
+
+#include <rfxcodec_encode.h>
+
+#define TEST_WIDTH 256
+#define TEST_HEIGHT 136 /* a row of partial tiles */
+#define TEST_CALLS 12
+#define TEST_MAX_TILES 32
+#define TEST_CDATA_BYTES (1024 * 1024)
+#define TEST_POLL_MS 10000
+
+static const char g_quants[10] =
+{
+    0x66, 0x66, 0x77, 0x88, 0x98,
+    0x99, 0x99, 0xaa, 0xcc, 0xdc
+};
+
+/* one submitted call, user points at it */
+struct test_call
+{
+    char *buf;
+    char *cdata;
+    char *expect;
+    int expect_bytes;
+    int expect_tiles;
+    int completions;
+};
+
+struct test_calls
+{
+    struct test_call calls[TEST_CALLS];
+    struct rfx_tile tiles[TEST_MAX_TILES];
+    struct rfx_rect region;
+    int num_tiles;
+    int stride_bytes;
+    /* done callback mode */
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int num_done;
+    int bad;
+};
+
+/*****************************************************************************/
+static void
+make_frame(char *buf, int stride_bytes, int frame)
+{
+    unsigned char *line;
+    int x;
+    int y;
+
+    for (y = 0; y < TEST_HEIGHT; y++)
+    {
+        line = (unsigned char *) (buf + y * stride_bytes);
+        for (x = 0; x < TEST_WIDTH; x++)
+        {
+            line[0] = x + frame * 16;
+            line[1] = y * 3 + frame;
+            line[2] = (x ^ y) + frame * 5;
+            line[3] = 0xff;
+            line += 4;
+        }
+    }
+}
+
+/*****************************************************************************/
+/* inputs and, from a plain rfxcodec_encode_ex handle, the expected
+   output of every call */
+static int
+calls_create(struct test_calls *tc, int flags)
+{
+    struct test_call *call;
+    struct rfx_tile *tile;
+    void *handle;
+    int index;
+    int x;
+    int y;
+
+    memset(tc, 0, sizeof(struct test_calls));
+    pthread_mutex_init(&(tc->mutex), NULL);
+    pthread_cond_init(&(tc->cond), NULL);
+    for (y = 0; y < TEST_HEIGHT; y += 64)
+    {
+        for (x = 0; x < TEST_WIDTH; x += 64)
+        {
+            tile = tc->tiles + tc->num_tiles;
+            tile->x = x;
+            tile->y = y;
+            tile->cx = TEST_WIDTH - x < 64 ? TEST_WIDTH - x : 64;
+            tile->cy = TEST_HEIGHT - y < 64 ? TEST_HEIGHT - y : 64;
+            tc->num_tiles++;
+        }
+    }
+    tc->region.cx = TEST_WIDTH;
+    tc->region.cy = TEST_HEIGHT;
+    tc->stride_bytes = TEST_WIDTH * 4;
+    if (rfxcodec_encode_create_ex(TEST_WIDTH, TEST_HEIGHT, RFX_FORMAT_BGRA,
+                                  flags, &handle) != 0)
+    {
+        return 1;
+    }
+    for (index = 0; index < TEST_CALLS; index++)
+    {
+        call = tc->calls + index;
+        call->buf = (char *) malloc(tc->stride_bytes * TEST_HEIGHT);
+        call->cdata = (char *) malloc(TEST_CDATA_BYTES);
+        call->expect = (char *) malloc(TEST_CDATA_BYTES);
+        if ((call->buf == NULL) || (call->cdata == NULL) ||
+                (call->expect == NULL))
+        {
+            return 1;
+        }
+        make_frame(call->buf, tc->stride_bytes, index);
+        call->expect_bytes = TEST_CDATA_BYTES;
+        call->expect_tiles =
+            rfxcodec_encode_ex(handle, call->expect, &(call->expect_bytes),
+                               call->buf, TEST_WIDTH, TEST_HEIGHT,
+                               tc->stride_bytes, &(tc->region), 1,
+                               tc->tiles, tc->num_tiles, g_quants, 1, 0);
+        if (call->expect_tiles != tc->num_tiles)
+        {
+            return 1;
+        }
+    }
+    rfxcodec_encode_destroy(handle);
+    return 0;
+}
+
+/*****************************************************************************/
+static void
+calls_destroy(struct test_calls *tc)
+{
+    int index;
+
+    for (index = 0; index < TEST_CALLS; index++)
+    {
+        free(tc->calls[index].buf);
+        free(tc->calls[index].cdata);
+        free(tc->calls[index].expect);
+    }
+    pthread_cond_destroy(&(tc->cond));
+    pthread_mutex_destroy(&(tc->mutex));
+}
+
+/*****************************************************************************/
+/* returns 1 if user is not one of tc's calls or the result is wrong */
+static int
+check_result(struct test_calls *tc, void *user, int tiles_written,
+             int cdata_bytes)
+{
+    struct test_call *call;
+    int index;
+
+    for (index = 0; index < TEST_CALLS; index++)
+    {
+        call = tc->calls + index;
+        if (user != call)
+        {
+            continue;
+        }
+        call->completions++;
+        if ((tiles_written != call->expect_tiles) ||
+                (cdata_bytes != call->expect_bytes) ||
+                (memcmp(call->cdata, call->expect, cdata_bytes) != 0))
+        {
+            printf("check_result: call %d tiles %d %d bytes %d %d\n",
+                   index, tiles_written, call->expect_tiles,
+                   cdata_bytes, call->expect_bytes);
+            return 1;
+        }
+        return 0;
+    }
+    printf("check_result: unknown user %p\n", user);
+    return 1;
+}
+
+/*****************************************************************************/
+static int
+submit_calls(void *handle, struct test_calls *tc,
+             rfxcodec_encode_done_proc done)
+{
+    struct test_call *call;
+    int index;
+
+    for (index = 0; index < TEST_CALLS; index++)
+    {
+        call = tc->calls + index;
+        if (rfxcodec_encode_submit(handle, call->cdata, TEST_CDATA_BYTES,
+                                   call->buf, TEST_WIDTH, TEST_HEIGHT,
+                                   tc->stride_bytes, &(tc->region), 1,
+                                   tc->tiles, tc->num_tiles,
+                                   g_quants, 1, 0, done, call) != 0)
+        {
+            printf("submit_calls: submit %d failed\n", index);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*****************************************************************************/
+/* returns the number of calls that did not complete exactly once */
+static int
+count_completions(struct test_calls *tc)
+{
+    int index;
+    int bad;
+
+    bad = 0;
+    for (index = 0; index < TEST_CALLS; index++)
+    {
+        if (tc->calls[index].completions != 1)
+        {
+            printf("count_completions: call %d completed %d times\n",
+                   index, tc->calls[index].completions);
+            bad++;
+        }
+    }
+    return bad;
+}
+
+/*****************************************************************************/
+/* done NULL, results are collected when the fd is readable */
+static int
+check_get_result(int flags)
+{
+    struct test_calls tc;
+    struct pollfd pfd;
+    void *handle;
+    void *user;
+    int tiles_written;
+    int cdata_bytes;
+    int results;
+    int bad;
+
+    if ((calls_create(&tc, flags) != 0) ||
+            (rfxcodec_encode_create_ex(TEST_WIDTH, TEST_HEIGHT,
+                                       RFX_FORMAT_BGRA, flags,
+                                       &handle) != 0))
+    {
+        printf("check_get_result: setup failed\n");
+        exit(1);
+    }
+    bad = 0;
+    if (rfxcodec_encode_get_result(handle, &user, &tiles_written,
+                                   &cdata_bytes) != 1)
+    {
+        printf("check_get_result: result before any submit\n");
+        bad++;
+    }
+    pfd.fd = rfxcodec_encode_get_fd(handle);
+    if (pfd.fd == -1)
+    {
+        printf("check_get_result: no fd\n");
+        exit(1);
+    }
+    bad += submit_calls(handle, &tc, NULL);
+    results = 0;
+    while (results < TEST_CALLS)
+    {
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, TEST_POLL_MS) != 1)
+        {
+            printf("check_get_result: fd not readable, %d results\n",
+                   results);
+            bad++;
+            break;
+        }
+        while (rfxcodec_encode_get_result(handle, &user, &tiles_written,
+                                          &cdata_bytes) == 0)
+        {
+            bad += check_result(&tc, user, tiles_written, cdata_bytes);
+            results++;
+        }
+    }
+    /* all taken, the fd must not stay readable */
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if ((poll(&pfd, 1, 0) != 0) ||
+            (rfxcodec_encode_get_result(handle, &user, &tiles_written,
+                                        &cdata_bytes) != 1))
+    {
+        printf("check_get_result: more results than calls\n");
+        bad++;
+    }
+    bad += count_completions(&tc);
+    rfxcodec_encode_destroy(handle);
+    calls_destroy(&tc);
+    return bad;
+}
+
+/*****************************************************************************/
+/* the calls done_proc checks against */
+static struct test_calls *g_done_calls = NULL;
+
+/*****************************************************************************/
+/* runs on the handle's thread, calls complete in submit order */
+static void
+done_proc(void *handle, void *user, int tiles_written, int cdata_bytes)
+{
+    struct test_calls *tc;
+
+    tc = g_done_calls;
+    pthread_mutex_lock(&(tc->mutex));
+    if (user != tc->calls + tc->num_done)
+    {
+        printf("done_proc: call %d out of order\n", tc->num_done);
+        tc->bad++;
+    }
+    tc->bad += check_result(tc, user, tiles_written, cdata_bytes);
+    tc->num_done++;
+    pthread_cond_signal(&(tc->cond));
+    pthread_mutex_unlock(&(tc->mutex));
+}
+
+/*****************************************************************************/
+/* done set, every call comes back through it and none through
+   get_result */
+static int
+check_done(int flags)
+{
+    struct test_calls tc;
+    void *handle;
+    void *user;
+    int tiles_written;
+    int cdata_bytes;
+    int bad;
+
+    if ((calls_create(&tc, flags) != 0) ||
+            (rfxcodec_encode_create_ex(TEST_WIDTH, TEST_HEIGHT,
+                                       RFX_FORMAT_BGRA, flags,
+                                       &handle) != 0))
+    {
+        printf("check_done: setup failed\n");
+        exit(1);
+    }
+    g_done_calls = &tc;
+    bad = submit_calls(handle, &tc, done_proc);
+    pthread_mutex_lock(&(tc.mutex));
+    while (tc.num_done < TEST_CALLS)
+    {
+        pthread_cond_wait(&(tc.cond), &(tc.mutex));
+    }
+    bad += tc.bad;
+    pthread_mutex_unlock(&(tc.mutex));
+    if (rfxcodec_encode_get_result(handle, &user, &tiles_written,
+                                   &cdata_bytes) != 1)
+    {
+        printf("check_done: result with a done callback\n");
+        bad++;
+    }
+    /* destroy runs anything still queued, nothing should be */
+    rfxcodec_encode_destroy(handle);
+    bad += count_completions(&tc);
+    g_done_calls = NULL;
+    calls_destroy(&tc);
+    return bad;
+}
+
+/*****************************************************************************/
+int
+main(int argc, char **argv)
+{
+    int bad;
+
+    bad = check_get_result(RFX_FLAGS_RLGR3);
+    bad += check_get_result(RFX_FLAGS_RLGR1);
+    bad += check_done(RFX_FLAGS_RLGR3);
+    if (bad != 0)
+    {
+        printf("rfxasynctest: %d failed\n", bad);
+        return 1;
+    }
+    return 0;
+}
@@ -50,7 +50,7 @@ get_mstime(void)
 
 /******************************************************************************/
 static int
-speed_random(int count, const char *quants)
+speed_random(int count, const char *quants, int num_threads, int pipeline)
 {
     void *han;
     int error;
@@ -81,6 +81,14 @@ speed_random(int count, const char *quants)
         return 1;
     }
     printf("speed_random: rfxcodec_encode_create_ex ok\n");
+    if (rfxcodec_encode_set_threads(han, num_threads) != 0)
+    {
+        printf("speed_random: rfxcodec_encode_set_threads failed\n");
+    }
+    if (rfxcodec_encode_set_pipeline(han, pipeline) != 0)
+    {
+        printf("speed_random: rfxcodec_encode_set_pipeline failed\n");
+    }
     cdata = (char *) malloc(128 * 64 * 4);
     cdata_bytes = 128 * 64 * 4;
     buf = (char *) malloc(128 * 64 * 4);
@@ -244,7 +252,8 @@ load_bmp_file(int in_fd, char **data, int *width, int *height)
 /******************************************************************************/
 static int
 encode_file(char *data, int width, int height, char *cdata, int *cdata_bytes,
-            const char *quants, int num_quants)
+            const char *quants, int num_quants, int num_threads,
+            int pipeline)
 {
     int awidth;
     int aheight;
@@ -264,6 +273,14 @@ encode_file(char *data, int width, int height, char *cdata, int *cdata_bytes,
         printf("encode_file: rfxcodec_encode_create_ex failed\n");
         return 1;
     }
+    if (rfxcodec_encode_set_threads(han, num_threads) != 0)
+    {
+        printf("encode_file: rfxcodec_encode_set_threads failed\n");
+    }
+    if (rfxcodec_encode_set_pipeline(han, pipeline) != 0)
+    {
+        printf("encode_file: rfxcodec_encode_set_pipeline failed\n");
+    }
 
     awidth = (width + 63) & ~63;
     aheight = (height + 63) & ~63;
@@ -311,7 +328,8 @@ encode_file(char *data, int width, int height, char *cdata, int *cdata_bytes,
 /******************************************************************************/
 static int
 read_file(int count, const char *quants, int num_quants,
-          const char *in_file, const char *out_file)
+          const char *in_file, const char *out_file, int num_threads,
+          int pipeline)
 {
     int in_fd;
     int out_fd;
@@ -354,7 +372,8 @@ read_file(int count, const char *quants, int num_quants,
     printf("loaded file ok width %d height %d\n", width, height);
     cdata_bytes = (width + 64) * (height + 64);
     cdata = (char *) malloc(cdata_bytes);
-    if (encode_file(data, width, height, cdata, &cdata_bytes, quants, num_quants) != 0)
+    if (encode_file(data, width, height, cdata, &cdata_bytes, quants,
+                    num_quants, num_threads, pipeline) != 0)
     {
         printf("encode_file failed\n");
         return 1;
@@ -389,6 +408,8 @@ out_usage(void)
     printf("examples\n");
     printf("  ./rfxcodectest --speed --count 1000\n");
     printf("  ./rfxcodectest -i infile.bmp -o outfile.rfx\n");
+    printf("  ./rfxcodectest -i infile.bmp -o outfile.rfx --threads 4\n");
+    printf("  ./rfxcodectest -i infile.bmp -o outfile.rfx --pipeline\n");
     printf("\n");
     return 0;
 }
@@ -401,6 +422,8 @@ main(int argc, char **argv)
     int do_speed;
     int do_read;
     int count;
+    int num_threads;
+    int pipeline;
     char in_file[256];
     char out_file[256];
     const char *quants = (const char *) g_rfx_default_quantization_values;
@@ -410,6 +433,8 @@ main(int argc, char **argv)
     in_file[0] = 0;
     out_file[0] = 0;
     count = 1;
+    num_threads = 0;
+    pipeline = 0;
     if (argc < 2)
     {
         return out_usage();
@@ -425,6 +450,15 @@ main(int argc, char **argv)
             index++;
             count = atoi(argv[index]);
         }
+        else if (strcmp("--threads", argv[index]) == 0)
+        {
+            index++;
+            num_threads = atoi(argv[index]);
+        }
+        else if (strcmp("--pipeline", argv[index]) == 0)
+        {
+            pipeline = 1;
+        }
         else if (strcmp("-i", argv[index]) == 0)
         {
             index++;
@@ -443,11 +477,12 @@ main(int argc, char **argv)
     }
     if (do_speed)
     {
-        speed_random(count, quants);
+        speed_random(count, quants, num_threads, pipeline);
     }
     if (do_read)
     {
-        read_file(count, quants, 2, in_file, out_file);
+        read_file(count, quants, 2, in_file, out_file, num_threads,
+                  pipeline);
     }
     return 0;
 }
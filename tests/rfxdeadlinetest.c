@@ -0,0 +1,279 @@
+/**
+ * RFX codec encoder deadline test
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * rfxcodec_encode_deadline must give the tiles highest priority first,
+ * ties in tiles order, and when the deadline passes stop with a tileset
+ * that is what rfxcodec_encode_ex gives for the tiles it did send
+ */
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rfxcodec_encode.h>
+
+#define TEST_WIDTH 1280
+#define TEST_HEIGHT 720 /* 240 tiles, the last row partial */
+#define TEST_MAX_TILES 256
+#define TEST_CDATA_BYTES (8 * 1024 * 1024)
+/* far less than any tile takes, only the first is sent for sure */
+#define TEST_DEADLINE_US 1
+
+static const char g_quants[10] =
+{
+    0x66, 0x66, 0x77, 0x88, 0x98,
+    0x99, 0x99, 0xaa, 0xcc, 0xdc
+};
+
+static unsigned int g_seed = 1;
+
+/*****************************************************************************/
+static int
+test_rand(void)
+{
+    g_seed = g_seed * 1103515245 + 12345;
+    return (g_seed >> 8) & 0xffff;
+}
+
+/*****************************************************************************/
+static void
+make_frame(char *buf, int stride_bytes)
+{
+    unsigned char *line;
+    int x;
+    int y;
+
+    for (y = 0; y < TEST_HEIGHT; y++)
+    {
+        line = (unsigned char *) (buf + y * stride_bytes);
+        for (x = 0; x < TEST_WIDTH; x++)
+        {
+            line[0] = x + test_rand() % 8;
+            line[1] = y;
+            line[2] = x ^ y;
+            line[3] = 0xff;
+            line += 4;
+        }
+    }
+}
+
+/*****************************************************************************/
+static int
+make_tiles(struct rfx_tile *tiles)
+{
+    struct rfx_tile *tile;
+    int num_tiles;
+    int x;
+    int y;
+
+    num_tiles = 0;
+    for (y = 0; y < TEST_HEIGHT; y += 64)
+    {
+        for (x = 0; x < TEST_WIDTH; x += 64)
+        {
+            tile = tiles + num_tiles;
+            tile->x = x;
+            tile->y = y;
+            tile->cx = TEST_WIDTH - x < 64 ? TEST_WIDTH - x : 64;
+            tile->cy = TEST_HEIGHT - y < 64 ? TEST_HEIGHT - y : 64;
+            tile->quant_y = 0;
+            tile->quant_cb = 0;
+            tile->quant_cr = 0;
+            num_tiles++;
+        }
+    }
+    return num_tiles;
+}
+
+/*****************************************************************************/
+/* order must hold every index once, highest priority first and ties in
+   index order, or be 0, 1, 2, ... without priorities
+   returns 1 if it does not */
+static int
+check_order(const int *order, const int *priorities, int num_tiles)
+{
+    char seen[TEST_MAX_TILES];
+    int index;
+    int prev;
+    int cur;
+
+    memset(seen, 0, sizeof(seen));
+    for (index = 0; index < num_tiles; index++)
+    {
+        cur = order[index];
+        if ((cur < 0) || (cur >= num_tiles) || seen[cur])
+        {
+            printf("check_order: order[%d] %d not a new tile\n", index, cur);
+            return 1;
+        }
+        seen[cur] = 1;
+        if (index < 1)
+        {
+            continue;
+        }
+        prev = order[index - 1];
+        if (priorities == NULL)
+        {
+            if (cur != index)
+            {
+                printf("check_order: order[%d] %d without priorities\n",
+                       index, cur);
+                return 1;
+            }
+        }
+        else if ((priorities[prev] < priorities[cur]) ||
+                 ((priorities[prev] == priorities[cur]) && (prev > cur)))
+        {
+            printf("check_order: order[%d] %d priority %d after %d "
+                   "priority %d\n", index, cur, priorities[cur],
+                   prev, priorities[prev]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*****************************************************************************/
+/* encodes a frame with rfxcodec_encode_deadline on handle set up with
+   pool, NULL for none, and compares it with rfxcodec_encode_ex on a new
+   handle given the tiles that were sent in the order they were sent
+   returns the number of checks that failed */
+static int
+check_deadline(int flags, void *pool, int use_priorities, int deadline_us)
+{
+    struct rfx_tile tiles[TEST_MAX_TILES];
+    struct rfx_tile sent[TEST_MAX_TILES];
+    struct rfx_rect region;
+    int priorities[TEST_MAX_TILES];
+    int order[TEST_MAX_TILES];
+    void *handle;
+    void *ref;
+    char *buf;
+    char *cdata;
+    char *ref_cdata;
+    int stride_bytes;
+    int num_tiles;
+    int bytes;
+    int ref_bytes;
+    int written;
+    int ref_written;
+    int index;
+    int bad;
+
+    stride_bytes = TEST_WIDTH * 4;
+    buf = (char *) malloc(stride_bytes * TEST_HEIGHT);
+    cdata = (char *) malloc(TEST_CDATA_BYTES);
+    ref_cdata = (char *) malloc(TEST_CDATA_BYTES);
+    if ((buf == NULL) || (cdata == NULL) || (ref_cdata == NULL) ||
+            (rfxcodec_encode_create_ex(TEST_WIDTH, TEST_HEIGHT,
+                                       RFX_FORMAT_BGRA, flags,
+                                       &handle) != 0) ||
+            (rfxcodec_encode_create_ex(TEST_WIDTH, TEST_HEIGHT,
+                                       RFX_FORMAT_BGRA, flags,
+                                       &ref) != 0) ||
+            ((pool != NULL) && (rfxcodec_encode_set_pool(handle, pool) != 0)))
+    {
+        printf("check_deadline: setup failed\n");
+        exit(1);
+    }
+    make_frame(buf, stride_bytes);
+    num_tiles = make_tiles(tiles);
+    for (index = 0; index < num_tiles; index++)
+    {
+        /* few values so there are plenty of ties */
+        priorities[index] = test_rand() % 4;
+    }
+    region.x = 0;
+    region.y = 0;
+    region.cx = TEST_WIDTH;
+    region.cy = TEST_HEIGHT;
+    memset(order, 0xff, sizeof(order));
+    bytes = TEST_CDATA_BYTES;
+    written = rfxcodec_encode_deadline(handle, cdata, &bytes, buf,
+                                       TEST_WIDTH, TEST_HEIGHT,
+                                       stride_bytes, &region, 1,
+                                       tiles, num_tiles, g_quants, 1, 0,
+                                       use_priorities ? priorities : NULL,
+                                       deadline_us, order);
+    bad = check_order(order, use_priorities ? priorities : NULL, num_tiles);
+    if ((written < 1) || (written > num_tiles) ||
+            ((deadline_us == 0) && (written != num_tiles)) ||
+            ((deadline_us != 0) && (written == num_tiles)))
+    {
+        printf("check_deadline: flags 0x%x deadline_us %d wrote %d of %d "
+               "tiles\n", flags, deadline_us, written, num_tiles);
+        bad++;
+    }
+    if (bad == 0)
+    {
+        for (index = 0; index < written; index++)
+        {
+            sent[index] = tiles[order[index]];
+        }
+        ref_bytes = TEST_CDATA_BYTES;
+        ref_written = rfxcodec_encode_ex(ref, ref_cdata, &ref_bytes, buf,
+                                         TEST_WIDTH, TEST_HEIGHT,
+                                         stride_bytes, &region, 1,
+                                         sent, written, g_quants, 1, 0);
+        if ((ref_written != written) || (ref_bytes != bytes) ||
+                (memcmp(ref_cdata, cdata, bytes) != 0))
+        {
+            printf("check_deadline: flags 0x%x deadline_us %d tileset "
+                   "differs, tiles %d %d bytes %d %d\n", flags,
+                   deadline_us, written, ref_written, bytes, ref_bytes);
+            bad++;
+        }
+    }
+    rfxcodec_encode_destroy(handle);
+    rfxcodec_encode_destroy(ref);
+    free(buf);
+    free(cdata);
+    free(ref_cdata);
+    return bad;
+}
+
+/*****************************************************************************/
+int
+main(int argc, char **argv)
+{
+    void *pool;
+    int bad;
+
+    bad = check_deadline(RFX_FLAGS_RLGR3, NULL, 1, 0);
+    bad += check_deadline(RFX_FLAGS_RLGR3, NULL, 0, 0);
+    bad += check_deadline(RFX_FLAGS_RLGR3, NULL, 1, TEST_DEADLINE_US);
+    bad += check_deadline(RFX_FLAGS_RLGR1, NULL, 1, TEST_DEADLINE_US);
+    bad += check_deadline(RFX_FLAGS_RLGR3, NULL, 0, TEST_DEADLINE_US);
+    if (rfxcodec_encode_pool_create(0, &pool) != 0)
+    {
+        printf("rfxdeadlinetest: rfxcodec_encode_pool_create failed\n");
+        return 1;
+    }
+    bad += check_deadline(RFX_FLAGS_RLGR3, pool, 1, 0);
+    bad += check_deadline(RFX_FLAGS_RLGR3, pool, 1, TEST_DEADLINE_US);
+    rfxcodec_encode_pool_destroy(pool);
+    if (bad != 0)
+    {
+        printf("rfxdeadlinetest: %d failed\n", bad);
+        return 1;
+    }
+    return 0;
+}
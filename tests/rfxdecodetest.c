@@ -0,0 +1,383 @@
+/**
+ * RFX codec decoder test
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * frames from rfxcodec_encode must come back from rfxcodec_decode close
+ * to the source, alpha exact with RFX_FLAGS_ALPHAV1, nothing outside the
+ * region or past the row written, and cut short input must fail
+ */
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <rfxcodec_encode.h>
+#include <rfxcodec_decode.h>
+
+#define TEST_WIDTH 200 /* not a multiple of 64 so there are partial tiles */
+#define TEST_HEIGHT 136
+/* RFX_FORMAT_YUV is whole tiles */
+#define TEST_YUV_WIDTH 192
+#define TEST_YUV_HEIGHT 128
+#define TEST_FRAMES 2
+#define TEST_MAX_TILES 16
+#define TEST_CDATA_BYTES (1024 * 1024)
+/* about 42 to 44 dB with g_quants on this content */
+#define TEST_MIN_PSNR 40.0
+#define TEST_FILL 0x5a
+
+static const char g_quants[10] =
+{
+    0x66, 0x66, 0x66, 0x66, 0x66,
+    0x66, 0x66, 0x66, 0x66, 0x66
+};
+
+static unsigned int g_seed = 1;
+
+/*****************************************************************************/
+static int
+test_rand(void)
+{
+    g_seed = g_seed * 1103515245 + 12345;
+    return (g_seed >> 8) & 0xffff;
+}
+
+/*****************************************************************************/
+static int
+get_bpp(int format)
+{
+    if ((format == RFX_FORMAT_BGR) || (format == RFX_FORMAT_RGB))
+    {
+        return 3;
+    }
+    return 4;
+}
+
+/*****************************************************************************/
+/* smooth gradients with some noise and an alpha ramp, moved each frame */
+static void
+make_frame(char *buf, int width, int height, int stride_bytes, int format,
+           int frame)
+{
+    unsigned char *line;
+    unsigned char *tile;
+    int bpp;
+    int x;
+    int y;
+    int index;
+
+    if (format == RFX_FORMAT_YUV)
+    {
+        /* each 64x64 tile is 4 planes of 4096 bytes, Y U V A */
+        for (y = 0; y < height; y += 64)
+        {
+            for (x = 0; x < width; x += 64)
+            {
+                tile = (unsigned char *) buf + y * stride_bytes + (x << 8);
+                for (index = 0; index < 4096; index++)
+                {
+                    tile[index] = (index & 63) * 3 + y + frame * 8;
+                    tile[4096 + index] = 128 + (index >> 6) + x;
+                    tile[8192 + index] = 100 + (index & 7) + frame;
+                    tile[12288 + index] = (index * 7) & 0xff;
+                }
+            }
+        }
+        return;
+    }
+    bpp = get_bpp(format);
+    for (y = 0; y < height; y++)
+    {
+        line = (unsigned char *) (buf + y * stride_bytes);
+        for (x = 0; x < width; x++)
+        {
+            line[0] = (x * 255 / width + frame * 8) + test_rand() % 5;
+            line[1] = y * 255 / height;
+            line[2] = ((x + y) * 3 + frame) & 0xff;
+            if (bpp == 4)
+            {
+                line[3] = (x * 4 + y) & 0xff;
+            }
+            line += bpp;
+        }
+    }
+}
+
+/*****************************************************************************/
+static int
+make_tiles(struct rfx_tile *tiles, int width, int height)
+{
+    struct rfx_tile *tile;
+    int num_tiles;
+    int x;
+    int y;
+
+    num_tiles = 0;
+    for (y = 0; y < height; y += 64)
+    {
+        for (x = 0; x < width; x += 64)
+        {
+            tile = tiles + num_tiles;
+            tile->x = x;
+            tile->y = y;
+            tile->cx = width - x < 64 ? width - x : 64;
+            tile->cy = height - y < 64 ? height - y : 64;
+            tile->quant_y = 0;
+            tile->quant_cb = 0;
+            tile->quant_cr = 0;
+            num_tiles++;
+        }
+    }
+    return num_tiles;
+}
+
+/*****************************************************************************/
+/* compares a decoded frame with its source, colour by PSNR, alpha
+   exact or 0xff without alpha, TEST_FILL outside region and past the
+   last pixel of each row
+   returns 1 if it is not close enough */
+static int
+check_frame(const char *src, const char *dst, int width, int height,
+            int stride_bytes, int format, int alpha,
+            const struct rfx_rect *region)
+{
+    const unsigned char *s;
+    const unsigned char *d;
+    double sum;
+    double psnr;
+    long count;
+    int misses;
+    int bpp;
+    int inside;
+    int diff;
+    int x;
+    int y;
+    int c;
+
+    s = (const unsigned char *) src;
+    d = (const unsigned char *) dst;
+    sum = 0;
+    count = 0;
+    misses = 0;
+    if (format == RFX_FORMAT_YUV)
+    {
+        for (x = 0; x < stride_bytes * height; x++)
+        {
+            diff = s[x] - d[x];
+            if (((x >> 12) & 3) == 3)
+            {
+                misses += alpha && (diff != 0);
+                continue;
+            }
+            sum += diff * diff;
+            count++;
+        }
+    }
+    else
+    {
+        bpp = get_bpp(format);
+        for (y = 0; y < height; y++)
+        {
+            for (x = 0; x < width; x++)
+            {
+                inside = (x >= region->x) && (x < region->x + region->cx) &&
+                         (y >= region->y) && (y < region->y + region->cy);
+                for (c = 0; c < bpp; c++)
+                {
+                    diff = s[y * stride_bytes + x * bpp + c] -
+                           d[y * stride_bytes + x * bpp + c];
+                    if (!inside)
+                    {
+                        misses += d[y * stride_bytes + x * bpp + c] !=
+                                  TEST_FILL;
+                    }
+                    else if (c == 3)
+                    {
+                        misses += alpha ? diff != 0 :
+                                  d[y * stride_bytes + x * bpp + c] != 0xff;
+                    }
+                    else
+                    {
+                        sum += diff * diff;
+                        count++;
+                    }
+                }
+            }
+            for (x = width * bpp; x < stride_bytes; x++)
+            {
+                misses += d[y * stride_bytes + x] != TEST_FILL;
+            }
+        }
+    }
+    psnr = 10 * log10(255.0 * 255.0 / (sum / count + 1e-9));
+    if ((psnr < TEST_MIN_PSNR) || (misses != 0))
+    {
+        printf("check_frame: format %d alpha %d psnr %.2f misses %d\n",
+               format, alpha, psnr, misses);
+        return 1;
+    }
+    return 0;
+}
+
+/*****************************************************************************/
+/* encodes TEST_FRAMES frames with one handle, decodes them with another
+   and compares each with its source, the first frame is also decoded
+   cut short
+   returns the number of checks that failed */
+static int
+check_decode(int format, int flags, int encode_flags, int clip)
+{
+    struct rfx_tile tiles[TEST_MAX_TILES];
+    struct rfx_rect region;
+    void *encoder;
+    void *decoder;
+    char *buf;
+    char *dst;
+    char *cdata;
+    int width;
+    int height;
+    int stride_bytes;
+    int num_tiles;
+    int bytes;
+    int frame;
+    int bad;
+
+    width = TEST_WIDTH;
+    height = TEST_HEIGHT;
+    stride_bytes = width * get_bpp(format) + 4;
+    if (format == RFX_FORMAT_YUV)
+    {
+        width = TEST_YUV_WIDTH;
+        height = TEST_YUV_HEIGHT;
+        stride_bytes = width * 4;
+    }
+    buf = (char *) malloc(stride_bytes * height);
+    dst = (char *) malloc(stride_bytes * height);
+    cdata = (char *) malloc(TEST_CDATA_BYTES);
+    if ((buf == NULL) || (dst == NULL) || (cdata == NULL) ||
+            (rfxcodec_encode_create_ex(width, height, format, flags,
+                                       &encoder) != 0) ||
+            (rfxcodec_decode_create(width, height, format, 0,
+                                    &decoder) != 0))
+    {
+        printf("check_decode: setup failed\n");
+        exit(1);
+    }
+    num_tiles = make_tiles(tiles, width, height);
+    region.x = 0;
+    region.y = 0;
+    region.cx = width;
+    region.cy = height;
+    if (clip)
+    {
+        region.x = 10;
+        region.y = 5;
+        region.cx = width - 20;
+        region.cy = height - 12;
+    }
+    bad = 0;
+    for (frame = 0; frame < TEST_FRAMES; frame++)
+    {
+        make_frame(buf, width, height, stride_bytes, format, frame);
+        bytes = TEST_CDATA_BYTES;
+        if (rfxcodec_encode_ex(encoder, cdata, &bytes, buf, width, height,
+                               stride_bytes, &region, 1, tiles, num_tiles,
+                               g_quants, 1, encode_flags) != num_tiles)
+        {
+            printf("check_decode: encode failed\n");
+            exit(1);
+        }
+        if (frame == 0)
+        {
+            /* the header and part of the tileset, must fail and not
+               touch the handle for the whole frame that follows */
+            if ((rfxcodec_decode(decoder, cdata, bytes / 2, dst,
+                                 width, height, stride_bytes) == 0) ||
+                    (rfxcodec_decode(decoder, cdata, bytes - 1, dst,
+                                     width, height, stride_bytes) == 0))
+            {
+                printf("check_decode: format %d flags 0x%x short input "
+                       "decoded\n", format, flags);
+                bad++;
+            }
+        }
+        memset(dst, TEST_FILL, stride_bytes * height);
+        if (rfxcodec_decode(decoder, cdata, bytes, dst, width, height,
+                            stride_bytes) != 0)
+        {
+            printf("check_decode: format %d flags 0x%x frame %d decode "
+                   "failed\n", format, flags, frame);
+            bad++;
+            continue;
+        }
+        bad += check_frame(buf, dst, width, height, stride_bytes, format,
+                           encode_flags & RFX_FLAGS_ALPHAV1, &region);
+    }
+    rfxcodec_encode_destroy(encoder);
+    rfxcodec_decode_destroy(decoder);
+    free(buf);
+    free(dst);
+    free(cdata);
+    return bad;
+}
+
+/*****************************************************************************/
+int
+main(int argc, char **argv)
+{
+    static const int formats[4] =
+    {
+        RFX_FORMAT_BGRA, RFX_FORMAT_RGBA, RFX_FORMAT_BGR, RFX_FORMAT_RGB
+    };
+    void *decoder;
+    int index;
+    int bad;
+
+    bad = 0;
+    for (index = 0; index < 4; index++)
+    {
+        bad += check_decode(formats[index], RFX_FLAGS_RLGR3, 0, 0);
+        bad += check_decode(formats[index], RFX_FLAGS_RLGR1, 0, 0);
+        bad += check_decode(formats[index], RFX_FLAGS_RLGR1, 0, 1);
+    }
+    bad += check_decode(RFX_FORMAT_BGRA, RFX_FLAGS_RLGR3,
+                        RFX_FLAGS_ALPHAV1, 0);
+    bad += check_decode(RFX_FORMAT_RGBA, RFX_FLAGS_RLGR1,
+                        RFX_FLAGS_ALPHAV1, 1);
+    bad += check_decode(RFX_FORMAT_YUV, RFX_FLAGS_RLGR3, 0, 0);
+    bad += check_decode(RFX_FORMAT_YUV, RFX_FLAGS_RLGR1,
+                        RFX_FLAGS_ALPHAV1, 0);
+    /* progressive is encode only */
+    if (rfxcodec_decode_create(TEST_YUV_WIDTH, TEST_YUV_HEIGHT,
+                               RFX_FORMAT_YUV, RFX_FLAGS_PRO1,
+                               &decoder) == 0)
+    {
+        printf("rfxdecodetest: progressive decoder created\n");
+        rfxcodec_decode_destroy(decoder);
+        bad++;
+    }
+    if (bad != 0)
+    {
+        printf("rfxdecodetest: %d failed\n", bad);
+        return 1;
+    }
+    return 0;
+}
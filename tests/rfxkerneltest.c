@@ -0,0 +1,498 @@
+/**
+ * RFX codec encoder kernel test
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * every SIMD kernel rfxcodec_encode_get_internals gives, not only the one
+ * rfxcodec_encode_create_ex picks, must match the C code on extreme and
+ * random tiles, kernels the cpu can not run are skipped
+ */
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rfxcodec_encode.h>
+
+#define TEST_EXTREME_TILES 6 /* see make_tile */
+#define TEST_TILES (TEST_EXTREME_TILES + 32)
+#define TEST_QUANTS 3
+
+#define TEST_ISA_SSE2 0
+#define TEST_ISA_SSE41 1
+#define TEST_ISA_AVX2 2
+#define TEST_ISA_AVX512BW 3
+
+/* the 5 bytes of one component, finest to coarsest quant */
+static const char g_quants[TEST_QUANTS][5] =
+{
+    { 0x66, 0x66, 0x66, 0x66, 0x66 },
+    { 0x66, 0x77, 0x88, 0x98, 0x99 },
+    { 0xff, 0xff, 0xff, 0xff, 0xff }
+};
+
+static unsigned int g_seed = 1;
+
+typedef int (*dwt_shift_proc)(const char *qtable, const unsigned char *data,
+                              short *dwt_buffer1, short *dwt_buffer);
+
+struct dwt_kernel
+{
+    const char *name;
+    dwt_shift_proc proc;
+    int isa;
+};
+
+typedef int (*rem_dwt_shift_proc)(const unsigned char *in_buffer,
+                                  short *out_buffer, short *tmp_buffer,
+                                  const char *quants);
+
+struct rem_kernel
+{
+    const char *name;
+    rem_dwt_shift_proc proc;
+    int isa;
+};
+
+typedef int (*differential_pro_proc)(const short *coefs, const short *history,
+                                     short *diff, short *history_out,
+                                     int *diff_zeros, int *coef_zeros);
+
+struct diff_kernel
+{
+    const char *name;
+    differential_pro_proc proc;
+    int isa;
+};
+
+/*****************************************************************************/
+static int
+test_rand(void)
+{
+    g_seed = g_seed * 1103515245 + 12345;
+    return (g_seed >> 8) & 0xffff;
+}
+
+/*****************************************************************************/
+/* returns non zero if the cpu and OS can run code for isa */
+static int
+got_isa(int isa)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    switch (isa)
+    {
+        case TEST_ISA_SSE2:
+            return __builtin_cpu_supports("sse2");
+        case TEST_ISA_SSE41:
+            return __builtin_cpu_supports("sse4.1");
+        case TEST_ISA_AVX2:
+            return __builtin_cpu_supports("avx2");
+        case TEST_ISA_AVX512BW:
+            return __builtin_cpu_supports("avx512bw");
+    }
+#endif
+    return 0;
+}
+
+/*****************************************************************************/
+/* 64 x 64 8 bit tile, index 0 to TEST_EXTREME_TILES - 1 are all 0, all
+   255, a 0 and 255 checkerboard, 0 and 255 columns, 0 and 255 rows and a
+   sharp diagonal, the rest random */
+static void
+make_tile(unsigned char *data, int index)
+{
+    int x;
+    int y;
+
+    for (y = 0; y < 64; y++)
+    {
+        for (x = 0; x < 64; x++)
+        {
+            switch (index)
+            {
+                case 0:
+                    data[y * 64 + x] = 0;
+                    break;
+                case 1:
+                    data[y * 64 + x] = 255;
+                    break;
+                case 2:
+                    data[y * 64 + x] = ((x ^ y) & 1) * 255;
+                    break;
+                case 3:
+                    data[y * 64 + x] = (x & 1) * 255;
+                    break;
+                case 4:
+                    data[y * 64 + x] = (y & 1) * 255;
+                    break;
+                case 5:
+                    data[y * 64 + x] = x > y ? 255 : 0;
+                    break;
+                default:
+                    data[y * 64 + x] = test_rand();
+                    break;
+            }
+        }
+    }
+}
+
+/*****************************************************************************/
+/* each dwt_shift kernel against rfxencode_dwt_2d then
+   rfxencode_quantization
+   returns the number of kernel, tile and quant runs that differ */
+static int
+check_dwt(const struct rfxcodec_encode_internals *internals)
+{
+    struct dwt_kernel kernels[9];
+    unsigned char *data;
+    short *expect;
+    short *coefs;
+    short *tmp;
+    int num_kernels;
+    int kernel;
+    int tile;
+    int quant;
+    int bad;
+
+    num_kernels = 0;
+    kernels[num_kernels].name = "x86_sse2";
+    kernels[num_kernels].proc = internals->rfxencode_dwt_shift_x86_sse2;
+    kernels[num_kernels++].isa = TEST_ISA_SSE2;
+    kernels[num_kernels].name = "x86_sse41";
+    kernels[num_kernels].proc = internals->rfxencode_dwt_shift_x86_sse41;
+    kernels[num_kernels++].isa = TEST_ISA_SSE41;
+    kernels[num_kernels].name = "amd64_sse2";
+    kernels[num_kernels].proc = internals->rfxencode_dwt_shift_amd64_sse2;
+    kernels[num_kernels++].isa = TEST_ISA_SSE2;
+    kernels[num_kernels].name = "amd64_sse41";
+    kernels[num_kernels].proc = internals->rfxencode_dwt_shift_amd64_sse41;
+    kernels[num_kernels++].isa = TEST_ISA_SSE41;
+    kernels[num_kernels].name = "amd64_avx2";
+    kernels[num_kernels].proc = internals->rfxencode_dwt_shift_amd64_avx2;
+    kernels[num_kernels++].isa = TEST_ISA_AVX2;
+    kernels[num_kernels].name = "amd64_avx512";
+    kernels[num_kernels].proc = internals->rfxencode_dwt_shift_amd64_avx512;
+    kernels[num_kernels++].isa = TEST_ISA_AVX512BW;
+    kernels[num_kernels].name = "intrin_sse2";
+    kernels[num_kernels].proc = internals->rfxencode_dwt_shift_intrin_sse2;
+    kernels[num_kernels++].isa = TEST_ISA_SSE2;
+    kernels[num_kernels].name = "intrin_sse41";
+    kernels[num_kernels].proc = internals->rfxencode_dwt_shift_intrin_sse41;
+    kernels[num_kernels++].isa = TEST_ISA_SSE41;
+    kernels[num_kernels].name = "intrin_avx2";
+    kernels[num_kernels].proc = internals->rfxencode_dwt_shift_intrin_avx2;
+    kernels[num_kernels++].isa = TEST_ISA_AVX2;
+
+    data = (unsigned char *) malloc(4096);
+    expect = (short *) malloc(4096 * sizeof(short));
+    coefs = (short *) malloc(4096 * sizeof(short));
+    tmp = (short *) malloc(4096 * sizeof(short));
+    if ((data == NULL) || (expect == NULL) || (coefs == NULL) ||
+            (tmp == NULL))
+    {
+        printf("check_dwt: malloc failed\n");
+        exit(1);
+    }
+    bad = 0;
+    for (kernel = 0; kernel < num_kernels; kernel++)
+    {
+        if ((kernels[kernel].proc == NULL) ||
+                !got_isa(kernels[kernel].isa))
+        {
+            continue;
+        }
+        printf("check_dwt: dwt_shift_%s\n", kernels[kernel].name);
+        g_seed = 1;
+        for (tile = 0; tile < TEST_TILES; tile++)
+        {
+            make_tile(data, tile);
+            for (quant = 0; quant < TEST_QUANTS; quant++)
+            {
+                internals->rfxencode_dwt_2d(data, expect, tmp);
+                internals->rfxencode_quantization(expect, g_quants[quant]);
+                memset(coefs, 0x5a, 4096 * sizeof(short));
+                kernels[kernel].proc(g_quants[quant], data, coefs, tmp);
+                if (memcmp(coefs, expect, 4096 * sizeof(short)) != 0)
+                {
+                    printf("check_dwt: dwt_shift_%s tile %d quant %d "
+                           "differs\n", kernels[kernel].name, tile, quant);
+                    bad++;
+                }
+            }
+        }
+    }
+    free(data);
+    free(expect);
+    free(coefs);
+    free(tmp);
+    return bad;
+}
+
+/*****************************************************************************/
+/* each progressive rem_dwt_shift kernel against rfxencode_rem_dwt_shift
+   returns the number of kernel, tile and quant runs that differ */
+static int
+check_rem(const struct rfxcodec_encode_internals *internals)
+{
+    struct rem_kernel kernels[2];
+    unsigned char *data;
+    short *expect;
+    short *coefs;
+    short *tmp;
+    int num_kernels;
+    int kernel;
+    int tile;
+    int quant;
+    int bad;
+
+    num_kernels = 0;
+    kernels[num_kernels].name = "amd64_sse41";
+    kernels[num_kernels].proc = internals->rfxencode_rem_dwt_shift_amd64_sse41;
+    kernels[num_kernels++].isa = TEST_ISA_SSE41;
+    kernels[num_kernels].name = "amd64_avx2";
+    kernels[num_kernels].proc = internals->rfxencode_rem_dwt_shift_amd64_avx2;
+    kernels[num_kernels++].isa = TEST_ISA_AVX2;
+
+    data = (unsigned char *) malloc(4096);
+    expect = (short *) malloc(4096 * sizeof(short));
+    coefs = (short *) malloc(4096 * sizeof(short));
+    tmp = (short *) malloc(4096 * sizeof(short));
+    if ((data == NULL) || (expect == NULL) || (coefs == NULL) ||
+            (tmp == NULL))
+    {
+        printf("check_rem: malloc failed\n");
+        exit(1);
+    }
+    bad = 0;
+    for (kernel = 0; kernel < num_kernels; kernel++)
+    {
+        if ((kernels[kernel].proc == NULL) ||
+                !got_isa(kernels[kernel].isa))
+        {
+            continue;
+        }
+        printf("check_rem: rem_dwt_shift_%s\n", kernels[kernel].name);
+        g_seed = 1;
+        for (tile = 0; tile < TEST_TILES; tile++)
+        {
+            make_tile(data, tile);
+            for (quant = 0; quant < TEST_QUANTS; quant++)
+            {
+                internals->rfxencode_rem_dwt_shift(data, expect, tmp,
+                                                   g_quants[quant]);
+                memset(coefs, 0x5a, 4096 * sizeof(short));
+                kernels[kernel].proc(data, coefs, tmp, g_quants[quant]);
+                if (memcmp(coefs, expect, 4096 * sizeof(short)) != 0)
+                {
+                    printf("check_rem: rem_dwt_shift_%s tile %d quant %d "
+                           "differs\n", kernels[kernel].name, tile, quant);
+                    bad++;
+                }
+            }
+        }
+    }
+    free(data);
+    free(expect);
+    free(coefs);
+    free(tmp);
+    return bad;
+}
+
+/*****************************************************************************/
+/* 4096 coefficients and their history, index 0 to TEST_EXTREME_TILES - 1
+   are all 0, equal, 32767 over -32768, -32768 over 32767, 0 and -1 over -1
+   and 0, and the same sparse values, the rest random, sparse or full
+   range */
+static void
+make_coefs(short *coefs, short *history, int index)
+{
+    int i;
+
+    for (i = 0; i < 4096; i++)
+    {
+        switch (index)
+        {
+            case 0:
+                coefs[i] = 0;
+                history[i] = 0;
+                break;
+            case 1:
+                coefs[i] = test_rand() - 32768;
+                history[i] = coefs[i];
+                break;
+            case 2:
+                coefs[i] = 32767;
+                history[i] = -32768;
+                break;
+            case 3:
+                coefs[i] = -32768;
+                history[i] = 32767;
+                break;
+            case 4:
+                coefs[i] = -(i & 1);
+                history[i] = -((i & 1) ^ 1);
+                break;
+            case 5:
+                coefs[i] = (test_rand() & 7) == 0 ?
+                           (test_rand() & 63) - 32 : 0;
+                history[i] = coefs[i];
+                break;
+            default:
+                if (index & 1)
+                {
+                    coefs[i] = test_rand() - 32768;
+                    history[i] = test_rand() - 32768;
+                }
+                else
+                {
+                    coefs[i] = (test_rand() & 3) == 0 ?
+                               (test_rand() & 7) - 4 : 0;
+                    history[i] = (test_rand() & 3) == 0 ? coefs[i] : 0;
+                }
+                break;
+        }
+    }
+}
+
+/*****************************************************************************/
+/* each progressive diff_count kernel against rfxencode_differential_pro,
+   with and without history_out
+   returns the number of kernel, input and history_out runs that differ */
+static int
+check_diff(const struct rfxcodec_encode_internals *internals)
+{
+    struct diff_kernel kernels[5];
+    short *coefs;
+    short *history;
+    short *expect_diff;
+    short *expect_out;
+    short *diff;
+    short *out;
+    int expect_zeros[2];
+    int zeros[2];
+    int num_kernels;
+    int kernel;
+    int tile;
+    int with_out;
+    int bad;
+
+    num_kernels = 0;
+    kernels[num_kernels].name = "amd64_sse2";
+    kernels[num_kernels].proc =
+        internals->rfxencode_differential_pro_amd64_sse2;
+    kernels[num_kernels++].isa = TEST_ISA_SSE2;
+    kernels[num_kernels].name = "amd64_avx2";
+    kernels[num_kernels].proc =
+        internals->rfxencode_differential_pro_amd64_avx2;
+    kernels[num_kernels++].isa = TEST_ISA_AVX2;
+    kernels[num_kernels].name = "intrin_sse2";
+    kernels[num_kernels].proc =
+        internals->rfxencode_differential_pro_intrin_sse2;
+    kernels[num_kernels++].isa = TEST_ISA_SSE2;
+    kernels[num_kernels].name = "intrin_sse41";
+    kernels[num_kernels].proc =
+        internals->rfxencode_differential_pro_intrin_sse41;
+    kernels[num_kernels++].isa = TEST_ISA_SSE41;
+    kernels[num_kernels].name = "intrin_avx2";
+    kernels[num_kernels].proc =
+        internals->rfxencode_differential_pro_intrin_avx2;
+    kernels[num_kernels++].isa = TEST_ISA_AVX2;
+
+    coefs = (short *) malloc(4096 * sizeof(short));
+    history = (short *) malloc(4096 * sizeof(short));
+    expect_diff = (short *) malloc(4096 * sizeof(short));
+    expect_out = (short *) malloc(4096 * sizeof(short));
+    diff = (short *) malloc(4096 * sizeof(short));
+    out = (short *) malloc(4096 * sizeof(short));
+    if ((coefs == NULL) || (history == NULL) || (expect_diff == NULL) ||
+            (expect_out == NULL) || (diff == NULL) || (out == NULL))
+    {
+        printf("check_diff: malloc failed\n");
+        exit(1);
+    }
+    bad = 0;
+    for (kernel = 0; kernel < num_kernels; kernel++)
+    {
+        if ((kernels[kernel].proc == NULL) ||
+                !got_isa(kernels[kernel].isa))
+        {
+            continue;
+        }
+        printf("check_diff: diff_count_%s\n", kernels[kernel].name);
+        g_seed = 1;
+        for (tile = 0; tile < TEST_TILES; tile++)
+        {
+            make_coefs(coefs, history, tile);
+            internals->rfxencode_differential_pro(coefs, history, expect_diff,
+                                                  expect_out,
+                                                  expect_zeros + 0,
+                                                  expect_zeros + 1);
+            for (with_out = 0; with_out < 2; with_out++)
+            {
+                memset(diff, 0x5a, 4096 * sizeof(short));
+                memset(out, 0x5a, 4096 * sizeof(short));
+                zeros[0] = -1;
+                zeros[1] = -1;
+                kernels[kernel].proc(coefs, history, diff,
+                                     with_out ? out : NULL,
+                                     zeros + 0, zeros + 1);
+                if ((memcmp(diff, expect_diff, 4096 * sizeof(short)) != 0) ||
+                        (zeros[0] != expect_zeros[0]) ||
+                        (zeros[1] != expect_zeros[1]) ||
+                        (with_out &&
+                         (memcmp(out, expect_out, 4096 * sizeof(short)) != 0)))
+                {
+                    printf("check_diff: diff_count_%s input %d history_out %d "
+                           "differs, zeros %d %d expected %d %d\n",
+                           kernels[kernel].name, tile, with_out,
+                           zeros[0], zeros[1],
+                           expect_zeros[0], expect_zeros[1]);
+                    bad++;
+                }
+            }
+        }
+    }
+    free(coefs);
+    free(history);
+    free(expect_diff);
+    free(expect_out);
+    free(diff);
+    free(out);
+    return bad;
+}
+
+/*****************************************************************************/
+int
+main(int argc, char **argv)
+{
+    struct rfxcodec_encode_internals internals;
+    int bad;
+
+    rfxcodec_encode_get_internals(&internals);
+    bad = check_dwt(&internals);
+    bad += check_rem(&internals);
+    bad += check_diff(&internals);
+    if (bad != 0)
+    {
+        printf("rfxkerneltest: %d failed\n", bad);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,427 @@
+/**
+ * RFX codec encoder thread test
+ *
+ * Copyright 2026 librfxcodec contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * the output of a handle encoding on worker threads, its own, a shared
+ * pool's or its pipeline stages, must be byte for byte what the same handle gives
+ * encoding on the calling thread, also when the output buffer is too
+ * small for all the tiles, and the pool stats must add up
+ */
+
+#if defined(HAVE_CONFIG_H)
+#include <config_ac.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rfxcodec_encode.h>
+
+#define TEST_WIDTH 300 /* not a multiple of 64 so there are partial tiles */
+#define TEST_HEIGHT 200
+/* RFX_FORMAT_YUV is whole tiles, PRO1 takes only that */
+#define TEST_YUV_WIDTH 320
+#define TEST_YUV_HEIGHT 192
+#define TEST_FRAMES 3
+#define TEST_MAX_TILES 64
+#define TEST_CDATA_BYTES (4 * 1024 * 1024)
+/* frame that gets half the bytes it needs, RFX stops once less than a
+   worst case tile, about 24 KB, is left so it gets that on top, PRO
+   stops at the first tile that does not fit */
+#define TEST_SMALL_FRAME 1
+#define TEST_SMALL_BYTES(_need, _flags) \
+    (((_flags) & RFX_FLAGS_PRO1) ? (_need) / 2 : (_need) / 2 + 25 * 1024)
+
+#define TEST_MODE_THREADS 0 /* rfxcodec_encode_set_threads */
+#define TEST_MODE_POOL 1 /* rfxcodec_encode_set_pool */
+#define TEST_MODE_PIPELINE 2 /* rfxcodec_encode_set_pipeline */
+
+static const char g_quants[10] =
+{
+    0x66, 0x66, 0x77, 0x88, 0x98,
+    0x99, 0x99, 0xaa, 0xcc, 0xdc
+};
+
+static unsigned int g_seed = 1;
+
+/*****************************************************************************/
+static int
+test_rand(void)
+{
+    g_seed = g_seed * 1103515245 + 12345;
+    return (g_seed >> 8) & 0xffff;
+}
+
+/*****************************************************************************/
+static int
+get_bpp(int format)
+{
+    if ((format == RFX_FORMAT_BGR) || (format == RFX_FORMAT_RGB))
+    {
+        return 3;
+    }
+    return 4;
+}
+
+/*****************************************************************************/
+/* smooth gradients with some noise and an alpha ramp, moved each frame */
+static void
+make_frame(char *buf, int width, int height, int stride_bytes, int format,
+           int frame)
+{
+    unsigned char *line;
+    unsigned char *tile;
+    int bpp;
+    int x;
+    int y;
+    int index;
+
+    if (format == RFX_FORMAT_YUV)
+    {
+        /* each 64x64 tile is 4 planes of 4096 bytes, Y U V A */
+        for (y = 0; y < height; y += 64)
+        {
+            for (x = 0; x < width; x += 64)
+            {
+                tile = (unsigned char *) buf + y * stride_bytes + (x << 8);
+                for (index = 0; index < 4096; index++)
+                {
+                    tile[index] = (index & 63) * 3 + y + frame * 8 +
+                                  test_rand() % 5;
+                    tile[4096 + index] = 128 + (index >> 6) + x;
+                    tile[8192 + index] = 100 + (index & 7) + frame;
+                    tile[12288 + index] = (index * 7) & 0xff;
+                }
+            }
+        }
+        return;
+    }
+    bpp = get_bpp(format);
+    for (y = 0; y < height; y++)
+    {
+        line = (unsigned char *) (buf + y * stride_bytes);
+        for (x = 0; x < width; x++)
+        {
+            line[0] = (x * 255 / width + frame * 8) + test_rand() % 5;
+            line[1] = y * 255 / height;
+            line[2] = ((x + y) * 3 + frame) & 0xff;
+            if (bpp == 4)
+            {
+                line[3] = (x + y) & 0xff;
+            }
+            line += bpp;
+        }
+    }
+}
+
+/*****************************************************************************/
+static int
+make_tiles(struct rfx_tile *tiles, int width, int height)
+{
+    struct rfx_tile *tile;
+    int num_tiles;
+    int x;
+    int y;
+
+    num_tiles = 0;
+    for (y = 0; y < height; y += 64)
+    {
+        for (x = 0; x < width; x += 64)
+        {
+            tile = tiles + num_tiles;
+            tile->x = x;
+            tile->y = y;
+            tile->cx = width - x < 64 ? width - x : 64;
+            tile->cy = height - y < 64 ? height - y : 64;
+            tile->quant_y = 0;
+            tile->quant_cb = 0;
+            tile->quant_cr = 0;
+            num_tiles++;
+        }
+    }
+    return num_tiles;
+}
+
+/*****************************************************************************/
+static int
+setup_handle(void *handle, int mode, int num_threads, void *pool)
+{
+    if (mode == TEST_MODE_POOL)
+    {
+        return rfxcodec_encode_set_pool(handle, pool);
+    }
+    if (mode == TEST_MODE_PIPELINE)
+    {
+        return rfxcodec_encode_set_pipeline(handle, 1);
+    }
+    return rfxcodec_encode_set_threads(handle, num_threads);
+}
+
+/*****************************************************************************/
+/* encodes TEST_FRAMES frames on a serial handle and on one set up by
+   mode and compares them, frame TEST_SMALL_FRAME does not fit
+   returns the number of frames that differ */
+static int
+check_encode(int format, int flags, int encode_flags, int mode,
+             int num_threads, void *pool)
+{
+    struct rfx_tile tiles[TEST_MAX_TILES];
+    struct rfx_rect region;
+    void *serial;
+    void *threaded;
+    void *probe;
+    char *buf;
+    char *cdata1;
+    char *cdata2;
+    int width;
+    int height;
+    int stride_bytes;
+    int num_tiles;
+    int max_bytes;
+    int bytes1;
+    int bytes2;
+    int written1;
+    int written2;
+    int frame;
+    int bad;
+
+    width = TEST_WIDTH;
+    height = TEST_HEIGHT;
+    stride_bytes = width * get_bpp(format) + 4;
+    if (format == RFX_FORMAT_YUV)
+    {
+        width = TEST_YUV_WIDTH;
+        height = TEST_YUV_HEIGHT;
+        stride_bytes = width * 4;
+    }
+    buf = (char *) malloc(stride_bytes * height);
+    cdata1 = (char *) malloc(TEST_CDATA_BYTES);
+    cdata2 = (char *) malloc(TEST_CDATA_BYTES);
+    if ((buf == NULL) || (cdata1 == NULL) || (cdata2 == NULL) ||
+            (rfxcodec_encode_create_ex(width, height, format, flags,
+                                       &serial) != 0) ||
+            (rfxcodec_encode_create_ex(width, height, format, flags,
+                                       &threaded) != 0) ||
+            (rfxcodec_encode_create_ex(width, height, format, flags,
+                                       &probe) != 0) ||
+            (setup_handle(threaded, mode, num_threads, pool) != 0))
+    {
+        printf("check_encode: setup failed\n");
+        exit(1);
+    }
+    num_tiles = make_tiles(tiles, width, height);
+    region.x = 0;
+    region.y = 0;
+    region.cx = width;
+    region.cy = height;
+    bad = 0;
+    for (frame = 0; frame < TEST_FRAMES; frame++)
+    {
+        make_frame(buf, width, height, stride_bytes, format, frame);
+        /* probe has the same history as serial up to TEST_SMALL_FRAME and
+           tells how many bytes all the tiles take */
+        max_bytes = TEST_CDATA_BYTES;
+        rfxcodec_encode_ex(probe, cdata1, &max_bytes, buf,
+                           width, height, stride_bytes,
+                           &region, 1, tiles, num_tiles,
+                           g_quants, 1, encode_flags);
+        bytes1 = frame == TEST_SMALL_FRAME ?
+                 TEST_SMALL_BYTES(max_bytes, flags) : TEST_CDATA_BYTES;
+        bytes2 = bytes1;
+        written1 = rfxcodec_encode_ex(serial, cdata1, &bytes1, buf,
+                                      width, height, stride_bytes,
+                                      &region, 1, tiles, num_tiles,
+                                      g_quants, 1, encode_flags);
+        written2 = rfxcodec_encode_ex(threaded, cdata2, &bytes2, buf,
+                                      width, height, stride_bytes,
+                                      &region, 1, tiles, num_tiles,
+                                      g_quants, 1, encode_flags);
+        if ((written2 != written1) || (bytes2 != bytes1) ||
+                (memcmp(cdata1, cdata2, bytes1) != 0) ||
+                (frame == TEST_SMALL_FRAME ?
+                 (written1 < 1) || (written1 >= num_tiles) :
+                 (written1 != num_tiles)))
+        {
+            printf("check_encode: format %d flags 0x%x encode_flags 0x%x "
+                   "mode %d frame %d differs, tiles %d %d bytes %d %d\n",
+                   format, flags, encode_flags, mode, frame,
+                   written1, written2, bytes1, bytes2);
+            bad++;
+        }
+    }
+    rfxcodec_encode_destroy(serial);
+    rfxcodec_encode_destroy(threaded);
+    rfxcodec_encode_destroy(probe);
+    free(buf);
+    free(cdata1);
+    free(cdata2);
+    return bad;
+}
+
+/*****************************************************************************/
+/* every case with mode */
+static int
+check_mode(int mode, int num_threads, void *pool)
+{
+    static const int formats[4] =
+    {
+        RFX_FORMAT_BGRA, RFX_FORMAT_RGBA, RFX_FORMAT_BGR, RFX_FORMAT_RGB
+    };
+    int index;
+    int bad;
+
+    bad = 0;
+    for (index = 0; index < 4; index++)
+    {
+        bad += check_encode(formats[index], RFX_FLAGS_RLGR3, 0,
+                            mode, num_threads, pool);
+        bad += check_encode(formats[index], RFX_FLAGS_RLGR1, 0,
+                            mode, num_threads, pool);
+        bad += check_encode(formats[index], RFX_FLAGS_RLGR3,
+                            RFX_FLAGS_ALPHAV1, mode, num_threads, pool);
+    }
+    bad += check_encode(RFX_FORMAT_BGRA, RFX_FLAGS_RLGR1,
+                        RFX_FLAGS_ALPHAV1, mode, num_threads, pool);
+    bad += check_encode(RFX_FORMAT_YUV, RFX_FLAGS_RLGR1, 0,
+                        mode, num_threads, pool);
+    bad += check_encode(RFX_FORMAT_YUV, RFX_FLAGS_PRO1, 0,
+                        mode, num_threads, pool);
+    bad += check_encode(RFX_FORMAT_YUV, RFX_FLAGS_PRO1,
+                        RFX_FLAGS_PRO_KEY, mode, num_threads, pool);
+    return bad;
+}
+
+/*****************************************************************************/
+/* every tile of a handle on pool is counted once and nothing is left
+   queued after rfxcodec_encode_ex returns
+   returns the number of checks that failed */
+static int
+check_stats(void *pool)
+{
+    struct rfxcodec_encode_stats stats;
+    struct rfx_tile tiles[TEST_MAX_TILES];
+    struct rfx_rect region;
+    void *handle;
+    char *buf;
+    char *cdata;
+    int stride_bytes;
+    int num_tiles;
+    int bytes;
+    int frame;
+    int bad;
+
+    stride_bytes = TEST_WIDTH * 4;
+    buf = (char *) malloc(stride_bytes * TEST_HEIGHT);
+    cdata = (char *) malloc(TEST_CDATA_BYTES);
+    if ((buf == NULL) || (cdata == NULL) ||
+            (rfxcodec_encode_create_ex(TEST_WIDTH, TEST_HEIGHT,
+                                       RFX_FORMAT_BGRA, 0, &handle) != 0))
+    {
+        printf("check_stats: setup failed\n");
+        exit(1);
+    }
+    bad = 0;
+    memset(&stats, 0xff, sizeof(stats));
+    if ((rfxcodec_encode_get_stats(handle, &stats) != 0) ||
+            (stats.queue_depth != 0) || (stats.tiles_done != 0) ||
+            (stats.wait_us_avg != 0) || (stats.wait_us_max != 0))
+    {
+        printf("check_stats: stats without a pool not 0\n");
+        bad++;
+    }
+    /* out of range values are clamped, set before or after the pool */
+    if ((rfxcodec_encode_set_share(handle, 0, -1) != 0) ||
+            (rfxcodec_encode_set_pool(handle, pool) != 0) ||
+            (rfxcodec_encode_set_share(handle, 3, 20) != 0))
+    {
+        printf("check_stats: set_share failed\n");
+        bad++;
+    }
+    num_tiles = make_tiles(tiles, TEST_WIDTH, TEST_HEIGHT);
+    region.x = 0;
+    region.y = 0;
+    region.cx = TEST_WIDTH;
+    region.cy = TEST_HEIGHT;
+    for (frame = 0; frame < TEST_FRAMES; frame++)
+    {
+        make_frame(buf, TEST_WIDTH, TEST_HEIGHT, stride_bytes,
+                   RFX_FORMAT_BGRA, frame);
+        bytes = TEST_CDATA_BYTES;
+        if (rfxcodec_encode_ex(handle, cdata, &bytes, buf,
+                               TEST_WIDTH, TEST_HEIGHT, stride_bytes,
+                               &region, 1, tiles, num_tiles,
+                               g_quants, 1, 0) != num_tiles)
+        {
+            printf("check_stats: frame %d encode failed\n", frame);
+            bad++;
+        }
+        if ((rfxcodec_encode_get_stats(handle, &stats) != 0) ||
+                (stats.queue_depth != 0) ||
+                (stats.tiles_done != num_tiles * (frame + 1)) ||
+                (stats.wait_us_avg < 0) || (stats.wait_us_max < 0) ||
+                (stats.wait_us_avg > 60 * 1000 * 1000) ||
+                (stats.wait_us_max > 60 * 1000 * 1000))
+        {
+            printf("check_stats: frame %d queue_depth %d tiles_done %d "
+                   "wait_us_avg %d wait_us_max %d\n", frame,
+                   stats.queue_depth, stats.tiles_done,
+                   stats.wait_us_avg, stats.wait_us_max);
+            bad++;
+        }
+        /* no tiles since, the max starts over */
+        if ((rfxcodec_encode_get_stats(handle, &stats) != 0) ||
+                (stats.wait_us_max != 0) ||
+                (stats.tiles_done != num_tiles * (frame + 1)))
+        {
+            printf("check_stats: frame %d wait_us_max %d not reset\n",
+                   frame, stats.wait_us_max);
+            bad++;
+        }
+    }
+    rfxcodec_encode_destroy(handle);
+    free(buf);
+    free(cdata);
+    return bad;
+}
+
+/*****************************************************************************/
+int
+main(int argc, char **argv)
+{
+    void *pool;
+    int bad;
+
+    bad = check_mode(TEST_MODE_THREADS, 4, NULL);
+    /* capped at the cpu count, one thread still runs the tiles off the
+       calling thread */
+    if (rfxcodec_encode_pool_create(4, &pool) != 0)
+    {
+        printf("rfxpooltest: rfxcodec_encode_pool_create failed\n");
+        return 1;
+    }
+    bad += check_mode(TEST_MODE_POOL, 0, pool);
+    bad += check_stats(pool);
+    rfxcodec_encode_pool_destroy(pool);
+    /* PRO1 is not pipelined, those cases stay serial */
+    bad += check_mode(TEST_MODE_PIPELINE, 0, NULL);
+    if (bad != 0)
+    {
+        printf("rfxpooltest: %d failed\n", bad);
+        return 1;
+    }
+    return 0;
+}